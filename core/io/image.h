@@ -302,6 +302,7 @@ public:
 	bool is_empty() const;
 
 	Vector<uint8_t> get_data() const;
+	virtual uint64_t get_memory_usage_estimate() const override { return data.size(); }
 
 	Error load(const String &p_path);
 	static Ref<Image> load_from_file(const String &p_path);
@@ -46,8 +46,13 @@ static int _get_pad(int p_alignment, int p_n) {
 	return pad;
 }
 
+String PCKPacker::_get_content_key(const uint8_t *p_md5, uint64_t p_size, bool p_encrypted) {
+	return String::hex_encode_buffer(p_md5, 16) + ":" + itos(p_size) + (p_encrypted ? ":e" : "");
+}
+
 void PCKPacker::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pck_start", "pck_name", "alignment", "key", "encrypt_directory"), &PCKPacker::pck_start, DEFVAL(32), DEFVAL("0000000000000000000000000000000000000000000000000000000000000000"), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("set_patch_base", "base_pck"), &PCKPacker::set_patch_base);
 	ClassDB::bind_method(D_METHOD("add_file", "pck_path", "source_path", "encrypt"), &PCKPacker::add_file, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("flush", "verbose"), &PCKPacker::flush, DEFVAL(false));
 }
@@ -101,11 +106,103 @@ Error PCKPacker::pck_start(const String &p_file, int p_alignment, const String &
 	file->store_32(pack_flags); // flags
 
 	files.clear();
+	content_files.clear();
+	base_files.clear();
+	base_pack = String();
+	skipped_count = 0;
+	duplicate_count = 0;
 	ofs = 0;
 
 	return OK;
 }
 
+Error PCKPacker::set_patch_base(const String &p_base_pack) {
+	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
+
+	base_files.clear();
+	base_pack = String();
+
+	Ref<FileAccess> f = FileAccess::open(p_base_pack, FileAccess::READ);
+	ERR_FAIL_COND_V_MSG(f.is_null(), ERR_FILE_CANT_OPEN, "Can't open base pack: " + p_base_pack + ".");
+
+	uint32_t magic = f->get_32();
+	ERR_FAIL_COND_V_MSG(magic != PACK_HEADER_MAGIC, ERR_FILE_UNRECOGNIZED, "Base pack is not a standalone PCK file: " + p_base_pack + ".");
+	uint32_t version = f->get_32();
+	ERR_FAIL_COND_V_MSG(version != PACK_FORMAT_VERSION, ERR_FILE_UNRECOGNIZED, "Base pack version unsupported: " + itos(version) + ".");
+	f->get_32(); // major
+	f->get_32(); // minor
+	f->get_32(); // patch
+
+	uint32_t pack_flags = f->get_32();
+	uint64_t files_base = f->get_64();
+
+	for (int i = 0; i < 16; i++) {
+		f->get_32(); // reserved
+	}
+
+	int file_count = f->get_32();
+
+	if (pack_flags & PACK_DIR_ENCRYPTED) {
+		Ref<FileAccessEncrypted> fae;
+		fae.instantiate();
+		ERR_FAIL_COND_V(fae.is_null(), ERR_CANT_OPEN);
+
+		Error err = fae->open_and_parse(f, key, FileAccessEncrypted::MODE_READ, false);
+		ERR_FAIL_COND_V_MSG(err != OK, ERR_CANT_OPEN, "Can't open encrypted directory of base pack (the key must match the one passed to pck_start).");
+		f = fae;
+	}
+
+	for (int i = 0; i < file_count; i++) {
+		uint32_t sl = f->get_32();
+		CharString cs;
+		cs.resize(sl + 1);
+		f->get_buffer((uint8_t *)cs.ptr(), sl);
+		cs[sl] = 0;
+
+		String path;
+		path.parse_utf8(cs.ptr());
+
+		uint64_t ofs = files_base + f->get_64();
+		uint64_t size = f->get_64();
+		uint8_t md5[16];
+		f->get_buffer(md5, 16);
+		uint32_t flags = f->get_32();
+
+		BaseFile bf;
+		bf.content_key = _get_content_key(md5, size, flags & PACK_FILE_ENCRYPTED);
+		bf.ofs = ofs;
+		base_files[path] = bf;
+	}
+
+	base_pack = p_base_pack;
+
+	return OK;
+}
+
+bool PCKPacker::_base_file_matches(const BaseFile &p_base_file, bool p_encrypted, const Vector<uint8_t> &p_data) const {
+	Ref<FileAccess> f = FileAccess::open(base_pack, FileAccess::READ);
+	if (f.is_null()) {
+		return false;
+	}
+	f->seek(p_base_file.ofs);
+
+	if (p_encrypted) {
+		Ref<FileAccessEncrypted> fae;
+		fae.instantiate();
+		if (fae->open_and_parse(f, key, FileAccessEncrypted::MODE_READ, false) != OK) {
+			return false;
+		}
+		f = fae;
+	}
+
+	Vector<uint8_t> stored;
+	stored.resize(p_data.size());
+	if (f->get_buffer(stored.ptrw(), stored.size()) != (uint64_t)stored.size()) {
+		return false;
+	}
+	return stored == p_data;
+}
+
 Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encrypt) {
 	ERR_FAIL_COND_V_MSG(file.is_null(), ERR_INVALID_PARAMETER, "File must be opened before use.");
 
@@ -131,6 +228,32 @@ Error PCKPacker::add_file(const String &p_file, const String &p_src, bool p_encr
 	}
 	pf.encrypted = p_encrypt;
 
+	const String content_key = _get_content_key(pf.md5.ptr(), pf.size, pf.encrypted);
+
+	// Files that are identical in the patch base pack don't need to be stored again,
+	// they keep being read from the base pack once the patch is loaded on top of it.
+	// The hash only identifies candidates, the stored bytes are compared before skipping.
+	HashMap<String, BaseFile>::ConstIterator base = base_files.find(p_file);
+	if (base && base->value.content_key == content_key && _base_file_matches(base->value, pf.encrypted, data)) {
+		skipped_count++;
+		return OK;
+	}
+
+	// Files with the same contents share the data stored for the first one.
+	HashMap<String, int>::ConstIterator existing = content_files.find(content_key);
+	if (existing) {
+		const File &first = files[existing->value];
+		if (FileAccess::get_file_as_bytes(first.src_path) == data) {
+			pf.ofs = first.ofs;
+			pf.duplicate = true;
+			duplicate_count++;
+			files.push_back(pf);
+			return OK;
+		}
+	} else {
+		content_files.insert(content_key, files.size());
+	}
+
 	uint64_t _size = pf.size;
 	if (p_encrypt) { // Add encryption overhead.
 		if (_size % 16) { // Pad to encryption block size.
@@ -216,6 +339,14 @@ Error PCKPacker::flush(bool p_verbose) {
 
 	int count = 0;
 	for (int i = 0; i < files.size(); i++) {
+		if (files[i].duplicate) {
+			count += 1;
+			if (p_verbose) {
+				print_line(vformat("[%d/%d - %d%%] PCKPacker flush: %s -> %s (duplicate)", count, files.size(), float(count) / files.size() * 100, files[i].src_path, files[i].path));
+			}
+			continue;
+		}
+
 		Ref<FileAccess> src = FileAccess::open(files[i].src_path, FileAccess::READ);
 		uint64_t to_write = files[i].size;
 
@@ -253,6 +384,9 @@ Error PCKPacker::flush(bool p_verbose) {
 	}
 
 	if (p_verbose) {
+		if (duplicate_count > 0 || skipped_count > 0) {
+			print_line(vformat("PCKPacker flush: %d duplicate file(s) shared, %d file(s) unchanged from the patch base skipped.", duplicate_count, skipped_count));
+		}
 		printf("\n");
 	}
 
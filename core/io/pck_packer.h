@@ -32,6 +32,7 @@
 #define PCK_PACKER_H
 
 #include "core/object/ref_counted.h"
+#include "core/templates/hash_map.h"
 
 class FileAccess;
 
@@ -53,12 +54,28 @@ class PCKPacker : public RefCounted {
 		uint64_t ofs = 0;
 		uint64_t size = 0;
 		bool encrypted = false;
+		bool duplicate = false; // Shares the data of an earlier file with the same contents.
 		Vector<uint8_t> md5;
 	};
 	Vector<File> files;
 
+	struct BaseFile {
+		String content_key;
+		uint64_t ofs = 0; // Absolute offset of the data in the patch base pack.
+	};
+
+	HashMap<String, int> content_files; // Index in files of the first file added for each content key.
+	HashMap<String, BaseFile> base_files; // Files of the patch base pack, by path.
+	String base_pack;
+	int skipped_count = 0;
+	int duplicate_count = 0;
+
+	static String _get_content_key(const uint8_t *p_md5, uint64_t p_size, bool p_encrypted);
+	bool _base_file_matches(const BaseFile &p_base_file, bool p_encrypted, const Vector<uint8_t> &p_data) const;
+
 public:
 	Error pck_start(const String &p_file, int p_alignment = 32, const String &p_key = "0000000000000000000000000000000000000000000000000000000000000000", bool p_encrypt_directory = false);
+	Error set_patch_base(const String &p_base_pack);
 	Error add_file(const String &p_file, const String &p_src, bool p_encrypt = false);
 	Error flush(bool p_verbose = false);
 
@@ -484,7 +484,18 @@ Mutex ResourceCache::lock;
 RWLock ResourceCache::path_cache_lock;
 #endif
 
+List<ResourceCache::SoftCacheEntry> ResourceCache::soft_cache;
+HashMap<const Resource *, List<ResourceCache::SoftCacheEntry>::Element *> ResourceCache::soft_cache_map;
+uint64_t ResourceCache::soft_cache_budget = 0;
+uint64_t ResourceCache::soft_cache_usage = 0;
+
+SafeNumeric<uint64_t> ResourceCache::hits;
+SafeNumeric<uint64_t> ResourceCache::misses;
+SafeNumeric<uint64_t> ResourceCache::soft_cache_evictions;
+
 void ResourceCache::clear() {
+	clear_soft_cache();
+
 	if (resources.size()) {
 		ERR_PRINT("Resources still in use at exit (run with --verbose for details).");
 		if (OS::get_singleton()->is_stdout_verbose()) {
@@ -572,3 +583,96 @@ int ResourceCache::get_cached_resource_count() {
 
 	return rc;
 }
+
+void ResourceCache::_evict_soft_cache(LocalVector<Ref<Resource>> &r_evicted) {
+	while (soft_cache_usage > soft_cache_budget && soft_cache.size()) {
+		List<SoftCacheEntry>::Element *E = soft_cache.back();
+		soft_cache_usage -= E->get().size;
+		soft_cache_map.erase(E->get().resource.ptr());
+		// Released by the caller outside of the lock, as it may free the resource.
+		r_evicted.push_back(E->get().resource);
+		soft_cache.erase(E);
+		soft_cache_evictions.increment();
+	}
+}
+
+void ResourceCache::touch(const Ref<Resource> &p_resource) {
+	ERR_FAIL_COND(p_resource.is_null());
+
+	LocalVector<Ref<Resource>> evicted;
+
+	lock.lock();
+	if (soft_cache_budget == 0) {
+		lock.unlock();
+		return;
+	}
+	List<SoftCacheEntry>::Element **E = soft_cache_map.getptr(p_resource.ptr());
+	if (E) {
+		soft_cache.move_to_front(*E);
+		lock.unlock();
+		return;
+	}
+	lock.unlock();
+
+	// Estimating may query servers or scripts, so it's done outside of the lock.
+	const uint64_t size = p_resource->get_memory_usage_estimate();
+
+	lock.lock();
+	// Only resources that are cached by path can be found again when loading.
+	Resource **res = resources.getptr(p_resource->get_path());
+	if (soft_cache_budget > 0 && res && *res == p_resource.ptr() && !soft_cache_map.has(p_resource.ptr())) {
+		SoftCacheEntry entry;
+		entry.resource = p_resource;
+		entry.size = size;
+		soft_cache_usage += entry.size;
+		soft_cache_map[p_resource.ptr()] = soft_cache.push_front(entry);
+		_evict_soft_cache(evicted);
+	}
+	lock.unlock();
+}
+
+void ResourceCache::set_soft_cache_budget(uint64_t p_bytes) {
+	LocalVector<Ref<Resource>> evicted;
+
+	lock.lock();
+	soft_cache_budget = p_bytes;
+	_evict_soft_cache(evicted);
+	lock.unlock();
+}
+
+uint64_t ResourceCache::get_soft_cache_budget() {
+	lock.lock();
+	uint64_t budget = soft_cache_budget;
+	lock.unlock();
+
+	return budget;
+}
+
+uint64_t ResourceCache::get_soft_cache_usage() {
+	lock.lock();
+	uint64_t usage = soft_cache_usage;
+	lock.unlock();
+
+	return usage;
+}
+
+int ResourceCache::get_soft_cache_resource_count() {
+	lock.lock();
+	int rc = soft_cache.size();
+	lock.unlock();
+
+	return rc;
+}
+
+void ResourceCache::clear_soft_cache() {
+	LocalVector<Ref<Resource>> evicted;
+
+	lock.lock();
+	for (const SoftCacheEntry &E : soft_cache) {
+		evicted.push_back(E.resource);
+	}
+	soft_cache.clear();
+	soft_cache_map.clear();
+	soft_cache_usage = 0;
+	lock.unlock();
+}
@@ -34,6 +34,8 @@
 #include "core/io/resource_uid.h"
 #include "core/object/class_db.h"
 #include "core/object/ref_counted.h"
+#include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/safe_refcount.h"
 #include "core/templates/self_list.h"
 
@@ -139,6 +141,9 @@ public:
 
 	virtual RID get_rid() const; // some resources may offer conversion to RID
 
+	// Rough amount of memory used by the resource, used to budget the soft resource cache.
+	virtual uint64_t get_memory_usage_estimate() const { return 1024; }
+
 #ifdef TOOLS_ENABLED
 	//helps keep IDs same number when loading/saving scenes. -1 clears ID and it Returns -1 when no id stored
 	void set_id_for_path(const String &p_path, const String &p_id);
@@ -158,6 +163,26 @@ class ResourceCache {
 	static HashMap<String, HashMap<String, String>> resource_path_cache; // Each tscn has a set of resource paths and IDs.
 	static RWLock path_cache_lock;
 #endif // TOOLS_ENABLED
+
+	// The soft cache keeps a reference to recently loaded resources, so they are not
+	// freed as soon as their last user releases them. Least recently used resources
+	// are released first when the estimated memory usage goes over the budget.
+	struct SoftCacheEntry {
+		Ref<Resource> resource;
+		uint64_t size = 0;
+	};
+
+	static List<SoftCacheEntry> soft_cache;
+	static HashMap<const Resource *, List<SoftCacheEntry>::Element *> soft_cache_map;
+	static uint64_t soft_cache_budget;
+	static uint64_t soft_cache_usage;
+
+	static SafeNumeric<uint64_t> hits;
+	static SafeNumeric<uint64_t> misses;
+	static SafeNumeric<uint64_t> soft_cache_evictions;
+
+	static void _evict_soft_cache(LocalVector<Ref<Resource>> &r_evicted);
+
 	friend void unregister_core_types();
 	static void clear();
 	friend void register_core_types();
@@ -167,6 +192,17 @@ public:
 	static Ref<Resource> get_ref(const String &p_path);
 	static void get_cached_resources(List<Ref<Resource>> *p_resources);
 	static int get_cached_resource_count();
+
+	static void touch(const Ref<Resource> &p_resource);
+	static void set_soft_cache_budget(uint64_t p_bytes);
+	static uint64_t get_soft_cache_budget();
+	static uint64_t get_soft_cache_usage();
+	static int get_soft_cache_resource_count();
+	static void clear_soft_cache();
+
+	static uint64_t get_hit_count() { return hits.get(); }
+	static uint64_t get_miss_count() { return misses.get(); }
+	static uint64_t get_soft_cache_eviction_count() { return soft_cache_evictions.get(); }
 };
 
 #endif // RESOURCE_H
@@ -384,6 +384,9 @@ Error ResourceLoader::_load_threaded_request_whitelisted_int(const String &p_pat
 				load_task.resource = existing;
 				load_task.status = THREAD_LOAD_LOADED;
 				load_task.progress = 1.0;
+				ResourceCache::hits.increment();
+			} else {
+				ResourceCache::misses.increment();
 			}
 		}
 
@@ -545,6 +548,10 @@ Ref<Resource> ResourceLoader::load_threaded_get(const String &p_path, Error *r_e
 		*r_error = load_task.error;
 	}
 
+	if (resource.is_valid()) {
+		ResourceCache::touch(resource);
+	}
+
 	load_task.requests--;
 
 	if (load_task.requests == 0) {
@@ -598,6 +605,9 @@ Ref<Resource> ResourceLoader::_load_whitelisted_int(const String &p_path, const
 		if (existing.is_valid()) {
 			thread_load_mutex->unlock();
 
+			ResourceCache::hits.increment();
+			ResourceCache::touch(existing);
+
 			if (r_error) {
 				*r_error = OK;
 			}
@@ -605,6 +615,8 @@ Ref<Resource> ResourceLoader::_load_whitelisted_int(const String &p_path, const
 			return existing; //use cached
 		}
 
+		ResourceCache::misses.increment();
+
 		//load using task (but this thread)
 		ThreadLoadTask load_task;
 
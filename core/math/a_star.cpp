@@ -327,23 +327,19 @@ bool AStar3D::_solve(Point *begin_point, Point *end_point) {
 
 	bool found_route = false;
 
-	LocalVector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
-
 	begin_point->g_score = 0;
 	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
+	begin_point->open_pass = pass;
+	open_list.push(begin_point);
 
 	while (!open_list.is_empty()) {
-		Point *p = open_list[0]; // The currently processed point.
+		Point *p = open_list.pop(); // The currently processed point, removed from the open list.
 
 		if (p == end_point) {
 			found_route = true;
 			break;
 		}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
-		open_list.remove_at(open_list.size() - 1);
 		p->closed_pass = pass; // Mark the point as closed.
 
 		for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
@@ -359,7 +355,6 @@ bool AStar3D::_solve(Point *begin_point, Point *end_point) {
 
 			if (e->open_pass != pass) { // The point wasn't inside the open list.
 				e->open_pass = pass;
-				open_list.push_back(e);
 				new_point = true;
 			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
 				continue;
@@ -369,14 +364,17 @@ bool AStar3D::_solve(Point *begin_point, Point *end_point) {
 			e->g_score = tentative_g_score;
 			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
-			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
+			if (new_point) {
+				open_list.push(e);
+			} else { // The position of the point in the open list is already known.
+				open_list.shift(e->open_index);
 			}
 		}
 	}
 
+	// The points left in the open list could be removed before the next query.
+	open_list.clear();
+
 	return found_route;
 }
 
@@ -794,23 +792,19 @@ bool AStar2D::_solve(AStar3D::Point *begin_point, AStar3D::Point *end_point) {
 
 	bool found_route = false;
 
-	LocalVector<AStar3D::Point *> open_list;
-	SortArray<AStar3D::Point *, AStar3D::SortPoints> sorter;
-
 	begin_point->g_score = 0;
 	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
+	begin_point->open_pass = astar.pass;
+	astar.open_list.push(begin_point);
 
-	while (!open_list.is_empty()) {
-		AStar3D::Point *p = open_list[0]; // The currently processed point.
+	while (!astar.open_list.is_empty()) {
+		AStar3D::Point *p = astar.open_list.pop(); // The currently processed point, removed from the open list.
 
 		if (p == end_point) {
 			found_route = true;
 			break;
 		}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
-		open_list.remove_at(open_list.size() - 1);
 		p->closed_pass = astar.pass; // Mark the point as closed.
 
 		for (OAHashMap<int64_t, AStar3D::Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
@@ -826,7 +820,6 @@ bool AStar2D::_solve(AStar3D::Point *begin_point, AStar3D::Point *end_point) {
 
 			if (e->open_pass != astar.pass) { // The point wasn't inside the open list.
 				e->open_pass = astar.pass;
-				open_list.push_back(e);
 				new_point = true;
 			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
 				continue;
@@ -836,14 +829,17 @@ bool AStar2D::_solve(AStar3D::Point *begin_point, AStar3D::Point *end_point) {
 			e->g_score = tentative_g_score;
 			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
-			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
+			if (new_point) {
+				astar.open_list.push(e);
+			} else { // The position of the point in the open list is already known.
+				astar.open_list.shift(e->open_index);
 			}
 		}
 	}
 
+	// The points left in the open list could be removed before the next query.
+	astar.open_list.clear();
+
 	return found_route;
 }
 
@@ -34,6 +34,7 @@
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
+#include "core/templates/indexed_heap.h"
 #include "core/templates/oa_hash_map.h"
 
 /**
@@ -61,20 +62,27 @@ class AStar3D : public RefCounted {
 		real_t f_score = 0;
 		uint64_t open_pass = 0;
 		uint64_t closed_pass = 0;
+		uint32_t open_index = UINT32_MAX;
 	};
 
 	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
+		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is better than Point B.
+			if (A->f_score < B->f_score) {
 				return true;
-			} else if (A->f_score < B->f_score) {
+			} else if (A->f_score > B->f_score) {
 				return false;
 			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+				return A->g_score > B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
 			}
 		}
 	};
 
+	struct OpenListIndexer {
+		_FORCE_INLINE_ void operator()(Point *p_point, uint32_t p_index) const {
+			p_point->open_index = p_index;
+		}
+	};
+
 	struct Segment {
 		Pair<int64_t, int64_t> key;
 
@@ -111,6 +119,9 @@ class AStar3D : public RefCounted {
 	OAHashMap<int64_t, Point *> points;
 	HashSet<Segment, Segment> segments;
 
+	// Kept between queries to reuse its memory.
+	IndexedHeap<Point *, SortPoints, OpenListIndexer> open_list;
+
 	bool _solve(Point *begin_point, Point *end_point);
 
 protected:
@@ -30,6 +30,7 @@
 
 #include "a_star_grid_2d.h"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/variant/typed_array.h"
 
 static real_t heuristic_euclidian(const Vector2i &p_from, const Vector2i &p_to) {
@@ -95,12 +96,11 @@ Size2 AStarGrid2D::get_cell_size() const {
 
 void AStarGrid2D::update() {
 	points.clear();
+	points.reserve(size.x * size.y);
 	for (int64_t y = 0; y < size.y; y++) {
-		LocalVector<Point> line;
 		for (int64_t x = 0; x < size.x; x++) {
-			line.push_back(Point(Vector2i(x, y), offset + Vector2(x, y) * cell_size));
+			points.push_back(Point(Vector2i(x, y), offset + Vector2(x, y) * cell_size));
 		}
-		points.push_back(line);
 	}
 	dirty = false;
 }
@@ -155,33 +155,33 @@ AStarGrid2D::Heuristic AStarGrid2D::get_default_estimate_heuristic() const {
 void AStarGrid2D::set_point_solid(const Vector2i &p_id, bool p_solid) {
 	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set if point is disabled. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.width, p_id.y, size.height));
-	points[p_id.y][p_id.x].solid = p_solid;
+	points[p_id.y * size.width + p_id.x].solid = p_solid;
 }
 
 bool AStarGrid2D::is_point_solid(const Vector2i &p_id) const {
 	ERR_FAIL_COND_V_MSG(dirty, false, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), false, vformat("Can't get if point is disabled. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.width, p_id.y, size.height));
-	return points[p_id.y][p_id.x].solid;
+	return points[p_id.y * size.width + p_id.x].solid;
 }
 
 void AStarGrid2D::set_point_weight_scale(const Vector2i &p_id, real_t p_weight_scale) {
 	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set point's weight scale. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.width, p_id.y, size.height));
 	ERR_FAIL_COND_MSG(p_weight_scale < 0.0, vformat("Can't set point's weight scale less than 0.0: %f.", p_weight_scale));
-	points[p_id.y][p_id.x].weight_scale = p_weight_scale;
+	points[p_id.y * size.width + p_id.x].weight_scale = p_weight_scale;
 }
 
 real_t AStarGrid2D::get_point_weight_scale(const Vector2i &p_id) const {
 	ERR_FAIL_COND_V_MSG(dirty, 0, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), 0, vformat("Can't get point's weight scale. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.width, p_id.y, size.height));
-	return points[p_id.y][p_id.x].weight_scale;
+	return points[p_id.y * size.width + p_id.x].weight_scale;
 }
 
-AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
+AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to, const Point *p_end) {
 	if (!p_to || p_to->solid) {
 		return nullptr;
 	}
-	if (p_to == end) {
+	if (p_to == p_end) {
 		return p_to;
 	}
 
@@ -199,10 +199,10 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 			if ((_is_walkable(to_x - dx, to_y + dy) && !_is_walkable(to_x - dx, to_y)) || (_is_walkable(to_x + dx, to_y - dy) && !_is_walkable(to_x, to_y - dy))) {
 				return p_to;
 			}
-			if (_jump(p_to, _get_point(to_x + dx, to_y)) != nullptr) {
+			if (_jump(p_to, _get_point(to_x + dx, to_y), p_end) != nullptr) {
 				return p_to;
 			}
-			if (_jump(p_to, _get_point(to_x, to_y + dy)) != nullptr) {
+			if (_jump(p_to, _get_point(to_x, to_y + dy), p_end) != nullptr) {
 				return p_to;
 			}
 		} else {
@@ -217,17 +217,17 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 			}
 		}
 		if (_is_walkable(to_x + dx, to_y + dy) && (diagonal_mode == DIAGONAL_MODE_ALWAYS || (_is_walkable(to_x + dx, to_y) || _is_walkable(to_x, to_y + dy)))) {
-			return _jump(p_to, _get_point(to_x + dx, to_y + dy));
+			return _jump(p_to, _get_point(to_x + dx, to_y + dy), p_end);
 		}
 	} else if (diagonal_mode == DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES) {
 		if (dx != 0 && dy != 0) {
 			if ((_is_walkable(to_x + dx, to_y + dy) && !_is_walkable(to_x, to_y + dy)) || !_is_walkable(to_x + dx, to_y)) {
 				return p_to;
 			}
-			if (_jump(p_to, _get_point(to_x + dx, to_y)) != nullptr) {
+			if (_jump(p_to, _get_point(to_x + dx, to_y), p_end) != nullptr) {
 				return p_to;
 			}
-			if (_jump(p_to, _get_point(to_x, to_y + dy)) != nullptr) {
+			if (_jump(p_to, _get_point(to_x, to_y + dy), p_end) != nullptr) {
 				return p_to;
 			}
 		} else {
@@ -242,7 +242,7 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 			}
 		}
 		if (_is_walkable(to_x + dx, to_y + dy) && _is_walkable(to_x + dx, to_y) && _is_walkable(to_x, to_y + dy)) {
-			return _jump(p_to, _get_point(to_x + dx, to_y + dy));
+			return _jump(p_to, _get_point(to_x + dx, to_y + dy), p_end);
 		}
 	} else { // DIAGONAL_MODE_NEVER
 		if (dx != 0) {
@@ -253,14 +253,14 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 			if ((_is_walkable(to_x - 1, to_y) && !_is_walkable(to_x - 1, to_y - dy)) || (_is_walkable(to_x + 1, to_y) && !_is_walkable(to_x + 1, to_y - dy))) {
 				return p_to;
 			}
-			if (_jump(p_to, _get_point(to_x + 1, to_y)) != nullptr) {
+			if (_jump(p_to, _get_point(to_x + 1, to_y), p_end) != nullptr) {
 				return p_to;
 			}
-			if (_jump(p_to, _get_point(to_x - 1, to_y)) != nullptr) {
+			if (_jump(p_to, _get_point(to_x - 1, to_y), p_end) != nullptr) {
 				return p_to;
 			}
 		}
-		return _jump(p_to, _get_point(to_x + dx, to_y + dy));
+		return _jump(p_to, _get_point(to_x + dx, to_y + dy), p_end);
 	}
 	return nullptr;
 }
@@ -369,36 +369,72 @@ void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
 	}
 }
 
-bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point) {
-	pass++;
+AStarGrid2D::SolveContext &AStarGrid2D::_get_solve_context(uint32_t p_index) {
+	while (solve_contexts.size() <= p_index) {
+		solve_contexts.push_back(memnew(SolveContext));
+	}
+	return *solve_contexts[p_index];
+}
 
+void AStarGrid2D::_free_solve_contexts(uint32_t p_from) {
+	for (uint32_t i = p_from; i < solve_contexts.size(); i++) {
+		memdelete(solve_contexts[i]);
+	}
+	if (p_from < solve_contexts.size()) {
+		solve_contexts.resize(p_from);
+	}
+}
+
+bool AStarGrid2D::_solve(SolveContext &r_context, Point *p_begin_point, Point *p_end_point) {
 	if (p_end_point->solid) {
 		return false;
 	}
 
-	bool found_route = false;
+	LocalVector<PointState> &states = r_context.states;
+	if (states.size() != points.size()) {
+		states.clear();
+		states.resize(points.size());
+		r_context.pass = 0;
+	}
+
+	r_context.pass++;
+	if (r_context.pass == 0) { // Wrapped around, old passes could be mistaken for the current one.
+		for (PointState &point_state : states) {
+			point_state.open_pass = 0;
+			point_state.closed_pass = 0;
+		}
+		r_context.pass = 1;
+	}
+	const uint32_t pass = r_context.pass;
 
-	LocalVector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
+	const uint32_t end_index = _get_point_index(p_end_point);
+	IndexedHeap<uint32_t, SortPoints, OpenListIndexer> &open_list = r_context.open_list;
+	LocalVector<Point *> &nbors = r_context.nbors;
 
-	p_begin_point->g_score = 0;
-	p_begin_point->f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
-	open_list.push_back(p_begin_point);
-	end = p_end_point;
+	bool found_route = false;
+
+	{
+		const uint32_t begin_index = _get_point_index(p_begin_point);
+		PointState &begin_state = states[begin_index];
+		begin_state.g_score = 0;
+		begin_state.f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
+		begin_state.open_pass = pass;
+		open_list.push(begin_index);
+	}
 
 	while (!open_list.is_empty()) {
-		Point *p = open_list[0]; // The currently processed point.
+		const uint32_t index = open_list.pop(); // The currently processed point, removed from the open list.
 
-		if (p == p_end_point) {
+		if (index == end_index) {
 			found_route = true;
 			break;
 		}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
-		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = pass; // Mark the point as closed.
+		Point *p = &points[index];
+		PointState &state = states[index];
+		state.closed_pass = pass; // Mark the point as closed.
 
-		LocalVector<Point *> nbors;
+		nbors.clear();
 		_get_nbors(p, nbors);
 
 		for (Point *e : nbors) {
@@ -406,43 +442,67 @@ bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point) {
 
 			if (jumping_enabled) {
 				// TODO: Make it works with weight_scale.
-				e = _jump(p, e);
-				if (!e || e->closed_pass == pass) {
+				e = _jump(p, e, p_end_point);
+				if (!e) {
 					continue;
 				}
 			} else {
-				if (e->solid || e->closed_pass == pass) {
+				if (e->solid) {
 					continue;
 				}
 				weight_scale = e->weight_scale;
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * weight_scale;
+			const uint32_t e_index = _get_point_index(e);
+			PointState &e_state = states[e_index];
+			if (e_state.closed_pass == pass) {
+				continue;
+			}
+
+			real_t tentative_g_score = state.g_score + _compute_cost(p->id, e->id) * weight_scale;
 			bool new_point = false;
 
-			if (e->open_pass != pass) { // The point wasn't inside the open list.
-				e->open_pass = pass;
-				open_list.push_back(e);
+			if (e_state.open_pass != pass) { // The point wasn't inside the open list.
+				e_state.open_pass = pass;
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= e_state.g_score) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, p_end_point->id);
+			e_state.prev_point = index;
+			e_state.g_score = tentative_g_score;
+			e_state.f_score = e_state.g_score + _estimate_cost(e->id, p_end_point->id);
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
-			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
+			if (new_point) {
+				open_list.push(e_index);
+			} else { // The position of the point in the open list is already known.
+				open_list.shift(e_state.open_index);
 			}
 		}
 	}
 
+	// The states can be resized before the next query, don't leave stale indices behind.
+	open_list.clear();
+
 	return found_route;
 }
 
+void AStarGrid2D::_get_path(const SolveContext &p_context, uint32_t p_begin, uint32_t p_end, LocalVector<uint32_t> &r_path) const {
+	uint32_t pc = 1;
+	for (uint32_t p = p_end; p != p_begin; p = p_context.states[p].prev_point) {
+		pc++;
+	}
+
+	r_path.resize(pc);
+
+	uint32_t p = p_end;
+	for (int64_t idx = pc - 1; idx > 0; idx--) {
+		r_path[idx] = p;
+		p = p_context.states[p].prev_point;
+	}
+	r_path[0] = p_begin;
+}
+
 real_t AStarGrid2D::_estimate_cost(const Vector2i &p_from_id, const Vector2i &p_to_id) {
 	real_t scost;
 	if (GDVIRTUAL_CALL(_estimate_cost, p_from_id, p_to_id, scost)) {
@@ -461,13 +521,14 @@ real_t AStarGrid2D::_compute_cost(const Vector2i &p_from_id, const Vector2i &p_t
 
 void AStarGrid2D::clear() {
 	points.clear();
+	_free_solve_contexts();
 	size = Vector2i();
 }
 
 Vector2 AStarGrid2D::get_point_position(const Vector2i &p_id) const {
 	ERR_FAIL_COND_V_MSG(dirty, Vector2(), "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), Vector2(), vformat("Can't get point's position. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.width, p_id.y, size.height));
-	return points[p_id.y][p_id.x].pos;
+	return points[p_id.y * size.width + p_id.x].pos;
 }
 
 Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from_id, const Vector2i &p_to_id) {
@@ -484,35 +545,22 @@ Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from_id, const Vec
 		return ret;
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
+	SolveContext &context = _get_solve_context(0);
+	bool found_route = _solve(context, a, b);
 	if (!found_route) {
 		return Vector<Vector2>();
 	}
 
-	Point *p = end_point;
-	int64_t pc = 1;
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
+	_get_path(context, _get_point_index(a), _get_point_index(b), context.path);
 
 	Vector<Vector2> path;
-	path.resize(pc);
+	path.resize(context.path.size());
 
 	{
 		Vector2 *w = path.ptrw();
-
-		p = end_point;
-		int64_t idx = pc - 1;
-		while (p != begin_point) {
-			w[idx--] = p->pos;
-			p = p->prev_point;
+		for (uint32_t i = 0; i < context.path.size(); i++) {
+			w[i] = points[context.path[i]].pos;
 		}
-
-		w[0] = p->pos;
 	}
 
 	return path;
@@ -532,36 +580,122 @@ TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from_id, const V
 		return ret;
 	}
 
-	Point *begin_point = a;
-	Point *end_point = b;
-
-	bool found_route = _solve(begin_point, end_point);
+	SolveContext &context = _get_solve_context(0);
+	bool found_route = _solve(context, a, b);
 	if (!found_route) {
 		return TypedArray<Vector2i>();
 	}
 
-	Point *p = end_point;
-	int64_t pc = 1;
-	while (p != begin_point) {
-		pc++;
-		p = p->prev_point;
-	}
+	_get_path(context, _get_point_index(a), _get_point_index(b), context.path);
 
 	TypedArray<Vector2i> path;
-	path.resize(pc);
+	path.resize(context.path.size());
+	for (uint32_t i = 0; i < context.path.size(); i++) {
+		path[i] = points[context.path[i]].id;
+	}
 
-	{
-		p = end_point;
-		int64_t idx = pc - 1;
-		while (p != begin_point) {
-			path[idx--] = p->id;
-			p = p->prev_point;
+	return path;
+}
+
+bool AStarGrid2D::_solve_batch(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids, BatchData &r_batch) {
+	ERR_FAIL_COND_V_MSG(dirty, false, "Grid is not initialized. Call the update method.");
+	ERR_FAIL_COND_V_MSG(p_from_ids.size() != p_to_ids.size(), false, vformat("Can't get paths. The number of start points (%d) differs from the number of end points (%d).", p_from_ids.size(), p_to_ids.size()));
+
+	r_batch.queries.resize(p_from_ids.size());
+	for (uint32_t i = 0; i < r_batch.queries.size(); i++) {
+		const Vector2i from_id = p_from_ids[i];
+		const Vector2i to_id = p_to_ids[i];
+		ERR_FAIL_COND_V_MSG(!is_in_boundsv(from_id), false, vformat("Can't get id path. Point out of bounds (%s/%s, %s/%s)", from_id.x, size.width, from_id.y, size.height));
+		ERR_FAIL_COND_V_MSG(!is_in_boundsv(to_id), false, vformat("Can't get id path. Point out of bounds (%s/%s, %s/%s)", to_id.x, size.width, to_id.y, size.height));
+		r_batch.queries[i].begin = from_id.y * size.width + from_id.x;
+		r_batch.queries[i].end = to_id.y * size.width + to_id.x;
+	}
+
+	// Costs computed by scripts can't be called from several threads at once.
+	uint32_t task_count = 1;
+	if (!get_script_instance() && !GDVIRTUAL_IS_OVERRIDDEN(_estimate_cost) && !GDVIRTUAL_IS_OVERRIDDEN(_compute_cost)) {
+		task_count = MIN(r_batch.queries.size(), (uint32_t)WorkerThreadPool::get_singleton()->get_thread_count());
+	}
+
+	// Every task uses its own context, allocate them before going wide.
+	for (uint32_t i = 0; i < task_count; i++) {
+		_get_solve_context(i);
+	}
+
+	if (task_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &AStarGrid2D::_solve_batch_task, &r_batch, task_count, -1, true, SNAME("AStarGrid2DSolveBatch"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (!r_batch.queries.is_empty()) {
+		_solve_batch_task(0, &r_batch);
+	}
+
+	// Each context holds a state per point of the grid, only keep the one of single queries.
+	_free_solve_contexts(1);
+
+	return true;
+}
+
+void AStarGrid2D::_solve_batch_task(uint32_t p_task, BatchData *p_batch) {
+	SolveContext &context = *solve_contexts[p_task];
+
+	// Queries vary a lot in cost, so tasks pick the next one when they are done instead of splitting them up front.
+	for (uint32_t i = p_batch->next_query.postincrement(); i < p_batch->queries.size(); i = p_batch->next_query.postincrement()) {
+		BatchQuery &query = p_batch->queries[i];
+		if (query.begin == query.end) {
+			query.path.push_back(query.begin);
+		} else if (_solve(context, &points[query.begin], &points[query.end])) {
+			_get_path(context, query.begin, query.end, query.path);
 		}
+	}
+}
 
-		path[0] = p->id;
+Array AStarGrid2D::get_point_paths(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids) {
+	BatchData batch;
+	if (!_solve_batch(p_from_ids, p_to_ids, batch)) {
+		return Array();
 	}
 
-	return path;
+	Array paths;
+	paths.resize(batch.queries.size());
+	for (uint32_t i = 0; i < batch.queries.size(); i++) {
+		const LocalVector<uint32_t> &indices = batch.queries[i].path;
+
+		Vector<Vector2> path;
+		path.resize(indices.size());
+		Vector2 *w = path.ptrw();
+		for (uint32_t j = 0; j < indices.size(); j++) {
+			w[j] = points[indices[j]].pos;
+		}
+		paths[i] = path;
+	}
+
+	return paths;
+}
+
+Array AStarGrid2D::get_id_paths(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids) {
+	BatchData batch;
+	if (!_solve_batch(p_from_ids, p_to_ids, batch)) {
+		return Array();
+	}
+
+	Array paths;
+	paths.resize(batch.queries.size());
+	for (uint32_t i = 0; i < batch.queries.size(); i++) {
+		const LocalVector<uint32_t> &indices = batch.queries[i].path;
+
+		TypedArray<Vector2i> path;
+		path.resize(indices.size());
+		for (uint32_t j = 0; j < indices.size(); j++) {
+			path[j] = points[indices[j]].id;
+		}
+		paths[i] = path;
+	}
+
+	return paths;
+}
+
+AStarGrid2D::~AStarGrid2D() {
+	_free_solve_contexts();
 }
 
 void AStarGrid2D::_bind_methods() {
@@ -592,6 +726,8 @@ void AStarGrid2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_point_position", "id"), &AStarGrid2D::get_point_position);
 	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStarGrid2D::get_point_path);
 	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStarGrid2D::get_id_path);
+	ClassDB::bind_method(D_METHOD("get_point_paths", "from_ids", "to_ids"), &AStarGrid2D::get_point_paths);
+	ClassDB::bind_method(D_METHOD("get_id_paths", "from_ids", "to_ids"), &AStarGrid2D::get_id_paths);
 
 	GDVIRTUAL_BIND(_estimate_cost, "from_id", "to_id")
 	GDVIRTUAL_BIND(_compute_cost, "from_id", "to_id")
@@ -34,8 +34,10 @@
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
 #include "core/object/script_language.h"
+#include "core/templates/indexed_heap.h"
 #include "core/templates/list.h"
 #include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
 
 class AStarGrid2D : public RefCounted {
 	GDCLASS(AStarGrid2D, RefCounted);
@@ -75,58 +77,112 @@ private:
 		Vector2 pos;
 		real_t weight_scale = 1.0;
 
-		// Used for pathfinding.
-		Point *prev_point = nullptr;
-		real_t g_score = 0;
-		real_t f_score = 0;
-		uint64_t open_pass = 0;
-		uint64_t closed_pass = 0;
-
 		Point() {}
 
 		Point(const Vector2i &p_id, const Vector2 &p_pos) :
 				id(p_id), pos(p_pos) {}
 	};
 
+	// Used for pathfinding, kept out of the points so that several queries can run at once.
+	struct PointState {
+		uint32_t prev_point = 0;
+		real_t g_score = 0;
+		real_t f_score = 0;
+		uint32_t open_pass = 0;
+		uint32_t closed_pass = 0;
+		uint32_t open_index = UINT32_MAX;
+	};
+
 	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
+		const LocalVector<PointState> *states = nullptr;
+
+		_FORCE_INLINE_ bool operator()(uint32_t A, uint32_t B) const { // Returns true when the point A is better than the point B.
+			const PointState &state_a = (*states)[A];
+			const PointState &state_b = (*states)[B];
+			if (state_a.f_score < state_b.f_score) {
 				return true;
-			} else if (A->f_score < B->f_score) {
+			} else if (state_a.f_score > state_b.f_score) {
 				return false;
 			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+				return state_a.g_score > state_b.g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
 			}
 		}
+
+		SortPoints() {}
+		SortPoints(const LocalVector<PointState> *p_states) :
+				states(p_states) {}
 	};
 
-	LocalVector<LocalVector<Point>> points;
-	Point *end = nullptr;
+	struct OpenListIndexer {
+		LocalVector<PointState> *states = nullptr;
+
+		_FORCE_INLINE_ void operator()(uint32_t p_point, uint32_t p_heap_index) const {
+			(*states)[p_point].open_index = p_heap_index;
+		}
+
+		OpenListIndexer() {}
+		OpenListIndexer(LocalVector<PointState> *p_states) :
+				states(p_states) {}
+	};
 
-	uint64_t pass = 1;
+	// Search state of one query at a time, reused to avoid allocating on every query.
+	struct SolveContext {
+		LocalVector<PointState> states;
+		IndexedHeap<uint32_t, SortPoints, OpenListIndexer> open_list;
+		LocalVector<Point *> nbors;
+		LocalVector<uint32_t> path;
+		uint32_t pass = 0;
+
+		SolveContext() :
+				open_list(SortPoints(&states), OpenListIndexer(&states)) {}
+	};
+
+	struct BatchQuery {
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		LocalVector<uint32_t> path; // Indices of the points, empty if there is no route.
+	};
+
+	struct BatchData {
+		LocalVector<BatchQuery> queries;
+		SafeNumeric<uint32_t> next_query;
+	};
+
+	LocalVector<Point> points; // Indexed by `y * size.width + x`.
+	LocalVector<SolveContext *> solve_contexts; // The first one is used by single queries, the others only live during a batch.
 
 private: // Internal routines.
 	_FORCE_INLINE_ bool _is_walkable(int64_t p_x, int64_t p_y) const {
 		if (p_x >= 0 && p_y >= 0 && p_x < size.width && p_y < size.height) {
-			return !points[p_y][p_x].solid;
+			return !points[p_y * size.width + p_x].solid;
 		}
 		return false;
 	}
 
 	_FORCE_INLINE_ Point *_get_point(int64_t p_x, int64_t p_y) {
 		if (p_x >= 0 && p_y >= 0 && p_x < size.width && p_y < size.height) {
-			return &points[p_y][p_x];
+			return &points[p_y * size.width + p_x];
 		}
 		return nullptr;
 	}
 
 	_FORCE_INLINE_ Point *_get_point_unchecked(int64_t p_x, int64_t p_y) {
-		return &points[p_y][p_x];
+		return &points[p_y * size.width + p_x];
+	}
+
+	_FORCE_INLINE_ uint32_t _get_point_index(const Point *p_point) const {
+		return p_point - points.ptr();
 	}
 
+	SolveContext &_get_solve_context(uint32_t p_index);
+	void _free_solve_contexts(uint32_t p_from = 0);
+
 	void _get_nbors(Point *p_point, LocalVector<Point *> &r_nbors);
-	Point *_jump(Point *p_from, Point *p_to);
-	bool _solve(Point *p_begin_point, Point *p_end_point);
+	Point *_jump(Point *p_from, Point *p_to, const Point *p_end);
+	bool _solve(SolveContext &r_context, Point *p_begin_point, Point *p_end_point);
+	void _get_path(const SolveContext &p_context, uint32_t p_begin, uint32_t p_end, LocalVector<uint32_t> &r_path) const;
+	bool _solve_batch(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids, BatchData &r_batch);
+	void _solve_batch_task(uint32_t p_task, BatchData *p_batch);
 
 protected:
 	static void _bind_methods();
@@ -179,6 +235,11 @@ public:
 	Vector2 get_point_position(const Vector2i &p_id) const;
 	Vector<Vector2> get_point_path(const Vector2i &p_from, const Vector2i &p_to);
 	TypedArray<Vector2i> get_id_path(const Vector2i &p_from, const Vector2i &p_to);
+
+	Array get_point_paths(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids);
+	Array get_id_paths(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids);
+
+	~AStarGrid2D();
 };
 
 VARIANT_ENUM_CAST(AStarGrid2D::DiagonalMode);
@@ -52,6 +52,7 @@
 // and pairable_mask is either 0 if static, or set to all if non static
 
 #include "bvh_tree.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/mutex.h"
 
 #define BVHTREE_CLASS BVH_Tree<T, NUM_TREES, 2, MAX_ITEMS, USER_PAIR_TEST_FUNCTION, USER_CULL_TEST_FUNCTION, USE_PAIRS, BOUNDS, POINT>
@@ -88,6 +89,14 @@ public:
 		tree.params_set_pairing_expansion(p_value);
 	}
 
+	// when at least this many items have changed since the last collision check,
+	// the tree culls used to find new pairs are spread over the worker threads.
+	// 0 (the default) always checks collisions on the calling thread.
+	void params_set_parallel_pairing_threshold(uint32_t p_threshold) {
+		BVH_LOCKED_FUNCTION
+		_parallel_pairing_threshold = p_threshold;
+	}
+
 	void set_pair_callback(PairCallback p_callback, void *p_userdata) {
 		BVH_LOCKED_FUNCTION
 		pair_callback = p_callback;
@@ -398,6 +407,44 @@ public:
 		return params.result_count_overall;
 	}
 
+	// versions of the cull tests that don't lock, and use the r_hits buffer instead of the shared one,
+	// so they can run on several threads at once. Only valid as long as the tree isn't modified meanwhile.
+	int cull_aabb_concurrent(const BOUNDS &p_aabb, LocalVector<uint32_t, uint32_t, true> &r_hits, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
+		typename BVHTREE_CLASS::CullParams params;
+
+		params.result_count_overall = 0;
+		params.result_max = p_result_max;
+		params.result_array = p_result_array;
+		params.subindex_array = p_subindex_array;
+		params.tree_collision_mask = p_tree_collision_mask;
+		params.abb.from(p_aabb);
+		params.tester = p_tester;
+		params.hits = &r_hits;
+
+		tree.cull_aabb(params);
+
+		return params.result_count_overall;
+	}
+
+	int cull_segment_concurrent(const POINT &p_from, const POINT &p_to, LocalVector<uint32_t, uint32_t, true> &r_hits, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF, int *p_subindex_array = nullptr) {
+		typename BVHTREE_CLASS::CullParams params;
+
+		params.result_count_overall = 0;
+		params.result_max = p_result_max;
+		params.result_array = p_result_array;
+		params.subindex_array = p_subindex_array;
+		params.tester = p_tester;
+		params.tree_collision_mask = p_tree_collision_mask;
+		params.hits = &r_hits;
+
+		params.segment.from = p_from;
+		params.segment.to = p_to;
+
+		tree.cull_segment(params);
+
+		return params.result_count_overall;
+	}
+
 	int cull_convex(const Vector<Plane> &p_convex, T **p_result_array, int p_result_max, const T *p_tester, uint32_t p_tree_collision_mask = 0xFFFFFFFF) {
 		BVH_LOCKED_FUNCTION
 		if (!p_convex.size()) {
@@ -435,6 +482,11 @@ private:
 			return;
 		}
 
+		if (_parallel_pairing_threshold && changed_items.size() >= _parallel_pairing_threshold && WorkerThreadPool::get_singleton() && WorkerThreadPool::get_singleton()->get_thread_count() > 1) {
+			_check_for_collisions_parallel(p_full_check);
+			return;
+		}
+
 		BOUNDS bb;
 
 		typename BVHTREE_CLASS::CullParams params;
@@ -480,6 +532,84 @@ private:
 		_reset();
 	}
 
+	// Same as _check_for_collisions, but the culls for finding new pairs (by far the most
+	// expensive part) run on the worker threads. The leavers are processed first, then the
+	// hits of every batch are merged in the order of changed_items, so the pair callbacks are
+	// always sent from this thread and in the same order for the same input.
+	void _check_for_collisions_parallel(bool p_full_check) {
+		for (const BVHHandle &h : changed_items) {
+			BVHABB_CLASS abb;
+			abb.from(tree._pairs[h.id()].expanded_aabb);
+			_find_leavers(h, abb, p_full_check);
+		}
+
+		uint32_t batch_count = MIN(changed_items.size(), (uint32_t)WorkerThreadPool::get_singleton()->get_thread_count() * 4);
+		uint32_t batch_size = (changed_items.size() + batch_count - 1) / batch_count;
+		batch_count = (changed_items.size() + batch_size - 1) / batch_size;
+
+		if (_pairing_batches.size() < batch_count) {
+			_pairing_batches.resize(batch_count);
+		}
+		for (uint32_t n = 0; n < batch_count; n++) {
+			PairingBatch &batch = _pairing_batches[n];
+			batch.first_item = n * batch_size;
+			batch.item_count = MIN(batch_size, changed_items.size() - batch.first_item);
+		}
+
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &BVH_Manager::_find_enterers_batch, nullptr, batch_count, -1, true, "BVH pairing");
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+		for (uint32_t n = 0; n < batch_count; n++) {
+			const PairingBatch &batch = _pairing_batches[n];
+			uint32_t hit = 0;
+
+			for (uint32_t i = 0; i < batch.item_count; i++) {
+				const BVHHandle &h = changed_items[batch.first_item + i];
+				uint32_t hits_end = hit + batch.item_hit_counts[i];
+
+				for (; hit < hits_end; hit++) {
+					uint32_t ref_id = batch.hits[hit];
+
+					// don't collide against ourself
+					if (ref_id == h.id()) {
+						continue;
+					}
+
+					BVHHandle h_collidee;
+					h_collidee.set_id(ref_id);
+
+					// find NEW enterers, and send callbacks for them only
+					_collide(h, h_collidee);
+				}
+			}
+		}
+		_reset();
+	}
+
+	// Called from the worker threads. Only reads the tree, and writes to the batch.
+	void _find_enterers_batch(uint32_t p_batch_index, void *p_userdata) {
+		PairingBatch &batch = _pairing_batches[p_batch_index];
+		batch.hits.clear();
+		batch.item_hit_counts.resize(batch.item_count);
+
+		typename BVHTREE_CLASS::CullParams params;
+		params.result_count_overall = 0;
+		params.result_max = INT_MAX;
+		params.result_array = nullptr;
+		params.subindex_array = nullptr;
+
+		for (uint32_t i = 0; i < batch.item_count; i++) {
+			const BVHHandle &h = changed_items[batch.first_item + i];
+
+			tree.item_fill_cullparams(h, params);
+			params.abb.from(tree._pairs[h.id()].expanded_aabb);
+
+			uint32_t hits_before = batch.hits.size();
+			tree.cull_aabb_hits(params, batch.hits);
+			batch.item_hit_counts[i] = batch.hits.size() - hits_before;
+		}
+	}
+
 public:
 	void item_get_AABB(BVHHandle p_handle, BOUNDS &r_aabb) {
 		DEV_ASSERT(!p_handle.is_invalid());
@@ -773,6 +903,17 @@ private:
 	LocalVector<BVHHandle, uint32_t, true> changed_items;
 	uint32_t _tick = 1; // Start from 1 so items with 0 indicate never updated.
 
+	// Changed items are split in contiguous batches for parallel pairing,
+	// each batch keeping the hits of its items one after the other.
+	struct PairingBatch {
+		uint32_t first_item = 0;
+		uint32_t item_count = 0;
+		LocalVector<uint32_t, uint32_t, true> hits;
+		LocalVector<uint32_t, uint32_t, true> item_hit_counts;
+	};
+	LocalVector<PairingBatch> _pairing_batches;
+	uint32_t _parallel_pairing_threshold = 0;
+
 	class BVHLockedFunction {
 	public:
 		BVHLockedFunction(Mutex *p_mutex, bool p_thread_safe) {
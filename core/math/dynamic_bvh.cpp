@@ -386,6 +386,41 @@ bool DynamicBVH::update(const ID &p_id, const AABB &p_box) {
 	return true;
 }
 
+void DynamicBVH::set_volume(const ID &p_id, const AABB &p_box) {
+	ERR_FAIL_COND(!p_id.is_valid());
+	Node *leaf = p_id.node;
+	leaf->volume.min = p_box.position;
+	leaf->volume.max = p_box.position + p_box.size;
+}
+
+void DynamicBVH::_refit(Node *p_node) {
+	// Internal nodes are listed parents first, so merging them in reverse
+	// order updates the children of every node before the node itself.
+	LocalVector<Node *> internal_nodes;
+	LocalVector<Node *> stack;
+	stack.push_back(p_node);
+	while (!stack.is_empty()) {
+		Node *node = stack[stack.size() - 1];
+		stack.resize(stack.size() - 1);
+		if (node->is_internal()) {
+			internal_nodes.push_back(node);
+			stack.push_back(node->children[0]);
+			stack.push_back(node->children[1]);
+		}
+	}
+
+	for (int i = int(internal_nodes.size()) - 1; i >= 0; i--) {
+		Node *node = internal_nodes[i];
+		node->volume = node->children[0]->volume.merge(node->children[1]->volume);
+	}
+}
+
+void DynamicBVH::refit() {
+	if (bvh_root) {
+		_refit(bvh_root);
+	}
+}
+
 void DynamicBVH::remove(const ID &p_id) {
 	ERR_FAIL_COND(!p_id.is_valid());
 	Node *leaf = p_id.node;
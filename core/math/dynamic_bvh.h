@@ -249,6 +249,7 @@ private:
 	_FORCE_INLINE_ void _update(Node *leaf, int lookahead = -1);
 
 	void _extract_leaves(Node *p_node, List<ID> *r_elements);
+	void _refit(Node *p_node);
 
 	_FORCE_INLINE_ bool _ray_aabb(const Vector3 &rayFrom, const Vector3 &rayInvDirection, const unsigned int raySign[3], const Vector3 bounds[2], real_t &tmin, real_t lambda_min, real_t lambda_max) {
 		real_t tmax, tymin, tymax, tzmin, tzmax;
@@ -293,6 +294,11 @@ public:
 	void optimize_incremental(int passes);
 	ID insert(const AABB &p_box, void *p_userdata);
 	bool update(const ID &p_id, const AABB &p_box);
+	// Moves a leaf without restructuring the tree, call refit() once all the leaves are moved.
+	// Leaves can be moved from several threads as long as each leaf is only moved by one of them.
+	void set_volume(const ID &p_id, const AABB &p_box);
+	// Recomputes the volumes of internal nodes from their children, cheaper than updating every leaf when most of them moved.
+	void refit();
 	void remove(const ID &p_id);
 	void get_elements(List<ID> *r_elements);
 
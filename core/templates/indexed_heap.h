@@ -0,0 +1,126 @@
+/**************************************************************************/
+/*  indexed_heap.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef INDEXED_HEAP_H
+#define INDEXED_HEAP_H
+
+#include "core/templates/local_vector.h"
+
+/// Binary min-heap, the indexer is told where each element is stored,
+/// so that an element can be moved up in place when its cost decreases.
+template <class T, class LessThan, class Indexer>
+class IndexedHeap {
+	LocalVector<T> buffer;
+	LessThan less_than;
+	Indexer indexer;
+
+	void _shift_up(uint32_t p_index) {
+		T element = buffer[p_index];
+		while (p_index > 0) {
+			uint32_t parent = (p_index - 1) / 2;
+			if (!less_than(element, buffer[parent])) {
+				break;
+			}
+			buffer[p_index] = buffer[parent];
+			indexer(buffer[p_index], p_index);
+			p_index = parent;
+		}
+		buffer[p_index] = element;
+		indexer(element, p_index);
+	}
+
+	void _shift_down(uint32_t p_index) {
+		T element = buffer[p_index];
+		const uint32_t size = buffer.size();
+		while (true) {
+			uint32_t child = p_index * 2 + 1;
+			if (child >= size) {
+				break;
+			}
+			if (child + 1 < size && less_than(buffer[child + 1], buffer[child])) {
+				child++;
+			}
+			if (!less_than(buffer[child], element)) {
+				break;
+			}
+			buffer[p_index] = buffer[child];
+			indexer(buffer[p_index], p_index);
+			p_index = child;
+		}
+		buffer[p_index] = element;
+		indexer(element, p_index);
+	}
+
+public:
+	void push(const T &p_element) {
+		buffer.push_back(p_element);
+		_shift_up(buffer.size() - 1);
+	}
+
+	T pop() {
+		T top = buffer[0];
+		T last = buffer[buffer.size() - 1];
+		buffer.resize(buffer.size() - 1);
+		if (!buffer.is_empty()) {
+			buffer[0] = last;
+			_shift_down(0);
+		}
+		indexer(top, UINT32_MAX);
+		return top;
+	}
+
+	/// Restores the heap order after the cost of the element at `p_heap_index` decreased.
+	void shift(uint32_t p_heap_index) {
+		_shift_up(p_heap_index);
+	}
+
+	void clear() {
+		for (const T &element : buffer) {
+			indexer(element, UINT32_MAX);
+		}
+		buffer.clear();
+	}
+
+	uint32_t size() const {
+		return buffer.size();
+	}
+
+	bool is_empty() const {
+		return buffer.is_empty();
+	}
+
+	IndexedHeap() {}
+
+	IndexedHeap(const LessThan &p_less_than, const Indexer &p_indexer) :
+			less_than(p_less_than),
+			indexer(p_indexer) {}
+};
+
+#endif // INDEXED_HEAP_H
@@ -34,6 +34,7 @@
 #include "core/io/resource_loader.h"
 #include "core/os/keyboard.h"
 #include "core/string/string_buffer.h"
+#include "core/templates/local_vector.h"
 
 char32_t VariantParser::Stream::get_char() {
 	// is within buffer?
@@ -155,6 +156,81 @@ static double stor_fix(const String &p_str) {
 	return -1;
 }
 
+// Reads a number starting with p_char into r_num, the character after it is kept in p_stream->saved.
+// Returns whether the number is a float.
+static bool _read_number(VariantParser::Stream *p_stream, char32_t p_char, StringBuffer<> &r_num) {
+#define READING_SIGN 0
+#define READING_INT 1
+#define READING_DEC 2
+#define READING_EXP 3
+#define READING_DONE 4
+	int reading = READING_INT;
+
+	if (p_char == '-') {
+		r_num += '-';
+		p_char = p_stream->get_char();
+	}
+
+	char32_t c = p_char;
+	bool exp_sign = false;
+	bool exp_beg = false;
+	bool is_float = false;
+
+	while (true) {
+		switch (reading) {
+			case READING_INT: {
+				if (is_digit(c)) {
+					//pass
+				} else if (c == '.') {
+					reading = READING_DEC;
+					is_float = true;
+				} else if (c == 'e') {
+					reading = READING_EXP;
+					is_float = true;
+				} else {
+					reading = READING_DONE;
+				}
+
+			} break;
+			case READING_DEC: {
+				if (is_digit(c)) {
+				} else if (c == 'e') {
+					reading = READING_EXP;
+				} else {
+					reading = READING_DONE;
+				}
+
+			} break;
+			case READING_EXP: {
+				if (is_digit(c)) {
+					exp_beg = true;
+
+				} else if ((c == '-' || c == '+') && !exp_sign && !exp_beg) {
+					exp_sign = true;
+
+				} else {
+					reading = READING_DONE;
+				}
+			} break;
+		}
+
+		if (reading == READING_DONE) {
+			break;
+		}
+		r_num += c;
+		c = p_stream->get_char();
+	}
+#undef READING_SIGN
+#undef READING_INT
+#undef READING_DEC
+#undef READING_EXP
+#undef READING_DONE
+
+	p_stream->saved = c;
+
+	return is_float;
+}
+
 Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, String &r_err_str) {
 	bool string_name = false;
 
@@ -413,71 +489,8 @@ Error VariantParser::get_token(Stream *p_stream, Token &r_token, int &line, Stri
 
 				if (cchar == '-' || (cchar >= '0' && cchar <= '9')) {
 					//a number
-
 					StringBuffer<> num;
-#define READING_SIGN 0
-#define READING_INT 1
-#define READING_DEC 2
-#define READING_EXP 3
-#define READING_DONE 4
-					int reading = READING_INT;
-
-					if (cchar == '-') {
-						num += '-';
-						cchar = p_stream->get_char();
-					}
-
-					char32_t c = cchar;
-					bool exp_sign = false;
-					bool exp_beg = false;
-					bool is_float = false;
-
-					while (true) {
-						switch (reading) {
-							case READING_INT: {
-								if (is_digit(c)) {
-									//pass
-								} else if (c == '.') {
-									reading = READING_DEC;
-									is_float = true;
-								} else if (c == 'e') {
-									reading = READING_EXP;
-									is_float = true;
-								} else {
-									reading = READING_DONE;
-								}
-
-							} break;
-							case READING_DEC: {
-								if (is_digit(c)) {
-								} else if (c == 'e') {
-									reading = READING_EXP;
-								} else {
-									reading = READING_DONE;
-								}
-
-							} break;
-							case READING_EXP: {
-								if (is_digit(c)) {
-									exp_beg = true;
-
-								} else if ((c == '-' || c == '+') && !exp_sign && !exp_beg) {
-									exp_sign = true;
-
-								} else {
-									reading = READING_DONE;
-								}
-							} break;
-						}
-
-						if (reading == READING_DONE) {
-							break;
-						}
-						num += c;
-						c = p_stream->get_char();
-					}
-
-					p_stream->saved = c;
+					bool is_float = _read_number(p_stream, cchar, num);
 
 					r_token.type = TK_NUMBER;
 
@@ -545,6 +558,29 @@ Error VariantParser::_parse_enginecfg(Stream *p_stream, Vector<String> &strings,
 	}
 }
 
+// Skips blanks and returns the next character, which is left in p_stream->saved.
+static char32_t _peek_char(VariantParser::Stream *p_stream, int &line) {
+	while (true) {
+		char32_t c;
+		if (p_stream->saved) {
+			c = p_stream->saved;
+			p_stream->saved = 0;
+		} else {
+			c = p_stream->get_char();
+			if (p_stream->is_eof()) {
+				return 0;
+			}
+		}
+
+		if (c == '\n') {
+			line++;
+		} else if (c > 32 || c == 0) {
+			p_stream->saved = c;
+			return c;
+		}
+	}
+}
+
 template <class T>
 Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct, int &line, String &r_err_str) {
 	Token token;
@@ -554,19 +590,46 @@ Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct,
 		return ERR_PARSE_ERROR;
 	}
 
+	// Packed arrays can hold a lot of values, so separators and plain numbers
+	// are read straight from the stream instead of going through tokens and
+	// variants. Anything else falls back to get_token().
+	LocalVector<T> values;
+
 	bool first = true;
 	while (true) {
 		if (!first) {
-			get_token(p_stream, token, line, r_err_str);
-			if (token.type == TK_COMMA) {
-				//do none
-			} else if (token.type == TK_PARENTHESIS_CLOSE) {
+			char32_t c = _peek_char(p_stream, line);
+			if (c == ',') {
+				p_stream->saved = 0;
+			} else if (c == ')') {
+				p_stream->saved = 0;
 				break;
 			} else {
-				r_err_str = "Expected ',' or ')' in constructor";
-				return ERR_PARSE_ERROR;
+				get_token(p_stream, token, line, r_err_str);
+				if (token.type == TK_COMMA) {
+					//do none
+				} else if (token.type == TK_PARENTHESIS_CLOSE) {
+					break;
+				} else {
+					r_err_str = "Expected ',' or ')' in constructor";
+					return ERR_PARSE_ERROR;
+				}
 			}
 		}
+
+		char32_t c = _peek_char(p_stream, line);
+		if (c == '-' || is_digit(c)) {
+			p_stream->saved = 0;
+			StringBuffer<> num;
+			if (_read_number(p_stream, c, num)) {
+				values.push_back((T)num.as_double());
+			} else {
+				values.push_back((T)num.as_int());
+			}
+			first = false;
+			continue;
+		}
+
 		get_token(p_stream, token, line, r_err_str);
 
 		if (first && token.type == TK_PARENTHESIS_CLOSE) {
@@ -587,10 +650,16 @@ Error VariantParser::_parse_construct(Stream *p_stream, Vector<T> &r_construct,
 			}
 		}
 
-		r_construct.push_back(token.value);
+		values.push_back(token.value);
 		first = false;
 	}
 
+	r_construct.resize(values.size());
+	T *w = r_construct.ptrw();
+	for (uint32_t i = 0; i < values.size(); i++) {
+		w[i] = values[i];
+	}
+
 	return OK;
 }
 
@@ -1445,6 +1445,12 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 	GLOBAL_DEF(PropertyInfo(Variant::INT, "network/limits/debugger/max_errors_per_second", PROPERTY_HINT_RANGE, "0, 200, 1, or_greater"), 400);
 	GLOBAL_DEF(PropertyInfo(Variant::INT, "network/limits/debugger/max_warnings_per_second", PROPERTY_HINT_RANGE, "0, 200, 1, or_greater"), 400);
 
+	GLOBAL_DEF(PropertyInfo(Variant::INT, "memory/limits/resource_cache/soft_budget_mb", PROPERTY_HINT_RANGE, "0,4096,1,or_greater"), 0);
+	if (!editor && !project_manager) {
+		// Not used in the editor, as it must be able to release resources that are reimported.
+		ResourceCache::set_soft_cache_budget(uint64_t(GLOBAL_GET("memory/limits/resource_cache/soft_budget_mb")) * 1024 * 1024);
+	}
+
 	EngineDebugger::initialize(debug_uri, skip_breakpoints, breakpoints, []() {
 		if (editor_pid) {
 			DisplayServer::get_singleton()->enable_for_stealing_focus(editor_pid);
@@ -3344,6 +3350,8 @@ void Main::cleanup(bool p_force) {
 	ResourceLoader::clear_translation_remaps();
 	ResourceLoader::clear_path_remaps();
 
+	ResourceCache::clear_soft_cache();
+
 	ResourceLoader::clear_thread_load_tasks();
 
 	ScriptServer::finish_languages();
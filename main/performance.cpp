@@ -85,6 +85,10 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_MERGE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_FREE_COUNT);
+	BIND_ENUM_CONSTANT(RESOURCE_CACHE_HIT_COUNT);
+	BIND_ENUM_CONSTANT(RESOURCE_CACHE_MISS_COUNT);
+	BIND_ENUM_CONSTANT(RESOURCE_CACHE_EVICTION_COUNT);
+	BIND_ENUM_CONSTANT(RESOURCE_CACHE_SOFT_MEMORY);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -133,6 +137,10 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"navigation/edges_merged",
 		"navigation/edges_connected",
 		"navigation/edges_free",
+		"resource_cache/hits",
+		"resource_cache/misses",
+		"resource_cache/evictions",
+		"resource_cache/soft_memory",
 
 	};
 
@@ -207,6 +215,14 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT);
 		case NAVIGATION_EDGE_FREE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
+		case RESOURCE_CACHE_HIT_COUNT:
+			return ResourceCache::get_hit_count();
+		case RESOURCE_CACHE_MISS_COUNT:
+			return ResourceCache::get_miss_count();
+		case RESOURCE_CACHE_EVICTION_COUNT:
+			return ResourceCache::get_soft_cache_eviction_count();
+		case RESOURCE_CACHE_SOFT_MEMORY:
+			return ResourceCache::get_soft_cache_usage();
 
 		default: {
 		}
@@ -252,6 +268,10 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_MEMORY,
 
 	};
 
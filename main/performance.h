@@ -100,6 +100,10 @@ public:
 		NAVIGATION_EDGE_MERGE_COUNT,
 		NAVIGATION_EDGE_CONNECTION_COUNT,
 		NAVIGATION_EDGE_FREE_COUNT,
+		RESOURCE_CACHE_HIT_COUNT,
+		RESOURCE_CACHE_MISS_COUNT,
+		RESOURCE_CACHE_EVICTION_COUNT,
+		RESOURCE_CACHE_SOFT_MEMORY,
 		MONITOR_MAX
 	};
 
@@ -170,6 +170,7 @@ void EditorNetworkProfiler::_clear_pressed() {
 	node_data.clear();
 	missing_node_data.clear();
 	set_bandwidth(0, 0);
+	set_packet_rates(0, 0, 0);
 	refresh_rpc_data();
 	refresh_replication_data();
 }
@@ -230,6 +231,11 @@ void EditorNetworkProfiler::set_bandwidth(int p_incoming, int p_outgoing) {
 			get_theme_color(SNAME("font_color"), SNAME("Editor")) * Color(1, 1, 1, p_outgoing > 0 ? 1 : 0.5));
 }
 
+void EditorNetworkProfiler::set_packet_rates(int p_incoming, int p_outgoing, int p_batched_messages) {
+	incoming_bandwidth_text->set_tooltip_text(vformat(TTR("%d packets/s"), p_incoming));
+	outgoing_bandwidth_text->set_tooltip_text(vformat(TTR("%d packets/s\n%d messages/s sent in batches"), p_outgoing, p_batched_messages));
+}
+
 bool EditorNetworkProfiler::is_profiling() {
 	return activate->is_pressed();
 }
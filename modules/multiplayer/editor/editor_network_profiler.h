@@ -93,6 +93,7 @@ public:
 	void add_rpc_frame_data(const RPCNodeInfo &p_frame);
 	void add_sync_frame_data(const SyncInfo &p_frame);
 	void set_bandwidth(int p_incoming, int p_outgoing);
+	void set_packet_rates(int p_incoming, int p_outgoing, int p_batched_messages);
 	bool is_profiling();
 
 	EditorNetworkProfiler();
@@ -83,6 +83,9 @@ bool MultiplayerEditorDebugger::capture(const String &p_message, const Array &p_
 	} else if (p_message == "multiplayer:bandwidth") {
 		ERR_FAIL_COND_V(p_data.size() < 2, false);
 		profiler->set_bandwidth(p_data[0], p_data[1]);
+		if (p_data.size() >= 5) {
+			profiler->set_packet_rates(p_data[2], p_data[3], p_data[4]);
+		}
 		return true;
 	}
 	return false;
@@ -88,9 +88,10 @@ Error MultiplayerDebugger::_capture(void *p_user, const String &p_msg, const Arr
 
 // BandwidthProfiler
 
-int MultiplayerDebugger::BandwidthProfiler::bandwidth_usage(const Vector<BandwidthFrame> &p_buffer, int p_pointer) {
+int MultiplayerDebugger::BandwidthProfiler::bandwidth_usage(const Vector<BandwidthFrame> &p_buffer, int p_pointer, int *r_packets) {
 	ERR_FAIL_COND_V(p_buffer.size() == 0, 0);
 	int total_bandwidth = 0;
+	int total_packets = 0;
 
 	uint64_t timestamp = OS::get_singleton()->get_ticks_msec();
 	uint64_t final_timestamp = timestamp - 1000;
@@ -99,11 +100,15 @@ int MultiplayerDebugger::BandwidthProfiler::bandwidth_usage(const Vector<Bandwid
 
 	while (i != p_pointer && p_buffer[i].packet_size > 0) {
 		if (p_buffer[i].timestamp < final_timestamp) {
-			return total_bandwidth;
+			break;
 		}
 		total_bandwidth += p_buffer[i].packet_size;
+		total_packets++;
 		i = (i + p_buffer.size() - 1) % p_buffer.size();
 	}
+	if (r_packets) {
+		*r_packets = total_packets;
+	}
 
 	ERR_FAIL_COND_V_MSG(i == p_pointer, total_bandwidth, "Reached the end of the bandwidth profiler buffer, values might be inaccurate.");
 	return total_bandwidth;
@@ -113,6 +118,7 @@ void MultiplayerDebugger::BandwidthProfiler::toggle(bool p_enable, const Array &
 	if (!p_enable) {
 		bandwidth_in.clear();
 		bandwidth_out.clear();
+		batches_out.clear();
 	} else {
 		bandwidth_in_ptr = 0;
 		bandwidth_in.resize(16384); // ~128kB
@@ -124,6 +130,11 @@ void MultiplayerDebugger::BandwidthProfiler::toggle(bool p_enable, const Array &
 		for (int i = 0; i < bandwidth_out.size(); ++i) {
 			bandwidth_out.write[i].packet_size = -1;
 		}
+		batches_out_ptr = 0;
+		batches_out.resize(4096);
+		for (int i = 0; i < batches_out.size(); ++i) {
+			batches_out.write[i].packet_size = -1;
+		}
 	}
 }
 
@@ -140,6 +151,10 @@ void MultiplayerDebugger::BandwidthProfiler::add(const Array &p_data) {
 		bandwidth_out.write[bandwidth_out_ptr].timestamp = time;
 		bandwidth_out.write[bandwidth_out_ptr].packet_size = size;
 		bandwidth_out_ptr = (bandwidth_out_ptr + 1) % bandwidth_out.size();
+	} else if (inout == "batch") {
+		batches_out.write[batches_out_ptr].timestamp = time;
+		batches_out.write[batches_out_ptr].packet_size = size;
+		batches_out_ptr = (batches_out_ptr + 1) % batches_out.size();
 	}
 }
 
@@ -147,12 +162,18 @@ void MultiplayerDebugger::BandwidthProfiler::tick(double p_frame_time, double p_
 	uint64_t pt = OS::get_singleton()->get_ticks_msec();
 	if (pt - last_bandwidth_time > 200) {
 		last_bandwidth_time = pt;
-		int incoming_bandwidth = bandwidth_usage(bandwidth_in, bandwidth_in_ptr);
-		int outgoing_bandwidth = bandwidth_usage(bandwidth_out, bandwidth_out_ptr);
+		int incoming_packets = 0;
+		int outgoing_packets = 0;
+		int incoming_bandwidth = bandwidth_usage(bandwidth_in, bandwidth_in_ptr, &incoming_packets);
+		int outgoing_bandwidth = bandwidth_usage(bandwidth_out, bandwidth_out_ptr, &outgoing_packets);
+		int batched_messages = bandwidth_usage(batches_out, batches_out_ptr);
 
 		Array arr;
 		arr.push_back(incoming_bandwidth);
 		arr.push_back(outgoing_bandwidth);
+		arr.push_back(incoming_packets);
+		arr.push_back(outgoing_packets);
+		arr.push_back(batched_messages);
 		EngineDebugger::get_singleton()->send_message("multiplayer:bandwidth", arr);
 	}
 }
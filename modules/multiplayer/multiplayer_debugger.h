@@ -90,9 +90,11 @@ private:
 		Vector<BandwidthFrame> bandwidth_in;
 		int bandwidth_out_ptr = 0;
 		Vector<BandwidthFrame> bandwidth_out;
+		int batches_out_ptr = 0;
+		Vector<BandwidthFrame> batches_out; // The packet size is the amount of batched messages.
 		uint64_t last_bandwidth_time = 0;
 
-		int bandwidth_usage(const Vector<BandwidthFrame> &p_buffer, int p_pointer);
+		int bandwidth_usage(const Vector<BandwidthFrame> &p_buffer, int p_pointer, int *r_packets = nullptr);
 
 	public:
 		void toggle(bool p_enable, const Array &p_opts);
@@ -49,6 +49,8 @@ private:
 	Ref<SceneReplicationConfig> replication_config;
 	NodePath root_path = NodePath(".."); // Start with parent, like with AnimationPlayer.
 	uint64_t interval_msec = 0;
+	real_t interest_radius = 0.0;
+	real_t replication_priority = 1.0;
 	VisibilityUpdateMode visibility_update_mode = VISIBILITY_PROCESS_IDLE;
 	HashSet<Callable> visibility_filters;
 	HashSet<int> peer_visibility;
@@ -85,6 +87,12 @@ public:
 	void set_replication_interval(double p_interval);
 	double get_replication_interval() const;
 
+	void set_interest_radius(real_t p_radius);
+	real_t get_interest_radius() const;
+
+	void set_replication_priority(real_t p_priority);
+	real_t get_replication_priority() const;
+
 	void set_replication_config(Ref<SceneReplicationConfig> p_config);
 	Ref<SceneReplicationConfig> get_replication_config();
 
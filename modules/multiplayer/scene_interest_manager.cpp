@@ -0,0 +1,186 @@
+/**************************************************************************/
+/*  scene_interest_manager.cpp                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "scene_interest_manager.h"
+
+#include "core/templates/sort_array.h"
+
+void SceneInterestManager::set_cell_size(real_t p_size) {
+	ERR_FAIL_COND_MSG(p_size <= 0, "The interest cell size must be greater than 0.");
+	cell_size = p_size;
+}
+
+real_t SceneInterestManager::get_cell_size() const {
+	return cell_size;
+}
+
+void SceneInterestManager::set_peer_position(int p_peer, const Vector3 &p_position) {
+	peers[p_peer].position = p_position;
+}
+
+Vector3 SceneInterestManager::get_peer_position(int p_peer) const {
+	const PeerInterest *peer = peers.getptr(p_peer);
+	return peer ? peer->position : Vector3();
+}
+
+void SceneInterestManager::remove_peer(int p_peer) {
+	peers.erase(p_peer);
+}
+
+void SceneInterestManager::clear() {
+	peers.clear();
+	managed.clear();
+	cells.clear();
+}
+
+void SceneInterestManager::_add_relevant(const LocalVector<Entry> &p_entries, const CellRange &p_range, const Vector3 &p_position, HashMap<ObjectID, real_t> &r_relevant) const {
+	for (uint32_t i = p_range.from; i < p_range.to; i++) {
+		const Entry &entry = p_entries[sorted_entries[i]];
+		const real_t distance = entry.position.distance_to(p_position);
+		if (distance <= entry.radius) {
+			r_relevant.insert(entry.id, 1.0 - distance / entry.radius);
+		}
+	}
+}
+
+void SceneInterestManager::update(const LocalVector<Entry> &p_entries, LocalVector<Change> &r_changes) {
+	// Sort the objects by cell, each cell is then a range of the sorted list.
+	real_t max_radius = 0.0;
+	Vector3i min_cell;
+	Vector3i max_cell;
+	entry_cells.resize(p_entries.size());
+	sorted_entries.resize(p_entries.size());
+	for (uint32_t i = 0; i < p_entries.size(); i++) {
+		entry_cells[i] = _get_cell(p_entries[i].position);
+		sorted_entries[i] = i;
+		max_radius = MAX(max_radius, p_entries[i].radius);
+		min_cell = i ? min_cell.min(entry_cells[i]) : entry_cells[i];
+		max_cell = i ? max_cell.max(entry_cells[i]) : entry_cells[i];
+	}
+	SortArray<uint32_t, SortEntriesByCell> sorter;
+	sorter.compare.cells = entry_cells.ptr();
+	sorter.sort(sorted_entries.ptr(), sorted_entries.size());
+
+	cells.clear();
+	for (uint32_t i = 0; i < sorted_entries.size();) {
+		const Vector3i cell = entry_cells[sorted_entries[i]];
+		CellRange range;
+		range.from = i;
+		range.to = i + 1;
+		while (range.to < sorted_entries.size() && entry_cells[sorted_entries[range.to]] == cell) {
+			range.to++;
+		}
+		cells.insert(cell, range);
+		i = range.to;
+	}
+
+	// Objects which start or stop being managed change for every peer.
+	HashSet<ObjectID> new_managed;
+	for (const Entry &entry : p_entries) {
+		new_managed.insert(entry.id);
+		if (!managed.has(entry.id)) {
+			r_changes.push_back({ 0, entry.id });
+		}
+	}
+	for (const ObjectID &id : managed) {
+		if (!new_managed.has(id)) {
+			r_changes.push_back({ 0, id });
+		}
+	}
+	managed = new_managed;
+
+	// Visiting every cell is cheaper than looking up many empty ones when radii are large compared to cells.
+	// Lookups are limited to the bounds of the occupied cells, e.g. a single layer when all objects are in 2D.
+	const int64_t reach = Math::ceil(max_radius / cell_size);
+	const int64_t side = 2 * reach + 1;
+	bool visit_all_cells = true;
+	if (!p_entries.is_empty()) {
+		const Vector3i extent = max_cell - min_cell + Vector3i(1, 1, 1);
+		visit_all_cells = MIN(side, (int64_t)extent.x) * MIN(side, (int64_t)extent.y) * MIN(side, (int64_t)extent.z) > (int64_t)cells.size();
+	}
+
+	for (KeyValue<int, PeerInterest> &E : peers) {
+		PeerInterest &peer = E.value;
+		HashMap<ObjectID, real_t> relevant;
+		if (visit_all_cells) {
+			for (const KeyValue<Vector3i, CellRange> &C : cells) {
+				_add_relevant(p_entries, C.value, peer.position, relevant);
+			}
+		} else {
+			const Vector3i center = _get_cell(peer.position);
+			Vector3i from;
+			Vector3i to;
+			for (int axis = 0; axis < 3; axis++) {
+				from[axis] = MAX((int64_t)center[axis] - reach, (int64_t)min_cell[axis]);
+				to[axis] = MIN((int64_t)center[axis] + reach, (int64_t)max_cell[axis]);
+			}
+			Vector3i cell;
+			for (cell.x = from.x; cell.x <= to.x; cell.x++) {
+				for (cell.y = from.y; cell.y <= to.y; cell.y++) {
+					for (cell.z = from.z; cell.z <= to.z; cell.z++) {
+						const CellRange *range = cells.getptr(cell);
+						if (range) {
+							_add_relevant(p_entries, *range, peer.position, relevant);
+						}
+					}
+				}
+			}
+		}
+
+		for (const KeyValue<ObjectID, real_t> &R : peer.relevant) {
+			if (!relevant.has(R.key)) {
+				r_changes.push_back({ E.key, R.key });
+			}
+		}
+		for (const KeyValue<ObjectID, real_t> &R : relevant) {
+			if (!peer.relevant.has(R.key)) {
+				r_changes.push_back({ E.key, R.key });
+			}
+		}
+		peer.relevant = relevant;
+	}
+}
+
+bool SceneInterestManager::is_relevant(int p_peer, const ObjectID &p_id) const {
+	if (!managed.has(p_id)) {
+		return true;
+	}
+	const PeerInterest *peer = peers.getptr(p_peer);
+	return peer && peer->relevant.has(p_id);
+}
+
+real_t SceneInterestManager::get_proximity(int p_peer, const ObjectID &p_id) const {
+	const PeerInterest *peer = peers.getptr(p_peer);
+	if (!peer) {
+		return 0.0;
+	}
+	const real_t *proximity = peer->relevant.getptr(p_id);
+	return proximity ? *proximity : 0.0;
+}
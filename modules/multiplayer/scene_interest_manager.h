@@ -0,0 +1,108 @@
+/**************************************************************************/
+/*  scene_interest_manager.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SCENE_INTEREST_MANAGER_H
+#define SCENE_INTEREST_MANAGER_H
+
+#include "core/math/vector3.h"
+#include "core/math/vector3i.h"
+#include "core/object/object_id.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/local_vector.h"
+
+// Finds which objects are relevant to each peer, i.e. the objects closer to the peer's position than their radius.
+// Objects are bucketed in a uniform grid, so each peer only visits the cells within reach of the largest radius.
+class SceneInterestManager {
+public:
+	struct Entry {
+		ObjectID id;
+		Vector3 position;
+		real_t radius = 0.0;
+	};
+
+	struct Change {
+		int peer = 0; // 0 when the object changed for every peer.
+		ObjectID id;
+	};
+
+private:
+	struct PeerInterest {
+		Vector3 position;
+		HashMap<ObjectID, real_t> relevant; // Proximity of each relevant object, from 1 at its position to 0 at its radius.
+	};
+
+	struct CellRange {
+		uint32_t from = 0;
+		uint32_t to = 0;
+	};
+
+	struct SortEntriesByCell {
+		const Vector3i *cells = nullptr;
+
+		_FORCE_INLINE_ bool operator()(uint32_t p_a, uint32_t p_b) const {
+			return cells[p_a] < cells[p_b];
+		}
+	};
+
+	real_t cell_size = 64.0;
+	HashMap<int, PeerInterest> peers;
+	HashSet<ObjectID> managed;
+
+	// Grid of the last update.
+	LocalVector<Vector3i> entry_cells;
+	LocalVector<uint32_t> sorted_entries;
+	HashMap<Vector3i, CellRange> cells;
+
+	_FORCE_INLINE_ Vector3i _get_cell(const Vector3 &p_position) const {
+		return Vector3i((p_position / cell_size).floor());
+	}
+
+	void _add_relevant(const LocalVector<Entry> &p_entries, const CellRange &p_range, const Vector3 &p_position, HashMap<ObjectID, real_t> &r_relevant) const;
+
+public:
+	void set_cell_size(real_t p_size);
+	real_t get_cell_size() const;
+
+	void set_peer_position(int p_peer, const Vector3 &p_position);
+	Vector3 get_peer_position(int p_peer) const;
+	void remove_peer(int p_peer);
+	void clear();
+
+	// Recomputes the objects relevant to each peer, and lists the peers and objects whose relevancy changed.
+	void update(const LocalVector<Entry> &p_entries, LocalVector<Change> &r_changes);
+
+	bool has_managed() const { return !managed.is_empty(); }
+	// Objects which aren't managed are relevant to every peer, managed ones are never relevant to peers without a position.
+	bool is_relevant(int p_peer, const ObjectID &p_id) const;
+	real_t get_proximity(int p_peer, const ObjectID &p_id) const;
+};
+
+#endif // SCENE_INTEREST_MANAGER_H
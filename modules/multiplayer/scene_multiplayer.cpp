@@ -67,6 +67,15 @@ void SceneMultiplayer::_update_status() {
 }
 
 Error SceneMultiplayer::poll() {
+	Error err = _poll();
+	if (last_connection_status == MultiplayerPeer::CONNECTION_CONNECTED) {
+		// Also after an early return, so batched messages don't wait for the next poll.
+		_flush_batches();
+	}
+	return err;
+}
+
+Error SceneMultiplayer::_poll() {
 	_update_status();
 	if (last_connection_status == MultiplayerPeer::CONNECTION_DISCONNECTED) {
 		return OK;
@@ -179,6 +188,7 @@ void SceneMultiplayer::clear() {
 	pending_peers.clear();
 	connected_peers.clear();
 	packet_cache.clear();
+	packet_batches.clear();
 	replicator->on_reset();
 	cache->clear();
 	relay_buffer->clear();
@@ -265,7 +275,73 @@ _FORCE_INLINE_ Error SceneMultiplayer::_send(const uint8_t *p_packet, int p_pack
 }
 #endif
 
+Error SceneMultiplayer::_send_to(int p_peer, MultiplayerPeer::TransferMode p_mode, int p_channel, const uint8_t *p_packet, int p_packet_len) {
+	PacketBatchKey key;
+	key.peer = p_peer;
+	key.channel = p_channel;
+	key.mode = p_mode;
+	PacketBatch *batch = packet_batches.getptr(key);
+	if (packet_batching && SYS_CMD_SIZE + 2 + p_packet_len <= batch_mtu) {
+		if (!batch) {
+			batch = &packet_batches.insert(key, PacketBatch())->value;
+		}
+		if (batch->count && (int)batch->buffer.size() + 2 + p_packet_len > batch_mtu) {
+			_flush_batch(key, *batch);
+			// Callers might send more with the same settings.
+			multiplayer_peer->set_transfer_channel(p_channel);
+			multiplayer_peer->set_transfer_mode(p_mode);
+		}
+		if (batch->count == 0) {
+			batch->buffer.resize(SYS_CMD_SIZE);
+		}
+		const uint32_t ofs = batch->buffer.size();
+		batch->buffer.resize(ofs + 2 + p_packet_len);
+		encode_uint16(p_packet_len, &batch->buffer[ofs]);
+		memcpy(&batch->buffer[ofs + 2], p_packet, p_packet_len);
+		batch->count++;
+		return OK;
+	}
+	// Too big to batch, the pending messages must still be sent first.
+	if (batch && batch->count) {
+		_flush_batch(key, *batch);
+	}
+	multiplayer_peer->set_transfer_channel(p_channel);
+	multiplayer_peer->set_transfer_mode(p_mode);
+	multiplayer_peer->set_target_peer(p_peer);
+	return _send(p_packet, p_packet_len);
+}
+
+void SceneMultiplayer::_flush_batch(const PacketBatchKey &p_key, PacketBatch &p_batch) {
+	multiplayer_peer->set_transfer_channel(p_key.channel);
+	multiplayer_peer->set_transfer_mode(p_key.mode);
+	multiplayer_peer->set_target_peer(p_key.peer);
+	if (p_batch.count == 1) {
+		// A single message doesn't need the frame.
+		_send(&p_batch.buffer[SYS_CMD_SIZE + 2], p_batch.buffer.size() - SYS_CMD_SIZE - 2);
+	} else {
+		p_batch.buffer[0] = NETWORK_COMMAND_SYS;
+		p_batch.buffer[1] = SYS_COMMAND_BATCH;
+		encode_uint32(p_batch.count, &p_batch.buffer[2]);
+		_send(p_batch.buffer.ptr(), p_batch.buffer.size());
+#ifdef DEBUG_ENABLED
+		_profile_bandwidth("batch", p_batch.count);
+#endif
+	}
+	p_batch.buffer.clear();
+	p_batch.count = 0;
+}
+
+void SceneMultiplayer::_flush_batches() {
+	for (KeyValue<PacketBatchKey, PacketBatch> &E : packet_batches) {
+		if (E.value.count) {
+			_flush_batch(E.key, E.value);
+		}
+	}
+}
+
 Error SceneMultiplayer::send_command(int p_to, const uint8_t *p_packet, int p_packet_len) {
+	const MultiplayerPeer::TransferMode mode = multiplayer_peer->get_transfer_mode();
+	const int channel = multiplayer_peer->get_transfer_channel();
 	if (server_relay && get_unique_id() != 1 && p_to != 1 && multiplayer_peer->is_server_relay_supported()) {
 		// Send relay packet.
 		relay_buffer->seek(0);
@@ -273,21 +349,18 @@ Error SceneMultiplayer::send_command(int p_to, const uint8_t *p_packet, int p_pa
 		relay_buffer->put_u8(SYS_COMMAND_RELAY);
 		relay_buffer->put_32(p_to); // Set the destination.
 		relay_buffer->put_data(p_packet, p_packet_len);
-		multiplayer_peer->set_target_peer(1);
 		const Vector<uint8_t> data = relay_buffer->get_data_array();
-		return _send(data.ptr(), relay_buffer->get_position());
+		return _send_to(1, mode, channel, data.ptr(), relay_buffer->get_position());
 	}
 	if (p_to > 0) {
 		ERR_FAIL_COND_V(!connected_peers.has(p_to), ERR_BUG);
-		multiplayer_peer->set_target_peer(p_to);
-		return _send(p_packet, p_packet_len);
+		return _send_to(p_to, mode, channel, p_packet, p_packet_len);
 	} else {
 		for (const int &pid : connected_peers) {
 			if (p_to && pid == -p_to) {
 				continue;
 			}
-			multiplayer_peer->set_target_peer(pid);
-			_send(p_packet, p_packet_len);
+			_send_to(pid, mode, channel, p_packet, p_packet_len);
 		}
 		return OK;
 	}
@@ -322,19 +395,15 @@ void SceneMultiplayer::_process_sys(int p_from, const uint8_t *p_packet, int p_p
 				relay_buffer->put_32(p_from); // Set the source.
 				relay_buffer->put_data(packet, len);
 				const Vector<uint8_t> data = relay_buffer->get_data_array();
-				multiplayer_peer->set_transfer_mode(p_mode);
-				multiplayer_peer->set_transfer_channel(p_channel);
 				if (peer > 0) {
-					multiplayer_peer->set_target_peer(peer);
-					_send(data.ptr(), relay_buffer->get_position());
+					_send_to(peer, p_mode, p_channel, data.ptr(), relay_buffer->get_position());
 				} else {
 					for (const int &P : connected_peers) {
 						// Not to sender, nor excluded.
 						if (P == p_from || (peer < 0 && P != -peer)) {
 							continue;
 						}
-						multiplayer_peer->set_target_peer(P);
-						_send(data.ptr(), relay_buffer->get_position());
+						_send_to(P, p_mode, p_channel, data.ptr(), relay_buffer->get_position());
 					}
 				}
 				if (peer == 0 || peer == -1) {
@@ -351,12 +420,53 @@ void SceneMultiplayer::_process_sys(int p_from, const uint8_t *p_packet, int p_p
 				remote_sender_id = 0;
 			}
 		} break;
+		case SYS_COMMAND_BATCH: {
+			_process_batch(p_from, p_packet, p_packet_len, p_mode, p_channel);
+		} break;
 		default: {
 			ERR_FAIL();
 		}
 	}
 }
 
+void SceneMultiplayer::_process_batch(int p_from, const uint8_t *p_packet, int p_packet_len, MultiplayerPeer::TransferMode p_mode, int p_channel) {
+	const uint32_t count = decode_uint32(&p_packet[2]);
+	// Check the whole frame first, so that malformed batches are dropped without processing any of their messages.
+	int ofs = SYS_CMD_SIZE;
+	for (uint32_t i = 0; i < count; i++) {
+		ERR_FAIL_COND_MSG(ofs + 2 > p_packet_len, "Invalid batch received. Size too small.");
+		const int len = decode_uint16(&p_packet[ofs]);
+		ofs += 2;
+		ERR_FAIL_COND_MSG(len < 1 || ofs + len > p_packet_len, "Invalid batch received. Size too small.");
+		const uint8_t *packet = &p_packet[ofs];
+		ofs += len;
+		if ((packet[0] & CMD_MASK) == NETWORK_COMMAND_SYS) {
+			// Batches are never nested, and authentication is never batched.
+			ERR_FAIL_COND_MSG(len < 2 || packet[1] == SYS_COMMAND_BATCH || packet[1] == SYS_COMMAND_AUTH, "Invalid batch received. Unexpected system message.");
+		}
+	}
+	ERR_FAIL_COND_MSG(ofs != p_packet_len, "Invalid batch received. Size too big.");
+
+	ofs = SYS_CMD_SIZE;
+	for (uint32_t i = 0; i < count; i++) {
+		const int len = decode_uint16(&p_packet[ofs]);
+		const uint8_t *packet = &p_packet[ofs + 2];
+		ofs += 2 + len;
+		if ((packet[0] & CMD_MASK) == NETWORK_COMMAND_SYS) {
+			_process_sys(p_from, packet, len, p_mode, p_channel);
+		} else {
+			remote_sender_id = p_from;
+			_process_packet(p_from, packet, len);
+			remote_sender_id = 0;
+		}
+		// Processing a message might have disconnected us, or the sender.
+		_update_status();
+		if (last_connection_status != MultiplayerPeer::CONNECTION_CONNECTED || !connected_peers.has(p_from)) {
+			return;
+		}
+	}
+}
+
 void SceneMultiplayer::_add_peer(int p_id) {
 	if (auth_callback.is_valid()) {
 		pending_peers[p_id] = PendingPeer();
@@ -371,20 +481,17 @@ void SceneMultiplayer::_add_peer(int p_id) {
 void SceneMultiplayer::_admit_peer(int p_id) {
 	if (server_relay && get_unique_id() == 1 && multiplayer_peer->is_server_relay_supported()) {
 		// Notify others of connection, and send connected peers to newly connected one.
+		// Sent like any other message, so they stay ordered with the batched ones.
 		uint8_t buf[SYS_CMD_SIZE];
 		buf[0] = NETWORK_COMMAND_SYS;
 		buf[1] = SYS_COMMAND_ADD_PEER;
-		multiplayer_peer->set_transfer_channel(0);
-		multiplayer_peer->set_transfer_mode(MultiplayerPeer::TRANSFER_MODE_RELIABLE);
 		for (const int &P : connected_peers) {
 			// Send new peer to already connected.
 			encode_uint32(p_id, &buf[2]);
-			multiplayer_peer->set_target_peer(P);
-			_send(buf, sizeof(buf));
+			_send_to(P, MultiplayerPeer::TRANSFER_MODE_RELIABLE, 0, buf, sizeof(buf));
 			// Send already connected to new peer.
 			encode_uint32(P, &buf[2]);
-			multiplayer_peer->set_target_peer(p_id);
-			_send(buf, sizeof(buf));
+			_send_to(p_id, MultiplayerPeer::TRANSFER_MODE_RELIABLE, 0, buf, sizeof(buf));
 		}
 	}
 
@@ -411,21 +518,27 @@ void SceneMultiplayer::_del_peer(int p_id) {
 		uint8_t buf[SYS_CMD_SIZE];
 		buf[0] = NETWORK_COMMAND_SYS;
 		buf[1] = SYS_COMMAND_DEL_PEER;
-		multiplayer_peer->set_transfer_channel(0);
-		multiplayer_peer->set_transfer_mode(MultiplayerPeer::TRANSFER_MODE_RELIABLE);
 		encode_uint32(p_id, &buf[2]);
 		for (const int &P : connected_peers) {
 			if (P == p_id) {
 				continue;
 			}
-			multiplayer_peer->set_target_peer(P);
-			_send(buf, sizeof(buf));
+			_send_to(P, MultiplayerPeer::TRANSFER_MODE_RELIABLE, 0, buf, sizeof(buf));
 		}
 	}
 
 	replicator->on_peer_change(p_id, false);
 	cache->on_peer_change(p_id, false);
 	connected_peers.erase(p_id);
+	LocalVector<PacketBatchKey> to_erase;
+	for (const KeyValue<PacketBatchKey, PacketBatch> &E : packet_batches) {
+		if (E.key.peer == p_id) {
+			to_erase.push_back(E.key);
+		}
+	}
+	for (const PacketBatchKey &key : to_erase) {
+		packet_batches.erase(key);
+	}
 	emit_signal(SNAME("peer_disconnected"), p_id);
 }
 
@@ -617,6 +730,41 @@ bool SceneMultiplayer::is_server_relay_enabled() const {
 	return server_relay;
 }
 
+void SceneMultiplayer::set_packet_batching_enabled(bool p_enabled) {
+	if (!p_enabled && last_connection_status == MultiplayerPeer::CONNECTION_CONNECTED) {
+		_flush_batches();
+	}
+	packet_batching = p_enabled;
+}
+
+bool SceneMultiplayer::is_packet_batching_enabled() const {
+	return packet_batching;
+}
+
+void SceneMultiplayer::set_peer_interest_position(int p_peer, const Vector3 &p_position) {
+	replicator->set_peer_interest_position(p_peer, p_position);
+}
+
+Vector3 SceneMultiplayer::get_peer_interest_position(int p_peer) const {
+	return replicator->get_peer_interest_position(p_peer);
+}
+
+void SceneMultiplayer::set_interest_cell_size(real_t p_size) {
+	replicator->set_interest_cell_size(p_size);
+}
+
+real_t SceneMultiplayer::get_interest_cell_size() const {
+	return replicator->get_interest_cell_size();
+}
+
+void SceneMultiplayer::set_peer_sync_budget(int p_bytes) {
+	replicator->set_peer_sync_budget(p_bytes);
+}
+
+int SceneMultiplayer::get_peer_sync_budget() const {
+	return replicator->get_peer_sync_budget();
+}
+
 void SceneMultiplayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_root_path", "path"), &SceneMultiplayer::set_root_path);
 	ClassDB::bind_method(D_METHOD("get_root_path"), &SceneMultiplayer::get_root_path);
@@ -639,6 +787,14 @@ void SceneMultiplayer::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_object_decoding_allowed"), &SceneMultiplayer::is_object_decoding_allowed);
 	ClassDB::bind_method(D_METHOD("set_server_relay_enabled", "enabled"), &SceneMultiplayer::set_server_relay_enabled);
 	ClassDB::bind_method(D_METHOD("is_server_relay_enabled"), &SceneMultiplayer::is_server_relay_enabled);
+	ClassDB::bind_method(D_METHOD("set_packet_batching_enabled", "enabled"), &SceneMultiplayer::set_packet_batching_enabled);
+	ClassDB::bind_method(D_METHOD("is_packet_batching_enabled"), &SceneMultiplayer::is_packet_batching_enabled);
+	ClassDB::bind_method(D_METHOD("set_peer_interest_position", "peer", "position"), &SceneMultiplayer::set_peer_interest_position);
+	ClassDB::bind_method(D_METHOD("get_peer_interest_position", "peer"), &SceneMultiplayer::get_peer_interest_position);
+	ClassDB::bind_method(D_METHOD("set_interest_cell_size", "size"), &SceneMultiplayer::set_interest_cell_size);
+	ClassDB::bind_method(D_METHOD("get_interest_cell_size"), &SceneMultiplayer::get_interest_cell_size);
+	ClassDB::bind_method(D_METHOD("set_peer_sync_budget", "bytes"), &SceneMultiplayer::set_peer_sync_budget);
+	ClassDB::bind_method(D_METHOD("get_peer_sync_budget"), &SceneMultiplayer::get_peer_sync_budget);
 	ClassDB::bind_method(D_METHOD("send_bytes", "bytes", "id", "mode", "channel"), &SceneMultiplayer::send_bytes, DEFVAL(MultiplayerPeer::TARGET_PEER_BROADCAST), DEFVAL(MultiplayerPeer::TRANSFER_MODE_RELIABLE), DEFVAL(0));
 
 	ADD_PROPERTY(PropertyInfo(Variant::NODE_PATH, "root_path"), "set_root_path", "get_root_path");
@@ -647,6 +803,9 @@ void SceneMultiplayer::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "allow_object_decoding"), "set_allow_object_decoding", "is_object_decoding_allowed");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "refuse_new_connections"), "set_refuse_new_connections", "is_refusing_new_connections");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "server_relay"), "set_server_relay_enabled", "is_server_relay_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "packet_batching"), "set_packet_batching_enabled", "is_packet_batching_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "interest_cell_size", PROPERTY_HINT_RANGE, "0.01,1000,0.01,or_greater,suffix:m"), "set_interest_cell_size", "get_interest_cell_size");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "peer_sync_budget", PROPERTY_HINT_RANGE, "0,65536,1,or_greater,suffix:B"), "set_peer_sync_budget", "get_peer_sync_budget");
 
 	ADD_PROPERTY_DEFAULT("refuse_new_connections", false);
 
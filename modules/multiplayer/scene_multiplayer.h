@@ -82,6 +82,7 @@ public:
 		SYS_COMMAND_ADD_PEER,
 		SYS_COMMAND_DEL_PEER,
 		SYS_COMMAND_RELAY,
+		SYS_COMMAND_BATCH,
 	};
 
 	enum {
@@ -108,6 +109,28 @@ private:
 		uint64_t time = 0;
 	};
 
+	struct PacketBatchKey {
+		int peer = 0;
+		int channel = 0;
+		MultiplayerPeer::TransferMode mode = MultiplayerPeer::TRANSFER_MODE_RELIABLE;
+
+		bool operator==(const PacketBatchKey &p_other) const {
+			return peer == p_other.peer && channel == p_other.channel && mode == p_other.mode;
+		}
+
+		static uint32_t hash(const PacketBatchKey &p_key) {
+			uint32_t h = hash_murmur3_one_32(p_key.peer);
+			h = hash_murmur3_one_32(p_key.channel, h);
+			return hash_fmix32(hash_murmur3_one_32(p_key.mode, h));
+		}
+	};
+
+	// Messages for the same peer, channel, and transfer mode, sent together as a single packet.
+	struct PacketBatch {
+		LocalVector<uint8_t> buffer; // Room for the frame header, then each message prefixed by its size.
+		uint32_t count = 0;
+	};
+
 	Ref<MultiplayerPeer> multiplayer_peer;
 	MultiplayerPeer::ConnectionStatus last_connection_status = MultiplayerPeer::CONNECTION_DISCONNECTED;
 	HashMap<int, PendingPeer> pending_peers; // true if locally finalized.
@@ -124,6 +147,10 @@ private:
 	bool server_relay = true;
 	Ref<StreamPeerBuffer> relay_buffer;
 
+	bool packet_batching = false;
+	int batch_mtu = 1350; // Highly dependent on underlying protocol.
+	HashMap<PacketBatchKey, PacketBatch, PacketBatchKey> packet_batches;
+
 	Ref<SceneCacheInterface> cache;
 	Ref<SceneReplicationInterface> replicator;
 	Ref<SceneRPCInterface> rpc;
@@ -136,6 +163,10 @@ private:
 		return multiplayer_peer->put_packet(p_packet, p_packet_len);
 	}
 #endif
+	Error _send_to(int p_peer, MultiplayerPeer::TransferMode p_mode, int p_channel, const uint8_t *p_packet, int p_packet_len); // Batches when possible.
+	void _flush_batch(const PacketBatchKey &p_key, PacketBatch &p_batch);
+	void _flush_batches();
+	Error _poll(); // Batches are flushed after it, whichever way it returns.
 
 protected:
 	static void _bind_methods();
@@ -143,6 +174,7 @@ protected:
 	void _process_packet(int p_from, const uint8_t *p_packet, int p_packet_len);
 	void _process_raw(int p_from, const uint8_t *p_packet, int p_packet_len);
 	void _process_sys(int p_from, const uint8_t *p_packet, int p_packet_len, MultiplayerPeer::TransferMode p_mode, int p_channel);
+	void _process_batch(int p_from, const uint8_t *p_packet, int p_packet_len, MultiplayerPeer::TransferMode p_mode, int p_channel);
 
 	void _add_peer(int p_id);
 	void _admit_peer(int p_id);
@@ -195,6 +227,16 @@ public:
 	void set_server_relay_enabled(bool p_enabled);
 	bool is_server_relay_enabled() const;
 
+	void set_packet_batching_enabled(bool p_enabled);
+	bool is_packet_batching_enabled() const;
+
+	void set_peer_interest_position(int p_peer, const Vector3 &p_position);
+	Vector3 get_peer_interest_position(int p_peer) const;
+	void set_interest_cell_size(real_t p_size);
+	real_t get_interest_cell_size() const;
+	void set_peer_sync_budget(int p_bytes);
+	int get_peer_sync_budget() const;
+
 	Ref<SceneCacheInterface> get_path_cache() { return cache; }
 	Ref<SceneReplicationInterface> get_replicator() { return replicator; }
 
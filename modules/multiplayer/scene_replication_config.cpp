@@ -47,19 +47,20 @@ bool SceneReplicationConfig::_set(const StringName &p_name, const Variant &p_val
 			add_property(path);
 			return true;
 		}
-		ERR_FAIL_COND_V(p_value.get_type() != Variant::BOOL, false);
 		ERR_FAIL_INDEX_V(idx, properties.size(), false);
 		ReplicationProperty &prop = properties[idx];
+		if (what == "quantization") {
+			ERR_FAIL_COND_V(p_value.get_type() != Variant::FLOAT && p_value.get_type() != Variant::INT, false);
+			property_set_quantization(prop.name, p_value);
+			return true;
+		}
+		ERR_FAIL_COND_V(p_value.get_type() != Variant::BOOL, false);
 		if (what == "sync") {
 			if ((bool)p_value == prop.sync) {
 				return true;
 			}
 			prop.sync = p_value;
-			if (prop.sync) {
-				sync_props.push_back(prop.name);
-			} else {
-				sync_props.erase(prop.name);
-			}
+			_update_sync_props();
 			return true;
 		} else if (what == "spawn") {
 			if ((bool)p_value == prop.spawn) {
@@ -94,16 +95,34 @@ bool SceneReplicationConfig::_get(const StringName &p_name, Variant &r_ret) cons
 		} else if (what == "spawn") {
 			r_ret = prop.spawn;
 			return true;
+		} else if (what == "quantization") {
+			r_ret = prop.quantization;
+			return true;
 		}
 	}
 	return false;
 }
 
 void SceneReplicationConfig::_get_property_list(List<PropertyInfo> *p_list) const {
-	for (int i = 0; i < properties.size(); i++) {
+	int i = 0;
+	for (const ReplicationProperty &prop : properties) {
 		p_list->push_back(PropertyInfo(Variant::STRING, "properties/" + itos(i) + "/path", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::STRING, "properties/" + itos(i) + "/spawn", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
 		p_list->push_back(PropertyInfo(Variant::STRING, "properties/" + itos(i) + "/sync", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_NO_EDITOR | PROPERTY_USAGE_INTERNAL));
+		// Only stored when set, so existing scenes keep saving the same properties.
+		p_list->push_back(PropertyInfo(Variant::FLOAT, "properties/" + itos(i) + "/quantization", PROPERTY_HINT_NONE, "", (prop.quantization != 0.0 ? PROPERTY_USAGE_NO_EDITOR : PROPERTY_USAGE_NONE) | PROPERTY_USAGE_INTERNAL));
+		i++;
+	}
+}
+
+void SceneReplicationConfig::_update_sync_props() {
+	sync_props.clear();
+	sync_quantization.clear();
+	for (const ReplicationProperty &prop : properties) {
+		if (prop.sync) {
+			sync_props.push_back(prop.name);
+			sync_quantization.push_back(prop.quantization);
+		}
 	}
 }
 
@@ -121,6 +140,7 @@ void SceneReplicationConfig::add_property(const NodePath &p_path, int p_index) {
 	if (p_index < 0 || p_index == properties.size()) {
 		properties.push_back(ReplicationProperty(p_path));
 		sync_props.push_back(p_path);
+		sync_quantization.push_back(0.0);
 		spawn_props.push_back(p_path);
 		return;
 	}
@@ -134,12 +154,9 @@ void SceneReplicationConfig::add_property(const NodePath &p_path, int p_index) {
 		c++;
 	}
 	properties.insert_before(I, ReplicationProperty(p_path));
-	sync_props.clear();
+	_update_sync_props();
 	spawn_props.clear();
 	for (const ReplicationProperty &prop : properties) {
-		if (prop.sync) {
-			sync_props.push_back(prop.name);
-		}
 		if (prop.spawn) {
 			spawn_props.push_back(prop.name);
 		}
@@ -148,7 +165,7 @@ void SceneReplicationConfig::add_property(const NodePath &p_path, int p_index) {
 
 void SceneReplicationConfig::remove_property(const NodePath &p_path) {
 	properties.erase(p_path);
-	sync_props.erase(p_path);
+	_update_sync_props();
 	spawn_props.erase(p_path);
 }
 
@@ -204,12 +221,24 @@ void SceneReplicationConfig::property_set_sync(const NodePath &p_path, bool p_en
 		return;
 	}
 	E->get().sync = p_enabled;
-	sync_props.clear();
-	for (const ReplicationProperty &prop : properties) {
-		if (prop.sync) {
-			sync_props.push_back(prop.name);
-		}
+	_update_sync_props();
+}
+
+real_t SceneReplicationConfig::property_get_quantization(const NodePath &p_path) {
+	List<ReplicationProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND_V(!E, 0.0);
+	return E->get().quantization;
+}
+
+void SceneReplicationConfig::property_set_quantization(const NodePath &p_path, real_t p_step) {
+	ERR_FAIL_COND_MSG(p_step < 0, "The quantization step can't be negative.");
+	List<ReplicationProperty>::Element *E = properties.find(p_path);
+	ERR_FAIL_COND(!E);
+	if (E->get().quantization == p_step) {
+		return;
 	}
+	E->get().quantization = p_step;
+	_update_sync_props();
 }
 
 void SceneReplicationConfig::_bind_methods() {
@@ -222,4 +251,6 @@ void SceneReplicationConfig::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("property_set_spawn", "path", "enabled"), &SceneReplicationConfig::property_set_spawn);
 	ClassDB::bind_method(D_METHOD("property_get_sync", "path"), &SceneReplicationConfig::property_get_sync);
 	ClassDB::bind_method(D_METHOD("property_set_sync", "path", "enabled"), &SceneReplicationConfig::property_set_sync);
+	ClassDB::bind_method(D_METHOD("property_get_quantization", "path"), &SceneReplicationConfig::property_get_quantization);
+	ClassDB::bind_method(D_METHOD("property_set_quantization", "path", "step"), &SceneReplicationConfig::property_set_quantization);
 }
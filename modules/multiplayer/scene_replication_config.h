@@ -45,6 +45,7 @@ private:
 		NodePath name;
 		bool spawn = true;
 		bool sync = true;
+		real_t quantization = 0.0;
 
 		bool operator==(const ReplicationProperty &p_to) {
 			return name == p_to.name;
@@ -60,6 +61,9 @@ private:
 	List<ReplicationProperty> properties;
 	List<NodePath> spawn_props;
 	List<NodePath> sync_props;
+	Vector<real_t> sync_quantization;
+
+	void _update_sync_props();
 
 protected:
 	static void _bind_methods();
@@ -82,8 +86,12 @@ public:
 	bool property_get_sync(const NodePath &p_path);
 	void property_set_sync(const NodePath &p_path, bool p_enabled);
 
+	real_t property_get_quantization(const NodePath &p_path);
+	void property_set_quantization(const NodePath &p_path, real_t p_step);
+
 	const List<NodePath> &get_spawn_properties() { return spawn_props; }
 	const List<NodePath> &get_sync_properties() { return sync_props; }
+	const Vector<real_t> &get_sync_quantization() { return sync_quantization; } // Same order as the sync properties.
 
 	SceneReplicationConfig() {}
 };
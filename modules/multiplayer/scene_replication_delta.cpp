@@ -0,0 +1,285 @@
+/**************************************************************************/
+/*  scene_replication_delta.cpp                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "scene_replication_delta.h"
+
+#include "scene/main/multiplayer_api.h"
+
+int SceneReplicationDelta::_get_component_count(Variant::Type p_type) {
+	switch (p_type) {
+		case Variant::FLOAT:
+			return 1;
+		case Variant::VECTOR2:
+			return 2;
+		case Variant::VECTOR3:
+			return 3;
+		case Variant::VECTOR4:
+		case Variant::QUATERNION:
+			return 4;
+		default:
+			return 0; // Not quantized.
+	}
+}
+
+int SceneReplicationDelta::_get_components(const Variant &p_value, double *r_components) {
+	switch (p_value.get_type()) {
+		case Variant::FLOAT: {
+			r_components[0] = p_value;
+			return 1;
+		}
+		case Variant::VECTOR2: {
+			const Vector2 v = p_value;
+			r_components[0] = v.x;
+			r_components[1] = v.y;
+			return 2;
+		}
+		case Variant::VECTOR3: {
+			const Vector3 v = p_value;
+			r_components[0] = v.x;
+			r_components[1] = v.y;
+			r_components[2] = v.z;
+			return 3;
+		}
+		case Variant::VECTOR4: {
+			const Vector4 v = p_value;
+			r_components[0] = v.x;
+			r_components[1] = v.y;
+			r_components[2] = v.z;
+			r_components[3] = v.w;
+			return 4;
+		}
+		case Variant::QUATERNION: {
+			const Quaternion q = p_value;
+			r_components[0] = q.x;
+			r_components[1] = q.y;
+			r_components[2] = q.z;
+			r_components[3] = q.w;
+			return 4;
+		}
+		default: {
+			return 0; // Not quantized.
+		}
+	}
+}
+
+Variant SceneReplicationDelta::_make_value(Variant::Type p_type, const double *p_components) {
+	switch (p_type) {
+		case Variant::FLOAT:
+			return p_components[0];
+		case Variant::VECTOR2:
+			return Vector2(p_components[0], p_components[1]);
+		case Variant::VECTOR3:
+			return Vector3(p_components[0], p_components[1], p_components[2]);
+		case Variant::VECTOR4:
+			return Vector4(p_components[0], p_components[1], p_components[2], p_components[3]);
+		case Variant::QUATERNION:
+			return Quaternion(p_components[0], p_components[1], p_components[2], p_components[3]);
+		default:
+			ERR_FAIL_V(Variant());
+	}
+}
+
+int64_t SceneReplicationDelta::_quantize(double p_value, real_t p_step) {
+	// Keep the result exact once converted back to a double, this also takes care of infinities.
+	const double limit = double(1LL << 52);
+	const double steps = Math::round(p_value / p_step);
+	if (Math::is_nan(steps)) {
+		return 0;
+	}
+	return int64_t(CLAMP(steps, -limit, limit));
+}
+
+int SceneReplicationDelta::_encode_zigzag(int64_t p_value, uint8_t *p_buffer) {
+	uint64_t value = (uint64_t(p_value) << 1) ^ uint64_t(p_value >> 63);
+	int len = 0;
+	do {
+		uint8_t byte = value & 0x7F;
+		value >>= 7;
+		if (value) {
+			byte |= 0x80;
+		}
+		if (p_buffer) {
+			p_buffer[len] = byte;
+		}
+		len++;
+	} while (value);
+	return len;
+}
+
+int SceneReplicationDelta::_decode_zigzag(const uint8_t *p_buffer, int p_len, int64_t &r_value) {
+	uint64_t value = 0;
+	for (int i = 0; i < p_len && i < 10; i++) {
+		value |= uint64_t(p_buffer[i] & 0x7F) << (7 * i);
+		if (!(p_buffer[i] & 0x80)) {
+			r_value = int64_t(value >> 1) ^ -int64_t(value & 1);
+			return i + 1;
+		}
+	}
+	return 0; // Truncated.
+}
+
+void SceneReplicationDelta::quantize_state(Vector<Variant> &r_state, const Vector<real_t> &p_quantization) {
+	ERR_FAIL_COND(r_state.size() != p_quantization.size());
+	for (int i = 0; i < r_state.size(); i++) {
+		const real_t step = p_quantization[i];
+		if (step <= 0) {
+			continue;
+		}
+		double components[4];
+		const int count = _get_components(r_state[i], components);
+		if (!count) {
+			continue;
+		}
+		for (int c = 0; c < count; c++) {
+			components[c] = _quantize(components[c], step) * double(step);
+		}
+		r_state.write[i] = _make_value(r_state[i].get_type(), components);
+	}
+}
+
+void SceneReplicationDelta::normalize_quaternions(Vector<Variant> &r_state, const Vector<real_t> &p_quantization) {
+	ERR_FAIL_COND(r_state.size() != p_quantization.size());
+	for (int i = 0; i < r_state.size(); i++) {
+		if (p_quantization[i] <= 0 || r_state[i].get_type() != Variant::QUATERNION) {
+			continue;
+		}
+		// Quantized components are slightly off the unit length, which rotations expect.
+		const Quaternion q = r_state[i];
+		const real_t length_squared = q.length_squared();
+		if (length_squared == 0) {
+			r_state.write[i] = Quaternion(); // Too coarse a step, there is no rotation left to keep.
+		} else if (!Math::is_equal_approx(length_squared, (real_t)1.0)) {
+			r_state.write[i] = q / Math::sqrt(length_squared);
+		}
+	}
+}
+
+Error SceneReplicationDelta::encode_state(const Vector<Variant> &p_state, const Vector<Variant> *p_baseline, const Vector<real_t> &p_quantization, uint8_t *p_buffer, int &r_len) {
+	const int count = p_state.size();
+	ERR_FAIL_COND_V(p_quantization.size() != count, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(p_baseline && p_baseline->size() != count, ERR_INVALID_PARAMETER);
+
+	const int mask_size = (count + 7) / 8;
+	if (p_buffer) {
+		memset(p_buffer, 0, mask_size);
+	}
+	int ofs = mask_size;
+	for (int i = 0; i < count; i++) {
+		const Variant &value = p_state[i];
+		const Variant *base = p_baseline ? &(*p_baseline)[i] : nullptr;
+		if (base && *base == value) {
+			continue; // Unchanged.
+		}
+		if (p_buffer) {
+			p_buffer[i / 8] |= 1 << (i % 8);
+		}
+
+		const real_t step = p_quantization[i];
+		if (step > 0) {
+			// Quantized properties carry their type, since they are only quantized when it's a supported one.
+			if (p_buffer) {
+				p_buffer[ofs] = value.get_type();
+			}
+			ofs += 1;
+
+			double components[4];
+			const int component_count = _get_components(value, components);
+			if (component_count) {
+				double base_components[4] = { 0, 0, 0, 0 };
+				if (base && base->get_type() == value.get_type()) {
+					_get_components(*base, base_components);
+				}
+				for (int c = 0; c < component_count; c++) {
+					const int64_t delta = _quantize(components[c], step) - _quantize(base_components[c], step);
+					ofs += _encode_zigzag(delta, p_buffer ? &p_buffer[ofs] : nullptr);
+				}
+				continue;
+			}
+		}
+
+		int size = 0;
+		Error err = MultiplayerAPI::encode_and_compress_variant(value, p_buffer ? &p_buffer[ofs] : nullptr, size, false);
+		ERR_FAIL_COND_V(err != OK, err);
+		ofs += size;
+	}
+	r_len = ofs;
+	return OK;
+}
+
+Error SceneReplicationDelta::decode_state(const uint8_t *p_buffer, int p_len, const Vector<Variant> *p_baseline, const Vector<real_t> &p_quantization, Vector<Variant> &r_state) {
+	const int count = p_quantization.size();
+	ERR_FAIL_COND_V(p_baseline && p_baseline->size() != count, ERR_INVALID_PARAMETER);
+
+	const int mask_size = (count + 7) / 8;
+	ERR_FAIL_COND_V(p_len < mask_size, ERR_INVALID_DATA);
+
+	r_state.resize(count);
+	int ofs = mask_size;
+	for (int i = 0; i < count; i++) {
+		const Variant *base = p_baseline ? &(*p_baseline)[i] : nullptr;
+		if (!(p_buffer[i / 8] & (1 << (i % 8)))) {
+			ERR_FAIL_COND_V_MSG(!base, ERR_INVALID_DATA, "Unchanged property in a state without baseline.");
+			r_state.write[i] = *base;
+			continue;
+		}
+
+		const real_t step = p_quantization[i];
+		if (step > 0) {
+			ERR_FAIL_COND_V(ofs >= p_len, ERR_INVALID_DATA);
+			ERR_FAIL_COND_V(p_buffer[ofs] >= Variant::VARIANT_MAX, ERR_INVALID_DATA);
+			const Variant::Type type = Variant::Type(p_buffer[ofs]);
+			ofs += 1;
+
+			const int component_count = _get_component_count(type);
+			if (component_count) {
+				double components[4] = { 0, 0, 0, 0 };
+				if (base && base->get_type() == type) {
+					_get_components(*base, components);
+				}
+				for (int c = 0; c < component_count; c++) {
+					int64_t delta = 0;
+					const int len = _decode_zigzag(&p_buffer[ofs], p_len - ofs, delta);
+					ERR_FAIL_COND_V(len == 0, ERR_INVALID_DATA);
+					ofs += len;
+					components[c] = (_quantize(components[c], step) + delta) * double(step);
+				}
+				r_state.write[i] = _make_value(type, components);
+				continue;
+			}
+		}
+
+		int size = 0;
+		Error err = MultiplayerAPI::decode_and_decompress_variant(r_state.write[i], &p_buffer[ofs], p_len - ofs, &size, false);
+		ERR_FAIL_COND_V(err != OK, err);
+		ofs += size;
+	}
+	ERR_FAIL_COND_V_MSG(ofs != p_len, ERR_INVALID_DATA, "Unexpected data after the state.");
+	return OK;
+}
@@ -0,0 +1,54 @@
+/**************************************************************************/
+/*  scene_replication_delta.h                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SCENE_REPLICATION_DELTA_H
+#define SCENE_REPLICATION_DELTA_H
+
+#include "core/variant/variant.h"
+
+// Encodes synchronizer states as the changes from a state the remote peer already has (the baseline).
+// A bit mask tells which properties changed. Floats, vectors and quaternions with a quantization step are
+// sent as the variable length difference of their quantized components, everything else is sent as a whole.
+class SceneReplicationDelta {
+	static int _get_component_count(Variant::Type p_type);
+	static int _get_components(const Variant &p_value, double *r_components);
+	static Variant _make_value(Variant::Type p_type, const double *p_components);
+	static int64_t _quantize(double p_value, real_t p_step);
+	static int _encode_zigzag(int64_t p_value, uint8_t *p_buffer);
+	static int _decode_zigzag(const uint8_t *p_buffer, int p_len, int64_t &r_value);
+
+public:
+	static void quantize_state(Vector<Variant> &r_state, const Vector<real_t> &p_quantization);
+	static void normalize_quaternions(Vector<Variant> &r_state, const Vector<real_t> &p_quantization);
+	static Error encode_state(const Vector<Variant> &p_state, const Vector<Variant> *p_baseline, const Vector<real_t> &p_quantization, uint8_t *p_buffer, int &r_len);
+	static Error decode_state(const uint8_t *p_buffer, int p_len, const Vector<Variant> *p_baseline, const Vector<real_t> &p_quantization, Vector<Variant> &r_state);
+};
+
+#endif // SCENE_REPLICATION_DELTA_H
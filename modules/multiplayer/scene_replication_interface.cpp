@@ -31,9 +31,13 @@
 #include "scene_replication_interface.h"
 
 #include "scene_multiplayer.h"
+#include "scene_replication_delta.h"
 
 #include "core/debugger/engine_debugger.h"
 #include "core/io/marshalls.h"
+#include "core/templates/sort_array.h"
+#include "scene/2d/node_2d.h"
+#include "scene/3d/node_3d.h"
 #include "scene/main/node.h"
 #include "scene/scene_string_names.h"
 
@@ -41,6 +45,11 @@
 	if (packet_cache.size() < m_amount) \
 		packet_cache.resize(m_amount);
 
+#define SYNC_ACK_SHIFT SceneMultiplayer::CMD_FLAG_0_SHIFT
+
+// Flags of each state in a sync packet.
+#define SYNC_FLAG_BASELINE 1 // Encoded as the changes from a state the peer acknowledged.
+
 #ifdef DEBUG_ENABLED
 _FORCE_INLINE_ void SceneReplicationInterface::_profile_node_data(const String &p_what, ObjectID p_id, int p_size) {
 	if (EngineDebugger::is_profiling("multiplayer:replication")) {
@@ -102,6 +111,7 @@ void SceneReplicationInterface::on_peer_change(int p_id, bool p_connected) {
 		ERR_FAIL_COND(!peers_info.has(p_id));
 		_free_remotes(peers_info[p_id]);
 		peers_info.erase(p_id);
+		interest.remove_peer(p_id);
 	}
 }
 
@@ -110,6 +120,7 @@ void SceneReplicationInterface::on_reset() {
 		_free_remotes(E.value);
 	}
 	peers_info.clear();
+	interest.clear();
 	// Tracked nodes are cleared on deletion, here we only reset the ids so they can be later re-assigned.
 	for (KeyValue<ObjectID, TrackedNode> &E : tracked_nodes) {
 		TrackedNode &tobj = E.value;
@@ -138,9 +149,14 @@ void SceneReplicationInterface::on_network_process() {
 		spawn_queue.clear();
 	}
 
+	_update_interest();
+
 	// Process timed syncs.
 	uint64_t msec = OS::get_singleton()->get_ticks_msec();
 	for (KeyValue<int, PeerInfo> &E : peers_info) {
+		if (!E.value.sync_acks.is_empty()) {
+			_send_sync_acks(E.key, E.value);
+		}
 		const HashSet<ObjectID> to_sync = E.value.sync_nodes;
 		if (to_sync.is_empty()) {
 			continue; // Nothing to sync
@@ -280,6 +296,8 @@ Error SceneReplicationInterface::on_replication_stop(Object *p_obj, Variant p_co
 	sync_nodes.erase(sid);
 	for (KeyValue<int, PeerInfo> &E : peers_info) {
 		E.value.sync_nodes.erase(sid);
+		E.value.sync_send_states.erase(sid);
+		E.value.sync_recv_states.erase(sid);
 		if (sync->get_net_id()) {
 			E.value.recv_sync_ids.erase(sync->get_net_id());
 		}
@@ -287,6 +305,42 @@ Error SceneReplicationInterface::on_replication_stop(Object *p_obj, Variant p_co
 	return OK;
 }
 
+void SceneReplicationInterface::_update_interest() {
+	LocalVector<SceneInterestManager::Entry> entries;
+	for (const ObjectID &sid : sync_nodes) {
+		MultiplayerSynchronizer *sync = get_id_as<MultiplayerSynchronizer>(sid);
+		if (!sync || sync->get_interest_radius() <= 0 || !sync->is_multiplayer_authority()) {
+			continue;
+		}
+		SceneInterestManager::Entry entry;
+		Node *node = sync->get_root_node();
+		if (Node3D *node_3d = Object::cast_to<Node3D>(node)) {
+			entry.position = node_3d->get_global_position();
+		} else if (Node2D *node_2d = Object::cast_to<Node2D>(node)) {
+			const Vector2 position = node_2d->get_global_position();
+			entry.position = Vector3(position.x, position.y, 0);
+		} else {
+			continue; // Without a position, it's relevant to everyone.
+		}
+		entry.id = sid;
+		entry.radius = sync->get_interest_radius();
+		entries.push_back(entry);
+	}
+	if (entries.is_empty() && !interest.has_managed()) {
+		return;
+	}
+
+	LocalVector<SceneInterestManager::Change> changes;
+	interest.update(entries, changes);
+	for (const SceneInterestManager::Change &change : changes) {
+		MultiplayerSynchronizer *sync = get_id_as<MultiplayerSynchronizer>(change.id);
+		if (!sync || (change.peer != 0 && !peers_info.has(change.peer))) {
+			continue;
+		}
+		_update_sync_visibility(change.peer, sync);
+	}
+}
+
 void SceneReplicationInterface::_visibility_changed(int p_peer, ObjectID p_sid) {
 	MultiplayerSynchronizer *sync = get_id_as<MultiplayerSynchronizer>(p_sid);
 	ERR_FAIL_COND(!sync); // Bug.
@@ -345,11 +399,11 @@ Error SceneReplicationInterface::_update_sync_visibility(int p_peer, Multiplayer
 	}
 
 	const ObjectID &sid = p_sync->get_instance_id();
-	bool is_visible = p_sync->is_visible_to(p_peer);
 	if (p_peer == 0) {
+		bool is_visible = p_sync->is_visible_to(p_peer);
 		for (KeyValue<int, PeerInfo> &E : peers_info) {
-			// Might be visible to this specific peer.
-			bool is_visible_to_peer = is_visible || p_sync->is_visible_to(E.key);
+			// Might be visible to this specific peer, relevancy is checked first since it's cheaper than filters.
+			bool is_visible_to_peer = interest.is_relevant(E.key, sid) && (is_visible || p_sync->is_visible_to(E.key));
 			if (is_visible_to_peer == E.value.sync_nodes.has(sid)) {
 				continue;
 			}
@@ -357,11 +411,13 @@ Error SceneReplicationInterface::_update_sync_visibility(int p_peer, Multiplayer
 				E.value.sync_nodes.insert(sid);
 			} else {
 				E.value.sync_nodes.erase(sid);
+				E.value.sync_send_states.erase(sid); // The peer might drop the states we could use as baselines.
 			}
 		}
 		return OK;
 	} else {
 		ERR_FAIL_COND_V(!peers_info.has(p_peer), ERR_INVALID_PARAMETER);
+		bool is_visible = interest.is_relevant(p_peer, sid) && p_sync->is_visible_to(p_peer);
 		if (is_visible == peers_info[p_peer].sync_nodes.has(sid)) {
 			return OK;
 		}
@@ -369,6 +425,7 @@ Error SceneReplicationInterface::_update_sync_visibility(int p_peer, Multiplayer
 			peers_info[p_peer].sync_nodes.insert(sid);
 		} else {
 			peers_info[p_peer].sync_nodes.erase(sid);
+			peers_info[p_peer].sync_send_states.erase(sid);
 		}
 		return OK;
 	}
@@ -671,20 +728,47 @@ Error SceneReplicationInterface::on_despawn_receive(int p_from, const uint8_t *p
 }
 
 void SceneReplicationInterface::_send_sync(int p_peer, const HashSet<ObjectID> p_synchronizers, uint16_t p_sync_net_time, uint64_t p_msec) {
+	ERR_FAIL_COND(!peers_info.has(p_peer));
+	PeerInfo &info = peers_info[p_peer];
 	MAKE_ROOM(sync_mtu);
 	uint8_t *ptr = packet_cache.ptrw();
 	ptr[0] = SceneMultiplayer::NETWORK_COMMAND_SYNC;
 	int ofs = 1;
 	ofs += encode_uint16(p_sync_net_time, &ptr[1]);
-	// Can only send updates for already notified nodes.
-	// This is a lazy implementation, we could optimize much more here with by grouping by replication config.
+	SyncPacket *packet = &info.sent_sync_packets[p_sync_net_time % SYNC_HISTORY_SIZE];
+	packet->time = p_sync_net_time;
+	packet->synchronizers.clear();
+	// Collect the synchronizers due for sending. Those which didn't fit in the budget stay pending, and their
+	// priority grows every network process, so they are eventually sent.
+	LocalVector<SyncCandidate> candidates;
 	for (const ObjectID &oid : p_synchronizers) {
 		MultiplayerSynchronizer *sync = get_id_as<MultiplayerSynchronizer>(oid);
 		ERR_CONTINUE(!sync || !sync->get_replication_config().is_valid() || !sync->is_multiplayer_authority());
-		if (!sync->update_outbound_sync_time(p_msec)) {
+		SyncSendState &send_state = info.sync_send_states[oid];
+		if (sync->update_outbound_sync_time(p_msec)) {
+			send_state.pending = true;
+		}
+		if (!send_state.pending) {
 			continue; // nothing to sync.
 		}
+		// Relevant synchronizers closer to the peer get up to twice their priority.
+		send_state.priority += sync->get_replication_priority() * (1.0 + interest.get_proximity(p_peer, oid));
+		SyncCandidate candidate;
+		candidate.id = oid;
+		candidate.priority = send_state.priority;
+		candidates.push_back(candidate);
+	}
+	if (peer_sync_budget > 0) {
+		SortArray<SyncCandidate, SortSyncCandidates> sorter;
+		sorter.sort(candidates.ptr(), candidates.size());
+	}
 
+	// Can only send updates for already notified nodes.
+	// This is a lazy implementation, we could optimize much more here with by grouping by replication config.
+	int budget_left = peer_sync_budget;
+	for (const SyncCandidate &candidate : candidates) {
+		const ObjectID &oid = candidate.id;
+		MultiplayerSynchronizer *sync = get_id_as<MultiplayerSynchronizer>(oid);
 		Node *node = sync->get_root_node();
 		ERR_CONTINUE(!node);
 		uint32_t net_id = sync->get_net_id();
@@ -702,29 +786,68 @@ void SceneReplicationInterface::_send_sync(int p_peer, const HashSet<ObjectID> p
 				continue;
 			}
 		}
-		int size;
 		Vector<Variant> vars;
 		Vector<const Variant *> varp;
-		const List<NodePath> props = sync->get_replication_config()->get_sync_properties();
+		Ref<SceneReplicationConfig> config = sync->get_replication_config();
+		const List<NodePath> &props = config->get_sync_properties();
+		const Vector<real_t> &quantization = config->get_sync_quantization();
 		Error err = MultiplayerSynchronizer::get_state(props, node, vars, varp);
 		ERR_CONTINUE_MSG(err != OK, "Unable to retrieve sync state.");
-		err = MultiplayerAPI::encode_and_compress_variants(varp.ptrw(), varp.size(), nullptr, size);
+		SceneReplicationDelta::quantize_state(vars, quantization);
+
+		// The peer only keeps its last received states, the baseline must still be one of them.
+		SyncSendState &send_state = info.sync_send_states[oid];
+		const bool use_baseline = send_state.has_baseline && send_state.send_count - send_state.baseline.send_index < SYNC_HISTORY_SIZE;
+		if (use_baseline && send_state.baseline.send_index + 1 == send_state.send_count && send_state.baseline.state == vars) {
+			// The peer has our last state, and it didn't change.
+			send_state.pending = false;
+			send_state.priority = 0.0;
+			continue;
+		}
+		const Vector<Variant> *baseline = use_baseline ? &send_state.baseline.state : nullptr;
+
+		int size;
+		err = SceneReplicationDelta::encode_state(vars, baseline, quantization, nullptr, size);
 		ERR_CONTINUE_MSG(err != OK, "Unable to encode sync state.");
+		const int header_size = 4 + 2 + 1 + (use_baseline ? 2 : 0); // Net ID, size, flags, baseline time.
 		// TODO Handle single state above MTU.
-		ERR_CONTINUE_MSG(size > 3 + 4 + 4 + sync_mtu, vformat("Node states bigger then MTU will not be sent (%d > %d): %s", size, sync_mtu, node->get_path()));
-		if (ofs + 4 + 4 + size > sync_mtu) {
+		ERR_CONTINUE_MSG(3 + header_size + size > sync_mtu, vformat("Node states bigger than MTU will not be sent (%d > %d): %s", size, sync_mtu, node->get_path()));
+		if (peer_sync_budget > 0) {
+			if (header_size + size > budget_left && budget_left < peer_sync_budget) {
+				break; // Over budget, at least one state is always sent so large states can't stall.
+			}
+			budget_left -= header_size + size;
+		}
+		if (ofs + header_size + size > sync_mtu) {
 			// Send what we got, and reset write.
 			_send_raw(packet_cache.ptr(), ofs, p_peer, false);
 			ofs = 3;
+			// Each packet gets its own time, so that they can be acknowledged separately.
+			p_sync_net_time = ++info.last_sent_sync;
+			encode_uint16(p_sync_net_time, &ptr[1]);
+			packet = &info.sent_sync_packets[p_sync_net_time % SYNC_HISTORY_SIZE];
+			packet->time = p_sync_net_time;
+			packet->synchronizers.clear();
 		}
-		if (size) {
-			ofs += encode_uint32(sync->get_net_id(), &ptr[ofs]);
-			ofs += encode_uint32(size, &ptr[ofs]);
-			MultiplayerAPI::encode_and_compress_variants(varp.ptrw(), varp.size(), &ptr[ofs], size);
-			ofs += size;
+		ofs += encode_uint32(sync->get_net_id(), &ptr[ofs]);
+		ofs += encode_uint16(header_size - 6 + size, &ptr[ofs]);
+		ptr[ofs++] = use_baseline ? SYNC_FLAG_BASELINE : 0;
+		if (use_baseline) {
+			ofs += encode_uint16(send_state.baseline.time, &ptr[ofs]);
 		}
+		SceneReplicationDelta::encode_state(vars, baseline, quantization, &ptr[ofs], size);
+		ofs += size;
+
+		SyncSnapshot &snapshot = send_state.sent[send_state.send_count % SYNC_HISTORY_SIZE];
+		snapshot.time = p_sync_net_time;
+		snapshot.send_index = send_state.send_count;
+		snapshot.state = vars;
+		send_state.send_count++;
+		send_state.pending = false;
+		send_state.priority = 0.0;
+		packet->synchronizers.push_back(oid);
 #ifdef DEBUG_ENABLED
-		_profile_node_data("sync_out", oid, size);
+		_profile_node_data("sync_out", oid, header_size + size);
 #endif
 	}
 	if (ofs > 3) {
@@ -733,52 +856,171 @@ void SceneReplicationInterface::_send_sync(int p_peer, const HashSet<ObjectID> p
 	}
 }
 
+void SceneReplicationInterface::set_peer_interest_position(int p_peer, const Vector3 &p_position) {
+	interest.set_peer_position(p_peer, p_position);
+}
+
+Vector3 SceneReplicationInterface::get_peer_interest_position(int p_peer) const {
+	return interest.get_peer_position(p_peer);
+}
+
+void SceneReplicationInterface::set_interest_cell_size(real_t p_size) {
+	interest.set_cell_size(p_size);
+}
+
+real_t SceneReplicationInterface::get_interest_cell_size() const {
+	return interest.get_cell_size();
+}
+
+void SceneReplicationInterface::set_peer_sync_budget(int p_bytes) {
+	ERR_FAIL_COND_MSG(p_bytes < 0, "The sync budget must be greater or equal to 0 (where 0 means unlimited).");
+	peer_sync_budget = p_bytes;
+}
+
+int SceneReplicationInterface::get_peer_sync_budget() const {
+	return peer_sync_budget;
+}
+
+void SceneReplicationInterface::_send_sync_acks(int p_peer, PeerInfo &p_info) {
+	// Older packets can't be used as baselines anymore.
+	const uint32_t count = MIN(p_info.sync_acks.size(), (uint32_t)SYNC_HISTORY_SIZE);
+	MAKE_ROOM(2 + 2 * SYNC_HISTORY_SIZE);
+	uint8_t *ptr = packet_cache.ptrw();
+	ptr[0] = SceneMultiplayer::NETWORK_COMMAND_SYNC | (1 << SYNC_ACK_SHIFT);
+	ptr[1] = count;
+	int ofs = 2;
+	for (uint32_t i = p_info.sync_acks.size() - count; i < p_info.sync_acks.size(); i++) {
+		ofs += encode_uint16(p_info.sync_acks[i], &ptr[ofs]);
+	}
+	p_info.sync_acks.clear();
+	_send_raw(packet_cache.ptr(), ofs, p_peer, false);
+}
+
+Error SceneReplicationInterface::_on_sync_ack_receive(int p_from, const uint8_t *p_buffer, int p_buffer_len) {
+	ERR_FAIL_COND_V_MSG(p_buffer_len < 2 || p_buffer_len != 2 + 2 * p_buffer[1], ERR_INVALID_DATA, "Invalid sync acknowledgement received");
+	ERR_FAIL_COND_V(!peers_info.has(p_from), ERR_UNAVAILABLE);
+	PeerInfo &info = peers_info[p_from];
+	for (int i = 0; i < p_buffer[1]; i++) {
+		const uint16_t time = decode_uint16(&p_buffer[2 + 2 * i]);
+		SyncPacket &packet = info.sent_sync_packets[time % SYNC_HISTORY_SIZE];
+		if (packet.time != time) {
+			continue; // Too old.
+		}
+		for (const ObjectID &sid : packet.synchronizers) {
+			SyncSendState *send_state = info.sync_send_states.getptr(sid);
+			if (!send_state) {
+				continue; // Stopped, or no longer visible.
+			}
+			for (uint32_t s = send_state->send_count - MIN(send_state->send_count, (uint32_t)SYNC_HISTORY_SIZE); s < send_state->send_count; s++) {
+				const SyncSnapshot &snapshot = send_state->sent[s % SYNC_HISTORY_SIZE];
+				if (snapshot.time != time) {
+					continue;
+				}
+				if (!send_state->has_baseline || snapshot.send_index > send_state->baseline.send_index) {
+					send_state->baseline = snapshot;
+					send_state->has_baseline = true;
+				}
+				break;
+			}
+		}
+		packet.synchronizers.clear();
+	}
+	return OK;
+}
+
+const SceneReplicationInterface::SyncSnapshot *SceneReplicationInterface::SyncRecvState::find(uint16_t p_time) const {
+	for (uint32_t r = recv_count - MIN(recv_count, (uint32_t)SYNC_HISTORY_SIZE); r < recv_count; r++) {
+		if (received[r % SYNC_HISTORY_SIZE].time == p_time) {
+			return &received[r % SYNC_HISTORY_SIZE];
+		}
+	}
+	return nullptr;
+}
+
 Error SceneReplicationInterface::on_sync_receive(int p_from, const uint8_t *p_buffer, int p_buffer_len) {
-	ERR_FAIL_COND_V_MSG(p_buffer_len < 11, ERR_INVALID_DATA, "Invalid sync packet received");
+	ERR_FAIL_COND_V_MSG(p_buffer_len < 3, ERR_INVALID_DATA, "Invalid sync packet received");
+	if (p_buffer[0] & (1 << SYNC_ACK_SHIFT)) {
+		return _on_sync_ack_receive(p_from, p_buffer, p_buffer_len);
+	}
+	ERR_FAIL_COND_V(!peers_info.has(p_from), ERR_UNAVAILABLE);
+	PeerInfo &info = peers_info[p_from];
 	uint16_t time = decode_uint16(&p_buffer[1]);
+	bool complete = true; // Only acknowledge packets whose states were all kept, since they become baselines.
 	int ofs = 3;
-	while (ofs + 8 < p_buffer_len) {
+	while (ofs + 7 <= p_buffer_len) {
 		uint32_t net_id = decode_uint32(&p_buffer[ofs]);
 		ofs += 4;
-		uint32_t size = decode_uint32(&p_buffer[ofs]);
-		ofs += 4;
-		ERR_FAIL_COND_V(size > uint32_t(p_buffer_len - ofs), ERR_INVALID_DATA);
+		uint16_t size = decode_uint16(&p_buffer[ofs]);
+		ofs += 2;
+		ERR_FAIL_COND_V(size < 1 || size > uint32_t(p_buffer_len - ofs), ERR_INVALID_DATA);
+		const uint8_t *state_buffer = &p_buffer[ofs];
+		ofs += size;
 		MultiplayerSynchronizer *sync = nullptr;
 		if (net_id & 0x80000000) {
 			sync = Object::cast_to<MultiplayerSynchronizer>(multiplayer->get_path_cache()->get_cached_object(p_from, net_id & 0x7FFFFFFF));
-		} else if (peers_info[p_from].recv_sync_ids.has(net_id)) {
-			const ObjectID &sid = peers_info[p_from].recv_sync_ids[net_id];
+		} else if (info.recv_sync_ids.has(net_id)) {
+			const ObjectID &sid = info.recv_sync_ids[net_id];
 			sync = get_id_as<MultiplayerSynchronizer>(sid);
 		}
 		if (!sync) {
 			// Not received yet.
-			ofs += size;
+			complete = false;
 			continue;
 		}
 		Node *node = sync->get_root_node();
 		if (sync->get_multiplayer_authority() != p_from || !node) {
 			// Not valid for me.
-			ofs += size;
+			complete = false;
 			ERR_CONTINUE_MSG(true, "Ignoring sync data from non-authority or for missing node.");
 		}
-		if (!sync->update_inbound_sync_time(time)) {
-			// State is too old.
-			ofs += size;
+
+		SyncRecvState &recv_state = info.sync_recv_states[sync->get_instance_id()];
+		if (recv_state.find(time)) {
+			// Duplicated packet, it was already applied and kept as a possible baseline.
 			continue;
 		}
-		const List<NodePath> props = sync->get_replication_config()->get_sync_properties();
+		const Vector<Variant> *baseline = nullptr;
+		int state_ofs = 1;
+		if (state_buffer[0] & SYNC_FLAG_BASELINE) {
+			ERR_FAIL_COND_V(size < 3, ERR_INVALID_DATA);
+			const SyncSnapshot *baseline_snapshot = recv_state.find(decode_uint16(&state_buffer[1]));
+			state_ofs += 2;
+			if (!baseline_snapshot) {
+				// Dropped it, the sender will go back to full states.
+				complete = false;
+				continue;
+			}
+			baseline = &baseline_snapshot->state;
+		}
+		Ref<SceneReplicationConfig> config = sync->get_replication_config();
+		const List<NodePath> &props = config->get_sync_properties();
+		const Vector<real_t> &quantization = config->get_sync_quantization();
 		Vector<Variant> vars;
-		vars.resize(props.size());
-		int consumed;
-		Error err = MultiplayerAPI::decode_and_decompress_variants(vars, &p_buffer[ofs], size, consumed);
+		Error err = SceneReplicationDelta::decode_state(&state_buffer[state_ofs], size - state_ofs, baseline, quantization, vars);
 		ERR_FAIL_COND_V(err, err);
+
+		// Keep the state even when it's too old to apply, the sender might use it as a baseline.
+		SyncSnapshot &snapshot = recv_state.received[recv_state.recv_count % SYNC_HISTORY_SIZE];
+		snapshot.time = time;
+		snapshot.send_index = recv_state.recv_count;
+		snapshot.state = vars;
+		recv_state.recv_count++;
+
+		if (!sync->update_inbound_sync_time(time)) {
+			// State is too old.
+			continue;
+		}
+		// Only applied states are normalized, baselines must stay exactly as the sender encoded them.
+		SceneReplicationDelta::normalize_quaternions(vars, quantization);
 		err = MultiplayerSynchronizer::set_state(props, node, vars);
 		ERR_FAIL_COND_V(err, err);
-		ofs += size;
 		sync->emit_signal(SNAME("synchronized"));
 #ifdef DEBUG_ENABLED
 		_profile_node_data("sync_in", sync->get_instance_id(), size);
 #endif
 	}
+	if (complete) {
+		info.sync_acks.push_back(time);
+	}
 	return OK;
 }
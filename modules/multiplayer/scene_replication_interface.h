@@ -35,6 +35,7 @@
 
 #include "multiplayer_spawner.h"
 #include "multiplayer_synchronizer.h"
+#include "scene_interest_manager.h"
 
 class SceneMultiplayer;
 
@@ -59,12 +60,62 @@ private:
 		}
 	};
 
+	enum {
+		SYNC_HISTORY_SIZE = 16, // How many sent states stay usable as delta baselines.
+	};
+
+	struct SyncSnapshot {
+		uint16_t time = 0;
+		uint32_t send_index = 0;
+		Vector<Variant> state;
+	};
+
+	// The states of a synchronizer sent to one peer.
+	struct SyncSendState {
+		SyncSnapshot sent[SYNC_HISTORY_SIZE]; // Indexed by send_index % SYNC_HISTORY_SIZE.
+		uint32_t send_count = 0;
+		SyncSnapshot baseline; // The newest state acknowledged by the peer.
+		bool has_baseline = false;
+		bool pending = false; // Due for sending, but might be delayed by the sync budget.
+		real_t priority = 0.0; // Grows while pending, the highest priorities are sent first.
+	};
+
+	// The states of a synchronizer received from one peer, deltas refer to them.
+	struct SyncRecvState {
+		SyncSnapshot received[SYNC_HISTORY_SIZE];
+		uint32_t recv_count = 0;
+
+		const SyncSnapshot *find(uint16_t p_time) const;
+	};
+
+	struct SyncPacket {
+		uint16_t time = 0;
+		LocalVector<ObjectID> synchronizers;
+	};
+
+	struct SyncCandidate {
+		ObjectID id;
+		real_t priority = 0.0;
+	};
+
+	struct SortSyncCandidates {
+		_FORCE_INLINE_ bool operator()(const SyncCandidate &p_a, const SyncCandidate &p_b) const {
+			return p_a.priority > p_b.priority; // Highest priority first.
+		}
+	};
+
 	struct PeerInfo {
 		HashSet<ObjectID> sync_nodes;
 		HashSet<ObjectID> spawn_nodes;
 		HashMap<uint32_t, ObjectID> recv_sync_ids;
 		HashMap<uint32_t, ObjectID> recv_nodes;
 		uint16_t last_sent_sync = 0;
+
+		// Delta compression.
+		HashMap<ObjectID, SyncSendState> sync_send_states;
+		HashMap<ObjectID, SyncRecvState> sync_recv_states;
+		SyncPacket sent_sync_packets[SYNC_HISTORY_SIZE]; // Indexed by time % SYNC_HISTORY_SIZE, to apply acknowledgements.
+		LocalVector<uint16_t> sync_acks; // Received sync packets to acknowledge.
 	};
 
 	// Replication state.
@@ -88,16 +139,23 @@ private:
 	SceneMultiplayer *multiplayer = nullptr;
 	PackedByteArray packet_cache;
 	int sync_mtu = 1350; // Highly dependent on underlying protocol.
+	int peer_sync_budget = 0; // Bytes of sync state per peer and network process, 0 means unlimited.
+
+	// Spatial relevancy of synchronizers with an interest radius.
+	SceneInterestManager interest;
 
 	TrackedNode &_track(const ObjectID &p_id);
 	void _untrack(const ObjectID &p_id);
 	void _node_ready(const ObjectID &p_oid);
 
 	void _send_sync(int p_peer, const HashSet<ObjectID> p_synchronizers, uint16_t p_sync_net_time, uint64_t p_msec);
+	void _send_sync_acks(int p_peer, PeerInfo &p_info);
+	Error _on_sync_ack_receive(int p_from, const uint8_t *p_buffer, int p_buffer_len);
 	Error _make_spawn_packet(Node *p_node, MultiplayerSpawner *p_spawner, int &r_len);
 	Error _make_despawn_packet(Node *p_node, int &r_len);
 	Error _send_raw(const uint8_t *p_buffer, int p_size, int p_peer, bool p_reliable);
 
+	void _update_interest();
 	void _visibility_changed(int p_peer, ObjectID p_oid);
 	Error _update_sync_visibility(int p_peer, MultiplayerSynchronizer *p_sync);
 	Error _update_spawn_visibility(int p_peer, const ObjectID &p_oid);
@@ -130,6 +188,13 @@ public:
 
 	bool is_rpc_visible(const ObjectID &p_oid, int p_peer) const;
 
+	void set_peer_interest_position(int p_peer, const Vector3 &p_position);
+	Vector3 get_peer_interest_position(int p_peer) const;
+	void set_interest_cell_size(real_t p_size);
+	real_t get_interest_cell_size() const;
+	void set_peer_sync_budget(int p_bytes);
+	int get_peer_sync_budget() const;
+
 	SceneReplicationInterface(SceneMultiplayer *p_multiplayer) {
 		multiplayer = p_multiplayer;
 	}
@@ -0,0 +1,132 @@
+/**************************************************************************/
+/*  multiplayer_peer_mock.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef MULTIPLAYER_PEER_MOCK_H
+#define MULTIPLAYER_PEER_MOCK_H
+
+#include "scene/main/multiplayer_peer.h"
+
+#include "core/templates/list.h"
+#include "core/templates/local_vector.h"
+
+// Specialized MultiplayerPeer for unittests, delivering packets directly to a linked mock.
+// It keeps every packet it sent so they can be inspected, and it can drop or duplicate the
+// unreliable ones to simulate a lossy network.
+class MultiplayerPeerMock : public MultiplayerPeer {
+public:
+	struct Packet {
+		int from = 0;
+		int to = 0;
+		TransferMode mode = TRANSFER_MODE_RELIABLE;
+		int channel = 0;
+		Vector<uint8_t> data;
+	};
+
+private:
+	int unique_id = 0;
+	int target_peer = 0;
+	MultiplayerPeerMock *remote = nullptr;
+	List<Packet> incoming;
+	Packet current; // The buffer returned by get_packet must stay valid until the next call.
+
+public:
+	LocalVector<Packet> sent; // Also keeps the dropped ones.
+	bool drop_unreliable = false;
+	bool duplicate_unreliable = false;
+
+	// Links both mocks and notifies each one of the other, must be called after assigning them to their multiplayer.
+	static void link(MultiplayerPeerMock *p_first, MultiplayerPeerMock *p_second) {
+		p_first->remote = p_second;
+		p_second->remote = p_first;
+		p_first->emit_signal(SNAME("peer_connected"), p_second->unique_id);
+		p_second->emit_signal(SNAME("peer_connected"), p_first->unique_id);
+	}
+
+	// Delivers a packet as if the linked mock had sent it.
+	void receive(const Vector<uint8_t> &p_data, TransferMode p_mode = TRANSFER_MODE_RELIABLE, int p_channel = 0) {
+		ERR_FAIL_NULL(remote);
+		Packet packet;
+		packet.from = remote->unique_id;
+		packet.to = unique_id;
+		packet.mode = p_mode;
+		packet.channel = p_channel;
+		packet.data = p_data;
+		incoming.push_back(packet);
+	}
+
+	virtual int get_available_packet_count() const override { return incoming.size(); }
+	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size) override {
+		ERR_FAIL_COND_V(incoming.is_empty(), ERR_UNAVAILABLE);
+		current = incoming.front()->get();
+		incoming.pop_front();
+		*r_buffer = current.data.ptr();
+		r_buffer_size = current.data.size();
+		return OK;
+	}
+	virtual Error put_packet(const uint8_t *p_buffer, int p_buffer_size) override {
+		ERR_FAIL_NULL_V(remote, ERR_UNCONFIGURED);
+		Packet packet;
+		packet.from = unique_id;
+		packet.to = target_peer;
+		packet.mode = get_transfer_mode();
+		packet.channel = get_transfer_channel();
+		packet.data.resize(p_buffer_size);
+		memcpy(packet.data.ptrw(), p_buffer, p_buffer_size);
+		sent.push_back(packet);
+		if (packet.mode != TRANSFER_MODE_RELIABLE) {
+			if (drop_unreliable) {
+				return OK;
+			}
+			if (duplicate_unreliable) {
+				remote->incoming.push_back(packet);
+			}
+		}
+		remote->incoming.push_back(packet);
+		return OK;
+	}
+	virtual int get_max_packet_size() const override { return 1 << 24; }
+
+	virtual void set_target_peer(int p_peer_id) override { target_peer = p_peer_id; }
+	virtual int get_packet_peer() const override { return incoming.is_empty() ? 0 : incoming.front()->get().from; }
+	virtual TransferMode get_packet_mode() const override { return incoming.is_empty() ? TRANSFER_MODE_RELIABLE : incoming.front()->get().mode; }
+	virtual int get_packet_channel() const override { return incoming.is_empty() ? 0 : incoming.front()->get().channel; }
+	virtual void disconnect_peer(int p_peer, bool p_force = false) override {}
+	virtual bool is_server() const override { return unique_id == TARGET_PEER_SERVER; }
+	virtual void poll() override {}
+	virtual void close() override {}
+	virtual int get_unique_id() const override { return unique_id; }
+	virtual ConnectionStatus get_connection_status() const override { return CONNECTION_CONNECTED; }
+
+	MultiplayerPeerMock(int p_unique_id) {
+		unique_id = p_unique_id;
+	}
+};
+
+#endif // MULTIPLAYER_PEER_MOCK_H
@@ -0,0 +1,194 @@
+/**************************************************************************/
+/*  test_scene_interest_manager.h                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SCENE_INTEREST_MANAGER_H
+#define TEST_SCENE_INTEREST_MANAGER_H
+
+#include "modules/multiplayer/scene_interest_manager.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSceneInterestManager {
+
+static SceneInterestManager::Entry make_entry(uint64_t p_id, const Vector3 &p_position, real_t p_radius) {
+	SceneInterestManager::Entry entry;
+	entry.id = ObjectID(p_id);
+	entry.position = p_position;
+	entry.radius = p_radius;
+	return entry;
+}
+
+static bool has_change(const LocalVector<SceneInterestManager::Change> &p_changes, int p_peer, uint64_t p_id) {
+	for (const SceneInterestManager::Change &change : p_changes) {
+		if (change.peer == p_peer && change.id == ObjectID(p_id)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+TEST_CASE("[Multiplayer][SceneInterestManager] Relevancy by distance") {
+	SceneInterestManager interest;
+	interest.set_cell_size(10);
+	interest.set_peer_position(2, Vector3(0, 0, 0));
+	interest.set_peer_position(3, Vector3(-100, 0, 50));
+
+	LocalVector<SceneInterestManager::Entry> entries;
+	entries.push_back(make_entry(1, Vector3(5, 0, 0), 8));
+	entries.push_back(make_entry(2, Vector3(-95, 0, 48), 8));
+	entries.push_back(make_entry(3, Vector3(30, 0, 0), 8));
+
+	LocalVector<SceneInterestManager::Change> changes;
+	interest.update(entries, changes);
+
+	CHECK(interest.is_relevant(2, ObjectID(uint64_t(1))));
+	CHECK_FALSE(interest.is_relevant(2, ObjectID(uint64_t(2))));
+	CHECK_FALSE(interest.is_relevant(2, ObjectID(uint64_t(3))));
+	CHECK_FALSE(interest.is_relevant(3, ObjectID(uint64_t(1))));
+	CHECK(interest.is_relevant(3, ObjectID(uint64_t(2))));
+	CHECK_FALSE(interest.is_relevant(4, ObjectID(uint64_t(1)))); // Peers without a position.
+	CHECK(interest.is_relevant(2, ObjectID(uint64_t(42)))); // Unmanaged objects.
+
+	// Newly managed objects change for every peer, then for the peers they became relevant to.
+	CHECK(has_change(changes, 0, 1));
+	CHECK(has_change(changes, 0, 3));
+	CHECK(has_change(changes, 2, 1));
+	CHECK(has_change(changes, 3, 2));
+	CHECK_FALSE(has_change(changes, 2, 3));
+
+	CHECK(interest.get_proximity(2, ObjectID(uint64_t(1))) == doctest::Approx(1.0 - 5.0 / 8.0));
+	CHECK(interest.get_proximity(2, ObjectID(uint64_t(3))) == doctest::Approx(0.0));
+}
+
+TEST_CASE("[Multiplayer][SceneInterestManager] Changes when moving") {
+	SceneInterestManager interest;
+	interest.set_cell_size(10);
+	interest.set_peer_position(2, Vector3());
+
+	LocalVector<SceneInterestManager::Entry> entries;
+	entries.push_back(make_entry(1, Vector3(5, 5, 5), 10));
+	LocalVector<SceneInterestManager::Change> changes;
+	interest.update(entries, changes);
+	CHECK(interest.is_relevant(2, ObjectID(uint64_t(1))));
+
+	// No changes when nothing moved.
+	changes.clear();
+	interest.update(entries, changes);
+	CHECK(changes.is_empty());
+
+	// Peer moves away.
+	interest.set_peer_position(2, Vector3(0, -50, 0));
+	changes.clear();
+	interest.update(entries, changes);
+	CHECK(changes.size() == 1);
+	CHECK(has_change(changes, 2, 1));
+	CHECK_FALSE(interest.is_relevant(2, ObjectID(uint64_t(1))));
+
+	// Object follows the peer.
+	entries[0].position = Vector3(0, -45, 0);
+	changes.clear();
+	interest.update(entries, changes);
+	CHECK(changes.size() == 1);
+	CHECK(interest.is_relevant(2, ObjectID(uint64_t(1))));
+
+	// Object stops being managed.
+	entries.clear();
+	changes.clear();
+	interest.update(entries, changes);
+	CHECK(has_change(changes, 0, 1));
+	CHECK(has_change(changes, 2, 1));
+	CHECK(interest.is_relevant(2, ObjectID(uint64_t(1))));
+}
+
+TEST_CASE("[Multiplayer][SceneInterestManager] Radius larger than cells") {
+	SceneInterestManager interest;
+	interest.set_cell_size(1);
+	interest.set_peer_position(2, Vector3(-3.5, 2.5, 0));
+
+	LocalVector<SceneInterestManager::Entry> entries;
+	for (int i = 0; i < 20; i++) {
+		entries.push_back(make_entry(i + 1, Vector3(i * 10 - 100, 0, 0), 50));
+	}
+	LocalVector<SceneInterestManager::Change> changes;
+	interest.update(entries, changes);
+	for (const SceneInterestManager::Entry &entry : entries) {
+		CHECK(interest.is_relevant(2, entry.id) == (entry.position.distance_to(Vector3(-3.5, 2.5, 0)) <= 50));
+	}
+}
+
+TEST_CASE("[Multiplayer][SceneInterestManager] Many cells") {
+	SceneInterestManager interest;
+	interest.set_cell_size(10);
+	const Vector3 peer_position = Vector3(-33, 4, 17);
+	interest.set_peer_position(2, peer_position);
+
+	LocalVector<SceneInterestManager::Entry> entries;
+	for (int x = -5; x < 5; x++) {
+		for (int z = -5; z < 5; z++) {
+			entries.push_back(make_entry(entries.size() + 1, Vector3(x * 7.5, 0, z * 7.5), 9));
+		}
+	}
+	LocalVector<SceneInterestManager::Change> changes;
+	interest.update(entries, changes);
+	int relevant_count = 0;
+	for (const SceneInterestManager::Entry &entry : entries) {
+		const bool expected = entry.position.distance_to(peer_position) <= 9;
+		CHECK(interest.is_relevant(2, entry.id) == expected);
+		relevant_count += expected ? 1 : 0;
+	}
+	CHECK(relevant_count > 0);
+}
+
+TEST_CASE("[Multiplayer][SceneInterestManager] Objects on a plane") {
+	// Like in 2D, every object is in the same layer of cells, while their radius spans many cells.
+	SceneInterestManager interest;
+	interest.set_cell_size(1);
+	const Vector3 on_plane = Vector3(2.5, -4.5, 0);
+	const Vector3 above_plane = Vector3(-6.5, 3.5, 6);
+	interest.set_peer_position(2, on_plane);
+	interest.set_peer_position(3, above_plane);
+
+	LocalVector<SceneInterestManager::Entry> entries;
+	for (int x = -15; x < 15; x++) {
+		for (int y = -15; y < 15; y++) {
+			entries.push_back(make_entry(entries.size() + 1, Vector3(x + 0.5, y + 0.5, 0), 10));
+		}
+	}
+	LocalVector<SceneInterestManager::Change> changes;
+	interest.update(entries, changes);
+	for (const SceneInterestManager::Entry &entry : entries) {
+		CHECK(interest.is_relevant(2, entry.id) == (entry.position.distance_to(on_plane) <= 10));
+		CHECK(interest.is_relevant(3, entry.id) == (entry.position.distance_to(above_plane) <= 10));
+	}
+}
+
+} // namespace TestSceneInterestManager
+
+#endif // TEST_SCENE_INTEREST_MANAGER_H
@@ -0,0 +1,242 @@
+/**************************************************************************/
+/*  test_scene_multiplayer.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SCENE_MULTIPLAYER_H
+#define TEST_SCENE_MULTIPLAYER_H
+
+#include "modules/multiplayer/scene_multiplayer.h"
+#include "modules/multiplayer/tests/multiplayer_peer_mock.h"
+
+#include "core/io/marshalls.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSceneMultiplayer {
+
+// A server batching what it sends to a client.
+struct BatchTest {
+	Ref<MultiplayerPeerMock> server_peer;
+	Ref<MultiplayerPeerMock> client_peer;
+	Ref<SceneMultiplayer> server;
+	Ref<SceneMultiplayer> client;
+
+	BatchTest() {
+		server.instantiate();
+		client.instantiate();
+		server->set_root_path(NodePath("/root"));
+		client->set_root_path(NodePath("/root"));
+		server->set_packet_batching_enabled(true);
+		server_peer = Ref<MultiplayerPeerMock>(memnew(MultiplayerPeerMock(1)));
+		client_peer = Ref<MultiplayerPeerMock>(memnew(MultiplayerPeerMock(2)));
+		server->set_multiplayer_peer(server_peer);
+		client->set_multiplayer_peer(client_peer);
+		MultiplayerPeerMock::link(server_peer.ptr(), client_peer.ptr());
+		SIGNAL_WATCH(client.ptr(), "peer_packet");
+	}
+
+	~BatchTest() {
+		SIGNAL_UNWATCH(client.ptr(), "peer_packet");
+	}
+};
+
+static Vector<uint8_t> make_bytes(int p_size, uint8_t p_first) {
+	Vector<uint8_t> bytes;
+	bytes.resize(p_size);
+	for (int i = 0; i < p_size; i++) {
+		bytes.write[i] = p_first + i;
+	}
+	return bytes;
+}
+
+// The arguments of the "peer_packet" signals emitted for the given raw messages.
+static Array make_signals(const Vector<Vector<uint8_t>> &p_messages) {
+	Array signals;
+	for (const Vector<uint8_t> &message : p_messages) {
+		Array args;
+		args.push_back(1);
+		args.push_back(message);
+		signals.push_back(args);
+	}
+	return signals;
+}
+
+// A batch frame, with the given count of messages and then each message prefixed by its size.
+static Vector<uint8_t> make_batch(uint32_t p_count, const Vector<Vector<uint8_t>> &p_messages) {
+	Vector<uint8_t> batch;
+	batch.resize(SceneMultiplayer::SYS_CMD_SIZE);
+	batch.write[0] = SceneMultiplayer::NETWORK_COMMAND_SYS;
+	batch.write[1] = SceneMultiplayer::SYS_COMMAND_BATCH;
+	encode_uint32(p_count, &batch.write[2]);
+	for (const Vector<uint8_t> &message : p_messages) {
+		const int ofs = batch.size();
+		batch.resize(ofs + 2 + message.size());
+		encode_uint16(message.size(), &batch.write[ofs]);
+		memcpy(&batch.write[ofs + 2], message.ptr(), message.size());
+	}
+	return batch;
+}
+
+static Vector<uint8_t> make_raw(const Vector<uint8_t> &p_bytes) {
+	Vector<uint8_t> raw;
+	raw.push_back(SceneMultiplayer::NETWORK_COMMAND_RAW);
+	raw.append_array(p_bytes);
+	return raw;
+}
+
+TEST_CASE("[Multiplayer][SceneMultiplayer] Packet batching") {
+	Ref<SceneMultiplayer> multiplayer;
+	multiplayer.instantiate();
+	CHECK_FALSE_MESSAGE(multiplayer->is_packet_batching_enabled(), "Batching should be opt-in.");
+
+	BatchTest test;
+	const Vector<Vector<uint8_t>> messages = { make_bytes(10, 0), make_bytes(1, 100), make_bytes(300, 50) };
+
+	SUBCASE("Messages are framed together") {
+		for (const Vector<uint8_t> &message : messages) {
+			CHECK(test.server->send_bytes(message, 2) == OK);
+		}
+		CHECK_MESSAGE(test.server_peer->sent.is_empty(), "Messages should wait for the next poll.");
+		test.server->poll();
+		REQUIRE(test.server_peer->sent.size() == 1);
+
+		const Vector<uint8_t> &batch = test.server_peer->sent[0].data;
+		CHECK(batch == make_batch(3, { make_raw(messages[0]), make_raw(messages[1]), make_raw(messages[2]) }));
+		CHECK(test.server_peer->sent[0].to == 2);
+
+		test.client->poll();
+		SIGNAL_CHECK("peer_packet", make_signals(messages));
+	}
+
+	SUBCASE("Single messages are not framed") {
+		CHECK(test.server->send_bytes(messages[0], 2) == OK);
+		test.server->poll();
+		REQUIRE(test.server_peer->sent.size() == 1);
+		CHECK(test.server_peer->sent[0].data == make_raw(messages[0]));
+
+		test.client->poll();
+		SIGNAL_CHECK("peer_packet", make_signals({ messages[0] }));
+	}
+
+	SUBCASE("Channels and transfer modes are batched separately") {
+		CHECK(test.server->send_bytes(messages[0], 2, MultiplayerPeer::TRANSFER_MODE_RELIABLE, 0) == OK);
+		CHECK(test.server->send_bytes(messages[1], 2, MultiplayerPeer::TRANSFER_MODE_UNRELIABLE, 0) == OK);
+		CHECK(test.server->send_bytes(messages[2], 2, MultiplayerPeer::TRANSFER_MODE_RELIABLE, 1) == OK);
+		test.server->poll();
+		REQUIRE(test.server_peer->sent.size() == 3);
+		for (const MultiplayerPeerMock::Packet &packet : test.server_peer->sent) {
+			CHECK(packet.data[0] == SceneMultiplayer::NETWORK_COMMAND_RAW);
+			if (packet.mode == MultiplayerPeer::TRANSFER_MODE_UNRELIABLE) {
+				CHECK(packet.data == make_raw(messages[1]));
+			} else if (packet.channel == 1) {
+				CHECK(packet.data == make_raw(messages[2]));
+			} else {
+				CHECK(packet.data == make_raw(messages[0]));
+			}
+		}
+	}
+
+	SUBCASE("Oversize messages keep their order") {
+		const Vector<uint8_t> oversize = make_bytes(2000, 0);
+		CHECK(test.server->send_bytes(messages[0], 2) == OK);
+		CHECK(test.server->send_bytes(oversize, 2) == OK);
+		// Pending messages are sent first, then the oversize one directly.
+		REQUIRE(test.server_peer->sent.size() == 2);
+		CHECK(test.server_peer->sent[0].data == make_raw(messages[0]));
+		CHECK(test.server_peer->sent[1].data == make_raw(oversize));
+
+		CHECK(test.server->send_bytes(messages[1], 2) == OK);
+		test.server->poll();
+		REQUIRE(test.server_peer->sent.size() == 3);
+		CHECK(test.server_peer->sent[2].data == make_raw(messages[1]));
+
+		test.client->poll();
+		SIGNAL_CHECK("peer_packet", make_signals({ messages[0], oversize, messages[1] }));
+	}
+
+	SUBCASE("Full batches are sent right away") {
+		// Each message takes 2 bytes for its size, 1 for the command, and its bytes.
+		const Vector<uint8_t> large = make_bytes(500, 0);
+		for (int i = 0; i < 3; i++) {
+			CHECK(test.server->send_bytes(large, 2) == OK);
+		}
+		REQUIRE(test.server_peer->sent.size() == 1);
+		CHECK(test.server_peer->sent[0].data == make_batch(2, { make_raw(large), make_raw(large) }));
+		test.server->poll();
+		REQUIRE(test.server_peer->sent.size() == 2);
+		CHECK(test.server_peer->sent[1].data == make_raw(large));
+
+		test.client->poll();
+		SIGNAL_CHECK("peer_packet", make_signals({ large, large, large }));
+	}
+
+	SUBCASE("Disabling sends the pending messages") {
+		CHECK(test.server->send_bytes(messages[0], 2) == OK);
+		test.server->set_packet_batching_enabled(false);
+		REQUIRE(test.server_peer->sent.size() == 1);
+		CHECK(test.server->send_bytes(messages[1], 2) == OK);
+		CHECK(test.server_peer->sent.size() == 2);
+	}
+}
+
+TEST_CASE("[Multiplayer][SceneMultiplayer] Received batches") {
+	BatchTest test;
+	const Vector<uint8_t> first = make_raw(make_bytes(4, 0));
+	const Vector<uint8_t> second = make_raw(make_bytes(8, 10));
+
+	SUBCASE("Valid batches") {
+		test.client_peer->receive(make_batch(2, { first, second }));
+		test.client->poll();
+		SIGNAL_CHECK("peer_packet", make_signals({ make_bytes(4, 0), make_bytes(8, 10) }));
+	}
+
+	SUBCASE("Malformed batches are dropped whole") {
+		Vector<uint8_t> overlong = make_batch(2, { first, second });
+		overlong.push_back(0);
+		Vector<uint8_t> truncated = make_batch(2, { first, second });
+		truncated.resize(truncated.size() - 1);
+		Vector<uint8_t> empty_message = make_batch(2, { first, Vector<uint8_t>() });
+		Vector<uint8_t> nested = make_batch(2, { first, make_batch(2, { first, second }) });
+
+		ERR_PRINT_OFF;
+		test.client_peer->receive(make_batch(3, { first, second }));
+		test.client_peer->receive(make_batch(1, { first, second }));
+		test.client_peer->receive(overlong);
+		test.client_peer->receive(truncated);
+		test.client_peer->receive(empty_message);
+		test.client_peer->receive(nested);
+		test.client->poll();
+		ERR_PRINT_ON;
+		SIGNAL_CHECK_FALSE("peer_packet");
+	}
+}
+
+} // namespace TestSceneMultiplayer
+
+#endif // TEST_SCENE_MULTIPLAYER_H
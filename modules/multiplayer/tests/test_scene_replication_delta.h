@@ -0,0 +1,165 @@
+/**************************************************************************/
+/*  test_scene_replication_delta.h                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SCENE_REPLICATION_DELTA_H
+#define TEST_SCENE_REPLICATION_DELTA_H
+
+#include "modules/multiplayer/scene_replication_delta.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSceneReplicationDelta {
+
+static Vector<uint8_t> encode(const Vector<Variant> &p_state, const Vector<Variant> *p_baseline, const Vector<real_t> &p_quantization) {
+	int size = 0;
+	Error err = SceneReplicationDelta::encode_state(p_state, p_baseline, p_quantization, nullptr, size);
+	CHECK(err == OK);
+	Vector<uint8_t> buffer;
+	buffer.resize(size);
+	err = SceneReplicationDelta::encode_state(p_state, p_baseline, p_quantization, buffer.ptrw(), size);
+	CHECK(err == OK);
+	CHECK(size == buffer.size());
+	return buffer;
+}
+
+static Vector<Variant> decode(const Vector<uint8_t> &p_buffer, const Vector<Variant> *p_baseline, const Vector<real_t> &p_quantization) {
+	Vector<Variant> state;
+	CHECK(SceneReplicationDelta::decode_state(p_buffer.ptr(), p_buffer.size(), p_baseline, p_quantization, state) == OK);
+	return state;
+}
+
+static Vector<Variant> make_state(const Vector3 &p_position, const Quaternion &p_rotation, int p_health, const String &p_name) {
+	Vector<Variant> state;
+	state.push_back(p_position);
+	state.push_back(p_rotation);
+	state.push_back(p_health);
+	state.push_back(p_name);
+	return state;
+}
+
+TEST_CASE("[SceneReplicationDelta] Full states") {
+	const Vector<real_t> quantization = { 0.0, 0.0, 0.0, 0.0 };
+	const Vector<Variant> state = make_state(Vector3(1.5, -2, 3.25), Quaternion(0, 0.6, 0, 0.8), 100, "Player");
+
+	const Vector<uint8_t> buffer = encode(state, nullptr, quantization);
+	CHECK(decode(buffer, nullptr, quantization) == state);
+
+	ERR_PRINT_OFF;
+	Vector<Variant> decoded;
+	CHECK_MESSAGE(SceneReplicationDelta::decode_state(buffer.ptr(), buffer.size() - 1, nullptr, quantization, decoded) != OK, "Truncated states should be rejected.");
+	ERR_PRINT_ON;
+}
+
+TEST_CASE("[SceneReplicationDelta] Changes from a baseline") {
+	const Vector<real_t> quantization = { 0.0, 0.0, 0.0, 0.0 };
+	const Vector<Variant> baseline = make_state(Vector3(1, 2, 3), Quaternion(), 100, "Player");
+	const Vector<Variant> state = make_state(Vector3(1, 2, 4), Quaternion(), 100, "Player");
+
+	const Vector<uint8_t> full = encode(state, nullptr, quantization);
+	const Vector<uint8_t> delta = encode(state, &baseline, quantization);
+	CHECK_MESSAGE(delta.size() < full.size(), "Unchanged properties should not be sent.");
+	CHECK(decode(delta, &baseline, quantization) == state);
+
+	const Vector<uint8_t> unchanged = encode(baseline, &baseline, quantization);
+	CHECK_MESSAGE(unchanged.size() == 1, "Only the mask of changed properties should be sent.");
+	CHECK(decode(unchanged, &baseline, quantization) == baseline);
+}
+
+TEST_CASE("[SceneReplicationDelta] Quantization") {
+	const Vector<real_t> quantization = { 0.01, 0.001, 0.0, 0.5 };
+	const Vector<real_t> full_precision = { 0.0, 0.0, 0.0, 0.0 };
+
+	Vector<Variant> baseline = make_state(Vector3(100.123, -20.456, 3.001), Quaternion(0, 0.6, 0, 0.8), 100, "Player");
+	SceneReplicationDelta::quantize_state(baseline, quantization);
+	CHECK(Vector3(baseline[0]).is_equal_approx(Vector3(100.12, -20.46, 3.0)));
+	CHECK_MESSAGE(baseline[3] == Variant("Player"), "Types that can't be quantized should be left alone.");
+
+	SUBCASE("Full states") {
+		const Vector<uint8_t> buffer = encode(baseline, nullptr, quantization);
+		CHECK(decode(buffer, nullptr, quantization) == baseline);
+	}
+
+	SUBCASE("Small changes") {
+		Vector<Variant> state = make_state(Vector3(100.2, -20.4, 3.001), Quaternion(0, 0.6, 0, 0.8), 100, "Player");
+		SceneReplicationDelta::quantize_state(state, quantization);
+
+		const Vector<uint8_t> delta = encode(state, &baseline, quantization);
+		// Mask, type and one byte per component.
+		CHECK(delta.size() == 1 + 1 + 3);
+		CHECK(delta.size() < encode(state, &baseline, full_precision).size());
+		CHECK(decode(delta, &baseline, quantization) == state);
+	}
+
+	SUBCASE("Type changes") {
+		Vector<Variant> state = baseline;
+		state.write[0] = 2.5;
+		state.write[3] = 7.75;
+		SceneReplicationDelta::quantize_state(state, quantization);
+		CHECK(double(state[3]) == doctest::Approx(8.0));
+
+		const Vector<uint8_t> delta = encode(state, &baseline, quantization);
+		CHECK(decode(delta, &baseline, quantization) == state);
+	}
+}
+
+TEST_CASE("[SceneReplicationDelta] Quaternion normalization") {
+	const Vector<real_t> quantization = { 0.0, 0.1, 0.0, 0.0 };
+	const Quaternion rotation = Quaternion(Vector3(1, 2, 3).normalized(), 0.7);
+
+	Vector<Variant> state = make_state(Vector3(), rotation, 100, "Player");
+	SceneReplicationDelta::quantize_state(state, quantization);
+	const Vector<Variant> decoded = decode(encode(state, nullptr, quantization), nullptr, quantization);
+	CHECK(decoded == state);
+	CHECK_FALSE_MESSAGE(Quaternion(decoded[1]).is_normalized(), "The quantization step should be coarse enough to move the rotation off the unit length.");
+
+	Vector<Variant> normalized = decoded;
+	SceneReplicationDelta::normalize_quaternions(normalized, quantization);
+	CHECK(Quaternion(normalized[1]).is_normalized());
+	CHECK(Quaternion(normalized[1]).angle_to(rotation) < 0.2);
+	CHECK_MESSAGE(Quaternion(decoded[1]) != Quaternion(normalized[1]), "The decoded state, used as baseline, should be left untouched.");
+
+	SUBCASE("Quaternions without quantization") {
+		Vector<Variant> exact = make_state(Vector3(), Quaternion(0, 0, 0, 2), 100, "Player");
+		SceneReplicationDelta::normalize_quaternions(exact, { 0.0, 0.0, 0.0, 0.0 });
+		CHECK_MESSAGE(Quaternion(exact[1]) == Quaternion(0, 0, 0, 2), "Rotations sent as a whole should be applied as they are.");
+	}
+
+	SUBCASE("Rotations quantized to zero") {
+		Vector<Variant> zero = make_state(Vector3(), Quaternion(0.01, 0.01, 0.01, 0.01), 100, "Player");
+		SceneReplicationDelta::quantize_state(zero, quantization);
+		CHECK(Quaternion(zero[1]).length_squared() == 0);
+		SceneReplicationDelta::normalize_quaternions(zero, quantization);
+		CHECK(Quaternion(zero[1]) == Quaternion());
+	}
+}
+
+} // namespace TestSceneReplicationDelta
+
+#endif // TEST_SCENE_REPLICATION_DELTA_H
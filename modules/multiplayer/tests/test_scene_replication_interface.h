@@ -0,0 +1,364 @@
+/**************************************************************************/
+/*  test_scene_replication_interface.h                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SCENE_REPLICATION_INTERFACE_H
+#define TEST_SCENE_REPLICATION_INTERFACE_H
+
+#include "modules/multiplayer/multiplayer_synchronizer.h"
+#include "modules/multiplayer/scene_multiplayer.h"
+#include "modules/multiplayer/tests/multiplayer_peer_mock.h"
+
+#include "core/io/marshalls.h"
+#include "scene/2d/node_2d.h"
+#include "scene/main/window.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSceneReplicationInterface {
+
+struct SyncHeader {
+	bool sent = false;
+	uint16_t time = 0;
+	bool baseline = false;
+	uint16_t baseline_time = 0;
+};
+
+// A server and a client, each one with its own branch of the scene tree, where the server synchronizes a Node2D.
+struct SyncTest {
+	Ref<MultiplayerPeerMock> server_peer;
+	Ref<MultiplayerPeerMock> client_peer;
+	Ref<SceneMultiplayer> server;
+	Ref<SceneMultiplayer> client;
+	Node *server_root = nullptr;
+	Node *client_root = nullptr;
+	Node2D *server_node = nullptr;
+	Node2D *client_node = nullptr;
+
+	static Node *add_root(const String &p_name, const Ref<SceneMultiplayer> &p_multiplayer) {
+		Node *root = memnew(Node);
+		root->set_name(p_name);
+		SceneTree::get_singleton()->get_root()->add_child(root);
+		SceneTree::get_singleton()->set_multiplayer(p_multiplayer, root->get_path());
+		return root;
+	}
+
+	static Node2D *add_player(Node *p_root, const String &p_name = "Player") {
+		Ref<SceneReplicationConfig> config;
+		config.instantiate();
+		config->add_property(NodePath(":position"));
+		config->add_property(NodePath(":rotation"));
+		MultiplayerSynchronizer *sync = memnew(MultiplayerSynchronizer);
+		sync->set_name("Synchronizer");
+		sync->set_replication_config(config);
+		Node2D *player = memnew(Node2D);
+		player->set_name(p_name);
+		player->add_child(sync);
+		p_root->add_child(player);
+		return player;
+	}
+
+	static MultiplayerSynchronizer *get_sync(Node2D *p_player) {
+		return Object::cast_to<MultiplayerSynchronizer>(p_player->get_node(NodePath("Synchronizer")));
+	}
+
+	// The server sends, then the client acknowledges what it received.
+	void step() {
+		server->poll();
+		client->poll();
+	}
+
+	// The header of the last state the server sent since the given packet.
+	SyncHeader get_last_sync(uint32_t p_since) const {
+		SyncHeader header;
+		for (uint32_t i = p_since; i < server_peer->sent.size(); i++) {
+			const Vector<uint8_t> &data = server_peer->sent[i].data;
+			if (data.size() < 10 || data[0] != SceneMultiplayer::NETWORK_COMMAND_SYNC) {
+				continue;
+			}
+			// Command and time, then the net ID, size and flags of the first state.
+			header.sent = true;
+			header.time = decode_uint16(&data[1]);
+			header.baseline = data[9] & 1;
+			header.baseline_time = header.baseline ? decode_uint16(&data[10]) : 0;
+		}
+		return header;
+	}
+
+	// The net IDs of the states the server sent since the given packet.
+	LocalVector<uint32_t> get_synced_ids(uint32_t p_since) const {
+		LocalVector<uint32_t> ids;
+		for (uint32_t i = p_since; i < server_peer->sent.size(); i++) {
+			const Vector<uint8_t> &data = server_peer->sent[i].data;
+			if (data.size() < 3 || data[0] != SceneMultiplayer::NETWORK_COMMAND_SYNC) {
+				continue;
+			}
+			int ofs = 3;
+			while (ofs + 7 <= data.size()) {
+				ids.push_back(decode_uint32(&data[ofs]));
+				ofs += 6 + decode_uint16(&data[ofs + 4]);
+			}
+		}
+		return ids;
+	}
+
+	SyncTest() {
+		server.instantiate();
+		client.instantiate();
+		server_root = add_root("Server", server);
+		client_root = add_root("Client", client);
+		server_peer = Ref<MultiplayerPeerMock>(memnew(MultiplayerPeerMock(1)));
+		client_peer = Ref<MultiplayerPeerMock>(memnew(MultiplayerPeerMock(2)));
+		server->set_multiplayer_peer(server_peer);
+		client->set_multiplayer_peer(client_peer);
+		MultiplayerPeerMock::link(server_peer.ptr(), client_peer.ptr());
+		server_node = add_player(server_root);
+		client_node = add_player(client_root);
+	}
+
+	~SyncTest() {
+		memdelete(server_root);
+		memdelete(client_root);
+		SceneTree::get_singleton()->set_multiplayer(Ref<MultiplayerAPI>(), NodePath("/root/Server"));
+		SceneTree::get_singleton()->set_multiplayer(Ref<MultiplayerAPI>(), NodePath("/root/Client"));
+	}
+};
+
+TEST_CASE("[SceneTree][SceneReplicationInterface] Acknowledged states become baselines") {
+	SyncTest test;
+	test.server_node->set_position(Vector2(1, 2));
+
+	// The first network process only sends the synchronizer path.
+	test.step();
+	CHECK_FALSE(test.get_last_sync(0).sent);
+	test.step();
+	const SyncHeader first = test.get_last_sync(0);
+	REQUIRE(first.sent);
+	CHECK_MESSAGE(!first.baseline, "The first state can't be a delta, nothing was acknowledged yet.");
+	CHECK(test.client_node->get_position() == Vector2(1, 2));
+
+	uint32_t since = test.server_peer->sent.size();
+	test.step();
+	CHECK_MESSAGE(!test.get_last_sync(since).sent, "Acknowledged states that didn't change should not be sent again.");
+
+	test.server_node->set_position(Vector2(3, 4));
+	since = test.server_peer->sent.size();
+	test.step();
+	const SyncHeader delta = test.get_last_sync(since);
+	REQUIRE(delta.sent);
+	CHECK(delta.baseline);
+	CHECK(delta.baseline_time == first.time);
+	CHECK(test.client_node->get_position() == Vector2(3, 4));
+
+	SUBCASE("The newest acknowledged state is used") {
+		test.server_node->set_position(Vector2(5, 6));
+		since = test.server_peer->sent.size();
+		test.step();
+		const SyncHeader next = test.get_last_sync(since);
+		REQUIRE(next.sent);
+		CHECK(next.baseline);
+		CHECK(next.baseline_time == delta.time);
+		CHECK(test.client_node->get_position() == Vector2(5, 6));
+	}
+}
+
+TEST_CASE("[SceneTree][SceneReplicationInterface] Loss recovery") {
+	SyncTest test;
+	test.server_node->set_position(Vector2(1, 2));
+	test.step();
+	test.step();
+	const SyncHeader first = test.get_last_sync(0);
+	REQUIRE(first.sent);
+	test.step(); // Acknowledged.
+
+	SUBCASE("Lost states") {
+		test.server_peer->drop_unreliable = true;
+		test.server_node->set_position(Vector2(3, 4));
+		test.step();
+		CHECK(test.client_node->get_position() == Vector2(1, 2));
+
+		test.server_peer->drop_unreliable = false;
+		const uint32_t since = test.server_peer->sent.size();
+		test.step();
+		const SyncHeader header = test.get_last_sync(since);
+		REQUIRE(header.sent);
+		CHECK_MESSAGE(header.baseline_time == first.time, "The lost state was never acknowledged, so it can't be used as baseline.");
+		CHECK(test.client_node->get_position() == Vector2(3, 4));
+	}
+
+	SUBCASE("Lost acknowledgements") {
+		test.client_peer->drop_unreliable = true;
+		int deltas = 0;
+		bool full = false;
+		for (int i = 0; i < 64 && !full; i++) {
+			test.server_node->set_position(Vector2(i, 0));
+			const uint32_t since = test.server_peer->sent.size();
+			test.step();
+			const SyncHeader header = test.get_last_sync(since);
+			REQUIRE(header.sent);
+			CHECK(test.client_node->get_position() == Vector2(i, 0));
+			if (header.baseline) {
+				CHECK(header.baseline_time == first.time);
+				deltas++;
+			} else {
+				full = true;
+			}
+		}
+		CHECK(deltas > 0);
+		CHECK_MESSAGE(full, "Once the client might have dropped the baseline, full states should be sent again.");
+
+		test.client_peer->drop_unreliable = false;
+		test.server_node->set_position(Vector2(-1, 0));
+		test.step();
+		test.server_node->set_position(Vector2(-2, 0));
+		const uint32_t since = test.server_peer->sent.size();
+		test.step();
+		CHECK(test.get_last_sync(since).baseline);
+		CHECK(test.client_node->get_position() == Vector2(-2, 0));
+	}
+
+	SUBCASE("Duplicated states") {
+		// Without acknowledgements the first state stays the baseline, duplicates must not push it out of the history.
+		test.client_peer->drop_unreliable = true;
+		test.server_peer->duplicate_unreliable = true;
+		for (int i = 0; i < 12; i++) {
+			test.server_node->set_position(Vector2(i, 0));
+			const uint32_t since = test.server_peer->sent.size();
+			test.step();
+			const SyncHeader header = test.get_last_sync(since);
+			REQUIRE(header.sent);
+			CHECK(header.baseline);
+			CHECK(test.client_node->get_position() == Vector2(i, 0));
+		}
+	}
+}
+
+TEST_CASE("[SceneTree][SceneReplicationInterface] Sync budget") {
+	SyncTest test;
+	Node2D *players[3] = { test.server_node, SyncTest::add_player(test.server_root, "Second"), SyncTest::add_player(test.server_root, "Third") };
+	SyncTest::add_player(test.client_root, "Second");
+	SyncTest::add_player(test.client_root, "Third");
+	// Any state is over budget, but at least one is always sent.
+	test.server->set_peer_sync_budget(1);
+
+	SUBCASE("Delayed states gain priority") {
+		test.step(); // Paths.
+		HashMap<uint32_t, int> sent;
+		for (int i = 0; i < 6; i++) {
+			for (Node2D *player : players) {
+				player->set_position(Vector2(i, i));
+			}
+			const uint32_t since = test.server_peer->sent.size();
+			test.step();
+			const LocalVector<uint32_t> ids = test.get_synced_ids(since);
+			REQUIRE(ids.size() == 1);
+			sent[ids[0]] = sent.has(ids[0]) ? sent[ids[0]] + 1 : 1;
+		}
+		for (Node2D *player : players) {
+			const uint32_t net_id = SyncTest::get_sync(player)->get_net_id();
+			const int count = sent.has(net_id) ? sent[net_id] : 0;
+			CHECK_MESSAGE(count == 2, "Synchronizers over budget should not be starved.");
+		}
+	}
+
+	SUBCASE("Higher priorities first") {
+		SyncTest::get_sync(players[2])->set_replication_priority(10);
+		test.step(); // Paths.
+		const uint32_t high = SyncTest::get_sync(players[2])->get_net_id();
+		HashSet<uint32_t> sent;
+		for (int i = 0; i < 16; i++) {
+			for (Node2D *player : players) {
+				player->set_position(Vector2(i, i));
+			}
+			const uint32_t since = test.server_peer->sent.size();
+			test.step();
+			const LocalVector<uint32_t> ids = test.get_synced_ids(since);
+			REQUIRE(ids.size() == 1);
+			if (i < 3) {
+				CHECK(ids[0] == high);
+			}
+			sent.insert(ids[0]);
+		}
+		CHECK_MESSAGE(sent.size() == 3, "Lower priorities should still be sent once they waited long enough.");
+	}
+
+	SUBCASE("Unlimited budget") {
+		test.server->set_peer_sync_budget(0);
+		test.step();
+		const uint32_t since = test.server_peer->sent.size();
+		test.step();
+		CHECK(test.get_synced_ids(since).size() == 3);
+	}
+}
+
+TEST_CASE("[SceneTree][SceneReplicationInterface] Interest radius") {
+	SyncTest test;
+	Node2D *near = SyncTest::add_player(test.server_root, "Near");
+	Node2D *far = SyncTest::add_player(test.server_root, "Far");
+	Node2D *client_near = SyncTest::add_player(test.client_root, "Near");
+	Node2D *client_far = SyncTest::add_player(test.client_root, "Far");
+	near->set_position(Vector2(5, 0));
+	far->set_position(Vector2(100, 0));
+	SyncTest::get_sync(near)->set_interest_radius(10);
+	SyncTest::get_sync(far)->set_interest_radius(10);
+
+	// Without a position, the peer only gets the synchronizers without an interest radius.
+	test.step();
+	test.step();
+	const LocalVector<uint32_t> ids = test.get_synced_ids(0);
+	REQUIRE(ids.size() == 1);
+	CHECK(ids[0] == SyncTest::get_sync(test.server_node)->get_net_id());
+	CHECK(SyncTest::get_sync(near)->get_net_id() == 0);
+	CHECK(SyncTest::get_sync(far)->get_net_id() == 0);
+
+	test.server->set_peer_interest_position(2, Vector3());
+	test.step(); // Path.
+	uint32_t since = test.server_peer->sent.size();
+	test.step();
+	CHECK(test.get_synced_ids(since).find(SyncTest::get_sync(near)->get_net_id()) != -1);
+	CHECK(SyncTest::get_sync(far)->get_net_id() == 0);
+	CHECK(client_near->get_position() == Vector2(5, 0));
+	CHECK(client_far->get_position() == Vector2());
+
+	// Moving in and out of the radius.
+	far->set_position(Vector2(3, 0));
+	near->set_position(Vector2(200, 0));
+	test.step(); // Path.
+	since = test.server_peer->sent.size();
+	test.step();
+	const LocalVector<uint32_t> moved_ids = test.get_synced_ids(since);
+	CHECK(moved_ids.find(SyncTest::get_sync(far)->get_net_id()) != -1);
+	CHECK(moved_ids.find(SyncTest::get_sync(near)->get_net_id()) == -1);
+	CHECK(client_far->get_position() == Vector2(3, 0));
+	CHECK(client_near->get_position() == Vector2(5, 0));
+}
+
+} // namespace TestSceneReplicationInterface
+
+#endif // TEST_SCENE_REPLICATION_INTERFACE_H
@@ -30,7 +30,9 @@
 
 #include "godot_navigation_server.h"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/os/mutex.h"
+#include "core/os/os.h"
 
 #ifndef _3D_DISABLED
 #include "navigation_mesh_generator.h"
@@ -85,6 +87,10 @@ GodotNavigationServer::GodotNavigationServer() {}
 
 GodotNavigationServer::~GodotNavigationServer() {
 	flush_queries();
+
+	for (PathQueryBatch *batch : path_query_batches) {
+		memdelete(batch);
+	}
 }
 
 void GodotNavigationServer::add_command(SetCommand *command) {
@@ -194,6 +200,21 @@ real_t GodotNavigationServer::map_get_link_connection_radius(RID p_map) const {
 	return map->get_link_connection_radius();
 }
 
+COMMAND_2(map_set_avoidance_backend, RID, p_map, NavigationServer3D::AvoidanceBackend, p_backend) {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_COND(map == nullptr);
+	ERR_FAIL_INDEX(p_backend, AVOIDANCE_BACKEND_MAX);
+
+	map->set_avoidance_backend(p_backend);
+}
+
+NavigationServer3D::AvoidanceBackend GodotNavigationServer::map_get_avoidance_backend(RID p_map) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_COND_V(map == nullptr, AVOIDANCE_BACKEND_KD_TREE);
+
+	return map->get_avoidance_backend();
+}
+
 Vector<Vector3> GodotNavigationServer::map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers) const {
 	const NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_COND_V(map == nullptr, Vector<Vector3>());
@@ -229,6 +250,13 @@ RID GodotNavigationServer::map_get_closest_point_owner(RID p_map, const Vector3
 	return map->get_closest_point_owner(p_point);
 }
 
+Ref<NavigationFlowField3D> GodotNavigationServer::map_get_flow_field(RID p_map, const Vector3 &p_destination, uint32_t p_navigation_layers) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_COND_V(map == nullptr, Ref<NavigationFlowField3D>());
+
+	return map->get_flow_field(p_destination, p_navigation_layers);
+}
+
 TypedArray<RID> GodotNavigationServer::map_get_links(RID p_map) const {
 	TypedArray<RID> link_rids;
 	const NavMap *map = map_owner.get_or_null(p_map);
@@ -786,6 +814,8 @@ void GodotNavigationServer::map_force_update(RID p_map) {
 
 	flush_queries();
 
+	// Async path queries read the maps on worker threads while holding this lock.
+	MutexLock lock(operations_mutex);
 	map->sync();
 }
 
@@ -793,6 +823,8 @@ void GodotNavigationServer::process(real_t p_delta_time) {
 	flush_queries();
 
 	if (!active) {
+		// Maps don't sync while inactive, queued path queries are solved on their current state.
+		_process_path_queries();
 		return;
 	}
 
@@ -805,28 +837,30 @@ void GodotNavigationServer::process(real_t p_delta_time) {
 	int _new_pm_edge_connection_count = 0;
 	int _new_pm_edge_free_count = 0;
 
-	// In c++ we can't be sure that this is performed in the main thread
-	// even with mutable functions.
-	MutexLock lock(operations_mutex);
-	for (uint32_t i(0); i < active_maps.size(); i++) {
-		active_maps[i]->sync();
-		active_maps[i]->step(p_delta_time);
-		active_maps[i]->dispatch_callbacks();
-
-		_new_pm_region_count += active_maps[i]->get_pm_region_count();
-		_new_pm_agent_count += active_maps[i]->get_pm_agent_count();
-		_new_pm_link_count += active_maps[i]->get_pm_link_count();
-		_new_pm_polygon_count += active_maps[i]->get_pm_polygon_count();
-		_new_pm_edge_count += active_maps[i]->get_pm_edge_count();
-		_new_pm_edge_merge_count += active_maps[i]->get_pm_edge_merge_count();
-		_new_pm_edge_connection_count += active_maps[i]->get_pm_edge_connection_count();
-		_new_pm_edge_free_count += active_maps[i]->get_pm_edge_free_count();
-
-		// Emit a signal if a map changed.
-		const uint32_t new_map_update_id = active_maps[i]->get_map_update_id();
-		if (new_map_update_id != active_maps_update_id[i]) {
-			emit_signal(SNAME("map_changed"), active_maps[i]->get_self());
-			active_maps_update_id[i] = new_map_update_id;
+	{
+		// In c++ we can't be sure that this is performed in the main thread
+		// even with mutable functions.
+		MutexLock lock(operations_mutex);
+		for (uint32_t i(0); i < active_maps.size(); i++) {
+			active_maps[i]->sync();
+			active_maps[i]->step(p_delta_time);
+			active_maps[i]->dispatch_callbacks();
+
+			_new_pm_region_count += active_maps[i]->get_pm_region_count();
+			_new_pm_agent_count += active_maps[i]->get_pm_agent_count();
+			_new_pm_link_count += active_maps[i]->get_pm_link_count();
+			_new_pm_polygon_count += active_maps[i]->get_pm_polygon_count();
+			_new_pm_edge_count += active_maps[i]->get_pm_edge_count();
+			_new_pm_edge_merge_count += active_maps[i]->get_pm_edge_merge_count();
+			_new_pm_edge_connection_count += active_maps[i]->get_pm_edge_connection_count();
+			_new_pm_edge_free_count += active_maps[i]->get_pm_edge_free_count();
+
+			// Emit a signal if a map changed.
+			const uint32_t new_map_update_id = active_maps[i]->get_map_update_id();
+			if (new_map_update_id != active_maps_update_id[i]) {
+				emit_signal(SNAME("map_changed"), active_maps[i]->get_self());
+				active_maps_update_id[i] = new_map_update_id;
+			}
 		}
 	}
 
@@ -838,6 +872,108 @@ void GodotNavigationServer::process(real_t p_delta_time) {
 	pm_edge_merge_count = _new_pm_edge_merge_count;
 	pm_edge_connection_count = _new_pm_edge_connection_count;
 	pm_edge_free_count = _new_pm_edge_free_count;
+
+	_process_path_queries();
+}
+
+void GodotNavigationServer::_query_paths_async(const Vector<PathQueryParameters> &p_parameters, const Callable &p_callback) {
+	PathQueryBatch *batch = memnew(PathQueryBatch);
+	batch->parameters = p_parameters;
+	batch->results.resize(p_parameters.size());
+	batch->solved.resize(p_parameters.size());
+	for (uint32_t i = 0; i < batch->solved.size(); i++) {
+		batch->solved[i] = 0;
+	}
+	batch->callback = p_callback;
+
+	MutexLock lock(path_queries_mutex);
+	path_query_batches.push_back(batch);
+}
+
+void GodotNavigationServer::set_path_query_time_budget(real_t p_time_budget_msec) {
+	MutexLock lock(path_queries_mutex);
+	path_query_time_budget = p_time_budget_msec;
+}
+
+real_t GodotNavigationServer::get_path_query_time_budget() const {
+	MutexLock lock(path_queries_mutex);
+	return path_query_time_budget;
+}
+
+void GodotNavigationServer::_solve_path_query_job(uint32_t p_index, const LocalVector<Pair<PathQueryBatch *, uint32_t>> *p_jobs) {
+	// The first job always runs so every frame makes progress, the others are left for the next frame once the budget is spent.
+	if (p_index > 0 && path_query_deadline_usec > 0 && OS::get_singleton()->get_ticks_usec() > path_query_deadline_usec) {
+		return;
+	}
+
+	PathQueryBatch *batch = (*p_jobs)[p_index].first;
+	const uint32_t query_index = (*p_jobs)[p_index].second;
+	batch->results[query_index] = _query_path(batch->parameters[query_index]);
+	batch->solved[query_index] = 1;
+}
+
+void GodotNavigationServer::_process_path_queries() {
+	LocalVector<PathQueryBatch *> batches;
+	{
+		MutexLock lock(path_queries_mutex);
+		if (path_query_batches.is_empty()) {
+			return;
+		}
+		batches = path_query_batches;
+		path_query_batches.clear();
+		path_query_deadline_usec = path_query_time_budget > 0.0 ? OS::get_singleton()->get_ticks_usec() + uint64_t(path_query_time_budget * 1000.0) : 0;
+	}
+
+	LocalVector<Pair<PathQueryBatch *, uint32_t>> path_query_jobs;
+	for (PathQueryBatch *batch : batches) {
+		for (uint32_t i = 0; i < batch->solved.size(); i++) {
+			if (!batch->solved[i]) {
+				path_query_jobs.push_back(Pair<PathQueryBatch *, uint32_t>(batch, i));
+			}
+		}
+	}
+
+	{
+		// Maps are only synced, changed and freed under this lock, so all queries of this frame see the same map state.
+		MutexLock lock(operations_mutex);
+		if (path_query_jobs.size() > 1) {
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotNavigationServer::_solve_path_query_job, &path_query_jobs, path_query_jobs.size(), -1, true, SNAME("NavigationServerPathQueries"));
+			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+		} else if (path_query_jobs.size() == 1) {
+			_solve_path_query_job(0, &path_query_jobs);
+		}
+	}
+
+	LocalVector<PathQueryBatch *> finished_batches;
+	LocalVector<PathQueryBatch *> pending_batches;
+	for (PathQueryBatch *batch : batches) {
+		bool finished = true;
+		for (uint32_t i = 0; i < batch->solved.size(); i++) {
+			if (!batch->solved[i]) {
+				finished = false;
+				break;
+			}
+		}
+		if (finished) {
+			finished_batches.push_back(batch);
+		} else {
+			pending_batches.push_back(batch);
+		}
+	}
+
+	if (!pending_batches.is_empty()) {
+		// Keep the unfinished batches ahead of the ones queued meanwhile.
+		MutexLock lock(path_queries_mutex);
+		for (PathQueryBatch *batch : path_query_batches) {
+			pending_batches.push_back(batch);
+		}
+		path_query_batches = pending_batches;
+	}
+
+	for (PathQueryBatch *batch : finished_batches) {
+		_dispatch_path_query_results(batch->callback, batch->results);
+		memdelete(batch);
+	}
 }
 
 PathQueryResult GodotNavigationServer::_query_path(const PathQueryParameters &p_parameters) const {
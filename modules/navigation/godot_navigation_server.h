@@ -32,6 +32,7 @@
 #define GODOT_NAVIGATION_SERVER_H
 
 #include "core/templates/local_vector.h"
+#include "core/templates/pair.h"
 #include "core/templates/rid.h"
 #include "core/templates/rid_owner.h"
 #include "servers/navigation_server_3d.h"
@@ -61,6 +62,13 @@ struct SetCommand {
 	virtual void exec(GodotNavigationServer *server) = 0;
 };
 
+struct PathQueryBatch {
+	Vector<NavigationUtilities::PathQueryParameters> parameters;
+	LocalVector<NavigationUtilities::PathQueryResult> results;
+	LocalVector<uint8_t> solved;
+	Callable callback;
+};
+
 class GodotNavigationServer : public NavigationServer3D {
 	Mutex commands_mutex;
 	/// Mutex used to make any operation threadsafe.
@@ -68,6 +76,12 @@ class GodotNavigationServer : public NavigationServer3D {
 
 	LocalVector<SetCommand *> commands;
 
+	/// Async path queries, solved on worker threads after the maps sync.
+	mutable Mutex path_queries_mutex;
+	LocalVector<PathQueryBatch *> path_query_batches;
+	uint64_t path_query_deadline_usec = 0;
+	real_t path_query_time_budget = 0.0;
+
 	mutable RID_Owner<NavLink> link_owner;
 	mutable RID_Owner<NavMap> map_owner;
 	mutable RID_Owner<NavRegion> region_owner;
@@ -87,6 +101,9 @@ class GodotNavigationServer : public NavigationServer3D {
 	int pm_edge_connection_count = 0;
 	int pm_edge_free_count = 0;
 
+	void _solve_path_query_job(uint32_t p_index, const LocalVector<Pair<PathQueryBatch *, uint32_t>> *p_jobs);
+	void _process_path_queries();
+
 public:
 	GodotNavigationServer();
 	virtual ~GodotNavigationServer();
@@ -111,6 +128,9 @@ public:
 	COMMAND_2(map_set_link_connection_radius, RID, p_map, real_t, p_connection_radius);
 	virtual real_t map_get_link_connection_radius(RID p_map) const override;
 
+	COMMAND_2(map_set_avoidance_backend, RID, p_map, AvoidanceBackend, p_backend);
+	virtual AvoidanceBackend map_get_avoidance_backend(RID p_map) const override;
+
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers = 1) const override;
 
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const override;
@@ -118,6 +138,8 @@ public:
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const override;
 	virtual RID map_get_closest_point_owner(RID p_map, const Vector3 &p_point) const override;
 
+	virtual Ref<NavigationFlowField3D> map_get_flow_field(RID p_map, const Vector3 &p_destination, uint32_t p_navigation_layers = 1) const override;
+
 	virtual TypedArray<RID> map_get_links(RID p_map) const override;
 	virtual TypedArray<RID> map_get_regions(RID p_map) const override;
 	virtual TypedArray<RID> map_get_agents(RID p_map) const override;
@@ -189,6 +211,10 @@ public:
 
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const override;
 
+	virtual void _query_paths_async(const Vector<NavigationUtilities::PathQueryParameters> &p_parameters, const Callable &p_callback) override;
+	virtual void set_path_query_time_budget(real_t p_time_budget_msec) override;
+	virtual real_t get_path_query_time_budget() const override;
+
 	int get_process_info(ProcessInfo p_info) const override;
 };
 
@@ -0,0 +1,163 @@
+/**************************************************************************/
+/*  nav_avoidance_grid.cpp                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "nav_avoidance_grid.h"
+
+#include "core/math/math_funcs.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/hashfuncs.h"
+
+NavAvoidanceGrid::Cell NavAvoidanceGrid::_get_cell(const RVO::Vector3 &p_position) const {
+	Cell cell;
+	cell.x = (int32_t)Math::floor(p_position.x() / cell_size);
+	cell.y = (int32_t)Math::floor(p_position.y() / cell_size);
+	cell.z = (int32_t)Math::floor(p_position.z() / cell_size);
+	return cell;
+}
+
+uint32_t NavAvoidanceGrid::_get_slot(const Cell &p_cell) const {
+	uint32_t hash = hash_murmur3_one_32(p_cell.x);
+	hash = hash_murmur3_one_32(p_cell.y, hash);
+	hash = hash_murmur3_one_32(p_cell.z, hash);
+	return hash_fmix32(hash) & slot_mask;
+}
+
+void NavAvoidanceGrid::_compute_agent_slot(uint32_t p_index, RVO::Agent **p_agents) {
+	const Cell cell = _get_cell(p_agents[p_index]->position_);
+	agent_cells[p_index] = cell;
+	agent_slots[p_index] = _get_slot(cell);
+}
+
+void NavAvoidanceGrid::build(RVO::Agent **p_agents, uint32_t p_agent_count) {
+	if (p_agent_count == 0) {
+		clear();
+		return;
+	}
+
+	cell_size = 0.0;
+	for (uint32_t i = 0; i < p_agent_count; i++) {
+		cell_size = MAX(cell_size, p_agents[i]->neighborDist_);
+	}
+	// Agents without neighbor distance never search, any cell size works for them.
+	if (cell_size <= CMP_EPSILON) {
+		cell_size = 1.0;
+	}
+
+	// Twice as many slots as agents keeps most slots to a single cell.
+	const uint32_t slot_count = MAX(16u, next_power_of_2(p_agent_count * 2));
+	slot_mask = slot_count - 1;
+
+	agent_cells.resize(p_agent_count);
+	agent_slots.resize(p_agent_count);
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavAvoidanceGrid::_compute_agent_slot, p_agents, p_agent_count, -1, true, SNAME("NavigationAvoidanceGrid"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	// Counting sort of the agents by slot.
+	slot_begin.resize(slot_count + 1);
+	memset(slot_begin.ptr(), 0, slot_begin.size() * sizeof(uint32_t));
+	for (uint32_t i = 0; i < p_agent_count; i++) {
+		slot_begin[agent_slots[i] + 1]++;
+	}
+	for (uint32_t i = 0; i < slot_count; i++) {
+		slot_begin[i + 1] += slot_begin[i];
+	}
+
+	sorted_agents.resize(p_agent_count);
+	sorted_cells.resize(p_agent_count);
+	sorted_x.resize(p_agent_count);
+	sorted_y.resize(p_agent_count);
+	sorted_z.resize(p_agent_count);
+
+	// Use the slot starts as insertion cursors, each one ends on the start of the next slot.
+	for (uint32_t i = 0; i < p_agent_count; i++) {
+		const uint32_t index = slot_begin[agent_slots[i]]++;
+		const RVO::Agent *agent = p_agents[i];
+		sorted_agents[index] = agent;
+		sorted_cells[index] = agent_cells[i];
+		sorted_x[index] = agent->position_.x();
+		sorted_y[index] = agent->position_.y();
+		sorted_z[index] = agent->position_.z();
+	}
+	// Shift the cursors back to the slot starts.
+	for (uint32_t i = slot_count; i > 0; i--) {
+		slot_begin[i] = slot_begin[i - 1];
+	}
+	slot_begin[0] = 0;
+}
+
+void NavAvoidanceGrid::compute_agent_neighbors(RVO::Agent *p_agent) const {
+	p_agent->agentNeighbors_.clear();
+	if (p_agent->maxNeighbors_ == 0 || sorted_agents.is_empty()) {
+		return;
+	}
+
+	const float range = p_agent->neighborDist_;
+	float range_sq = range * range;
+	const RVO::Vector3 &position = p_agent->position_;
+	const Cell from = _get_cell(position - RVO::Vector3(range, range, range));
+	const Cell to = _get_cell(position + RVO::Vector3(range, range, range));
+
+	for (int32_t z = from.z; z <= to.z; z++) {
+		for (int32_t y = from.y; y <= to.y; y++) {
+			for (int32_t x = from.x; x <= to.x; x++) {
+				Cell cell;
+				cell.x = x;
+				cell.y = y;
+				cell.z = z;
+				const uint32_t slot = _get_slot(cell);
+				const uint32_t end = slot_begin[slot + 1];
+				for (uint32_t i = slot_begin[slot]; i < end; i++) {
+					// Other cells can share the slot, they are visited on their own.
+					if (!(sorted_cells[i] == cell)) {
+						continue;
+					}
+					const float dx = sorted_x[i] - position.x();
+					const float dy = sorted_y[i] - position.y();
+					const float dz = sorted_z[i] - position.z();
+					if (dx * dx + dy * dy + dz * dz < range_sq) {
+						// Keeps the closest agents and shrinks the range once the list is full.
+						p_agent->insertAgentNeighbor(sorted_agents[i], range_sq);
+					}
+				}
+			}
+		}
+	}
+}
+
+void NavAvoidanceGrid::clear() {
+	agent_cells.clear();
+	agent_slots.clear();
+	slot_begin.clear();
+	sorted_agents.clear();
+	sorted_cells.clear();
+	sorted_x.clear();
+	sorted_y.clear();
+	sorted_z.clear();
+}
@@ -0,0 +1,84 @@
+/**************************************************************************/
+/*  nav_avoidance_grid.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAV_AVOIDANCE_GRID_H
+#define NAV_AVOIDANCE_GRID_H
+
+#include "core/templates/local_vector.h"
+
+#include <Agent.h>
+
+/// Spatial hash of the avoidance agents, used to find their neighbors.
+///
+/// Agents are hashed into a uniform grid whose cells are as large as the largest
+/// neighbor distance, so a neighbor search visits at most 3x3x3 cells. The grid
+/// is rebuilt from scratch at each step: the cells of the agents are computed in
+/// parallel, then a counting sort stores the agents cell by cell, with their
+/// positions and cells kept in separate arrays for the distance tests.
+class NavAvoidanceGrid {
+	struct Cell {
+		int32_t x = 0;
+		int32_t y = 0;
+		int32_t z = 0;
+
+		bool operator==(const Cell &p_cell) const { return x == p_cell.x && y == p_cell.y && z == p_cell.z; }
+	};
+
+	float cell_size = 1.0;
+	uint32_t slot_mask = 0;
+
+	/// Cell and hash slot of each agent, in input order.
+	LocalVector<Cell> agent_cells;
+	LocalVector<uint32_t> agent_slots;
+
+	/// First sorted agent of each hash slot, plus the end of the last slot.
+	LocalVector<uint32_t> slot_begin;
+
+	/// Agents sorted by hash slot, with their cells and positions.
+	LocalVector<const RVO::Agent *> sorted_agents;
+	LocalVector<Cell> sorted_cells;
+	LocalVector<float> sorted_x;
+	LocalVector<float> sorted_y;
+	LocalVector<float> sorted_z;
+
+	_FORCE_INLINE_ Cell _get_cell(const RVO::Vector3 &p_position) const;
+	_FORCE_INLINE_ uint32_t _get_slot(const Cell &p_cell) const;
+
+	void _compute_agent_slot(uint32_t p_index, RVO::Agent **p_agents);
+
+public:
+	void build(RVO::Agent **p_agents, uint32_t p_agent_count);
+	void compute_agent_neighbors(RVO::Agent *p_agent) const;
+	void clear();
+
+	uint32_t get_agent_count() const { return sorted_agents.size(); }
+};
+
+#endif // NAV_AVOIDANCE_GRID_H
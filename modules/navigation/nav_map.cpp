@@ -38,16 +38,19 @@
 
 #define THREE_POINTS_CROSS_PRODUCT(m_a, m_b, m_c) (((m_c) - (m_a)).cross((m_b) - (m_a)))
 
+// Size of the cells cluster routes are cached by, in map cells.
+#define ROUTE_CACHE_CELL_SCALE 4
+
 // Helper macro
-#define APPEND_METADATA(poly)                                  \
-	if (r_path_types) {                                        \
-		r_path_types->push_back(poly->owner->get_type());      \
-	}                                                          \
-	if (r_path_rids) {                                         \
-		r_path_rids->push_back(poly->owner->get_self());       \
-	}                                                          \
-	if (r_path_owners) {                                       \
-		r_path_owners->push_back(poly->owner->get_owner_id()); \
+#define APPEND_METADATA(m_snapshot, m_poly)                                             \
+	if (r_path_types) {                                                                 \
+		r_path_types->push_back((m_snapshot).clusters[(m_poly)->cluster_id].type);      \
+	}                                                                                   \
+	if (r_path_rids) {                                                                  \
+		r_path_rids->push_back((m_snapshot).clusters[(m_poly)->cluster_id].self);       \
+	}                                                                                   \
+	if (r_path_owners) {                                                                \
+		r_path_owners->push_back((m_snapshot).clusters[(m_poly)->cluster_id].owner_id); \
 	}
 
 void NavMap::set_up(Vector3 p_up) {
@@ -70,6 +73,20 @@ void NavMap::set_link_connection_radius(float p_link_connection_radius) {
 	regenerate_links = true;
 }
 
+void NavMap::set_avoidance_backend(NavigationServer3D::AvoidanceBackend p_avoidance_backend) {
+	if (avoidance_backend == p_avoidance_backend) {
+		return;
+	}
+	avoidance_backend = p_avoidance_backend;
+	if (avoidance_backend == NavigationServer3D::AVOIDANCE_BACKEND_KD_TREE) {
+		avoidance_grid.clear();
+	} else {
+		rvo.buildAgentTree(std::vector<RVO::Agent *>());
+	}
+	// The next sync builds the tree when needed.
+	agents_dirty = true;
+}
+
 gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 	const int x = int(Math::floor(p_pos.x / cell_size));
 	const int y = int(Math::floor(p_pos.y / cell_size));
@@ -95,6 +112,9 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		r_path_owners->clear();
 	}
 
+	const SnapshotRef snapshot_ref(this);
+	const NavMapSnapshot &map_snapshot = *snapshot_ref;
+
 	// Find the start poly and the end poly on this map.
 	const gd::Polygon *begin_poly = nullptr;
 	const gd::Polygon *end_poly = nullptr;
@@ -103,15 +123,17 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	float begin_d = 1e20;
 	float end_d = 1e20;
 	// Find the initial poly and the end poly on this map.
-	for (const gd::Polygon &p : polygons) {
+	for (uint32_t polygon_index = 0; polygon_index < map_snapshot.region_polygon_count; polygon_index++) {
+		const gd::Polygon &p = map_snapshot.polygons[polygon_index];
+
 		// Only consider the polygon if it in a region with compatible layers.
-		if ((p_navigation_layers & p.owner->get_navigation_layers()) == 0) {
+		if ((p_navigation_layers & map_snapshot.clusters[p.cluster_id].navigation_layers) == 0) {
 			continue;
 		}
 
 		// For each face check the distance between the origin/destination
-		for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
-			const Face3 face(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+		for (uint32_t point_id = 2; point_id < p.point_count; point_id++) {
+			const Face3 face(map_snapshot.get_point(p, 0), map_snapshot.get_point(p, point_id - 1), map_snapshot.get_point(p, point_id));
 
 			Vector3 point = face.get_closest_point_to(p_origin);
 			float distance_to_point = point.distance_to(p_origin);
@@ -138,20 +160,20 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	if (begin_poly == end_poly) {
 		if (r_path_types) {
 			r_path_types->resize(2);
-			r_path_types->write[0] = begin_poly->owner->get_type();
-			r_path_types->write[1] = end_poly->owner->get_type();
+			r_path_types->write[0] = map_snapshot.clusters[begin_poly->cluster_id].type;
+			r_path_types->write[1] = map_snapshot.clusters[end_poly->cluster_id].type;
 		}
 
 		if (r_path_rids) {
 			r_path_rids->resize(2);
-			(*r_path_rids)[0] = begin_poly->owner->get_self();
-			(*r_path_rids)[1] = end_poly->owner->get_self();
+			(*r_path_rids)[0] = map_snapshot.clusters[begin_poly->cluster_id].self;
+			(*r_path_rids)[1] = map_snapshot.clusters[end_poly->cluster_id].self;
 		}
 
 		if (r_path_owners) {
 			r_path_owners->resize(2);
-			r_path_owners->write[0] = begin_poly->owner->get_owner_id();
-			r_path_owners->write[1] = end_poly->owner->get_owner_id();
+			r_path_owners->write[0] = map_snapshot.clusters[begin_poly->cluster_id].owner_id;
+			r_path_owners->write[1] = map_snapshot.clusters[end_poly->cluster_id].owner_id;
 		}
 
 		Vector<Vector3> path;
@@ -161,9 +183,25 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
+	// When the path goes through several regions or links, find the route across them first,
+	// then only search the polygons of the clusters on that route.
+	LocalVector<uint8_t> cluster_in_route;
+	if (begin_poly->cluster_id != end_poly->cluster_id) {
+		LocalVector<uint32_t> route;
+		if (_get_cluster_route(map_snapshot, begin_poly->cluster_id, begin_point, end_poly->cluster_id, end_point, p_navigation_layers, route)) {
+			cluster_in_route.resize(map_snapshot.clusters.size());
+			memset(cluster_in_route.ptr(), 0, cluster_in_route.size());
+			for (const uint32_t cluster_id : route) {
+				cluster_in_route[cluster_id] = 1;
+			}
+		}
+	}
+
 	// List of all reachable navigation polys.
 	LocalVector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.reserve(polygons.size() * 0.75);
+
+	// Index in navigation_polys of each reached polygon.
+	HashMap<uint32_t, uint32_t> navigation_poly_ids;
 
 	// Add the start polygon to the reachable navigation polygons.
 	gd::NavigationPoly begin_navigation_poly = gd::NavigationPoly(begin_poly);
@@ -172,14 +210,17 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	begin_navigation_poly.back_navigation_edge_pathway_start = begin_point;
 	begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
 	navigation_polys.push_back(begin_navigation_poly);
+	navigation_poly_ids.insert(begin_poly->id, 0);
 
-	// List of polygon IDs to visit.
-	List<uint32_t> to_visit;
-	to_visit.push_back(0);
+	// Polygons to visit, sorted by their total cost.
+	gd::NavPolyTotalCostLess less_than;
+	less_than.navigation_polys = &navigation_polys;
+	gd::NavPolyHeapIndexer indexer;
+	indexer.navigation_polys = &navigation_polys;
+	IndexedHeap<uint32_t, gd::NavPolyTotalCostLess, gd::NavPolyHeapIndexer> to_visit(less_than, indexer);
 
 	// This is an implementation of the A* algorithm.
-	int least_cost_id = 0;
-	int prev_least_cost_id = -1;
+	uint32_t least_cost_id = 0;
 	bool found_route = false;
 
 	const gd::Polygon *reachable_end = nullptr;
@@ -187,119 +228,123 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	bool is_reachable = true;
 
 	while (true) {
-		// Takes the current least_cost_poly neighbors (iterating over its edges) and compute the traveled_distance.
-		for (const gd::Edge &edge : navigation_polys[least_cost_id].poly->edges) {
-			// Iterate over connections in this edge, then compute the new optimized travel distance assigned to this polygon.
-			for (int connection_index = 0; connection_index < edge.connections.size(); connection_index++) {
-				const gd::Edge::Connection &connection = edge.connections[connection_index];
-
-				// Only consider the connection to another polygon if this polygon is in a region with compatible layers.
-				if ((p_navigation_layers & connection.polygon->owner->get_navigation_layers()) == 0) {
-					continue;
-				}
+		// Copy what's needed, adding polygons may reallocate the list.
+		const gd::Polygon *least_cost_polygon = navigation_polys[least_cost_id].poly;
+		const Vector3 least_cost_entry = navigation_polys[least_cost_id].entry;
+		const float least_cost_traveled_distance = navigation_polys[least_cost_id].traveled_distance;
+		const float poly_travel_cost = map_snapshot.clusters[least_cost_polygon->cluster_id].travel_cost;
+
+		// Takes the current least_cost_poly neighbors (iterating over its connections) and compute the traveled_distance.
+		const uint32_t connection_count = map_snapshot.get_connection_count(*least_cost_polygon);
+		for (uint32_t connection_index = 0; connection_index < connection_count; connection_index++) {
+			const gd::Connection connection = map_snapshot.get_connection(*least_cost_polygon, connection_index);
+			const gd::Polygon &connection_polygon = map_snapshot.polygons[connection.polygon];
+			const gd::Cluster &connection_cluster = map_snapshot.clusters[connection_polygon.cluster_id];
+
+			// Only consider the connection to another polygon if this polygon is in a region with compatible layers.
+			if ((p_navigation_layers & connection_cluster.navigation_layers) == 0) {
+				continue;
+			}
 
-				const gd::NavigationPoly &least_cost_poly = navigation_polys[least_cost_id];
-				float poly_enter_cost = 0.0;
-				float poly_travel_cost = least_cost_poly.poly->owner->get_travel_cost();
+			if (!cluster_in_route.is_empty() && !cluster_in_route[connection_polygon.cluster_id]) {
+				continue;
+			}
 
-				if (prev_least_cost_id != -1 && (navigation_polys[prev_least_cost_id].poly->owner->get_self() != least_cost_poly.poly->owner->get_self())) {
-					poly_enter_cost = least_cost_poly.poly->owner->get_enter_cost();
-				}
-				prev_least_cost_id = least_cost_id;
+			float poly_enter_cost = 0.0;
+			if (least_cost_polygon->cluster_id != connection_polygon.cluster_id) {
+				poly_enter_cost = connection_cluster.enter_cost;
+			}
 
-				Vector3 pathway[2] = { connection.pathway_start, connection.pathway_end };
-				const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_poly.entry, pathway);
-				const float new_distance = (least_cost_poly.entry.distance_to(new_entry) * poly_travel_cost) + poly_enter_cost + least_cost_poly.traveled_distance;
-
-				int64_t already_visited_polygon_index = navigation_polys.find(gd::NavigationPoly(connection.polygon));
-
-				if (already_visited_polygon_index != -1) {
-					// Polygon already visited, check if we can reduce the travel cost.
-					gd::NavigationPoly &avp = navigation_polys[already_visited_polygon_index];
-					if (new_distance < avp.traveled_distance) {
-						avp.back_navigation_poly_id = least_cost_id;
-						avp.back_navigation_edge = connection.edge;
-						avp.back_navigation_edge_pathway_start = connection.pathway_start;
-						avp.back_navigation_edge_pathway_end = connection.pathway_end;
-						avp.traveled_distance = new_distance;
-						avp.entry = new_entry;
+			Vector3 pathway[2] = { connection.pathway_start, connection.pathway_end };
+			const Vector3 new_entry = Geometry3D::get_closest_point_to_segment(least_cost_entry, pathway);
+			const float new_distance = (least_cost_entry.distance_to(new_entry) * poly_travel_cost) + poly_enter_cost + least_cost_traveled_distance;
+			const float new_total_cost = new_distance + (new_entry.distance_to(end_point) * connection_cluster.travel_cost);
+
+			HashMap<uint32_t, uint32_t>::Iterator already_visited = navigation_poly_ids.find(connection.polygon);
+
+			if (already_visited) {
+				// Polygon already visited, check if we can reduce the travel cost.
+				gd::NavigationPoly &avp = navigation_polys[already_visited->value];
+				if (new_distance < avp.traveled_distance) {
+					avp.back_navigation_poly_id = least_cost_id;
+					avp.back_navigation_edge = connection.edge;
+					avp.back_navigation_edge_pathway_start = connection.pathway_start;
+					avp.back_navigation_edge_pathway_end = connection.pathway_end;
+					avp.traveled_distance = new_distance;
+					avp.total_cost = new_total_cost;
+					avp.entry = new_entry;
+					if (avp.heap_index != UINT32_MAX) {
+						to_visit.shift(avp.heap_index);
 					}
-				} else {
-					// Add the neighbor polygon to the reachable ones.
-					gd::NavigationPoly new_navigation_poly = gd::NavigationPoly(connection.polygon);
-					new_navigation_poly.self_id = navigation_polys.size();
-					new_navigation_poly.back_navigation_poly_id = least_cost_id;
-					new_navigation_poly.back_navigation_edge = connection.edge;
-					new_navigation_poly.back_navigation_edge_pathway_start = connection.pathway_start;
-					new_navigation_poly.back_navigation_edge_pathway_end = connection.pathway_end;
-					new_navigation_poly.traveled_distance = new_distance;
-					new_navigation_poly.entry = new_entry;
-					navigation_polys.push_back(new_navigation_poly);
-
-					// Add the neighbor polygon to the polygons to visit.
-					to_visit.push_back(navigation_polys.size() - 1);
 				}
+			} else {
+				// Add the neighbor polygon to the reachable ones.
+				gd::NavigationPoly new_navigation_poly = gd::NavigationPoly(&connection_polygon);
+				new_navigation_poly.self_id = navigation_polys.size();
+				new_navigation_poly.back_navigation_poly_id = least_cost_id;
+				new_navigation_poly.back_navigation_edge = connection.edge;
+				new_navigation_poly.back_navigation_edge_pathway_start = connection.pathway_start;
+				new_navigation_poly.back_navigation_edge_pathway_end = connection.pathway_end;
+				new_navigation_poly.traveled_distance = new_distance;
+				new_navigation_poly.total_cost = new_total_cost;
+				new_navigation_poly.entry = new_entry;
+				navigation_polys.push_back(new_navigation_poly);
+				navigation_poly_ids.insert(connection.polygon, new_navigation_poly.self_id);
+
+				// Add the neighbor polygon to the polygons to visit.
+				to_visit.push(new_navigation_poly.self_id);
 			}
 		}
 
-		// Removes the least cost polygon from the list of polygons to visit so we can advance.
-		to_visit.erase(least_cost_id);
-
 		// When the list of polygons to visit is empty at this point it means the End Polygon is not reachable
-		if (to_visit.size() == 0) {
-			// Thus use the further reachable polygon
-			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
-			is_reachable = false;
-			if (reachable_end == nullptr) {
-				// The path is not found and there is not a way out.
-				break;
-			}
+		if (to_visit.is_empty()) {
+			if (!cluster_in_route.is_empty()) {
+				// The end polygon couldn't be reached through the route clusters, search the whole map instead.
+				cluster_in_route.clear();
+				reachable_end = nullptr;
+				reachable_d = 1e30;
+			} else {
+				// Thus use the further reachable polygon
+				ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
+				is_reachable = false;
+				if (reachable_end == nullptr) {
+					// The path is not found and there is not a way out.
+					break;
+				}
 
-			// Set as end point the furthest reachable point.
-			end_poly = reachable_end;
-			end_d = 1e20;
-			for (size_t point_id = 2; point_id < end_poly->points.size(); point_id++) {
-				Face3 f(end_poly->points[0].pos, end_poly->points[point_id - 1].pos, end_poly->points[point_id].pos);
-				Vector3 spoint = f.get_closest_point_to(p_destination);
-				float dpoint = spoint.distance_to(p_destination);
-				if (dpoint < end_d) {
-					end_point = spoint;
-					end_d = dpoint;
+				// Set as end point the furthest reachable point.
+				end_poly = reachable_end;
+				end_d = 1e20;
+				for (uint32_t point_id = 2; point_id < end_poly->point_count; point_id++) {
+					Face3 f(map_snapshot.get_point(*end_poly, 0), map_snapshot.get_point(*end_poly, point_id - 1), map_snapshot.get_point(*end_poly, point_id));
+					Vector3 spoint = f.get_closest_point_to(p_destination);
+					float dpoint = spoint.distance_to(p_destination);
+					if (dpoint < end_d) {
+						end_point = spoint;
+						end_d = dpoint;
+					}
 				}
+
+				reachable_end = nullptr;
 			}
 
-			// Reset open and navigation_polys
+			// Reset the reached polygons.
 			gd::NavigationPoly np = navigation_polys[0];
 			navigation_polys.clear();
 			navigation_polys.push_back(np);
-			to_visit.clear();
-			to_visit.push_back(0);
+			navigation_poly_ids.clear();
+			navigation_poly_ids.insert(np.poly->id, 0);
 			least_cost_id = 0;
-			prev_least_cost_id = -1;
-
-			reachable_end = nullptr;
 
 			continue;
 		}
 
-		// Find the polygon with the minimum cost from the list of polygons to visit.
-		least_cost_id = -1;
-		float least_cost = 1e30;
-		for (List<uint32_t>::Element *element = to_visit.front(); element != nullptr; element = element->next()) {
-			gd::NavigationPoly *np = &navigation_polys[element->get()];
-			float cost = np->traveled_distance;
-			cost += (np->entry.distance_to(end_point) * np->poly->owner->get_travel_cost());
-			if (cost < least_cost) {
-				least_cost_id = np->self_id;
-				least_cost = cost;
-			}
-		}
-
-		ERR_BREAK(least_cost_id == -1);
+		// Take the polygon with the minimum cost from the list of polygons to visit.
+		least_cost_id = to_visit.pop();
 
 		// Stores the further reachable end polygon, in case our goal is not reachable.
 		if (is_reachable) {
-			float d = navigation_polys[least_cost_id].entry.distance_to(p_destination) * navigation_polys[least_cost_id].poly->owner->get_travel_cost();
+			float d = navigation_polys[least_cost_id].entry.distance_to(p_destination) * map_snapshot.clusters[navigation_polys[least_cost_id].poly->cluster_id].travel_cost;
 			if (reachable_d > d) {
 				reachable_d = d;
 				reachable_end = navigation_polys[least_cost_id].poly;
@@ -331,26 +376,27 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		Vector3 right_portal = apex_point;
 
 		gd::NavigationPoly *p = apex_poly;
+		const Vector3 &map_up = map_snapshot.up;
 
 		path.push_back(end_point);
-		APPEND_METADATA(end_poly);
+		APPEND_METADATA(map_snapshot, end_poly);
 
 		while (p) {
 			// Set left and right points of the pathway between polygons.
 			Vector3 left = p->back_navigation_edge_pathway_start;
 			Vector3 right = p->back_navigation_edge_pathway_end;
-			if (THREE_POINTS_CROSS_PRODUCT(apex_point, left, right).dot(up) < 0) {
+			if (THREE_POINTS_CROSS_PRODUCT(apex_point, left, right).dot(map_up) < 0) {
 				SWAP(left, right);
 			}
 
 			bool skip = false;
-			if (THREE_POINTS_CROSS_PRODUCT(apex_point, left_portal, left).dot(up) >= 0) {
+			if (THREE_POINTS_CROSS_PRODUCT(apex_point, left_portal, left).dot(map_up) >= 0) {
 				//process
-				if (left_portal == apex_point || THREE_POINTS_CROSS_PRODUCT(apex_point, left, right_portal).dot(up) > 0) {
+				if (left_portal == apex_point || THREE_POINTS_CROSS_PRODUCT(apex_point, left, right_portal).dot(map_up) > 0) {
 					left_poly = p;
 					left_portal = left;
 				} else {
-					clip_path(navigation_polys, path, apex_poly, right_portal, right_poly, r_path_types, r_path_rids, r_path_owners);
+					clip_path(map_snapshot, navigation_polys, path, apex_poly, right_portal, right_poly, r_path_types, r_path_rids, r_path_owners);
 
 					apex_point = right_portal;
 					p = right_poly;
@@ -360,18 +406,18 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					right_portal = apex_point;
 
 					path.push_back(apex_point);
-					APPEND_METADATA(apex_poly->poly);
+					APPEND_METADATA(map_snapshot, apex_poly->poly);
 					skip = true;
 				}
 			}
 
-			if (!skip && THREE_POINTS_CROSS_PRODUCT(apex_point, right_portal, right).dot(up) <= 0) {
+			if (!skip && THREE_POINTS_CROSS_PRODUCT(apex_point, right_portal, right).dot(map_up) <= 0) {
 				//process
-				if (right_portal == apex_point || THREE_POINTS_CROSS_PRODUCT(apex_point, right, left_portal).dot(up) < 0) {
+				if (right_portal == apex_point || THREE_POINTS_CROSS_PRODUCT(apex_point, right, left_portal).dot(map_up) < 0) {
 					right_poly = p;
 					right_portal = right;
 				} else {
-					clip_path(navigation_polys, path, apex_poly, left_portal, left_poly, r_path_types, r_path_rids, r_path_owners);
+					clip_path(map_snapshot, navigation_polys, path, apex_poly, left_portal, left_poly, r_path_types, r_path_rids, r_path_owners);
 
 					apex_point = left_portal;
 					p = left_poly;
@@ -381,7 +427,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					left_portal = apex_point;
 
 					path.push_back(apex_point);
-					APPEND_METADATA(apex_poly->poly);
+					APPEND_METADATA(map_snapshot, apex_poly->poly);
 				}
 			}
 
@@ -397,7 +443,7 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		// If the last point is not the begin point, add it to the list.
 		if (path[path.size() - 1] != begin_point) {
 			path.push_back(begin_point);
-			APPEND_METADATA(begin_poly);
+			APPEND_METADATA(map_snapshot, begin_poly);
 		}
 
 		path.reverse();
@@ -413,28 +459,29 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 	} else {
 		path.push_back(end_point);
-		APPEND_METADATA(end_poly);
+		APPEND_METADATA(map_snapshot, end_poly);
 
 		// Add mid points
 		int np_id = least_cost_id;
 		while (np_id != -1 && navigation_polys[np_id].back_navigation_poly_id != -1) {
 			if (navigation_polys[np_id].back_navigation_edge != -1) {
+				const gd::Polygon &np_poly = *navigation_polys[np_id].poly;
 				int prev = navigation_polys[np_id].back_navigation_edge;
-				int prev_n = (navigation_polys[np_id].back_navigation_edge + 1) % navigation_polys[np_id].poly->points.size();
-				Vector3 point = (navigation_polys[np_id].poly->points[prev].pos + navigation_polys[np_id].poly->points[prev_n].pos) * 0.5;
+				int prev_n = (navigation_polys[np_id].back_navigation_edge + 1) % np_poly.point_count;
+				Vector3 point = (map_snapshot.get_point(np_poly, prev) + map_snapshot.get_point(np_poly, prev_n)) * 0.5;
 
 				path.push_back(point);
-				APPEND_METADATA(navigation_polys[np_id].poly);
+				APPEND_METADATA(map_snapshot, navigation_polys[np_id].poly);
 			} else {
 				path.push_back(navigation_polys[np_id].entry);
-				APPEND_METADATA(navigation_polys[np_id].poly);
+				APPEND_METADATA(map_snapshot, navigation_polys[np_id].poly);
 			}
 
 			np_id = navigation_polys[np_id].back_navigation_poly_id;
 		}
 
 		path.push_back(begin_point);
-		APPEND_METADATA(begin_poly);
+		APPEND_METADATA(map_snapshot, begin_poly);
 
 		path.reverse();
 		if (r_path_types) {
@@ -461,10 +508,15 @@ Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector
 	Vector3 closest_point;
 	real_t closest_point_d = 1e20;
 
-	for (const gd::Polygon &p : polygons) {
+	const SnapshotRef snapshot_ref(this);
+	const NavMapSnapshot &map_snapshot = *snapshot_ref;
+
+	for (uint32_t polygon_index = 0; polygon_index < map_snapshot.region_polygon_count; polygon_index++) {
+		const gd::Polygon &p = map_snapshot.polygons[polygon_index];
+
 		// For each face check the distance to the segment
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+		for (uint32_t point_id = 2; point_id < p.point_count; point_id += 1) {
+			const Face3 f(map_snapshot.get_point(p, 0), map_snapshot.get_point(p, point_id - 1), map_snapshot.get_point(p, point_id));
 			Vector3 inters;
 			if (f.intersects_segment(p_from, p_to, &inters)) {
 				const real_t d = closest_point_d = p_from.distance_to(inters);
@@ -480,14 +532,14 @@ Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector
 		}
 
 		if (use_collision == false) {
-			for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
+			for (uint32_t point_id = 0; point_id < p.point_count; point_id += 1) {
 				Vector3 a, b;
 
 				Geometry3D::get_closest_points_between_segments(
 						p_from,
 						p_to,
-						p.points[point_id].pos,
-						p.points[(point_id + 1) % p.points.size()].pos,
+						map_snapshot.get_point(p, point_id),
+						map_snapshot.get_point(p, (point_id + 1) % p.point_count),
 						a,
 						b);
 
@@ -518,22 +570,200 @@ RID NavMap::get_closest_point_owner(const Vector3 &p_point) const {
 	return cp.owner;
 }
 
+Ref<NavigationFlowField3D> NavMap::get_flow_field(const Vector3 &p_destination, uint32_t p_navigation_layers) const {
+	const SnapshotRef snapshot_ref(this);
+	const NavMapSnapshot &map_snapshot = *snapshot_ref;
+
+	// Destinations in the same cell share their field.
+	gd::FlowFieldKey key;
+	key.destination = p_destination.snapped(Vector3(map_snapshot.cell_size, map_snapshot.cell_size, map_snapshot.cell_size));
+	key.navigation_layers = p_navigation_layers;
+
+	Ref<NavigationFlowField3D> flow_field;
+	{
+		MutexLock lock(map_snapshot.flow_field_cache_mutex);
+		const Ref<NavigationFlowField3D> *cached_flow_field = map_snapshot.flow_field_cache.getptr(key);
+		if (cached_flow_field) {
+			return *cached_flow_field;
+		}
+
+		// Another caller is building this field, wait for it instead of building it again.
+		HashMap<gd::FlowFieldKey, Ref<NavigationFlowField3D>, gd::FlowFieldKey>::Iterator flow_field_build = map_snapshot.flow_field_builds.find(key);
+		if (flow_field_build) {
+			flow_field = flow_field_build->value;
+			while (map_snapshot.flow_field_builds.has(key)) {
+				map_snapshot.flow_field_built.wait(lock);
+			}
+			return flow_field;
+		}
+
+		flow_field.instantiate();
+		map_snapshot.flow_field_builds.insert(key, flow_field);
+	}
+
+	// Built outside of the lock, so fields of other destinations can be built at the same time.
+	_build_flow_field(map_snapshot, key.destination, p_navigation_layers, flow_field.ptr());
+
+	{
+		MutexLock lock(map_snapshot.flow_field_cache_mutex);
+		map_snapshot.flow_field_cache.insert(key, flow_field);
+		map_snapshot.flow_field_builds.erase(key);
+	}
+	map_snapshot.flow_field_built.notify_all();
+	return flow_field;
+}
+
+void NavMap::_build_flow_field(const NavMapSnapshot &p_snapshot, const Vector3 &p_destination, uint32_t p_navigation_layers, NavigationFlowField3D *r_flow_field) {
+	const uint32_t polygon_count = p_snapshot.polygons.size();
+
+	// Find the destination polygon.
+	int64_t end_polygon = -1;
+	Vector3 end_point = p_destination;
+	real_t end_distance = 1e20;
+	for (uint32_t polygon_index = 0; polygon_index < p_snapshot.region_polygon_count; polygon_index++) {
+		const gd::Polygon &p = p_snapshot.polygons[polygon_index];
+		if ((p_navigation_layers & p_snapshot.clusters[p.cluster_id].navigation_layers) == 0) {
+			continue;
+		}
+
+		for (uint32_t point_id = 2; point_id < p.point_count; point_id++) {
+			const Face3 face(p_snapshot.get_point(p, 0), p_snapshot.get_point(p, point_id - 1), p_snapshot.get_point(p, point_id));
+			const Vector3 point = face.get_closest_point_to(p_destination);
+			const real_t distance = point.distance_to(p_destination);
+			if (distance < end_distance) {
+				end_distance = distance;
+				end_polygon = polygon_index;
+				end_point = point;
+			}
+		}
+	}
+
+	LocalVector<gd::FlowFieldPoly> flow_field_polys;
+	flow_field_polys.resize(polygon_count);
+
+	if (end_polygon != -1) {
+		// The field is built backward from the destination, so list the connections entering each polygon.
+		LocalVector<uint32_t> incoming_begin;
+		incoming_begin.resize(polygon_count + 1);
+		memset(incoming_begin.ptr(), 0, incoming_begin.size() * sizeof(uint32_t));
+		for (const gd::Polygon &polygon : p_snapshot.polygons) {
+			if ((p_navigation_layers & p_snapshot.clusters[polygon.cluster_id].navigation_layers) == 0) {
+				continue;
+			}
+			const uint32_t connection_count = p_snapshot.get_connection_count(polygon);
+			for (uint32_t connection_index = 0; connection_index < connection_count; connection_index++) {
+				incoming_begin[p_snapshot.get_connection(polygon, connection_index).polygon + 1]++;
+			}
+		}
+		for (uint32_t polygon_index = 0; polygon_index < polygon_count; polygon_index++) {
+			incoming_begin[polygon_index + 1] += incoming_begin[polygon_index];
+		}
+
+		LocalVector<uint32_t> incoming_polygons;
+		LocalVector<gd::Connection> incoming_connections;
+		incoming_polygons.resize(incoming_begin[polygon_count]);
+		incoming_connections.resize(incoming_begin[polygon_count]);
+		LocalVector<uint32_t> incoming_fill;
+		incoming_fill.resize(polygon_count);
+		memcpy(incoming_fill.ptr(), incoming_begin.ptr(), polygon_count * sizeof(uint32_t));
+		for (const gd::Polygon &polygon : p_snapshot.polygons) {
+			if ((p_navigation_layers & p_snapshot.clusters[polygon.cluster_id].navigation_layers) == 0) {
+				continue;
+			}
+			const uint32_t connection_count = p_snapshot.get_connection_count(polygon);
+			for (uint32_t connection_index = 0; connection_index < connection_count; connection_index++) {
+				const gd::Connection connection = p_snapshot.get_connection(polygon, connection_index);
+				const uint32_t index = incoming_fill[connection.polygon]++;
+				incoming_polygons[index] = polygon.id;
+				incoming_connections[index] = connection;
+			}
+		}
+
+		// Polygons to visit, sorted by their cost to the destination.
+		gd::FlowFieldPolyCostLess less_than;
+		less_than.flow_field_polys = &flow_field_polys;
+		gd::FlowFieldPolyHeapIndexer indexer;
+		indexer.flow_field_polys = &flow_field_polys;
+		IndexedHeap<uint32_t, gd::FlowFieldPolyCostLess, gd::FlowFieldPolyHeapIndexer> to_visit(less_than, indexer);
+
+		flow_field_polys[end_polygon].cost = 0.0;
+		flow_field_polys[end_polygon].target = end_point;
+		to_visit.push(end_polygon);
+
+		// Dijkstra from the destination, each polygon leads to the neighbor with the cheapest way to the destination.
+		while (!to_visit.is_empty()) {
+			const uint32_t polygon_index = to_visit.pop();
+			const gd::Polygon &polygon = p_snapshot.polygons[polygon_index];
+			const gd::Cluster &cluster = p_snapshot.clusters[polygon.cluster_id];
+			const float cost = flow_field_polys[polygon_index].cost;
+			const Vector3 target = flow_field_polys[polygon_index].target;
+
+			for (uint32_t incoming_index = incoming_begin[polygon_index]; incoming_index < incoming_begin[polygon_index + 1]; incoming_index++) {
+				const uint32_t from_index = incoming_polygons[incoming_index];
+				const gd::Connection &connection = incoming_connections[incoming_index];
+
+				float enter_cost = 0.0;
+				if (p_snapshot.polygons[from_index].cluster_id != polygon.cluster_id) {
+					enter_cost = cluster.enter_cost;
+				}
+
+				// Agents leave the neighbor through the point of the gateway closest to where they go next.
+				Vector3 pathway[2] = { connection.pathway_start, connection.pathway_end };
+				const Vector3 from_target = Geometry3D::get_closest_point_to_segment(target, pathway);
+				const float from_cost = cost + from_target.distance_to(target) * cluster.travel_cost + enter_cost;
+
+				gd::FlowFieldPoly &from_poly = flow_field_polys[from_index];
+				if (from_poly.cost < 0.0 || from_cost < from_poly.cost) {
+					from_poly.cost = from_cost;
+					from_poly.target = from_target;
+					from_poly.next = polygon_index;
+					if (from_poly.heap_index != UINT32_MAX) {
+						to_visit.shift(from_poly.heap_index);
+					} else {
+						to_visit.push(from_index);
+					}
+				}
+			}
+		}
+	}
+
+	r_flow_field->set_destination(end_point);
+	r_flow_field->set_up(p_snapshot.up);
+	r_flow_field->set_arrival_distance(p_snapshot.cell_size);
+
+	LocalVector<Vector3> polygon_points;
+	for (uint32_t polygon_index = 0; polygon_index < polygon_count; polygon_index++) {
+		const gd::Polygon &polygon = p_snapshot.polygons[polygon_index];
+		polygon_points.resize(polygon.point_count);
+		for (uint32_t point_index = 0; point_index < polygon.point_count; point_index++) {
+			polygon_points[point_index] = p_snapshot.get_point(polygon, point_index);
+		}
+		const gd::FlowFieldPoly &flow_field_poly = flow_field_polys[polygon_index];
+		r_flow_field->add_polygon(polygon_points.ptr(), polygon_points.size(), flow_field_poly.target, flow_field_poly.next, flow_field_poly.cost, p_snapshot.clusters[polygon.cluster_id].travel_cost);
+	}
+	// Agents stand on regions, links are only followed.
+	r_flow_field->build_lookup(p_snapshot.region_polygon_count);
+}
+
 gd::ClosestPointQueryResult NavMap::get_closest_point_info(const Vector3 &p_point) const {
 	gd::ClosestPointQueryResult result;
 	real_t closest_point_ds = 1e20;
 
-	for (size_t i(0); i < polygons.size(); i++) {
-		const gd::Polygon &p = polygons[i];
+	const SnapshotRef snapshot_ref(this);
+	const NavMapSnapshot &map_snapshot = *snapshot_ref;
+
+	for (size_t i(0); i < map_snapshot.region_polygon_count; i++) {
+		const gd::Polygon &p = map_snapshot.polygons[i];
 
 		// For each face check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+		for (uint32_t point_id = 2; point_id < p.point_count; point_id += 1) {
+			const Face3 f(map_snapshot.get_point(p, 0), map_snapshot.get_point(p, point_id - 1), map_snapshot.get_point(p, point_id));
 			const Vector3 inters = f.get_closest_point_to(p_point);
 			const real_t ds = inters.distance_squared_to(p_point);
 			if (ds < closest_point_ds) {
 				result.point = inters;
 				result.normal = f.get_plane().normal;
-				result.owner = p.owner->get_self();
+				result.owner = map_snapshot.clusters[p.cluster_id].self;
 				closest_point_ds = ds;
 			}
 		}
@@ -605,6 +835,44 @@ void NavMap::remove_agent_as_controlled(NavAgent *agent) {
 	}
 }
 
+// Connects the free edge `p_edge` to the free edge `p_other` when both are close enough, see `NavMap::sync`.
+static bool _connect_free_edges(const Vector3 &p_edge_p1, const Vector3 &p_edge_p2, const Vector3 &p_other_p1, const Vector3 &p_other_p2, real_t p_margin, gd::Connection &r_connection) {
+	// Compute the projection of the opposite edge on the current one
+	Vector3 edge_vector = p_edge_p2 - p_edge_p1;
+	float projected_p1_ratio = edge_vector.dot(p_other_p1 - p_edge_p1) / (edge_vector.length_squared());
+	float projected_p2_ratio = edge_vector.dot(p_other_p2 - p_edge_p1) / (edge_vector.length_squared());
+	if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+		return false;
+	}
+
+	// Check if the two edges are close to each other enough and compute a pathway between the two regions.
+	Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + p_edge_p1;
+	Vector3 other1;
+	if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
+		other1 = p_other_p1;
+	} else {
+		other1 = p_other_p1.lerp(p_other_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other1.distance_to(self1) > p_margin) {
+		return false;
+	}
+
+	Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + p_edge_p1;
+	Vector3 other2;
+	if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
+		other2 = p_other_p2;
+	} else {
+		other2 = p_other_p1.lerp(p_other_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other2.distance_to(self2) > p_margin) {
+		return false;
+	}
+
+	r_connection.pathway_start = (self1 + other1) / 2.0;
+	r_connection.pathway_end = (self2 + other2) / 2.0;
+	return true;
+}
+
 void NavMap::sync() {
 	// Performance Monitor
 	int _new_pm_region_count = regions.size();
@@ -624,6 +892,7 @@ void NavMap::sync() {
 		regenerate_links = true;
 	}
 
+	// Only the regions that changed rebuild their polygons and the connections between them.
 	for (NavRegion *region : regions) {
 		if (region->sync()) {
 			regenerate_links = true;
@@ -636,6 +905,8 @@ void NavMap::sync() {
 		}
 	}
 
+	NavMapSnapshot *new_snapshot = nullptr;
+
 	if (regenerate_links) {
 		_new_pm_polygon_count = 0;
 		_new_pm_edge_count = 0;
@@ -643,70 +914,110 @@ void NavMap::sync() {
 		_new_pm_edge_connection_count = 0;
 		_new_pm_edge_free_count = 0;
 
+		new_snapshot = _create_snapshot();
+		LocalVector<gd::Polygon> &polygons = new_snapshot->polygons;
+		LocalVector<gd::Point> &points = new_snapshot->points;
+
 		// Remove regions connections.
 		for (NavRegion *region : regions) {
 			region->get_connections().clear();
 		}
 
 		// Resize the polygon count.
-		int count = 0;
+		uint32_t polygon_count = 0;
 		for (const NavRegion *region : regions) {
-			count += region->get_polygons().size();
+			polygon_count += region->get_polygons().size();
 		}
-		polygons.resize(count);
-
-		// Copy all region polygons in the map.
-		count = 0;
-		for (const NavRegion *region : regions) {
-			const LocalVector<gd::Polygon> &polygons_source = region->get_polygons();
+		polygons.resize(polygon_count);
+
+		// Index all region polygons in the map, their points and connections stay in the shared region data.
+		LocalVector<uint32_t> &region_polygon_begin = new_snapshot->region_polygon_begin;
+		region_polygon_begin.resize(regions.size());
+		new_snapshot->region_data.resize(regions.size());
+		new_snapshot->cluster_points.resize(regions.size() + links.size());
+		polygon_count = 0;
+		for (uint32_t region_index = 0; region_index < regions.size(); region_index++) {
+			const NavRegion *region = regions[region_index];
+			gd::RegionData *region_data = region->get_data();
+			region_data->reference();
+			new_snapshot->region_data[region_index] = region_data;
+			new_snapshot->cluster_points[region_index] = region_data->points.ptr();
+
+			const LocalVector<gd::Polygon> &polygons_source = region_data->polygons;
 			for (uint32_t n = 0; n < polygons_source.size(); n++) {
-				polygons[count + n] = polygons_source[n];
+				gd::Polygon &polygon = polygons[polygon_count + n];
+				polygon = polygons_source[n];
+				polygon.id = polygon_count + n;
+				polygon.cluster_id = region_index;
 			}
-			count += region->get_polygons().size();
+			region_polygon_begin[region_index] = polygon_count;
+			polygon_count += polygons_source.size();
+
+			_new_pm_edge_count += region->get_edge_count();
+			_new_pm_edge_merge_count += region->get_polygon_connections().size() / 2;
 		}
+		const uint32_t region_polygon_count = polygon_count;
+		new_snapshot->region_polygon_count = region_polygon_count;
 
 		_new_pm_polygon_count = polygons.size();
 
-		// Group all edges per key.
-		HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey> connections;
-		for (gd::Polygon &poly : polygons) {
-			for (uint32_t p = 0; p < poly.points.size(); p++) {
-				int next_point = (p + 1) % poly.points.size();
-				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
-
-				HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey>::Iterator connection = connections.find(ek);
-				if (!connection) {
-					connections[ek] = Vector<gd::Edge::Connection>();
-					_new_pm_edge_count += 1;
+		// Connections leaving regions, added after the connections inside each region.
+		struct ExtraConnection {
+			uint32_t from_polygon = 0;
+			gd::Connection connection;
+		};
+		LocalVector<ExtraConnection> extra_connections;
+
+		// Connect the edges that are shared by different regions.
+		LocalVector<gd::FreeEdge> free_edges;
+		LocalVector<uint8_t> free_edge_merged;
+		HashMap<gd::EdgeKey, uint32_t, gd::EdgeKey> free_edge_ids;
+		for (uint32_t region_index = 0; region_index < regions.size(); region_index++) {
+			for (const gd::FreeEdge &region_free_edge : regions[region_index]->get_free_edges()) {
+				gd::FreeEdge free_edge;
+				free_edge.polygon = region_polygon_begin[region_index] + region_free_edge.polygon;
+				free_edge.edge = region_free_edge.edge;
+				const gd::Polygon &poly = polygons[free_edge.polygon];
+				const gd::EdgeKey ek(new_snapshot->get_polygon_point(poly, free_edge.edge).key, new_snapshot->get_polygon_point(poly, (free_edge.edge + 1) % poly.point_count).key);
+
+				HashMap<gd::EdgeKey, uint32_t, gd::EdgeKey>::Iterator free_edge_id = free_edge_ids.find(ek);
+				if (!free_edge_id) {
+					free_edge_ids.insert(ek, free_edges.size());
+					free_edges.push_back(free_edge);
+					free_edge_merged.push_back(0);
+					continue;
 				}
-				if (connections[ek].size() <= 1) {
-					// Add the polygon/edge tuple to this key.
-					gd::Edge::Connection new_connection;
-					new_connection.polygon = &poly;
-					new_connection.edge = p;
-					new_connection.pathway_start = poly.points[p].pos;
-					new_connection.pathway_end = poly.points[next_point].pos;
-					connections[ek].push_back(new_connection);
-				} else {
+
+				// Both regions counted this edge.
+				_new_pm_edge_count -= 1;
+				if (free_edge_id->value == UINT32_MAX) {
 					// The edge is already connected with another edge, skip.
 					ERR_PRINT_ONCE("Attempted to merge a navigation mesh triangle edge with another already-merged edge. This happens when the current `cell_size` is different from the one used to generate the navigation mesh. This will cause navigation problems.");
+					continue;
 				}
-			}
-		}
 
-		Vector<gd::Edge::Connection> free_edges;
-		for (KeyValue<gd::EdgeKey, Vector<gd::Edge::Connection>> &E : connections) {
-			if (E.value.size() == 2) {
-				// Connect edge that are shared in different polygons.
-				gd::Edge::Connection &c1 = E.value.write[0];
-				gd::Edge::Connection &c2 = E.value.write[1];
-				c1.polygon->edges[c1.edge].connections.push_back(c2);
-				c2.polygon->edges[c2.edge].connections.push_back(c1);
+				const gd::FreeEdge &other_edge = free_edges[free_edge_id->value];
+				const gd::Polygon &other_poly = polygons[other_edge.polygon];
 				// Note: The pathway_start/end are full for those connection and do not need to be modified.
+				ExtraConnection c1;
+				c1.from_polygon = free_edge.polygon;
+				c1.connection.polygon = other_edge.polygon;
+				c1.connection.edge = other_edge.edge;
+				c1.connection.pathway_start = new_snapshot->get_point(other_poly, other_edge.edge);
+				c1.connection.pathway_end = new_snapshot->get_point(other_poly, (other_edge.edge + 1) % other_poly.point_count);
+				extra_connections.push_back(c1);
+
+				ExtraConnection c2;
+				c2.from_polygon = other_edge.polygon;
+				c2.connection.polygon = free_edge.polygon;
+				c2.connection.edge = free_edge.edge;
+				c2.connection.pathway_start = new_snapshot->get_point(poly, free_edge.edge);
+				c2.connection.pathway_end = new_snapshot->get_point(poly, (free_edge.edge + 1) % poly.point_count);
+				extra_connections.push_back(c2);
+
+				free_edge_merged[free_edge_id->value] = 1;
+				free_edge_id->value = UINT32_MAX;
 				_new_pm_edge_merge_count += 1;
-			} else {
-				CRASH_COND_MSG(E.value.size() != 1, vformat("Number of connection != 1. Found: %d", E.value.size()));
-				free_edges.push_back(E.value[0]);
 			}
 		}
 
@@ -717,88 +1028,91 @@ void NavMap::sync() {
 		// to be connected, create new polygons to remove that small gap is
 		// not really useful and would result in wasteful computation during
 		// connection, integration and path finding.
-		_new_pm_edge_free_count = free_edges.size();
-
-		for (int i = 0; i < free_edges.size(); i++) {
-			const gd::Edge::Connection &free_edge = free_edges[i];
-			Vector3 edge_p1 = free_edge.polygon->points[free_edge.edge].pos;
-			Vector3 edge_p2 = free_edge.polygon->points[(free_edge.edge + 1) % free_edge.polygon->points.size()].pos;
-
-			for (int j = 0; j < free_edges.size(); j++) {
-				const gd::Edge::Connection &other_edge = free_edges[j];
-				if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
-					continue;
-				}
+		struct FreeEdgeBounds {
+			gd::FreeEdge edge;
+			uint32_t cluster_id = 0;
+			Vector3 p1;
+			Vector3 p2;
+			AABB bounds;
+		};
+		struct FreeEdgeBoundsMinX {
+			_FORCE_INLINE_ bool operator()(const FreeEdgeBounds &p_a, const FreeEdgeBounds &p_b) const {
+				return p_a.bounds.position.x < p_b.bounds.position.x;
+			}
+		};
+		LocalVector<FreeEdgeBounds> free_edge_bounds;
+		for (uint32_t i = 0; i < free_edges.size(); i++) {
+			if (free_edge_merged[i]) {
+				continue;
+			}
+			const gd::Polygon &poly = polygons[free_edges[i].polygon];
+			FreeEdgeBounds edge_bounds;
+			edge_bounds.edge = free_edges[i];
+			edge_bounds.cluster_id = poly.cluster_id;
+			edge_bounds.p1 = new_snapshot->get_point(poly, free_edges[i].edge);
+			edge_bounds.p2 = new_snapshot->get_point(poly, (free_edges[i].edge + 1) % poly.point_count);
+			edge_bounds.bounds.position = edge_bounds.p1;
+			edge_bounds.bounds.expand_to(edge_bounds.p2);
+			edge_bounds.bounds.grow_by(edge_connection_margin * 0.5);
+			free_edge_bounds.push_back(edge_bounds);
+		}
+		_new_pm_edge_free_count = free_edge_bounds.size();
 
-				Vector3 other_edge_p1 = other_edge.polygon->points[other_edge.edge].pos;
-				Vector3 other_edge_p2 = other_edge.polygon->points[(other_edge.edge + 1) % other_edge.polygon->points.size()].pos;
+		// Sorted along X, only the edges whose bounds overlap can be close enough.
+		free_edge_bounds.sort_custom<FreeEdgeBoundsMinX>();
+		for (uint32_t i = 0; i < free_edge_bounds.size(); i++) {
+			const FreeEdgeBounds &free_edge = free_edge_bounds[i];
+			const real_t max_x = free_edge.bounds.position.x + free_edge.bounds.size.x;
 
-				// Compute the projection of the opposite edge on the current one
-				Vector3 edge_vector = edge_p2 - edge_p1;
-				float projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
-				float projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
-				if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+			for (uint32_t j = i + 1; j < free_edge_bounds.size() && free_edge_bounds[j].bounds.position.x <= max_x; j++) {
+				const FreeEdgeBounds &other_edge = free_edge_bounds[j];
+				if (free_edge.cluster_id == other_edge.cluster_id || !free_edge.bounds.intersects_inclusive(other_edge.bounds)) {
 					continue;
 				}
 
-				// Check if the two edges are close to each other enough and compute a pathway between the two regions.
-				Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other1;
-				if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
-					other1 = other_edge_p1;
-				} else {
-					other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other1.distance_to(self1) > edge_connection_margin) {
-					continue;
-				}
+				// The edges can now be connected, each one is checked against the other.
+				const FreeEdgeBounds *pair[2] = { &free_edge, &other_edge };
+				for (int side = 0; side < 2; side++) {
+					const FreeEdgeBounds &from = *pair[side];
+					const FreeEdgeBounds &to = *pair[1 - side];
+
+					ExtraConnection new_connection;
+					new_connection.from_polygon = from.edge.polygon;
+					new_connection.connection.polygon = to.edge.polygon;
+					new_connection.connection.edge = to.edge.edge;
+					if (!_connect_free_edges(from.p1, from.p2, to.p1, to.p2, edge_connection_margin, new_connection.connection)) {
+						continue;
+					}
+					extra_connections.push_back(new_connection);
 
-				Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other2;
-				if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
-					other2 = other_edge_p2;
-				} else {
-					other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other2.distance_to(self2) > edge_connection_margin) {
-					continue;
+					// Add the connection to the region_connection map.
+					regions[from.cluster_id]->get_connections().push_back(new_connection.connection);
+					_new_pm_edge_connection_count += 1;
 				}
-
-				// The edges can now be connected.
-				gd::Edge::Connection new_connection = other_edge;
-				new_connection.pathway_start = (self1 + other1) / 2.0;
-				new_connection.pathway_end = (self2 + other2) / 2.0;
-				free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
-
-				// Add the connection to the region_connection map.
-				((NavRegion *)free_edge.polygon->owner)->get_connections().push_back(new_connection);
-				_new_pm_edge_connection_count += 1;
 			}
 		}
 
-		uint32_t link_poly_idx = 0;
-		link_polygons.resize(links.size());
-
 		// Search for polygons within range of a nav link.
-		for (const NavLink *link : links) {
+		for (uint32_t link_index = 0; link_index < links.size(); link_index++) {
+			const NavLink *link = links[link_index];
 			const Vector3 start = link->get_start_position();
 			const Vector3 end = link->get_end_position();
 
-			gd::Polygon *closest_start_polygon = nullptr;
+			int64_t closest_start_polygon = -1;
 			real_t closest_start_distance = link_connection_radius;
 			Vector3 closest_start_point;
 
-			gd::Polygon *closest_end_polygon = nullptr;
+			int64_t closest_end_polygon = -1;
 			real_t closest_end_distance = link_connection_radius;
 			Vector3 closest_end_point;
 
 			// Create link to any polygons within the search radius of the start point.
-			for (uint32_t start_index = 0; start_index < polygons.size(); start_index++) {
-				gd::Polygon &start_poly = polygons[start_index];
+			for (uint32_t start_index = 0; start_index < region_polygon_count; start_index++) {
+				const gd::Polygon &start_poly = polygons[start_index];
 
 				// For each face check the distance to the start
-				for (uint32_t start_point_id = 2; start_point_id < start_poly.points.size(); start_point_id += 1) {
-					const Face3 start_face(start_poly.points[0].pos, start_poly.points[start_point_id - 1].pos, start_poly.points[start_point_id].pos);
+				for (uint32_t start_point_id = 2; start_point_id < start_poly.point_count; start_point_id += 1) {
+					const Face3 start_face(new_snapshot->get_point(start_poly, 0), new_snapshot->get_point(start_poly, start_point_id - 1), new_snapshot->get_point(start_poly, start_point_id));
 					const Vector3 start_point = start_face.get_closest_point_to(start);
 					const real_t start_distance = start_point.distance_to(start);
 
@@ -806,16 +1120,18 @@ void NavMap::sync() {
 					if (start_distance <= link_connection_radius && start_distance < closest_start_distance) {
 						closest_start_distance = start_distance;
 						closest_start_point = start_point;
-						closest_start_polygon = &start_poly;
+						closest_start_polygon = start_index;
 					}
 				}
 			}
 
 			// Find any polygons within the search radius of the end point.
-			for (gd::Polygon &end_poly : polygons) {
+			for (uint32_t end_index = 0; end_index < region_polygon_count; end_index++) {
+				const gd::Polygon &end_poly = polygons[end_index];
+
 				// For each face check the distance to the end
-				for (uint32_t end_point_id = 2; end_point_id < end_poly.points.size(); end_point_id += 1) {
-					const Face3 end_face(end_poly.points[0].pos, end_poly.points[end_point_id - 1].pos, end_poly.points[end_point_id].pos);
+				for (uint32_t end_point_id = 2; end_point_id < end_poly.point_count; end_point_id += 1) {
+					const Face3 end_face(new_snapshot->get_point(end_poly, 0), new_snapshot->get_point(end_poly, end_point_id - 1), new_snapshot->get_point(end_poly, end_point_id));
 					const Vector3 end_point = end_face.get_closest_point_to(end);
 					const real_t end_distance = end_point.distance_to(end);
 
@@ -823,76 +1139,137 @@ void NavMap::sync() {
 					if (end_distance <= link_connection_radius && end_distance < closest_end_distance) {
 						closest_end_distance = end_distance;
 						closest_end_point = end_point;
-						closest_end_polygon = &end_poly;
+						closest_end_polygon = end_index;
 					}
 				}
 			}
 
 			// If we have both a start and end point, then create a synthetic polygon to route through.
-			if (closest_start_polygon && closest_end_polygon) {
-				gd::Polygon &new_polygon = link_polygons[link_poly_idx++];
-				new_polygon.owner = link;
-
-				new_polygon.edges.clear();
-				new_polygon.edges.resize(4);
-				new_polygon.points.clear();
-				new_polygon.points.reserve(4);
+			if (closest_start_polygon != -1 && closest_end_polygon != -1) {
+				gd::Polygon new_polygon;
+				new_polygon.id = polygons.size();
+				new_polygon.cluster_id = regions.size() + link_index;
 
 				// Build a set of vertices that create a thin polygon going from the start to the end point.
-				new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
-				new_polygon.points.push_back({ closest_start_point, get_point_key(closest_start_point) });
-				new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
-				new_polygon.points.push_back({ closest_end_point, get_point_key(closest_end_point) });
-
-				Vector3 center;
-				for (int p = 0; p < 4; ++p) {
-					center += new_polygon.points[p].pos;
-				}
-				new_polygon.center = center / real_t(new_polygon.points.size());
+				new_polygon.point_begin = points.size();
+				new_polygon.point_count = 4;
+				points.push_back({ closest_start_point, get_point_key(closest_start_point) });
+				points.push_back({ closest_start_point, get_point_key(closest_start_point) });
+				points.push_back({ closest_end_point, get_point_key(closest_end_point) });
+				points.push_back({ closest_end_point, get_point_key(closest_end_point) });
+
+				new_polygon.center = (closest_start_point + closest_end_point) * 0.5;
 				new_polygon.clockwise = true;
 
 				// Setup connections to go forward in the link.
 				{
-					gd::Edge::Connection entry_connection;
-					entry_connection.polygon = &new_polygon;
-					entry_connection.edge = -1;
-					entry_connection.pathway_start = new_polygon.points[0].pos;
-					entry_connection.pathway_end = new_polygon.points[1].pos;
-					closest_start_polygon->edges[0].connections.push_back(entry_connection);
-
-					gd::Edge::Connection exit_connection;
-					exit_connection.polygon = closest_end_polygon;
-					exit_connection.edge = -1;
-					exit_connection.pathway_start = new_polygon.points[2].pos;
-					exit_connection.pathway_end = new_polygon.points[3].pos;
-					new_polygon.edges[2].connections.push_back(exit_connection);
+					ExtraConnection entry_connection;
+					entry_connection.from_polygon = closest_start_polygon;
+					entry_connection.connection.polygon = new_polygon.id;
+					entry_connection.connection.edge = -1;
+					entry_connection.connection.pathway_start = closest_start_point;
+					entry_connection.connection.pathway_end = closest_start_point;
+					extra_connections.push_back(entry_connection);
+
+					ExtraConnection exit_connection;
+					exit_connection.from_polygon = new_polygon.id;
+					exit_connection.connection.polygon = closest_end_polygon;
+					exit_connection.connection.edge = -1;
+					exit_connection.connection.pathway_start = closest_end_point;
+					exit_connection.connection.pathway_end = closest_end_point;
+					extra_connections.push_back(exit_connection);
 				}
 
 				// If the link is bi-directional, create connections from the end to the start.
 				if (link->is_bidirectional()) {
-					gd::Edge::Connection entry_connection;
-					entry_connection.polygon = &new_polygon;
-					entry_connection.edge = -1;
-					entry_connection.pathway_start = new_polygon.points[2].pos;
-					entry_connection.pathway_end = new_polygon.points[3].pos;
-					closest_end_polygon->edges[0].connections.push_back(entry_connection);
-
-					gd::Edge::Connection exit_connection;
-					exit_connection.polygon = closest_start_polygon;
-					exit_connection.edge = -1;
-					exit_connection.pathway_start = new_polygon.points[0].pos;
-					exit_connection.pathway_end = new_polygon.points[1].pos;
-					new_polygon.edges[0].connections.push_back(exit_connection);
+					ExtraConnection entry_connection;
+					entry_connection.from_polygon = closest_end_polygon;
+					entry_connection.connection.polygon = new_polygon.id;
+					entry_connection.connection.edge = -1;
+					entry_connection.connection.pathway_start = closest_end_point;
+					entry_connection.connection.pathway_end = closest_end_point;
+					extra_connections.push_back(entry_connection);
+
+					ExtraConnection exit_connection;
+					exit_connection.from_polygon = new_polygon.id;
+					exit_connection.connection.polygon = closest_start_polygon;
+					exit_connection.connection.edge = -1;
+					exit_connection.connection.pathway_start = closest_start_point;
+					exit_connection.connection.pathway_end = closest_start_point;
+					extra_connections.push_back(exit_connection);
 				}
+
+				polygons.push_back(new_polygon);
 			}
 		}
 
+		// The links points are complete.
+		for (uint32_t link_index = 0; link_index < links.size(); link_index++) {
+			new_snapshot->cluster_points[regions.size() + link_index] = points.ptr();
+		}
+
+		// Store the connections added by the map contiguously per polygon.
+		LocalVector<uint32_t> &map_connection_begin = new_snapshot->map_connection_begin;
+		map_connection_begin.resize(polygons.size() + 1);
+		memset(map_connection_begin.ptr(), 0, map_connection_begin.size() * sizeof(uint32_t));
+		for (const ExtraConnection &extra_connection : extra_connections) {
+			map_connection_begin[extra_connection.from_polygon + 1]++;
+		}
+		for (uint32_t polygon_index = 0; polygon_index < polygons.size(); polygon_index++) {
+			map_connection_begin[polygon_index + 1] += map_connection_begin[polygon_index];
+		}
+
+		LocalVector<uint32_t> extra_connection_offsets;
+		extra_connection_offsets.resize(polygons.size());
+		memcpy(extra_connection_offsets.ptr(), map_connection_begin.ptr(), polygons.size() * sizeof(uint32_t));
+		new_snapshot->connections.resize(extra_connections.size());
+		for (const ExtraConnection &extra_connection : extra_connections) {
+			new_snapshot->connections[extra_connection_offsets[extra_connection.from_polygon]++] = extra_connection.connection;
+		}
+
+		_build_clusters(*new_snapshot);
+
 		// Update the update ID.
 		map_update_id = (map_update_id + 1) % 9999999;
+	} else {
+		// Routes depend on the layers and costs of the clusters, which can change without changing the map.
+		bool clusters_changed = false;
+		for (const gd::Cluster &cluster : snapshot->clusters) {
+			if (cluster.navigation_layers != cluster.owner->get_navigation_layers() || cluster.enter_cost != cluster.owner->get_enter_cost() || cluster.travel_cost != cluster.owner->get_travel_cost()) {
+				clusters_changed = true;
+				break;
+			}
+		}
+		if (clusters_changed) {
+			new_snapshot = _create_snapshot();
+			new_snapshot->polygons = snapshot->polygons;
+			new_snapshot->region_polygon_count = snapshot->region_polygon_count;
+			new_snapshot->region_data = snapshot->region_data;
+			for (gd::RegionData *region_data : new_snapshot->region_data) {
+				region_data->reference();
+			}
+			new_snapshot->region_polygon_begin = snapshot->region_polygon_begin;
+			new_snapshot->points = snapshot->points;
+			new_snapshot->cluster_points = snapshot->cluster_points;
+			for (uint32_t cluster_index = new_snapshot->region_data.size(); cluster_index < new_snapshot->cluster_points.size(); cluster_index++) {
+				new_snapshot->cluster_points[cluster_index] = new_snapshot->points.ptr();
+			}
+			new_snapshot->connections = snapshot->connections;
+			new_snapshot->map_connection_begin = snapshot->map_connection_begin;
+			new_snapshot->clusters = snapshot->clusters;
+			new_snapshot->portals = snapshot->portals;
+			for (gd::Cluster &cluster : new_snapshot->clusters) {
+				_update_cluster_properties(cluster);
+			}
+		}
 	}
 
-	// Update agents tree.
-	if (agents_dirty) {
+	if (new_snapshot) {
+		_publish_snapshot(new_snapshot);
+	}
+
+	// Update agents tree, the spatial hash is rebuilt at each step instead.
+	if (agents_dirty && avoidance_backend == NavigationServer3D::AVOIDANCE_BACKEND_KD_TREE) {
 		// cannot use LocalVector here as RVO library expects std::vector to build KdTree
 		std::vector<RVO::Agent *> raw_agents;
 		raw_agents.reserve(controlled_agents.size());
@@ -917,15 +1294,260 @@ void NavMap::sync() {
 	pm_edge_free_count = _new_pm_edge_free_count;
 }
 
+NavMapSnapshot *NavMap::_create_snapshot() {
+	NavMapSnapshot *new_snapshot = spare_snapshot;
+	if (new_snapshot) {
+		// Reusing the previous snapshot keeps its allocations.
+		spare_snapshot = nullptr;
+		new_snapshot->clear();
+	} else {
+		new_snapshot = memnew(NavMapSnapshot);
+	}
+	new_snapshot->refcount.init();
+	new_snapshot->up = up;
+	new_snapshot->cell_size = cell_size;
+	return new_snapshot;
+}
+
+void NavMap::_publish_snapshot(NavMapSnapshot *p_snapshot) {
+	NavMapSnapshot *old_snapshot = nullptr;
+	{
+		MutexLock lock(snapshot_mutex);
+		old_snapshot = snapshot;
+		snapshot = p_snapshot;
+	}
+
+	// The queries still reading the old snapshot free it when they are done.
+	if (old_snapshot->refcount.unref()) {
+		if (spare_snapshot) {
+			memdelete(spare_snapshot);
+		}
+		spare_snapshot = old_snapshot;
+	}
+}
+
+void NavMap::_update_cluster_properties(gd::Cluster &r_cluster) {
+	r_cluster.self = r_cluster.owner->get_self();
+	r_cluster.owner_id = r_cluster.owner->get_owner_id();
+	r_cluster.type = r_cluster.owner->get_type();
+	r_cluster.navigation_layers = r_cluster.owner->get_navigation_layers();
+	r_cluster.enter_cost = r_cluster.owner->get_enter_cost();
+	r_cluster.travel_cost = r_cluster.owner->get_travel_cost();
+}
+
+void NavMap::_build_clusters(NavMapSnapshot &r_snapshot) const {
+	LocalVector<gd::Cluster> &clusters = r_snapshot.clusters;
+	clusters.resize(regions.size() + links.size());
+	for (uint32_t region_index = 0; region_index < regions.size(); region_index++) {
+		clusters[region_index] = gd::Cluster();
+		clusters[region_index].owner = regions[region_index];
+	}
+	for (uint32_t link_index = 0; link_index < links.size(); link_index++) {
+		clusters[regions.size() + link_index] = gd::Cluster();
+		clusters[regions.size() + link_index].owner = links[link_index];
+	}
+	for (gd::Cluster &cluster : clusters) {
+		_update_cluster_properties(cluster);
+	}
+
+	// Group the connections between clusters, a portal is placed at the average of their pathways.
+	struct Border {
+		Vector3 position_sum;
+		uint32_t connection_count = 0;
+	};
+	HashMap<uint64_t, Border> borders;
+	for (const gd::Polygon &polygon : r_snapshot.polygons) {
+		// Connections inside a region never cross clusters.
+		const uint32_t connection_count = r_snapshot.get_connection_count(polygon);
+		for (uint32_t connection_index = polygon.connection_count; connection_index < connection_count; connection_index++) {
+			const gd::Connection connection = r_snapshot.get_connection(polygon, connection_index);
+			const uint32_t to_cluster = r_snapshot.polygons[connection.polygon].cluster_id;
+			if (to_cluster == polygon.cluster_id) {
+				continue;
+			}
+			Border &border = borders[((uint64_t)polygon.cluster_id << 32) | to_cluster];
+			border.position_sum += (connection.pathway_start + connection.pathway_end) * 0.5;
+			border.connection_count++;
+		}
+	}
+
+	// Store the portals sorted by the cluster they leave.
+	for (const KeyValue<uint64_t, Border> &E : borders) {
+		clusters[E.key >> 32].portal_count++;
+	}
+	uint32_t portal_begin = 0;
+	for (gd::Cluster &cluster : clusters) {
+		cluster.portal_begin = portal_begin;
+		portal_begin += cluster.portal_count;
+		cluster.portal_count = 0;
+	}
+	r_snapshot.portals.resize(portal_begin);
+	for (const KeyValue<uint64_t, Border> &E : borders) {
+		gd::Cluster &cluster = clusters[E.key >> 32];
+		gd::Portal &portal = r_snapshot.portals[cluster.portal_begin + cluster.portal_count++];
+		portal.from_cluster = E.key >> 32;
+		portal.to_cluster = E.key & 0xFFFFFFFF;
+		portal.position = E.value.position_sum / real_t(E.value.connection_count);
+	}
+}
+
+struct PortalRouteNode {
+	float cost = 1e30;
+	int32_t back_portal = -1;
+	uint32_t heap_index = UINT32_MAX;
+};
+
+struct PortalRouteCostLess {
+	const LocalVector<PortalRouteNode> *nodes = nullptr;
+
+	bool operator()(uint32_t p_a, uint32_t p_b) const {
+		return (*nodes)[p_a].cost < (*nodes)[p_b].cost;
+	}
+};
+
+struct PortalRouteHeapIndexer {
+	LocalVector<PortalRouteNode> *nodes = nullptr;
+
+	void operator()(uint32_t p_portal, uint32_t p_heap_index) const {
+		(*nodes)[p_portal].heap_index = p_heap_index;
+	}
+};
+
+bool NavMap::_find_cluster_route(const NavMapSnapshot &p_snapshot, uint32_t p_begin_cluster, const Vector3 &p_begin_point, uint32_t p_end_cluster, const Vector3 &p_end_point, uint32_t p_navigation_layers, LocalVector<uint32_t> &r_route) {
+	const LocalVector<gd::Cluster> &clusters = p_snapshot.clusters;
+	const LocalVector<gd::Portal> &portals = p_snapshot.portals;
+
+	// Dijkstra search over the portals, each portal being entered at its position.
+	LocalVector<PortalRouteNode> nodes;
+	nodes.resize(portals.size());
+
+	PortalRouteCostLess less_than;
+	less_than.nodes = &nodes;
+	PortalRouteHeapIndexer indexer;
+	indexer.nodes = &nodes;
+	IndexedHeap<uint32_t, PortalRouteCostLess, PortalRouteHeapIndexer> to_visit(less_than, indexer);
+
+	const gd::Cluster &begin_cluster = clusters[p_begin_cluster];
+	const float begin_travel_cost = begin_cluster.travel_cost;
+	for (uint32_t portal_index = begin_cluster.portal_begin; portal_index < begin_cluster.portal_begin + begin_cluster.portal_count; portal_index++) {
+		const gd::Portal &portal = portals[portal_index];
+		const gd::Cluster &to_cluster = clusters[portal.to_cluster];
+		if ((p_navigation_layers & to_cluster.navigation_layers) == 0) {
+			continue;
+		}
+		nodes[portal_index].cost = p_begin_point.distance_to(portal.position) * begin_travel_cost + to_cluster.enter_cost;
+		to_visit.push(portal_index);
+	}
+
+	int32_t best_portal = -1;
+	float best_cost = 1e30;
+	while (!to_visit.is_empty()) {
+		const uint32_t portal_index = to_visit.pop();
+		const float cost = nodes[portal_index].cost;
+		if (cost >= best_cost) {
+			break;
+		}
+
+		const gd::Portal &portal = portals[portal_index];
+		const gd::Cluster &cluster = clusters[portal.to_cluster];
+		const float travel_cost = cluster.travel_cost;
+		if (portal.to_cluster == p_end_cluster) {
+			const float total_cost = cost + portal.position.distance_to(p_end_point) * travel_cost;
+			if (total_cost < best_cost) {
+				best_cost = total_cost;
+				best_portal = portal_index;
+			}
+			continue;
+		}
+
+		for (uint32_t next_index = cluster.portal_begin; next_index < cluster.portal_begin + cluster.portal_count; next_index++) {
+			const gd::Portal &next_portal = portals[next_index];
+			const gd::Cluster &to_cluster = clusters[next_portal.to_cluster];
+			if ((p_navigation_layers & to_cluster.navigation_layers) == 0) {
+				continue;
+			}
+			const float next_cost = cost + portal.position.distance_to(next_portal.position) * travel_cost + to_cluster.enter_cost;
+			PortalRouteNode &next_node = nodes[next_index];
+			if (next_cost < next_node.cost) {
+				next_node.cost = next_cost;
+				next_node.back_portal = portal_index;
+				if (next_node.heap_index != UINT32_MAX) {
+					to_visit.shift(next_node.heap_index);
+				} else {
+					to_visit.push(next_index);
+				}
+			}
+		}
+	}
+
+	if (best_portal == -1) {
+		return false;
+	}
+
+	r_route.clear();
+	for (int32_t portal_index = best_portal; portal_index != -1; portal_index = nodes[portal_index].back_portal) {
+		r_route.push_back(portals[portal_index].to_cluster);
+	}
+	r_route.push_back(p_begin_cluster);
+	r_route.invert();
+	return true;
+}
+
+bool NavMap::_get_cluster_route(const NavMapSnapshot &p_snapshot, uint32_t p_begin_cluster, const Vector3 &p_begin_point, uint32_t p_end_cluster, const Vector3 &p_end_point, uint32_t p_navigation_layers, LocalVector<uint32_t> &r_route) {
+	// Nearby points almost always take the same portals, so they share a cached route.
+	const real_t route_cell_size = p_snapshot.cell_size * ROUTE_CACHE_CELL_SCALE;
+
+	gd::ClusterRouteKey key;
+	key.begin_cluster = p_begin_cluster;
+	key.end_cluster = p_end_cluster;
+	key.begin_cell = (p_begin_point / route_cell_size).floor();
+	key.end_cell = (p_end_point / route_cell_size).floor();
+	key.navigation_layers = p_navigation_layers;
+
+	{
+		MutexLock lock(p_snapshot.route_cache_mutex);
+		const LocalVector<uint32_t> *cached_route = p_snapshot.route_cache.getptr(key);
+		if (cached_route) {
+			r_route = *cached_route;
+			return !r_route.is_empty();
+		}
+	}
+
+	if (!_find_cluster_route(p_snapshot, p_begin_cluster, p_begin_point, p_end_cluster, p_end_point, p_navigation_layers, r_route)) {
+		r_route.clear();
+	}
+
+	MutexLock lock(p_snapshot.route_cache_mutex);
+	p_snapshot.route_cache.insert(key, r_route);
+	return !r_route.is_empty();
+}
+
 void NavMap::compute_single_step(uint32_t index, NavAgent **agent) {
 	(*(agent + index))->get_agent()->computeNeighbors(&rvo);
 	(*(agent + index))->get_agent()->computeNewVelocity(deltatime);
 }
 
+void NavMap::_compute_single_step_with_grid(uint32_t p_index, NavAgent **p_agents) {
+	RVO::Agent *agent = p_agents[p_index]->get_agent();
+	avoidance_grid.compute_agent_neighbors(agent);
+	agent->computeNewVelocity(deltatime);
+}
+
 void NavMap::step(real_t p_deltatime) {
 	deltatime = p_deltatime;
 	if (controlled_agents.size() > 0) {
-		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::compute_single_step, controlled_agents.ptr(), controlled_agents.size(), -1, true, SNAME("NavigationMapAgents"));
+		WorkerThreadPool::GroupID group_task;
+		if (avoidance_backend == NavigationServer3D::AVOIDANCE_BACKEND_SPATIAL_HASH) {
+			// Agents move between steps, so the grid is rebuilt with their current positions.
+			avoidance_agents.resize(controlled_agents.size());
+			for (uint32_t i = 0; i < controlled_agents.size(); i++) {
+				avoidance_agents[i] = controlled_agents[i]->get_agent();
+			}
+			avoidance_grid.build(avoidance_agents.ptr(), avoidance_agents.size());
+			group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::_compute_single_step_with_grid, controlled_agents.ptr(), controlled_agents.size(), -1, true, SNAME("NavigationMapAgents"));
+		} else {
+			group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::compute_single_step, controlled_agents.ptr(), controlled_agents.size(), -1, true, SNAME("NavigationMapAgents"));
+		}
 		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 	}
 }
@@ -936,14 +1558,14 @@ void NavMap::dispatch_callbacks() {
 	}
 }
 
-void NavMap::clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
+void NavMap::clip_path(const NavMapSnapshot &p_snapshot, const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const {
 	Vector3 from = path[path.size() - 1];
 
 	if (from.is_equal_approx(p_to_point)) {
 		return;
 	}
 	Plane cut_plane;
-	cut_plane.normal = (from - p_to_point).cross(up);
+	cut_plane.normal = (from - p_to_point).cross(p_snapshot.up);
 	if (cut_plane.normal == Vector3()) {
 		return;
 	}
@@ -962,15 +1584,60 @@ void NavMap::clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys
 			if (cut_plane.intersects_segment(pathway_start, pathway_end, &inters)) {
 				if (!inters.is_equal_approx(p_to_point) && !inters.is_equal_approx(path[path.size() - 1])) {
 					path.push_back(inters);
-					APPEND_METADATA(from_poly->poly);
+					APPEND_METADATA(p_snapshot, from_poly->poly);
 				}
 			}
 		}
 	}
 }
 
+void NavMapSnapshot::clear() {
+	for (gd::RegionData *data : region_data) {
+		data->unreference();
+	}
+	polygons.clear();
+	region_polygon_count = 0;
+	region_data.clear();
+	region_polygon_begin.clear();
+	points.clear();
+	cluster_points.clear();
+	connections.clear();
+	map_connection_begin.clear();
+	clusters.clear();
+	portals.clear();
+	route_cache.clear();
+	flow_field_cache.clear();
+}
+
+NavMapSnapshot::~NavMapSnapshot() {
+	for (gd::RegionData *data : region_data) {
+		data->unreference();
+	}
+}
+
+NavMap::SnapshotRef::SnapshotRef(const NavMap *p_map) {
+	MutexLock lock(p_map->snapshot_mutex);
+	snapshot = p_map->snapshot;
+	snapshot->refcount.ref();
+}
+
+NavMap::SnapshotRef::~SnapshotRef() {
+	if (snapshot->refcount.unref()) {
+		memdelete(snapshot);
+	}
+}
+
 NavMap::NavMap() {
+	snapshot = memnew(NavMapSnapshot);
+	snapshot->refcount.init();
+	snapshot->up = up;
 }
 
 NavMap::~NavMap() {
+	if (snapshot->refcount.unref()) {
+		memdelete(snapshot);
+	}
+	if (spare_snapshot) {
+		memdelete(spare_snapshot);
+	}
 }
@@ -31,12 +31,19 @@
 #ifndef NAV_MAP_H
 #define NAV_MAP_H
 
+#include "nav_avoidance_grid.h"
 #include "nav_rid.h"
 
 #include "core/math/math_defs.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/os/condition_variable.h"
+#include "core/os/mutex.h"
+#include "core/templates/lru.h"
 #include "core/templates/rb_map.h"
+#include "core/templates/safe_refcount.h"
 #include "nav_utils.h"
+#include "servers/navigation/navigation_flow_field_3d.h"
+#include "servers/navigation_server_3d.h"
 
 #include <KdTree.h>
 
@@ -44,6 +51,79 @@ class NavLink;
 class NavRegion;
 class NavAgent;
 
+/// Polygons, connections and clusters of a map, built during sync and never modified after.
+/// Queries hold a reference to the snapshot they started with, so they never wait for a sync
+/// and a sync never waits for them.
+struct NavMapSnapshot {
+	SafeRefCount refcount;
+
+	Vector3 up;
+
+	/// Regions polygons first, then links polygons.
+	/// The points and connections inside each region are read from the region data, shared with
+	/// the next snapshots until the region changes.
+	LocalVector<gd::Polygon> polygons;
+	uint32_t region_polygon_count = 0;
+	LocalVector<gd::RegionData *> region_data;
+	LocalVector<uint32_t> region_polygon_begin;
+
+	/// Links points, and the points of each cluster.
+	LocalVector<gd::Point> points;
+	LocalVector<const gd::Point *> cluster_points;
+
+	/// Connections added by the map, between regions and with links, stored per polygon
+	/// from `map_connection_begin[polygon.id]` to `map_connection_begin[polygon.id + 1]`.
+	LocalVector<gd::Connection> connections;
+	LocalVector<uint32_t> map_connection_begin;
+
+	/// One cluster per region then one per link, and the portals between them.
+	/// Paths are first searched across clusters, then across the polygons of those clusters only.
+	LocalVector<gd::Cluster> clusters;
+	LocalVector<gd::Portal> portals;
+
+	/// Recently used routes between clusters, by clusters and coarse begin and end cells.
+	mutable Mutex route_cache_mutex;
+	mutable LRUCache<gd::ClusterRouteKey, LocalVector<uint32_t>, gd::ClusterRouteKey> route_cache;
+
+	/// Recently requested flow fields, agents sharing a destination share its field.
+	/// Fields still being built are listed apart, callers asking for them wait for the build.
+	mutable BinaryMutex flow_field_cache_mutex;
+	mutable LRUCache<gd::FlowFieldKey, Ref<NavigationFlowField3D>, gd::FlowFieldKey> flow_field_cache;
+	mutable HashMap<gd::FlowFieldKey, Ref<NavigationFlowField3D>, gd::FlowFieldKey> flow_field_builds;
+	ConditionVariable flow_field_built;
+
+	real_t cell_size = 0.25;
+
+	const gd::Point &get_polygon_point(const gd::Polygon &p_polygon, uint32_t p_index) const {
+		return cluster_points[p_polygon.cluster_id][p_polygon.point_begin + p_index];
+	}
+
+	const Vector3 &get_point(const gd::Polygon &p_polygon, uint32_t p_index) const {
+		return get_polygon_point(p_polygon, p_index).pos;
+	}
+
+	uint32_t get_connection_count(const gd::Polygon &p_polygon) const {
+		return p_polygon.connection_count + map_connection_begin[p_polygon.id + 1] - map_connection_begin[p_polygon.id];
+	}
+
+	/// Connections inside the polygon region come first, their polygon is made map-wide here.
+	gd::Connection get_connection(const gd::Polygon &p_polygon, uint32_t p_index) const {
+		if (p_index < p_polygon.connection_count) {
+			gd::Connection connection = region_data[p_polygon.cluster_id]->polygon_connections[p_polygon.connection_begin + p_index];
+			connection.polygon += region_polygon_begin[p_polygon.cluster_id];
+			return connection;
+		}
+		return connections[map_connection_begin[p_polygon.id] + p_index - p_polygon.connection_count];
+	}
+
+	void clear();
+
+	NavMapSnapshot() :
+			route_cache(256),
+			flow_field_cache(16) {}
+	~NavMapSnapshot();
+};
+
 class NavMap : public NavRid {
 	/// Map Up
 	Vector3 up = Vector3(0, 1, 0);
@@ -66,14 +146,34 @@ class NavMap : public NavRid {
 
 	/// Map links
 	LocalVector<NavLink *> links;
-	LocalVector<gd::Polygon> link_polygons;
 
-	/// Map polygons
-	LocalVector<gd::Polygon> polygons;
+	/// Snapshot read by the queries, replaced at the end of each sync that changed the map.
+	mutable Mutex snapshot_mutex;
+	NavMapSnapshot *snapshot = nullptr;
+	/// Previous snapshot, reused to build the next one once no query reads it anymore.
+	NavMapSnapshot *spare_snapshot = nullptr;
+
+	/// Keeps the current snapshot alive for the duration of a query.
+	class SnapshotRef {
+		NavMapSnapshot *snapshot = nullptr;
+
+	public:
+		const NavMapSnapshot &operator*() const { return *snapshot; }
+
+		SnapshotRef(const NavMap *p_map);
+		~SnapshotRef();
+	};
+
+	/// Neighbor search used by the avoidance.
+	NavigationServer3D::AvoidanceBackend avoidance_backend = NavigationServer3D::AVOIDANCE_BACKEND_KD_TREE;
 
 	/// Rvo world
 	RVO::KdTree rvo;
 
+	/// Spatial hash of the controlled agents, rebuilt at each step.
+	NavAvoidanceGrid avoidance_grid;
+	LocalVector<RVO::Agent *> avoidance_agents;
+
 	/// Is agent array modified?
 	bool agents_dirty = false;
 
@@ -123,6 +223,11 @@ public:
 		return link_connection_radius;
 	}
 
+	void set_avoidance_backend(NavigationServer3D::AvoidanceBackend p_avoidance_backend);
+	NavigationServer3D::AvoidanceBackend get_avoidance_backend() const {
+		return avoidance_backend;
+	}
+
 	gd::PointKey get_point_key(const Vector3 &p_pos) const;
 
 	Vector<Vector3> get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
@@ -131,6 +236,7 @@ public:
 	Vector3 get_closest_point_normal(const Vector3 &p_point) const;
 	gd::ClosestPointQueryResult get_closest_point_info(const Vector3 &p_point) const;
 	RID get_closest_point_owner(const Vector3 &p_point) const;
+	Ref<NavigationFlowField3D> get_flow_field(const Vector3 &p_destination, uint32_t p_navigation_layers) const;
 
 	void add_region(NavRegion *p_region);
 	void remove_region(NavRegion *p_region);
@@ -173,8 +279,18 @@ public:
 	int get_pm_edge_free_count() const { return pm_edge_free_count; }
 
 private:
+	NavMapSnapshot *_create_snapshot();
+	void _publish_snapshot(NavMapSnapshot *p_snapshot);
+
+	void _build_clusters(NavMapSnapshot &r_snapshot) const;
+	static void _update_cluster_properties(gd::Cluster &r_cluster);
+	static bool _find_cluster_route(const NavMapSnapshot &p_snapshot, uint32_t p_begin_cluster, const Vector3 &p_begin_point, uint32_t p_end_cluster, const Vector3 &p_end_point, uint32_t p_navigation_layers, LocalVector<uint32_t> &r_route);
+	static void _build_flow_field(const NavMapSnapshot &p_snapshot, const Vector3 &p_destination, uint32_t p_navigation_layers, NavigationFlowField3D *r_flow_field);
+	static bool _get_cluster_route(const NavMapSnapshot &p_snapshot, uint32_t p_begin_cluster, const Vector3 &p_begin_point, uint32_t p_end_cluster, const Vector3 &p_end_point, uint32_t p_navigation_layers, LocalVector<uint32_t> &r_route);
+
 	void compute_single_step(uint32_t index, NavAgent **agent);
-	void clip_path(const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
+	void _compute_single_step_with_grid(uint32_t p_index, NavAgent **p_agents);
+	void clip_path(const NavMapSnapshot &p_snapshot, const LocalVector<gd::NavigationPoly> &p_navigation_polys, Vector<Vector3> &path, const gd::NavigationPoly *from_poly, const Vector3 &p_to_point, const gd::NavigationPoly *p_to_poly, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
 };
 
 #endif // NAV_MAP_H
@@ -32,6 +32,15 @@
 
 #include "nav_map.h"
 
+NavRegion::NavRegion() {
+	type = NavigationUtilities::PathSegmentType::PATH_SEGMENT_TYPE_REGION;
+	data = memnew(gd::RegionData);
+}
+
+NavRegion::~NavRegion() {
+	data->unreference();
+}
+
 void NavRegion::set_map(NavMap *p_map) {
 	map = p_map;
 	polygons_dirty = true;
@@ -81,9 +90,16 @@ void NavRegion::update_polygons() {
 	if (!polygons_dirty) {
 		return;
 	}
-	polygons.clear();
+	// The snapshots still reading the previous data release it when they are done.
+	data->unreference();
+	data = memnew(gd::RegionData);
 	polygons_dirty = false;
 
+	LocalVector<gd::Polygon> &polygons = data->polygons;
+	LocalVector<gd::Point> &points = data->points;
+	LocalVector<gd::Connection> &polygon_connections = data->polygon_connections;
+	LocalVector<gd::FreeEdge> &free_edges = data->free_edges;
+
 	if (map == nullptr) {
 		return;
 	}
@@ -105,13 +121,14 @@ void NavRegion::update_polygons() {
 	// Build
 	for (size_t i(0); i < polygons.size(); i++) {
 		gd::Polygon &p = polygons[i];
-		p.owner = this;
+		p.id = i;
 
 		Vector<int> mesh_poly = mesh->get_polygon(i);
 		const int *indices = mesh_poly.ptr();
 		bool valid(true);
-		p.points.resize(mesh_poly.size());
-		p.edges.resize(mesh_poly.size());
+		p.point_begin = points.size();
+		p.point_count = mesh_poly.size();
+		points.resize(p.point_begin + p.point_count);
 
 		Vector3 center;
 		float sum(0);
@@ -124,8 +141,9 @@ void NavRegion::update_polygons() {
 			}
 
 			Vector3 point_position = transform.xform(vertices_r[idx]);
-			p.points[j].pos = point_position;
-			p.points[j].key = map->get_point_key(point_position);
+			gd::Point &point = points[p.point_begin + j];
+			point.pos = point_position;
+			point.key = map->get_point_key(point_position);
 
 			center += point_position; // Composing the center of the polygon
 
@@ -138,6 +156,8 @@ void NavRegion::update_polygons() {
 		}
 
 		if (!valid) {
+			points.resize(p.point_begin);
+			polygons.resize(i);
 			ERR_BREAK_MSG(!valid, "The navigation mesh set in this region is not valid!");
 		}
 
@@ -146,4 +166,67 @@ void NavRegion::update_polygons() {
 			p.center = center / float(mesh_poly.size());
 		}
 	}
+
+	// Group the edges per key, edges shared by two polygons are connected here once,
+	// the others are left for the map to connect with other regions.
+	struct SharedEdge {
+		gd::FreeEdge edges[2];
+		uint32_t count = 0;
+	};
+	LocalVector<SharedEdge> shared_edges;
+	HashMap<gd::EdgeKey, uint32_t, gd::EdgeKey> shared_edge_ids;
+	for (const gd::Polygon &p : polygons) {
+		for (uint32_t e = 0; e < p.point_count; e++) {
+			const gd::EdgeKey ek(points[p.point_begin + e].key, points[p.point_begin + (e + 1) % p.point_count].key);
+			HashMap<gd::EdgeKey, uint32_t, gd::EdgeKey>::Iterator shared_edge_id = shared_edge_ids.find(ek);
+			if (!shared_edge_id) {
+				shared_edge_id = shared_edge_ids.insert(ek, shared_edges.size());
+				shared_edges.push_back(SharedEdge());
+			}
+			SharedEdge &shared_edge = shared_edges[shared_edge_id->value];
+			if (shared_edge.count < 2) {
+				shared_edge.edges[shared_edge.count].polygon = p.id;
+				shared_edge.edges[shared_edge.count].edge = e;
+				shared_edge.count++;
+			} else {
+				// The edge is already connected with another edge, skip.
+				ERR_PRINT_ONCE("Attempted to merge a navigation mesh triangle edge with another already-merged edge. This happens when the current `cell_size` is different from the one used to generate the navigation mesh. This will cause navigation problems.");
+			}
+		}
+	}
+	data->edge_count = shared_edges.size();
+
+	// Store the connections of each polygon contiguously.
+	for (const SharedEdge &shared_edge : shared_edges) {
+		if (shared_edge.count == 2) {
+			polygons[shared_edge.edges[0].polygon].connection_count++;
+			polygons[shared_edge.edges[1].polygon].connection_count++;
+		} else {
+			free_edges.push_back(shared_edge.edges[0]);
+		}
+	}
+	uint32_t connection_begin = 0;
+	for (gd::Polygon &p : polygons) {
+		p.connection_begin = connection_begin;
+		connection_begin += p.connection_count;
+		p.connection_count = 0;
+	}
+	polygon_connections.resize(connection_begin);
+	for (const SharedEdge &shared_edge : shared_edges) {
+		if (shared_edge.count != 2) {
+			continue;
+		}
+		for (int side = 0; side < 2; side++) {
+			gd::Polygon &from = polygons[shared_edge.edges[side].polygon];
+			const gd::FreeEdge &to_edge = shared_edge.edges[1 - side];
+			const gd::Polygon &to = polygons[to_edge.polygon];
+
+			// Note: The pathway_start/end are full for those connection and do not need to be modified.
+			gd::Connection &connection = polygon_connections[from.connection_begin + from.connection_count++];
+			connection.polygon = to_edge.polygon;
+			connection.edge = to_edge.edge;
+			connection.pathway_start = points[to.point_begin + to_edge.edge].pos;
+			connection.pathway_end = points[to.point_begin + (to_edge.edge + 1) % to.point_count].pos;
+		}
+	}
 }
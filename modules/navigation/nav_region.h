@@ -40,17 +40,16 @@ class NavRegion : public NavBase {
 	NavMap *map = nullptr;
 	Transform3D transform;
 	Ref<NavigationMesh> mesh;
-	Vector<gd::Edge::Connection> connections;
+	Vector<gd::Connection> connections;
 
 	bool polygons_dirty = true;
 
-	/// Cache
-	LocalVector<gd::Polygon> polygons;
+	/// Cache, only rebuilt when this region changes.
+	gd::RegionData *data = nullptr;
 
 public:
-	NavRegion() {
-		type = NavigationUtilities::PathSegmentType::PATH_SEGMENT_TYPE_REGION;
-	}
+	NavRegion();
+	~NavRegion();
 
 	void scratch_polygons() {
 		polygons_dirty = true;
@@ -71,15 +70,35 @@ public:
 		return mesh;
 	}
 
-	Vector<gd::Edge::Connection> &get_connections() {
+	Vector<gd::Connection> &get_connections() {
 		return connections;
 	}
 	int get_connections_count() const;
 	Vector3 get_connection_pathway_start(int p_connection_id) const;
 	Vector3 get_connection_pathway_end(int p_connection_id) const;
 
+	gd::RegionData *get_data() const {
+		return data;
+	}
+
 	LocalVector<gd::Polygon> const &get_polygons() const {
-		return polygons;
+		return data->polygons;
+	}
+
+	LocalVector<gd::Point> const &get_points() const {
+		return data->points;
+	}
+
+	LocalVector<gd::Connection> const &get_polygon_connections() const {
+		return data->polygon_connections;
+	}
+
+	LocalVector<gd::FreeEdge> const &get_free_edges() const {
+		return data->free_edges;
+	}
+
+	uint32_t get_edge_count() const {
+		return data->edge_count;
 	}
 
 	bool sync();
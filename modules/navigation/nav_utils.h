@@ -32,9 +32,14 @@
 #define NAV_UTILS_H
 
 #include "core/math/vector3.h"
+#include "core/object/object_id.h"
 #include "core/templates/hash_map.h"
 #include "core/templates/hashfuncs.h"
+#include "core/templates/indexed_heap.h"
 #include "core/templates/local_vector.h"
+#include "core/templates/rid.h"
+#include "core/templates/safe_refcount.h"
+#include "servers/navigation/navigation_utilities.h"
 
 class NavBase;
 
@@ -77,43 +82,80 @@ struct Point {
 	PointKey key;
 };
 
-struct Edge {
-	/// The gateway in the edge, as, in some case, the whole edge might not be navigable.
-	struct Connection {
-		/// Polygon that this connection leads to.
-		Polygon *polygon = nullptr;
+/// The gateway in an edge, as, in some case, the whole edge might not be navigable.
+struct Connection {
+	/// Index of the polygon that this connection leads to.
+	uint32_t polygon = 0;
 
-		/// Edge of the source polygon where this connection starts from.
-		int edge = -1;
+	/// Edge of the polygon this connection leads to, `-1` for links.
+	int edge = -1;
 
-		/// Point on the edge where the gateway leading to the poly starts.
-		Vector3 pathway_start;
+	/// Point on the edge where the gateway leading to the poly starts.
+	Vector3 pathway_start;
 
-		/// Point on the edge where the gateway leading to the poly ends.
-		Vector3 pathway_end;
-	};
-
-	/// Connections from this edge to other polygons.
-	Vector<Connection> connections;
+	/// Point on the edge where the gateway leading to the poly ends.
+	Vector3 pathway_end;
 };
 
+/// Polygons only store ranges, their points and connections live in contiguous arrays
+/// owned by the region or the map snapshot. Edge `i` goes from point `i` to point `i + 1`.
 struct Polygon {
-	/// Navigation region or link that contains this polygon.
-	const NavBase *owner = nullptr;
+	/// Index of this `Polygon` in the map, regions polygons come first, then links polygons.
+	uint32_t id = 0;
 
-	/// The points of this `Polygon`
-	LocalVector<Point> points;
+	/// Index of the cluster (region or link) of this `Polygon` in the map.
+	uint32_t cluster_id = 0;
 
-	/// Are the points clockwise?
-	bool clockwise;
+	/// Range of the points of this `Polygon`, in the points of its cluster.
+	uint32_t point_begin = 0;
+	uint32_t point_count = 0;
+
+	/// Range of the connections leaving this `Polygon` to polygons of the same region.
+	uint32_t connection_begin = 0;
+	uint32_t connection_count = 0;
 
-	/// The edges of this `Polygon`
-	LocalVector<Edge> edges;
+	/// Are the points clockwise?
+	bool clockwise = false;
 
 	/// The center of this `Polygon`
 	Vector3 center;
 };
 
+/// Polygon edge that is not shared with another polygon of the same region.
+struct FreeEdge {
+	uint32_t polygon = 0;
+	uint32_t edge = 0;
+};
+
+/// Polygons of a region, never modified once built. A region replaces its data when it
+/// changes, the map snapshots keep referencing the data they were built from.
+/// Polygon, point and connection indices are local to the region.
+struct RegionData {
+	SafeRefCount refcount;
+
+	LocalVector<Polygon> polygons;
+	LocalVector<Point> points;
+	/// Connections between the polygons of this region, in the ranges of the polygons.
+	LocalVector<Connection> polygon_connections;
+	/// Edges left to connect with other regions.
+	LocalVector<FreeEdge> free_edges;
+	uint32_t edge_count = 0;
+
+	void reference() {
+		refcount.ref();
+	}
+
+	void unreference() {
+		if (refcount.unref()) {
+			memdelete(this);
+		}
+	}
+
+	RegionData() {
+		refcount.init();
+	}
+};
+
 struct NavigationPoly {
 	uint32_t self_id = 0;
 	/// This poly.
@@ -129,6 +171,10 @@ struct NavigationPoly {
 	Vector3 entry;
 	/// The distance to the destination.
 	float traveled_distance = 0.0;
+	/// The traveled distance plus the estimated cost to the destination.
+	float total_cost = 0.0;
+	/// Position in the open list, or `UINT32_MAX` when not in it.
+	uint32_t heap_index = UINT32_MAX;
 
 	NavigationPoly() { poly = nullptr; }
 
@@ -144,6 +190,121 @@ struct NavigationPoly {
 	}
 };
 
+struct NavPolyTotalCostLess {
+	const LocalVector<NavigationPoly> *navigation_polys = nullptr;
+
+	bool operator()(uint32_t p_a, uint32_t p_b) const {
+		return (*navigation_polys)[p_a].total_cost < (*navigation_polys)[p_b].total_cost;
+	}
+};
+
+struct NavPolyHeapIndexer {
+	LocalVector<NavigationPoly> *navigation_polys = nullptr;
+
+	void operator()(uint32_t p_id, uint32_t p_heap_index) const {
+		(*navigation_polys)[p_id].heap_index = p_heap_index;
+	}
+};
+
+/// Polygon of a flow field, reached backward from the destination.
+struct FlowFieldPoly {
+	/// Cost from `target` to the destination, negative until reached.
+	float cost = -1.0;
+	/// Where agents on this polygon head to, on the way to the destination.
+	Vector3 target;
+	/// Polygon reached at `target`, `-1` on the destination polygon.
+	int32_t next = -1;
+	/// Position in the open list, or `UINT32_MAX` when not in it.
+	uint32_t heap_index = UINT32_MAX;
+};
+
+struct FlowFieldPolyCostLess {
+	const LocalVector<FlowFieldPoly> *flow_field_polys = nullptr;
+
+	bool operator()(uint32_t p_a, uint32_t p_b) const {
+		return (*flow_field_polys)[p_a].cost < (*flow_field_polys)[p_b].cost;
+	}
+};
+
+struct FlowFieldPolyHeapIndexer {
+	LocalVector<FlowFieldPoly> *flow_field_polys = nullptr;
+
+	void operator()(uint32_t p_id, uint32_t p_heap_index) const {
+		(*flow_field_polys)[p_id].heap_index = p_heap_index;
+	}
+};
+
+/// Border between two clusters (regions or links) of the map, used to find routes
+/// across clusters before searching polygons.
+struct Portal {
+	uint32_t from_cluster = 0;
+	uint32_t to_cluster = 0;
+
+	/// Average position of the connections between both clusters.
+	Vector3 position;
+};
+
+struct Cluster {
+	/// Navigation region or link of this cluster, only used during sync.
+	const NavBase *owner = nullptr;
+
+	/// Owner properties at the time of the sync, queries read these instead of the owner.
+	RID self;
+	ObjectID owner_id;
+	NavigationUtilities::PathSegmentType type = NavigationUtilities::PathSegmentType::PATH_SEGMENT_TYPE_REGION;
+	uint32_t navigation_layers = 0;
+	float enter_cost = 0.0;
+	float travel_cost = 0.0;
+
+	/// Range of the portals leaving this cluster.
+	uint32_t portal_begin = 0;
+	uint32_t portal_count = 0;
+};
+
+/// The best route between two clusters depends on where the path begins and ends in them,
+/// so routes are cached per pair of clusters and coarse cells around the begin and end points.
+struct ClusterRouteKey {
+	uint32_t begin_cluster = 0;
+	uint32_t end_cluster = 0;
+	Vector3i begin_cell;
+	Vector3i end_cell;
+	uint32_t navigation_layers = 0;
+
+	static uint32_t hash(const ClusterRouteKey &p_val) {
+		uint32_t h = hash_murmur3_one_32(p_val.begin_cluster);
+		h = hash_murmur3_one_32(p_val.end_cluster, h);
+		h = hash_murmur3_one_32(p_val.begin_cell.x, h);
+		h = hash_murmur3_one_32(p_val.begin_cell.y, h);
+		h = hash_murmur3_one_32(p_val.begin_cell.z, h);
+		h = hash_murmur3_one_32(p_val.end_cell.x, h);
+		h = hash_murmur3_one_32(p_val.end_cell.y, h);
+		h = hash_murmur3_one_32(p_val.end_cell.z, h);
+		h = hash_murmur3_one_32(p_val.navigation_layers, h);
+		return hash_fmix32(h);
+	}
+
+	bool operator==(const ClusterRouteKey &p_key) const {
+		return begin_cluster == p_key.begin_cluster && end_cluster == p_key.end_cluster && begin_cell == p_key.begin_cell && end_cell == p_key.end_cell && navigation_layers == p_key.navigation_layers;
+	}
+};
+
+struct FlowFieldKey {
+	Vector3 destination;
+	uint32_t navigation_layers = 0;
+
+	static uint32_t hash(const FlowFieldKey &p_val) {
+		uint32_t h = hash_murmur3_one_real(p_val.destination.x);
+		h = hash_murmur3_one_real(p_val.destination.y, h);
+		h = hash_murmur3_one_real(p_val.destination.z, h);
+		h = hash_murmur3_one_32(p_val.navigation_layers, h);
+		return hash_fmix32(h);
+	}
+
+	bool operator==(const FlowFieldKey &p_key) const {
+		return destination == p_key.destination && navigation_layers == p_key.navigation_layers;
+	}
+};
+
 struct ClosestPointQueryResult {
 	Vector3 point;
 	Vector3 normal;
@@ -493,6 +493,43 @@ void NavigationMeshGenerator::_convert_detail_mesh_to_native_navigation_mesh(con
 	}
 }
 
+void NavigationMeshGenerator::_print_bake_settings_warnings(Ref<NavigationMesh> p_navigation_mesh) {
+	const float cs = p_navigation_mesh->get_cell_size();
+	const float ch = p_navigation_mesh->get_cell_height();
+	const int walkable_height = (int)Math::ceil(p_navigation_mesh->get_agent_height() / ch);
+	const int walkable_climb = (int)Math::floor(p_navigation_mesh->get_agent_max_climb() / ch);
+	const int walkable_radius = (int)Math::ceil(p_navigation_mesh->get_agent_radius() / cs);
+	const int max_edge_len = (int)(p_navigation_mesh->get_edge_max_length() / cs);
+	const int min_region_area = (int)(p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size());
+	const int merge_region_area = (int)(p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size());
+	const int max_verts_per_poly = (int)p_navigation_mesh->get_vertices_per_polygon();
+
+	if (!Math::is_equal_approx((float)walkable_height * ch, p_navigation_mesh->get_agent_height())) {
+		WARN_PRINT("Property agent_height is ceiled to cell_height voxel units and loses precision.");
+	}
+	if (!Math::is_equal_approx((float)walkable_climb * ch, p_navigation_mesh->get_agent_max_climb())) {
+		WARN_PRINT("Property agent_max_climb is floored to cell_height voxel units and loses precision.");
+	}
+	if (!Math::is_equal_approx((float)walkable_radius * cs, p_navigation_mesh->get_agent_radius())) {
+		WARN_PRINT("Property agent_radius is ceiled to cell_size voxel units and loses precision.");
+	}
+	if (!Math::is_equal_approx((float)max_edge_len * cs, p_navigation_mesh->get_edge_max_length())) {
+		WARN_PRINT("Property edge_max_length is rounded to cell_size voxel units and loses precision.");
+	}
+	if (!Math::is_equal_approx((float)min_region_area, p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size())) {
+		WARN_PRINT("Property region_min_size is converted to int and loses precision.");
+	}
+	if (!Math::is_equal_approx((float)merge_region_area, p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size())) {
+		WARN_PRINT("Property region_merge_size is converted to int and loses precision.");
+	}
+	if (!Math::is_equal_approx((float)max_verts_per_poly, p_navigation_mesh->get_vertices_per_polygon())) {
+		WARN_PRINT("Property vertices_per_polygon is converted to int and loses precision.");
+	}
+	if (p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance() < 0.1f) {
+		WARN_PRINT("Property detail_sample_distance is clamped to 0.1 world units as the resulting value from multiplying with cell_size is too low.");
+	}
+}
+
 void NavigationMeshGenerator::_build_recast_navigation_mesh(
 		Ref<NavigationMesh> p_navigation_mesh,
 #ifdef TOOLS_ENABLED
@@ -504,7 +541,8 @@ void NavigationMeshGenerator::_build_recast_navigation_mesh(
 		rcPolyMesh *poly_mesh,
 		rcPolyMeshDetail *detail_mesh,
 		Vector<float> &vertices,
-		Vector<int> &indices) {
+		Vector<int> &indices,
+		const AABB &p_tile_bounds) {
 	rcContext ctx;
 
 #ifdef TOOLS_ENABLED
@@ -538,29 +576,9 @@ void NavigationMeshGenerator::_build_recast_navigation_mesh(
 	cfg.detailSampleDist = MAX(p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance(), 0.1f);
 	cfg.detailSampleMaxError = p_navigation_mesh->get_cell_height() * p_navigation_mesh->get_detail_sample_max_error();
 
-	if (!Math::is_equal_approx((float)cfg.walkableHeight * cfg.ch, p_navigation_mesh->get_agent_height())) {
-		WARN_PRINT("Property agent_height is ceiled to cell_height voxel units and loses precision.");
-	}
-	if (!Math::is_equal_approx((float)cfg.walkableClimb * cfg.ch, p_navigation_mesh->get_agent_max_climb())) {
-		WARN_PRINT("Property agent_max_climb is floored to cell_height voxel units and loses precision.");
-	}
-	if (!Math::is_equal_approx((float)cfg.walkableRadius * cfg.cs, p_navigation_mesh->get_agent_radius())) {
-		WARN_PRINT("Property agent_radius is ceiled to cell_size voxel units and loses precision.");
-	}
-	if (!Math::is_equal_approx((float)cfg.maxEdgeLen * cfg.cs, p_navigation_mesh->get_edge_max_length())) {
-		WARN_PRINT("Property edge_max_length is rounded to cell_size voxel units and loses precision.");
-	}
-	if (!Math::is_equal_approx((float)cfg.minRegionArea, p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size())) {
-		WARN_PRINT("Property region_min_size is converted to int and loses precision.");
-	}
-	if (!Math::is_equal_approx((float)cfg.mergeRegionArea, p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size())) {
-		WARN_PRINT("Property region_merge_size is converted to int and loses precision.");
-	}
-	if (!Math::is_equal_approx((float)cfg.maxVertsPerPoly, p_navigation_mesh->get_vertices_per_polygon())) {
-		WARN_PRINT("Property vertices_per_polygon is converted to int and loses precision.");
-	}
-	if (p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance() < 0.1f) {
-		WARN_PRINT("Property detail_sample_distance is clamped to 0.1 world units as the resulting value from multiplying with cell_size is too low.");
+	if (!p_tile_bounds.has_volume()) {
+		// Tiled bakes print these once for all their tiles.
+		_print_bake_settings_warnings(p_navigation_mesh);
 	}
 
 	cfg.bmin[0] = bmin[0];
@@ -571,7 +589,18 @@ void NavigationMeshGenerator::_build_recast_navigation_mesh(
 	cfg.bmax[2] = bmax[2];
 
 	AABB baking_aabb = p_navigation_mesh->get_filter_baking_aabb();
-	if (baking_aabb.has_volume()) {
+	if (p_tile_bounds.has_volume()) {
+		// Tiles rasterize a border around their bounds so that polygons on both sides of a tile edge end on the same vertices.
+		// The border is cut away when building the regions.
+		cfg.borderSize = cfg.walkableRadius + 3;
+		const float border = cfg.borderSize * cfg.cs;
+		cfg.bmin[0] = p_tile_bounds.position.x - border;
+		cfg.bmin[1] = p_tile_bounds.position.y;
+		cfg.bmin[2] = p_tile_bounds.position.z - border;
+		cfg.bmax[0] = p_tile_bounds.position.x + p_tile_bounds.size.x + border;
+		cfg.bmax[1] = p_tile_bounds.position.y + p_tile_bounds.size.y;
+		cfg.bmax[2] = p_tile_bounds.position.z + p_tile_bounds.size.z + border;
+	} else if (baking_aabb.has_volume()) {
 		Vector3 baking_aabb_offset = p_navigation_mesh->get_filter_baking_aabb_offset();
 		cfg.bmin[0] = baking_aabb.position[0] + baking_aabb_offset.x;
 		cfg.bmin[1] = baking_aabb.position[1] + baking_aabb_offset.y;
@@ -663,11 +692,11 @@ void NavigationMeshGenerator::_build_recast_navigation_mesh(
 
 	if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
 		ERR_FAIL_COND(!rcBuildDistanceField(&ctx, *chf));
-		ERR_FAIL_COND(!rcBuildRegions(&ctx, *chf, 0, cfg.minRegionArea, cfg.mergeRegionArea));
+		ERR_FAIL_COND(!rcBuildRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
 	} else if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
-		ERR_FAIL_COND(!rcBuildRegionsMonotone(&ctx, *chf, 0, cfg.minRegionArea, cfg.mergeRegionArea));
+		ERR_FAIL_COND(!rcBuildRegionsMonotone(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
 	} else {
-		ERR_FAIL_COND(!rcBuildLayerRegions(&ctx, *chf, 0, cfg.minRegionArea));
+		ERR_FAIL_COND(!rcBuildLayerRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea));
 	}
 
 #ifdef TOOLS_ENABLED
@@ -714,6 +743,56 @@ void NavigationMeshGenerator::_build_recast_navigation_mesh(
 	detail_mesh = nullptr;
 }
 
+void NavigationMeshGenerator::_bake_tile(Ref<NavigationMesh> p_navigation_mesh, const AABB &p_tile_bounds, Vector<float> &p_vertices, Vector<int> &p_indices) {
+	if (p_vertices.size() == 0 || p_indices.size() == 0) {
+		return;
+	}
+
+	rcHeightfield *hf = nullptr;
+	rcCompactHeightfield *chf = nullptr;
+	rcContourSet *cset = nullptr;
+	rcPolyMesh *poly_mesh = nullptr;
+	rcPolyMeshDetail *detail_mesh = nullptr;
+
+	_build_recast_navigation_mesh(
+			p_navigation_mesh,
+#ifdef TOOLS_ENABLED
+			nullptr,
+#endif
+			hf,
+			chf,
+			cset,
+			poly_mesh,
+			detail_mesh,
+			p_vertices,
+			p_indices,
+			p_tile_bounds);
+
+	rcFreeHeightField(hf);
+	rcFreeCompactHeightfield(chf);
+	rcFreeContourSet(cset);
+	rcFreePolyMesh(poly_mesh);
+	rcFreePolyMeshDetail(detail_mesh);
+}
+
+void NavigationMeshGenerator::_parse_source_geometry(const Ref<NavigationMesh> &p_navigation_mesh, Node *p_root_node, Vector<float> &p_vertices, Vector<int> &p_indices) {
+	List<Node *> parse_nodes;
+
+	if (p_navigation_mesh->get_source_geometry_mode() == NavigationMesh::SOURCE_GEOMETRY_ROOT_NODE_CHILDREN) {
+		parse_nodes.push_back(p_root_node);
+	} else {
+		p_root_node->get_tree()->get_nodes_in_group(p_navigation_mesh->get_source_group_name(), &parse_nodes);
+	}
+
+	Transform3D navmesh_xform = Object::cast_to<Node3D>(p_root_node)->get_global_transform().affine_inverse();
+	for (Node *E : parse_nodes) {
+		NavigationMesh::ParsedGeometryType geometry_type = p_navigation_mesh->get_parsed_geometry_type();
+		uint32_t collision_mask = p_navigation_mesh->get_collision_mask();
+		bool recurse_children = p_navigation_mesh->get_source_geometry_mode() != NavigationMesh::SOURCE_GEOMETRY_GROUPS_EXPLICIT;
+		_parse_geometry(navmesh_xform, E, p_vertices, p_indices, geometry_type, collision_mask, recurse_children);
+	}
+}
+
 NavigationMeshGenerator *NavigationMeshGenerator::get_singleton() {
 	return singleton;
 }
@@ -749,21 +828,7 @@ void NavigationMeshGenerator::bake(Ref<NavigationMesh> p_navigation_mesh, Node *
 	Vector<float> vertices;
 	Vector<int> indices;
 
-	List<Node *> parse_nodes;
-
-	if (p_navigation_mesh->get_source_geometry_mode() == NavigationMesh::SOURCE_GEOMETRY_ROOT_NODE_CHILDREN) {
-		parse_nodes.push_back(p_root_node);
-	} else {
-		p_root_node->get_tree()->get_nodes_in_group(p_navigation_mesh->get_source_group_name(), &parse_nodes);
-	}
-
-	Transform3D navmesh_xform = Object::cast_to<Node3D>(p_root_node)->get_global_transform().affine_inverse();
-	for (Node *E : parse_nodes) {
-		NavigationMesh::ParsedGeometryType geometry_type = p_navigation_mesh->get_parsed_geometry_type();
-		uint32_t collision_mask = p_navigation_mesh->get_collision_mask();
-		bool recurse_children = p_navigation_mesh->get_source_geometry_mode() != NavigationMesh::SOURCE_GEOMETRY_GROUPS_EXPLICIT;
-		_parse_geometry(navmesh_xform, E, vertices, indices, geometry_type, collision_mask, recurse_children);
-	}
+	_parse_source_geometry(p_navigation_mesh, p_root_node, vertices, indices);
 
 	if (vertices.size() > 0 && indices.size() > 0) {
 		rcHeightfield *hf = nullptr;
@@ -44,6 +44,8 @@ struct EditorProgress;
 class NavigationMeshGenerator : public Object {
 	GDCLASS(NavigationMeshGenerator, Object);
 
+	friend class NavigationMeshTileCache;
+
 	static NavigationMeshGenerator *singleton;
 
 protected:
@@ -54,7 +56,9 @@ protected:
 	static void _add_mesh_array(const Array &p_array, const Transform3D &p_xform, Vector<float> &p_vertices, Vector<int> &p_indices);
 	static void _add_faces(const PackedVector3Array &p_faces, const Transform3D &p_xform, Vector<float> &p_vertices, Vector<int> &p_indices);
 	static void _parse_geometry(const Transform3D &p_navmesh_transform, Node *p_node, Vector<float> &p_vertices, Vector<int> &p_indices, NavigationMesh::ParsedGeometryType p_generate_from, uint32_t p_collision_mask, bool p_recurse_children);
+	static void _parse_source_geometry(const Ref<NavigationMesh> &p_navigation_mesh, Node *p_root_node, Vector<float> &p_vertices, Vector<int> &p_indices);
 
+	static void _print_bake_settings_warnings(Ref<NavigationMesh> p_navigation_mesh);
 	static void _convert_detail_mesh_to_native_navigation_mesh(const rcPolyMeshDetail *p_detail_mesh, Ref<NavigationMesh> p_navigation_mesh);
 	static void _build_recast_navigation_mesh(
 			Ref<NavigationMesh> p_navigation_mesh,
@@ -67,7 +71,9 @@ protected:
 			rcPolyMesh *poly_mesh,
 			rcPolyMeshDetail *detail_mesh,
 			Vector<float> &vertices,
-			Vector<int> &indices);
+			Vector<int> &indices,
+			const AABB &p_tile_bounds = AABB());
+	static void _bake_tile(Ref<NavigationMesh> p_navigation_mesh, const AABB &p_tile_bounds, Vector<float> &p_vertices, Vector<int> &p_indices);
 
 public:
 	static NavigationMeshGenerator *get_singleton();
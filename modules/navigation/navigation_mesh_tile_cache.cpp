@@ -0,0 +1,340 @@
+/**************************************************************************/
+/*  navigation_mesh_tile_cache.cpp                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef _3D_DISABLED
+
+#include "navigation_mesh_tile_cache.h"
+
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/hash_set.h"
+#include "scene/3d/node_3d.h"
+#include "scene/resources/world_3d.h"
+#include "servers/navigation_server_3d.h"
+
+#include "navigation_mesh_generator.h"
+
+void NavigationMeshTileCache::set_navigation_mesh(const Ref<NavigationMesh> &p_navigation_mesh) {
+	navigation_mesh = p_navigation_mesh;
+}
+
+Ref<NavigationMesh> NavigationMeshTileCache::get_navigation_mesh() const {
+	return navigation_mesh;
+}
+
+void NavigationMeshTileCache::set_tile_size(real_t p_tile_size) {
+	ERR_FAIL_COND(p_tile_size <= 0.0);
+	tile_size = p_tile_size;
+}
+
+real_t NavigationMeshTileCache::get_tile_size() const {
+	return tile_size;
+}
+
+void NavigationMeshTileCache::set_map(RID p_map) {
+	map = p_map;
+}
+
+RID NavigationMeshTileCache::get_map() const {
+	return map;
+}
+
+void NavigationMeshTileCache::set_navigation_layers(uint32_t p_navigation_layers) {
+	navigation_layers = p_navigation_layers;
+}
+
+uint32_t NavigationMeshTileCache::get_navigation_layers() const {
+	return navigation_layers;
+}
+
+// The settings used by Recast when baking a tile. The parsing and filtering settings
+// already change the hashed geometry and bounds of the tiles.
+uint32_t NavigationMeshTileCache::_get_bake_settings_hash(Ref<NavigationMesh> p_navigation_mesh) {
+	uint32_t h = hash_murmur3_one_32(p_navigation_mesh->get_sample_partition_type());
+	h = hash_murmur3_one_float(p_navigation_mesh->get_cell_size(), h);
+	h = hash_murmur3_one_float(p_navigation_mesh->get_cell_height(), h);
+	h = hash_murmur3_one_float(p_navigation_mesh->get_agent_height(), h);
+	h = hash_murmur3_one_float(p_navigation_mesh->get_agent_radius(), h);
+	h = hash_murmur3_one_float(p_navigation_mesh->get_agent_max_climb(), h);
+	h = hash_murmur3_one_float(p_navigation_mesh->get_agent_max_slope(), h);
+	h = hash_murmur3_one_float(p_navigation_mesh->get_region_min_size(), h);
+	h = hash_murmur3_one_float(p_navigation_mesh->get_region_merge_size(), h);
+	h = hash_murmur3_one_float(p_navigation_mesh->get_edge_max_length(), h);
+	h = hash_murmur3_one_float(p_navigation_mesh->get_edge_max_error(), h);
+	h = hash_murmur3_one_float(p_navigation_mesh->get_vertices_per_polygon(), h);
+	h = hash_murmur3_one_float(p_navigation_mesh->get_detail_sample_distance(), h);
+	h = hash_murmur3_one_float(p_navigation_mesh->get_detail_sample_max_error(), h);
+	h = hash_murmur3_one_32(p_navigation_mesh->get_filter_low_hanging_obstacles(), h);
+	h = hash_murmur3_one_32(p_navigation_mesh->get_filter_ledge_spans(), h);
+	h = hash_murmur3_one_32(p_navigation_mesh->get_filter_walkable_low_height_spans(), h);
+	return h;
+}
+
+void NavigationMeshTileCache::_bake_tile_task(uint32_t p_index, TileBakeTask *p_tasks) {
+	TileBakeTask &task = p_tasks[p_index];
+	NavigationMeshGenerator::_bake_tile(task.navigation_mesh, task.bounds, task.vertices, task.indices);
+}
+
+void NavigationMeshTileCache::_free_tile(Tile &p_tile) {
+	if (p_tile.region.is_valid()) {
+		NavigationServer3D::get_singleton()->free(p_tile.region);
+		p_tile.region = RID();
+	}
+	p_tile.navigation_mesh.unref();
+}
+
+int NavigationMeshTileCache::bake(Node *p_root_node) {
+	ERR_FAIL_COND_V_MSG(!navigation_mesh.is_valid(), 0, "Invalid navigation mesh.");
+	Node3D *root_node = Object::cast_to<Node3D>(p_root_node);
+	ERR_FAIL_COND_V_MSG(!root_node || !root_node->is_inside_tree(), 0, "The root node must be a Node3D inside the scene tree.");
+
+	// Parsing touches the scene tree, so it stays on the calling thread.
+	Vector<float> vertices;
+	Vector<int> indices;
+	NavigationMeshGenerator::_parse_source_geometry(navigation_mesh, p_root_node, vertices, indices);
+
+	// The settings are the same for every tile, so their warnings are printed once.
+	NavigationMeshGenerator::_print_bake_settings_warnings(navigation_mesh);
+
+	const real_t cell_size = navigation_mesh->get_cell_size();
+	const real_t cell_height = navigation_mesh->get_cell_height();
+	// Tiles are aligned on the cell grid so the polygons of neighbor tiles end on the same vertices.
+	const real_t tile_world_size = MAX(1, (int)Math::round(tile_size / cell_size)) * cell_size;
+	const real_t border = (Math::ceil(navigation_mesh->get_agent_radius() / cell_size) + 3) * cell_size;
+
+	const float *vertices_ptr = vertices.ptr();
+	const int *indices_ptr = indices.ptr();
+	const int triangle_count = indices.size() / 3;
+
+	HashMap<Vector2i, LocalVector<int>> tile_triangles;
+	for (int i = 0; i < triangle_count; i++) {
+		AABB triangle_bounds;
+		for (int j = 0; j < 3; j++) {
+			const float *v = &vertices_ptr[indices_ptr[i * 3 + j] * 3];
+			const Vector3 vertex(v[0], v[1], v[2]);
+			if (j == 0) {
+				triangle_bounds.position = vertex;
+			} else {
+				triangle_bounds.expand_to(vertex);
+			}
+		}
+
+		const int min_x = (int)Math::floor((triangle_bounds.position.x - border) / tile_world_size);
+		const int min_z = (int)Math::floor((triangle_bounds.position.z - border) / tile_world_size);
+		const int max_x = (int)Math::floor((triangle_bounds.position.x + triangle_bounds.size.x + border) / tile_world_size);
+		const int max_z = (int)Math::floor((triangle_bounds.position.z + triangle_bounds.size.z + border) / tile_world_size);
+		for (int z = min_z; z <= max_z; z++) {
+			for (int x = min_x; x <= max_x; x++) {
+				tile_triangles[Vector2i(x, z)].push_back(i);
+			}
+		}
+	}
+
+	const AABB baking_aabb = navigation_mesh->get_filter_baking_aabb();
+	const AABB filter_bounds = AABB(baking_aabb.position + navigation_mesh->get_filter_baking_aabb_offset(), baking_aabb.size);
+
+	// Changing a bake setting changes the hash of every tile, so they are all baked again.
+	const uint32_t settings_hash = _get_bake_settings_hash(navigation_mesh);
+
+	HashSet<Vector2i> source_tiles;
+	LocalVector<TileBakeTask> tasks;
+	for (KeyValue<Vector2i, LocalVector<int>> &E : tile_triangles) {
+		// The height range only follows the tile's own geometry, so changes elsewhere don't affect the tile.
+		// It is aligned on the cell height so the vertices of neighbor tiles end at the same heights.
+		real_t min_y = 1e20;
+		real_t max_y = -1e20;
+		for (int triangle : E.value) {
+			for (int j = 0; j < 3; j++) {
+				const real_t y = vertices_ptr[indices_ptr[triangle * 3 + j] * 3 + 1];
+				min_y = MIN(min_y, y);
+				max_y = MAX(max_y, y);
+			}
+		}
+		min_y = Math::floor(min_y / cell_height) * cell_height;
+		max_y = MAX(Math::ceil(max_y / cell_height) * cell_height, min_y + cell_height);
+
+		AABB tile_bounds(Vector3(E.key.x * tile_world_size, min_y, E.key.y * tile_world_size), Vector3(tile_world_size, max_y - min_y, tile_world_size));
+		if (baking_aabb.has_volume()) {
+			if (!tile_bounds.intersects(filter_bounds)) {
+				continue;
+			}
+			tile_bounds = tile_bounds.intersection(filter_bounds);
+		}
+		source_tiles.insert(E.key);
+
+		// Only the bake settings, the tile's geometry and its bounds, clamped to the baking filter, are hashed.
+		uint32_t source_hash = hash_murmur3_one_real(tile_bounds.position.x, settings_hash);
+		source_hash = hash_murmur3_one_real(tile_bounds.position.y, source_hash);
+		source_hash = hash_murmur3_one_real(tile_bounds.position.z, source_hash);
+		source_hash = hash_murmur3_one_real(tile_bounds.size.x, source_hash);
+		source_hash = hash_murmur3_one_real(tile_bounds.size.y, source_hash);
+		source_hash = hash_murmur3_one_real(tile_bounds.size.z, source_hash);
+		for (int triangle : E.value) {
+			for (int j = 0; j < 3; j++) {
+				const float *v = &vertices_ptr[indices_ptr[triangle * 3 + j] * 3];
+				source_hash = hash_murmur3_one_float(v[0], source_hash);
+				source_hash = hash_murmur3_one_float(v[1], source_hash);
+				source_hash = hash_murmur3_one_float(v[2], source_hash);
+			}
+		}
+		source_hash = hash_fmix32(source_hash);
+
+		const Tile *tile = tiles.getptr(E.key);
+		if (tile && tile->source_hash == source_hash) {
+			continue;
+		}
+
+		TileBakeTask task;
+		task.coords = E.key;
+		task.bounds = tile_bounds;
+		task.source_hash = source_hash;
+		task.vertices.resize(E.value.size() * 9);
+		task.indices.resize(E.value.size() * 3);
+		float *task_vertices = task.vertices.ptrw();
+		int *task_indices = task.indices.ptrw();
+		for (uint32_t i = 0; i < E.value.size(); i++) {
+			for (int j = 0; j < 3; j++) {
+				const float *v = &vertices_ptr[indices_ptr[E.value[i] * 3 + j] * 3];
+				task_vertices[i * 9 + j * 3 + 0] = v[0];
+				task_vertices[i * 9 + j * 3 + 1] = v[1];
+				task_vertices[i * 9 + j * 3 + 2] = v[2];
+				task_indices[i * 3 + j] = i * 3 + j;
+			}
+		}
+		// Resources are duplicated here as it is not safe on the worker threads.
+		task.navigation_mesh = navigation_mesh->duplicate();
+		task.navigation_mesh->clear_polygons();
+		task.navigation_mesh->set_vertices(Vector<Vector3>());
+		tasks.push_back(task);
+	}
+
+	LocalVector<Vector2i> removed_tiles;
+	for (KeyValue<Vector2i, Tile> &E : tiles) {
+		if (!source_tiles.has(E.key)) {
+			removed_tiles.push_back(E.key);
+		}
+	}
+	for (const Vector2i &coords : removed_tiles) {
+		_free_tile(tiles[coords]);
+		tiles.erase(coords);
+	}
+
+	if (tasks.size() > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavigationMeshTileCache::_bake_tile_task, tasks.ptr(), tasks.size(), -1, true, SNAME("NavigationMeshTileBake"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else if (tasks.size() == 1) {
+		_bake_tile_task(0, tasks.ptr());
+	}
+
+	NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+	for (TileBakeTask &task : tasks) {
+		Tile &tile = tiles[task.coords];
+		tile.source_hash = task.source_hash;
+		tile.navigation_mesh = task.navigation_mesh;
+		if (!tile.region.is_valid()) {
+			tile.region = navigation_server->region_create();
+		}
+		navigation_server->region_set_navigation_mesh(tile.region, tile.navigation_mesh);
+	}
+
+	// Neighbor tiles are stitched by the map, which connects the matching edges of its regions.
+	const RID tile_map = map.is_valid() ? map : root_node->get_world_3d()->get_navigation_map();
+	const Transform3D tile_transform = root_node->get_global_transform();
+	for (KeyValue<Vector2i, Tile> &E : tiles) {
+		navigation_server->region_set_map(E.value.region, tile_map);
+		navigation_server->region_set_transform(E.value.region, tile_transform);
+		navigation_server->region_set_navigation_layers(E.value.region, navigation_layers);
+	}
+
+	return tasks.size();
+}
+
+void NavigationMeshTileCache::clear() {
+	for (KeyValue<Vector2i, Tile> &E : tiles) {
+		_free_tile(E.value);
+	}
+	tiles.clear();
+}
+
+int NavigationMeshTileCache::get_tile_count() const {
+	return tiles.size();
+}
+
+TypedArray<Vector2i> NavigationMeshTileCache::get_tiles() const {
+	TypedArray<Vector2i> tile_coords;
+	for (const KeyValue<Vector2i, Tile> &E : tiles) {
+		tile_coords.push_back(E.key);
+	}
+	return tile_coords;
+}
+
+Ref<NavigationMesh> NavigationMeshTileCache::get_tile_navigation_mesh(const Vector2i &p_tile) const {
+	const Tile *tile = tiles.getptr(p_tile);
+	ERR_FAIL_COND_V(!tile, Ref<NavigationMesh>());
+	return tile->navigation_mesh;
+}
+
+RID NavigationMeshTileCache::get_tile_region(const Vector2i &p_tile) const {
+	const Tile *tile = tiles.getptr(p_tile);
+	ERR_FAIL_COND_V(!tile, RID());
+	return tile->region;
+}
+
+void NavigationMeshTileCache::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_navigation_mesh", "navigation_mesh"), &NavigationMeshTileCache::set_navigation_mesh);
+	ClassDB::bind_method(D_METHOD("get_navigation_mesh"), &NavigationMeshTileCache::get_navigation_mesh);
+
+	ClassDB::bind_method(D_METHOD("set_tile_size", "tile_size"), &NavigationMeshTileCache::set_tile_size);
+	ClassDB::bind_method(D_METHOD("get_tile_size"), &NavigationMeshTileCache::get_tile_size);
+
+	ClassDB::bind_method(D_METHOD("set_map", "map"), &NavigationMeshTileCache::set_map);
+	ClassDB::bind_method(D_METHOD("get_map"), &NavigationMeshTileCache::get_map);
+
+	ClassDB::bind_method(D_METHOD("set_navigation_layers", "navigation_layers"), &NavigationMeshTileCache::set_navigation_layers);
+	ClassDB::bind_method(D_METHOD("get_navigation_layers"), &NavigationMeshTileCache::get_navigation_layers);
+
+	ClassDB::bind_method(D_METHOD("bake", "root_node"), &NavigationMeshTileCache::bake);
+	ClassDB::bind_method(D_METHOD("clear"), &NavigationMeshTileCache::clear);
+
+	ClassDB::bind_method(D_METHOD("get_tile_count"), &NavigationMeshTileCache::get_tile_count);
+	ClassDB::bind_method(D_METHOD("get_tiles"), &NavigationMeshTileCache::get_tiles);
+	ClassDB::bind_method(D_METHOD("get_tile_navigation_mesh", "tile"), &NavigationMeshTileCache::get_tile_navigation_mesh);
+	ClassDB::bind_method(D_METHOD("get_tile_region", "tile"), &NavigationMeshTileCache::get_tile_region);
+
+	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "navigation_mesh", PROPERTY_HINT_RESOURCE_TYPE, "NavigationMesh"), "set_navigation_mesh", "get_navigation_mesh");
+	ADD_PROPERTY(PropertyInfo(Variant::FLOAT, "tile_size", PROPERTY_HINT_RANGE, "0.1,1024,0.1,or_greater,suffix:m"), "set_tile_size", "get_tile_size");
+	ADD_PROPERTY(PropertyInfo(Variant::RID, "map"), "set_map", "get_map");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "navigation_layers", PROPERTY_HINT_LAYERS_3D_NAVIGATION), "set_navigation_layers", "get_navigation_layers");
+}
+
+NavigationMeshTileCache::~NavigationMeshTileCache() {
+	clear();
+}
+
+#endif
@@ -0,0 +1,103 @@
+/**************************************************************************/
+/*  navigation_mesh_tile_cache.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAVIGATION_MESH_TILE_CACHE_H
+#define NAVIGATION_MESH_TILE_CACHE_H
+
+#ifndef _3D_DISABLED
+
+#include "core/object/ref_counted.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "scene/resources/navigation_mesh.h"
+
+class Node;
+
+/// Bakes the source geometry of a scene in square tiles, one navigation region per tile.
+/// A rebake only runs Recast again for the tiles whose source geometry changed.
+class NavigationMeshTileCache : public RefCounted {
+	GDCLASS(NavigationMeshTileCache, RefCounted);
+
+	struct Tile {
+		uint32_t source_hash = 0;
+		Ref<NavigationMesh> navigation_mesh;
+		RID region;
+	};
+
+	struct TileBakeTask {
+		Vector2i coords;
+		AABB bounds;
+		uint32_t source_hash = 0;
+		Vector<float> vertices;
+		Vector<int> indices;
+		Ref<NavigationMesh> navigation_mesh;
+	};
+
+	Ref<NavigationMesh> navigation_mesh;
+	real_t tile_size = 32.0;
+	RID map;
+	uint32_t navigation_layers = 1;
+
+	HashMap<Vector2i, Tile> tiles;
+
+	static uint32_t _get_bake_settings_hash(Ref<NavigationMesh> p_navigation_mesh);
+	void _bake_tile_task(uint32_t p_index, TileBakeTask *p_tasks);
+	void _free_tile(Tile &p_tile);
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_navigation_mesh(const Ref<NavigationMesh> &p_navigation_mesh);
+	Ref<NavigationMesh> get_navigation_mesh() const;
+
+	void set_tile_size(real_t p_tile_size);
+	real_t get_tile_size() const;
+
+	void set_map(RID p_map);
+	RID get_map() const;
+
+	void set_navigation_layers(uint32_t p_navigation_layers);
+	uint32_t get_navigation_layers() const;
+
+	int bake(Node *p_root_node);
+	void clear();
+
+	int get_tile_count() const;
+	TypedArray<Vector2i> get_tiles() const;
+	Ref<NavigationMesh> get_tile_navigation_mesh(const Vector2i &p_tile) const;
+	RID get_tile_region(const Vector2i &p_tile) const;
+
+	~NavigationMeshTileCache();
+};
+
+#endif
+
+#endif // NAVIGATION_MESH_TILE_CACHE_H
@@ -37,6 +37,7 @@
 
 #ifndef _3D_DISABLED
 #include "navigation_mesh_generator.h"
+#include "navigation_mesh_tile_cache.h"
 #endif
 
 #ifdef TOOLS_ENABLED
@@ -58,6 +59,7 @@ void initialize_navigation_module(ModuleInitializationLevel p_level) {
 #ifndef _3D_DISABLED
 		_nav_mesh_generator = memnew(NavigationMeshGenerator);
 		GDREGISTER_CLASS(NavigationMeshGenerator);
+		GDREGISTER_CLASS(NavigationMeshTileCache);
 		Engine::get_singleton()->add_singleton(Engine::Singleton("NavigationMeshGenerator", NavigationMeshGenerator::get_singleton()));
 #endif
 	}
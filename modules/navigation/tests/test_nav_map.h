@@ -0,0 +1,472 @@
+/**************************************************************************/
+/*  test_nav_map.h                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_NAV_MAP_H
+#define TEST_NAV_MAP_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "modules/navigation/nav_agent.h"
+#include "modules/navigation/nav_map.h"
+#include "modules/navigation/nav_region.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavMap {
+
+// Flat square navigation mesh made of quads.
+static Ref<NavigationMesh> make_grid_mesh(int p_size) {
+	Ref<NavigationMesh> mesh;
+	mesh.instantiate();
+	Vector<Vector3> vertices;
+	for (int z = 0; z <= p_size; z++) {
+		for (int x = 0; x <= p_size; x++) {
+			vertices.push_back(Vector3(x, 0, z));
+		}
+	}
+	mesh->set_vertices(vertices);
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			Vector<int> polygon;
+			polygon.push_back(z * (p_size + 1) + x);
+			polygon.push_back(z * (p_size + 1) + x + 1);
+			polygon.push_back((z + 1) * (p_size + 1) + x + 1);
+			polygon.push_back((z + 1) * (p_size + 1) + x);
+			mesh->add_polygon(polygon);
+		}
+	}
+	return mesh;
+}
+
+// 3x3 regions, each one made of 4x4 quads.
+struct RegionGrid {
+	static const int REGION_SIZE = 4;
+
+	NavMap map;
+	NavRegion regions[3][3];
+
+	NavRegion &get_region(int p_x, int p_z) {
+		return regions[p_z][p_x];
+	}
+
+	RegionGrid() {
+		Ref<NavigationMesh> mesh = make_grid_mesh(REGION_SIZE);
+		for (int z = 0; z < 3; z++) {
+			for (int x = 0; x < 3; x++) {
+				NavRegion &region = get_region(x, z);
+				region.set_self(RID::from_uint64(z * 3 + x + 1));
+				region.set_map(&map);
+				region.set_mesh(mesh);
+				region.set_transform(Transform3D(Basis(), Vector3(x * REGION_SIZE, 0, z * REGION_SIZE)));
+				map.add_region(&region);
+			}
+		}
+		map.sync();
+	}
+};
+
+// Paths and agents around the middle region touch its corners, so look for segments crossing its inside.
+static bool path_crosses_middle_region(const Vector<Vector3> &p_path) {
+	const real_t min = RegionGrid::REGION_SIZE + 0.01;
+	const real_t max = RegionGrid::REGION_SIZE * 2 - 0.01;
+	for (int i = 1; i < p_path.size(); i++) {
+		for (int step = 0; step <= 16; step++) {
+			const Vector3 point = p_path[i - 1].lerp(p_path[i], step / 16.0);
+			if (point.x > min && point.x < max && point.z > min && point.z < max) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+TEST_CASE("[NavMap] Paths across regions") {
+	RegionGrid grid;
+	const Vector3 from(0.5, 0, 6);
+	const Vector3 to(11.5, 0, 6);
+
+	Vector<Vector3> path = grid.map.get_path(from, to, true, 1, nullptr, nullptr, nullptr);
+	REQUIRE(path.size() >= 2);
+	CHECK(path[0].is_equal_approx(from));
+	CHECK(path[path.size() - 1].is_equal_approx(to));
+	CHECK_MESSAGE(path_crosses_middle_region(path), "The path should go straight through the middle region.");
+
+	// Asking again gives the same path, whether the route between regions is cached or not.
+	CHECK(grid.map.get_path(from, to, true, 1, nullptr, nullptr, nullptr) == path);
+
+	SUBCASE("Expensive regions are avoided") {
+		grid.get_region(1, 1).set_travel_cost(10.0);
+		grid.map.sync();
+		path = grid.map.get_path(from, to, true, 1, nullptr, nullptr, nullptr);
+		REQUIRE(path.size() >= 2);
+		CHECK(path[path.size() - 1].is_equal_approx(to));
+		CHECK_MESSAGE(!path_crosses_middle_region(path), "The path should go around the expensive region.");
+	}
+
+	SUBCASE("Routes follow the endpoints within the same regions") {
+		grid.get_region(1, 1).set_travel_cost(10.0);
+		grid.map.sync();
+
+		// Near the top of the middle row, going around through the top row is shorter.
+		path = grid.map.get_path(Vector3(0.5, 0, 4.1), Vector3(11.5, 0, 4.1), true, 1, nullptr, nullptr, nullptr);
+		REQUIRE(path.size() >= 2);
+		bool through_top_row = !path_crosses_middle_region(path);
+		for (const Vector3 &point : path) {
+			through_top_row = through_top_row && point.z < RegionGrid::REGION_SIZE * 1.5;
+		}
+		CHECK_MESSAGE(through_top_row, "The path should go around through the top row.");
+
+		// Between the same regions, near the bottom, the route through the top row must not be reused.
+		path = grid.map.get_path(Vector3(0.5, 0, 7.9), Vector3(11.5, 0, 7.9), true, 1, nullptr, nullptr, nullptr);
+		REQUIRE(path.size() >= 2);
+		bool through_bottom_row = !path_crosses_middle_region(path);
+		for (const Vector3 &point : path) {
+			through_bottom_row = through_bottom_row && point.z > RegionGrid::REGION_SIZE * 1.5;
+		}
+		CHECK_MESSAGE(through_bottom_row, "The path should go around through the bottom row.");
+	}
+
+	SUBCASE("Regions on other layers are avoided") {
+		grid.get_region(1, 1).set_navigation_layers(2);
+		grid.map.sync();
+		path = grid.map.get_path(from, to, true, 1, nullptr, nullptr, nullptr);
+		REQUIRE(path.size() >= 2);
+		CHECK(path[path.size() - 1].is_equal_approx(to));
+		CHECK_MESSAGE(!path_crosses_middle_region(path), "The path should go around the region on another layer.");
+	}
+
+	SUBCASE("Unreachable destinations give a path to the closest reachable point") {
+		grid.get_region(1, 0).set_navigation_layers(2);
+		grid.get_region(1, 1).set_navigation_layers(2);
+		grid.get_region(1, 2).set_navigation_layers(2);
+		grid.map.sync();
+		path = grid.map.get_path(from, to, true, 1, nullptr, nullptr, nullptr);
+		REQUIRE(path.size() >= 2);
+		CHECK(path[path.size() - 1].x <= RegionGrid::REGION_SIZE + CMP_EPSILON);
+	}
+}
+
+// Moves from p_from along the flow field, recording the visited positions.
+static Vector<Vector3> follow_flow_field(const Ref<NavigationFlowField3D> &p_flow_field, const Vector3 &p_from) {
+	Vector<Vector3> positions;
+	Vector3 position = p_from;
+	positions.push_back(position);
+	for (int i = 0; i < 1000; i++) {
+		const Vector3 step = p_flow_field->get_next_position(position) - position;
+		if (step.length() < CMP_EPSILON) {
+			break;
+		}
+		position += step.limit_length(0.25);
+		positions.push_back(position);
+	}
+	return positions;
+}
+
+// Requests the same flow field from several threads at once.
+struct FlowFieldRequests {
+	static const int REQUEST_COUNT = 8;
+
+	NavMap *map = nullptr;
+	Vector3 destination;
+	Ref<NavigationFlowField3D> flow_fields[REQUEST_COUNT];
+
+	void request(uint32_t p_index, Ref<NavigationFlowField3D> *p_flow_fields) {
+		p_flow_fields[p_index] = map->get_flow_field(destination, 1);
+	}
+};
+
+TEST_CASE("[NavMap] Flow fields") {
+	RegionGrid grid;
+	const Vector3 from(0.5, 0, 6);
+	const Vector3 to(11.5, 0, 6);
+
+	Ref<NavigationFlowField3D> flow_field = grid.map.get_flow_field(to, 1);
+	REQUIRE(flow_field.is_valid());
+	CHECK(flow_field->get_destination().is_equal_approx(to));
+	CHECK(flow_field->get_polygon_count() == 9 * RegionGrid::REGION_SIZE * RegionGrid::REGION_SIZE);
+	CHECK_MESSAGE(grid.map.get_flow_field(to, 1) == flow_field, "Agents sharing a destination should share its flow field.");
+	CHECK_MESSAGE(grid.map.get_flow_field(to + Vector3(0.05, 0, -0.05), 1) == flow_field, "Destinations in the same cell should share a flow field.");
+	CHECK(grid.map.get_flow_field(to, 2) != flow_field);
+
+	CHECK(flow_field->is_reachable(from));
+	CHECK(flow_field->get_travel_cost(from) == doctest::Approx(from.distance_to(to)).epsilon(0.01));
+	CHECK(flow_field->get_direction(from).is_equal_approx(Vector3(1, 0, 0)));
+	CHECK(flow_field->get_travel_cost(to) == doctest::Approx(0.0));
+
+	// Agents anywhere on the map reach the destination.
+	const Vector3 corners[] = { Vector3(0.5, 0, 0.5), Vector3(11.5, 0, 0.5), Vector3(0.5, 0, 11.5), Vector3(11.5, 0, 11.5) };
+	for (const Vector3 &corner : corners) {
+		const Vector<Vector3> positions = follow_flow_field(flow_field, corner);
+		CHECK(positions[positions.size() - 1].is_equal_approx(to));
+	}
+
+	SUBCASE("Expensive regions are avoided") {
+		grid.get_region(1, 1).set_travel_cost(10.0);
+		grid.map.sync();
+		flow_field = grid.map.get_flow_field(to, 1);
+		const Vector<Vector3> positions = follow_flow_field(flow_field, from);
+		CHECK(positions[positions.size() - 1].is_equal_approx(to));
+		CHECK_MESSAGE(!path_crosses_middle_region(positions), "Agents should go around the expensive region.");
+		CHECK_MESSAGE(flow_field->get_travel_cost(from) > from.distance_to(to), "The travel cost should follow the detour.");
+	}
+
+	SUBCASE("Concurrent requests share one build") {
+		FlowFieldRequests requests;
+		requests.map = &grid.map;
+		requests.destination = Vector3(6, 0, 11.5);
+		WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(&requests, &FlowFieldRequests::request, requests.flow_fields, FlowFieldRequests::REQUEST_COUNT, -1, true);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+		REQUIRE(requests.flow_fields[0].is_valid());
+		for (int i = 1; i < FlowFieldRequests::REQUEST_COUNT; i++) {
+			CHECK(requests.flow_fields[i] == requests.flow_fields[0]);
+		}
+		CHECK(grid.map.get_flow_field(requests.destination, 1) == requests.flow_fields[0]);
+	}
+
+	SUBCASE("Unreachable destinations") {
+		grid.get_region(1, 0).set_navigation_layers(2);
+		grid.get_region(1, 1).set_navigation_layers(2);
+		grid.get_region(1, 2).set_navigation_layers(2);
+		grid.map.sync();
+		flow_field = grid.map.get_flow_field(to, 1);
+		CHECK_FALSE(flow_field->is_reachable(from));
+		CHECK(flow_field->get_travel_cost(from) < 0.0);
+		CHECK(flow_field->get_next_position(from).is_equal_approx(from));
+		CHECK(flow_field->is_reachable(Vector3(10, 0, 10)));
+	}
+}
+
+struct RegionMapStats {
+	int polygon_count = 0;
+	uint64_t full_sync_usec = 0;
+	uint64_t incremental_sync_usec = 0;
+	int query_count = 0;
+	uint64_t query_usec = 0;
+	uint64_t flow_field_usec = 0;
+	int agent_count = 0;
+	uint64_t sample_usec = 0;
+};
+
+// Map of p_region_count x p_region_count regions of p_region_size x p_region_size quads,
+// checked while timing its sync and queries.
+static RegionMapStats check_region_map(int p_region_count, int p_region_size, int p_agent_side) {
+	const real_t map_size = p_region_count * p_region_size;
+	RegionMapStats stats;
+
+	NavMap map;
+	Ref<NavigationMesh> mesh = make_grid_mesh(p_region_size);
+	LocalVector<NavRegion *> regions;
+	for (int z = 0; z < p_region_count; z++) {
+		for (int x = 0; x < p_region_count; x++) {
+			NavRegion *region = memnew(NavRegion);
+			region->set_self(RID::from_uint64(regions.size() + 1));
+			region->set_map(&map);
+			region->set_mesh(mesh);
+			region->set_transform(Transform3D(Basis(), Vector3(x * p_region_size, 0, z * p_region_size)));
+			map.add_region(region);
+			regions.push_back(region);
+		}
+	}
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	map.sync();
+	stats.full_sync_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	CHECK(map.get_pm_polygon_count() == p_region_count * p_region_count * p_region_size * p_region_size);
+	CHECK_MESSAGE(map.get_pm_edge_free_count() == 4 * p_region_count * p_region_size, "Only the edges on the border of the map should be left free.");
+
+	// Only the changed region rebuilds its polygons, the others keep sharing theirs with the snapshots.
+	NavRegion *changed_region = regions[p_region_count * p_region_count / 2];
+	const gd::RegionData *changed_data = changed_region->get_data();
+	const gd::RegionData *unchanged_data = regions[0]->get_data();
+	changed_region->set_transform(changed_region->get_transform());
+	begin = OS::get_singleton()->get_ticks_usec();
+	map.sync();
+	stats.incremental_sync_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	CHECK(map.get_pm_polygon_count() == p_region_count * p_region_count * p_region_size * p_region_size);
+	CHECK(changed_region->get_data() != changed_data);
+	CHECK(regions[0]->get_data() == unchanged_data);
+	stats.polygon_count = map.get_pm_polygon_count();
+
+	stats.query_count = 10;
+	for (int i = 0; i < stats.query_count; i++) {
+		const Vector3 from(0.5, 0, 0.5 + i);
+		const Vector3 to(map_size - 0.5, 0, map_size - 0.5 - i);
+		begin = OS::get_singleton()->get_ticks_usec();
+		const Vector<Vector3> path = map.get_path(from, to, true, 1, nullptr, nullptr, nullptr);
+		stats.query_usec += OS::get_singleton()->get_ticks_usec() - begin;
+		REQUIRE(path.size() >= 2);
+		CHECK(path[0].is_equal_approx(from));
+		CHECK(path[path.size() - 1].is_equal_approx(to));
+	}
+
+	// One flow field serves every agent heading to the same destination.
+	begin = OS::get_singleton()->get_ticks_usec();
+	Ref<NavigationFlowField3D> flow_field = map.get_flow_field(Vector3(map_size - 0.5, 0, map_size - 0.5), 1);
+	stats.flow_field_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	REQUIRE(flow_field.is_valid());
+
+	stats.agent_count = p_agent_side * p_agent_side;
+	begin = OS::get_singleton()->get_ticks_usec();
+	int reachable_count = 0;
+	for (int i = 0; i < stats.agent_count; i++) {
+		const Vector3 position((i % p_agent_side) * map_size / p_agent_side + 0.1, 0, (i / p_agent_side) * map_size / p_agent_side + 0.1);
+		if (flow_field->is_reachable(position) && !flow_field->get_direction(position).is_zero_approx()) {
+			reachable_count++;
+		}
+	}
+	stats.sample_usec = OS::get_singleton()->get_ticks_usec() - begin;
+	CHECK(reachable_count == stats.agent_count);
+
+	for (NavRegion *region : regions) {
+		map.remove_region(region);
+		memdelete(region);
+	}
+	return stats;
+}
+
+TEST_CASE("[NavMap] Sync and queries with many regions") {
+	check_region_map(4, 8, 10);
+}
+
+TEST_CASE_BENCHMARK("[NavMap][Benchmark] Sync and queries with 100k polygons") {
+	const RegionMapStats stats = check_region_map(10, 32, 100);
+	MESSAGE(vformat("Syncing a map with %d polygons took %d usec, syncing it after changing one region took %d usec.", stats.polygon_count, stats.full_sync_usec, stats.incremental_sync_usec));
+	MESSAGE(vformat("%d path queries across the map took %d usec.", stats.query_count, stats.query_usec));
+	MESSAGE(vformat("Building a flow field took %d usec, sampling it for %d agents took %d usec.", stats.flow_field_usec, stats.agent_count, stats.sample_usec));
+}
+
+// Agents scattered in a square, heading to its center. On the XZ plane when p_flat is true.
+struct Crowd {
+	NavMap map;
+	LocalVector<NavAgent *> agents;
+
+	Crowd(NavigationServer3D::AvoidanceBackend p_backend, int p_agent_count, bool p_flat) {
+		map.set_avoidance_backend(p_backend);
+		RandomPCG rng(1234);
+		const float size = Math::sqrt((float)p_agent_count) * 2.0;
+		for (int i = 0; i < p_agent_count; i++) {
+			NavAgent *agent = memnew(NavAgent);
+			agent->set_map(&map);
+			RVO::Agent *rvo_agent = agent->get_agent();
+			const float x = rng.randf() * size;
+			const float y = p_flat ? 0.0 : rng.randf() * size;
+			const float z = rng.randf() * size;
+			rvo_agent->position_ = RVO::Vector3(x, y, z);
+			rvo_agent->prefVelocity_ = RVO::Vector3(size * 0.5 - x, p_flat ? 0.0 : size * 0.5 - y, size * 0.5 - z) * 0.1;
+			rvo_agent->maxNeighbors_ = 10;
+			rvo_agent->maxSpeed_ = 2.0;
+			rvo_agent->neighborDist_ = 5.0;
+			rvo_agent->radius_ = 0.5;
+			rvo_agent->timeHorizon_ = 5.0;
+			rvo_agent->ignore_y_ = p_flat;
+			map.add_agent(agent);
+			map.set_agent_as_controlled(agent);
+			agents.push_back(agent);
+		}
+	}
+
+	~Crowd() {
+		for (NavAgent *agent : agents) {
+			map.remove_agent(agent);
+			memdelete(agent);
+		}
+	}
+};
+
+static void check_avoidance_backends_match(bool p_flat) {
+	const int agent_count = 500;
+
+	Crowd kd_tree_crowd(NavigationServer3D::AVOIDANCE_BACKEND_KD_TREE, agent_count, p_flat);
+	Crowd spatial_hash_crowd(NavigationServer3D::AVOIDANCE_BACKEND_SPATIAL_HASH, agent_count, p_flat);
+	kd_tree_crowd.map.sync();
+	spatial_hash_crowd.map.sync();
+	kd_tree_crowd.map.step(0.1);
+	spatial_hash_crowd.map.step(0.1);
+
+	for (int i = 0; i < agent_count; i++) {
+		const RVO::Agent *expected = kd_tree_crowd.agents[i]->get_agent();
+		const RVO::Agent *agent = spatial_hash_crowd.agents[i]->get_agent();
+		REQUIRE(agent->agentNeighbors_.size() == expected->agentNeighbors_.size());
+		for (size_t j = 0; j < agent->agentNeighbors_.size(); j++) {
+			CHECK(agent->agentNeighbors_[j].first == doctest::Approx(expected->agentNeighbors_[j].first));
+		}
+		CHECK(Math::is_equal_approx(agent->newVelocity_.x(), expected->newVelocity_.x()));
+		CHECK(Math::is_equal_approx(agent->newVelocity_.y(), expected->newVelocity_.y()));
+		CHECK(Math::is_equal_approx(agent->newVelocity_.z(), expected->newVelocity_.z()));
+	}
+}
+
+static void benchmark_avoidance_backends(bool p_flat) {
+	const int agent_count = 10000;
+
+	// The k-d tree is built during sync, the spatial hash during step.
+	Crowd kd_tree_crowd(NavigationServer3D::AVOIDANCE_BACKEND_KD_TREE, agent_count, p_flat);
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	kd_tree_crowd.map.sync();
+	kd_tree_crowd.map.step(0.1);
+	const uint64_t kd_tree_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	Crowd spatial_hash_crowd(NavigationServer3D::AVOIDANCE_BACKEND_SPATIAL_HASH, agent_count, p_flat);
+	begin = OS::get_singleton()->get_ticks_usec();
+	spatial_hash_crowd.map.sync();
+	spatial_hash_crowd.map.step(0.1);
+	const uint64_t spatial_hash_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	for (NavAgent *agent : spatial_hash_crowd.agents) {
+		CHECK(agent->get_agent()->agentNeighbors_.size() <= 10);
+	}
+
+	MESSAGE(vformat("Avoidance step of %d %s agents took %d usec with the k-d tree and %d usec with the spatial hash.", agent_count, p_flat ? "2D" : "3D", kd_tree_usec, spatial_hash_usec));
+}
+
+TEST_CASE("[NavMap] Avoidance backends find the same neighbors") {
+	NavMap map;
+	CHECK_MESSAGE(map.get_avoidance_backend() == NavigationServer3D::AVOIDANCE_BACKEND_KD_TREE, "The k-d tree should be the default backend.");
+
+	SUBCASE("2D") {
+		check_avoidance_backends_match(true);
+	}
+	SUBCASE("3D") {
+		check_avoidance_backends_match(false);
+	}
+}
+
+TEST_CASE_BENCHMARK("[NavMap][Benchmark] Avoidance step with 10k agents") {
+	SUBCASE("2D") {
+		benchmark_avoidance_backends(true);
+	}
+	SUBCASE("3D") {
+		benchmark_avoidance_backends(false);
+	}
+}
+
+} // namespace TestNavMap
+
+#endif // TEST_NAV_MAP_H
@@ -0,0 +1,151 @@
+/**************************************************************************/
+/*  test_navigation_mesh_tile_cache.h                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_NAVIGATION_MESH_TILE_CACHE_H
+#define TEST_NAVIGATION_MESH_TILE_CACHE_H
+
+#include "modules/navigation/navigation_mesh_generator.h"
+#include "modules/navigation/navigation_mesh_tile_cache.h"
+#include "scene/3d/mesh_instance_3d.h"
+#include "scene/main/window.h"
+#include "scene/resources/primitive_meshes.h"
+#include "servers/navigation_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavigationMeshTileCache {
+
+// Area of the polygons of a navigation mesh, projected on the XZ plane.
+static real_t get_navigation_mesh_area(Ref<NavigationMesh> p_navigation_mesh) {
+	const Vector<Vector3> vertices = p_navigation_mesh->get_vertices();
+	real_t area = 0.0;
+	for (int i = 0; i < p_navigation_mesh->get_polygon_count(); i++) {
+		const Vector<int> polygon = p_navigation_mesh->get_polygon(i);
+		for (int j = 0; j < polygon.size(); j++) {
+			const Vector3 &a = vertices[polygon[j]];
+			const Vector3 &b = vertices[polygon[(j + 1) % polygon.size()]];
+			area += a.x * b.z - b.x * a.z;
+		}
+	}
+	return Math::abs(area) * 0.5;
+}
+
+static MeshInstance3D *add_box(Node3D *p_root, const Vector3 &p_position) {
+	Ref<BoxMesh> box_mesh;
+	box_mesh.instantiate();
+	MeshInstance3D *box = memnew(MeshInstance3D);
+	box->set_mesh(box_mesh);
+	box->set_position(p_position);
+	p_root->add_child(box);
+	return box;
+}
+
+TEST_CASE("[SceneTree][NavigationMeshTileCache] Tiled bakes") {
+	// A 32x32 floor, over 4x4 tiles of 8 units.
+	Node3D *root = memnew(Node3D);
+	SceneTree::get_singleton()->get_root()->add_child(root);
+	Ref<PlaneMesh> plane_mesh;
+	plane_mesh.instantiate();
+	plane_mesh->set_size(Size2(32, 32));
+	MeshInstance3D *floor = memnew(MeshInstance3D);
+	floor->set_mesh(plane_mesh);
+	floor->set_position(Vector3(16, 0, 16));
+	root->add_child(floor);
+
+	Ref<NavigationMesh> navigation_mesh;
+	navigation_mesh.instantiate();
+	navigation_mesh->set_agent_radius(0.5);
+
+	NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+	RID map = navigation_server->map_create();
+	navigation_server->map_set_active(map, true);
+
+	Ref<NavigationMeshTileCache> tile_cache;
+	tile_cache.instantiate();
+	tile_cache->set_navigation_mesh(navigation_mesh);
+	tile_cache->set_tile_size(8.0);
+	tile_cache->set_map(map);
+
+	const int tile_count = tile_cache->bake(root);
+	CHECK(tile_count > 0);
+	CHECK(tile_cache->get_tile_count() == tile_count);
+	CHECK_MESSAGE(tile_cache->bake(root) == 0, "Baking again without changes should not bake any tile.");
+
+	SUBCASE("Changing one tile only rebakes that tile") {
+		MeshInstance3D *box = add_box(root, Vector3(12, 0.5, 12));
+		CHECK(tile_cache->bake(root) == 1);
+		CHECK(tile_cache->get_tile_navigation_mesh(Vector2i(1, 1)).is_valid());
+
+		box->set_position(Vector3(20, 0.5, 20));
+		CHECK_MESSAGE(tile_cache->bake(root) == 2, "Moving the box should rebake the tile it left and the tile it entered.");
+	}
+
+	SUBCASE("Changing a bake setting rebakes every tile") {
+		navigation_mesh->set_agent_max_slope(30.0);
+		CHECK_MESSAGE(tile_cache->bake(root) == tile_count, "Changing a bake setting should rebake every tile.");
+		CHECK(tile_cache->get_tile_count() == tile_count);
+		CHECK(tile_cache->bake(root) == 0);
+	}
+
+	SUBCASE("Stitched tiles match a full bake") {
+		add_box(root, Vector3(12, 0.5, 12));
+		tile_cache->bake(root);
+
+		Ref<NavigationMesh> full_navigation_mesh;
+		full_navigation_mesh.instantiate();
+		full_navigation_mesh->set_agent_radius(0.5);
+		NavigationMeshGenerator::get_singleton()->bake(full_navigation_mesh, root);
+		REQUIRE(full_navigation_mesh->get_polygon_count() > 0);
+
+		real_t tiles_area = 0.0;
+		const TypedArray<Vector2i> tiles = tile_cache->get_tiles();
+		for (int i = 0; i < tiles.size(); i++) {
+			tiles_area += get_navigation_mesh_area(tile_cache->get_tile_navigation_mesh(tiles[i]));
+		}
+		const real_t full_area = get_navigation_mesh_area(full_navigation_mesh);
+		CHECK(tiles_area == doctest::Approx(full_area).epsilon(0.02));
+
+		// Paths cross the tile edges, so the map must have connected them.
+		navigation_server->map_force_update(map);
+		const Vector3 to(30, 0, 30);
+		const Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(2, 0, 2), to, true);
+		REQUIRE(path.size() >= 2);
+		CHECK(path[path.size() - 1].distance_to(to) < 0.5);
+	}
+
+	tile_cache->clear();
+	navigation_server->free(map);
+	navigation_server->process(0.0);
+	memdelete(root);
+}
+
+} // namespace TestNavigationMeshTileCache
+
+#endif // TEST_NAVIGATION_MESH_TILE_CACHE_H
@@ -179,6 +179,33 @@ Vector<real_t> HeightMapShape3D::get_map_data() const {
 	return map_data;
 }
 
+void HeightMapShape3D::update_map_data_region(const Rect2i &p_region, const Vector<real_t> &p_data) {
+	ERR_FAIL_COND_MSG(!p_region.has_area() || !Rect2i(0, 0, map_width, map_depth).encloses(p_region), "Region must be inside the height map.");
+	ERR_FAIL_COND(p_data.size() != p_region.size.x * p_region.size.y);
+
+	real_t *w = map_data.ptrw();
+	const real_t *r = p_data.ptr();
+	for (int z = 0; z < p_region.size.y; z++) {
+		for (int x = 0; x < p_region.size.x; x++) {
+			real_t val = r[z * p_region.size.x + x];
+			w[(p_region.position.y + z) * map_width + p_region.position.x + x] = val;
+			// Keep the range conservative rather than scanning the whole map again.
+			if (min_height > val) {
+				min_height = val;
+			}
+
+			if (max_height < val) {
+				max_height = val;
+			}
+		}
+	}
+
+	// Only send the modified region, the physics server doesn't need to rebuild the whole shape.
+	PhysicsServer3D::get_singleton()->heightmap_shape_update_region(get_shape(), p_region, p_data);
+	Shape3D::_update_shape();
+	notify_change_to_owners();
+}
+
 void HeightMapShape3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_map_width", "width"), &HeightMapShape3D::set_map_width);
 	ClassDB::bind_method(D_METHOD("get_map_width"), &HeightMapShape3D::get_map_width);
@@ -186,6 +213,7 @@ void HeightMapShape3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("get_map_depth"), &HeightMapShape3D::get_map_depth);
 	ClassDB::bind_method(D_METHOD("set_map_data", "data"), &HeightMapShape3D::set_map_data);
 	ClassDB::bind_method(D_METHOD("get_map_data"), &HeightMapShape3D::get_map_data);
+	ClassDB::bind_method(D_METHOD("update_map_data_region", "region", "data"), &HeightMapShape3D::update_map_data_region);
 
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "map_width", PROPERTY_HINT_RANGE, "0.001,100,0.001,or_greater"), "set_map_width", "get_map_width");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "map_depth", PROPERTY_HINT_RANGE, "0.001,100,0.001,or_greater"), "set_map_depth", "get_map_depth");
@@ -1633,6 +1633,15 @@ int ArrayMesh::get_surface_count() const {
 	return surfaces.size();
 }
 
+uint64_t ArrayMesh::get_memory_usage_estimate() const {
+	uint64_t size = 0;
+	for (int i = 0; i < surfaces.size(); i++) {
+		// Position, normal, tangent and UV per vertex, 32-bit indices.
+		size += (uint64_t)surfaces[i].array_length * 32 + (uint64_t)surfaces[i].index_array_length * 4;
+	}
+	return size;
+}
+
 void ArrayMesh::add_blend_shape(const StringName &p_name) {
 	ERR_FAIL_COND_MSG(surfaces.size(), "Can't add a shape key count if surfaces are already created.");
 
@@ -294,6 +294,8 @@ public:
 
 	int get_surface_count() const override;
 
+	virtual uint64_t get_memory_usage_estimate() const override;
+
 	void clear_surfaces();
 
 	void surface_set_custom_aabb(int p_idx, const AABB &p_aabb); //only recognized by driver
@@ -111,6 +111,13 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 
 	LocalVector<DeferredNodePathProperties> deferred_node_paths;
 
+	// Resolved setters are only used at runtime, the editor goes through Object::set() so it keeps track of edits.
+	const PropertySetter *setters = nullptr;
+	if (p_edit_state == GEN_EDIT_STATE_DISABLED) {
+		_update_property_setters();
+		setters = property_setters.ptr();
+	}
+
 	for (int i = 0; i < nc; i++) {
 		const NodeData &n = nd[i];
 
@@ -136,6 +143,7 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 
 		Node *node = nullptr;
 		MissingNode *missing_node = nullptr;
+		bool created_from_type = false;
 
 		if (i == 0 && base_scene_idx >= 0) {
 			//scene inheritance on root node
@@ -184,6 +192,7 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 			Object *obj = ClassDB::instantiate(snames[n.type]);
 
 			node = Object::cast_to<Node>(obj);
+			created_from_type = node != nullptr;
 
 			if (!node) {
 				if (obj) {
@@ -229,6 +238,12 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 			if (nprop_count) {
 				const NodeData::Property *nprops = &n.properties[0];
 
+				// Pre-resolved setters can only be used if the node is exactly of the packed type.
+				const PropertySetter *nsetters = nullptr;
+				if (setters && created_from_type && node->get_class_name() == snames[n.type]) {
+					nsetters = &setters[node_setter_offsets[i]];
+				}
+
 				Dictionary missing_resource_properties;
 
 				for (int j = 0; j < nprop_count; j++) {
@@ -340,7 +355,20 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 						}
 
 						if (set_valid) {
-							node->set(snames[nprops[j].name], value, &valid);
+							if (nsetters && nsetters[j].method && !node->get_script_instance()) {
+								// Same as ClassDB::set_property(), minus the lookup.
+								Callable::CallError ce;
+								if (nsetters[j].index >= 0) {
+									Variant index = nsetters[j].index;
+									const Variant *args[2] = { &index, &value };
+									nsetters[j].method->call(node, args, 2, ce);
+								} else {
+									const Variant *args[1] = { &value };
+									nsetters[j].method->call(node, args, 1, ce);
+								}
+							} else {
+								node->set(snames[nprops[j].name], value, &valid);
+							}
 						}
 					}
 				}
@@ -482,6 +510,261 @@ Node *SceneState::instantiate(GenEditState p_edit_state) const {
 	return ret_nodes[0];
 }
 
+bool SceneState::reset_instance(Node *p_root) const {
+	ERR_FAIL_NULL_V(p_root, false);
+
+	int nc = nodes.size();
+	ERR_FAIL_COND_V(nc == 0, false);
+
+	const StringName *snames = names.ptr();
+	int sname_count = names.size();
+	const Variant *props = variants.ptr();
+	int prop_count = variants.size();
+
+	LocalVector<Node *> reset_nodes;
+	reset_nodes.resize(nc);
+
+	LocalVector<DeferredNodePathProperties> deferred_node_paths;
+
+	for (int i = 0; i < nc; i++) {
+		const NodeData &n = nodes[i];
+		ERR_FAIL_INDEX_V(n.name, sname_count, false);
+
+		Node *node = nullptr;
+		if (i == 0) {
+			node = p_root;
+		} else {
+			Node *parent = nullptr;
+			if (n.parent & FLAG_ID_IS_PATH) {
+				parent = p_root->get_node_or_null(node_paths[n.parent & FLAG_MASK]);
+			} else if ((n.parent & FLAG_MASK) < i) {
+				parent = reset_nodes[n.parent & FLAG_MASK];
+			}
+			if (parent) {
+				node = parent->_get_child_by_name(snames[n.name]);
+			}
+		}
+
+		if (!node) {
+			// The instance no longer matches the scene, it can't be reset.
+			return false;
+		}
+
+		// Instantiated and inherited nodes are reset by their own state first, overrides from this state are applied on top.
+		Ref<PackedScene> sub_scene;
+		if (i == 0 && base_scene_idx >= 0) {
+			sub_scene = props[base_scene_idx];
+		} else if (n.instance >= 0) {
+			if (n.instance & FLAG_INSTANCE_IS_PLACEHOLDER) {
+				return false;
+			}
+			sub_scene = props[n.instance & FLAG_MASK];
+		}
+
+		if (sub_scene.is_valid()) {
+			if (!sub_scene->get_state()->reset_instance(node)) {
+				return false;
+			}
+		}
+
+		bool created_from_type = sub_scene.is_null() && n.type != TYPE_INSTANTIATED;
+
+		// A script added or replaced at runtime carries state we can't reset.
+		Variant packed_script;
+		bool has_packed_script = false;
+		for (const NodeData::Property &prop : n.properties) {
+			if (!(prop.name & FLAG_PATH_PROPERTY_IS_NODE) && prop.name < sname_count && prop.value < prop_count && snames[prop.name] == CoreStringNames::get_singleton()->_script) {
+				packed_script = props[prop.value];
+				has_packed_script = true;
+			}
+		}
+		if ((has_packed_script || created_from_type) && node->get_script() != packed_script) {
+			return false;
+		}
+
+		if (created_from_type) {
+			ERR_FAIL_INDEX_V(n.type, sname_count, false);
+			if (node->get_class_name() != snames[n.type]) {
+				return false;
+			}
+
+			// Properties that are not packed go back to the script or class default.
+			Ref<Script> scr = node->get_script();
+			List<PropertyInfo> plist;
+			node->get_property_list(&plist);
+			for (const PropertyInfo &E : plist) {
+				if (!(E.usage & PROPERTY_USAGE_STORAGE) || E.name == CoreStringNames::get_singleton()->_script) {
+					continue;
+				}
+
+				bool packed = false;
+				for (const NodeData::Property &prop : n.properties) {
+					if ((prop.name & FLAG_PROP_NAME_MASK) < sname_count && snames[prop.name & FLAG_PROP_NAME_MASK] == E.name) {
+						packed = true;
+						break;
+					}
+				}
+				if (packed) {
+					continue;
+				}
+
+				Variant default_value;
+				bool valid = scr.is_valid() && scr->get_property_default_value(E.name, default_value);
+				if (!valid) {
+					default_value = ClassDB::class_get_default_property_value(snames[n.type], E.name, &valid);
+				}
+				if (valid && PropertyUtils::is_property_value_different(node->get(E.name), default_value)) {
+					node->set(E.name, default_value);
+				}
+			}
+
+			// Metadata and groups added at runtime are removed, internal groups are managed by the nodes themselves.
+			List<StringName> meta_list;
+			node->get_meta_list(&meta_list);
+			for (const StringName &meta : meta_list) {
+				const String meta_property = "metadata/" + String(meta);
+				bool packed = false;
+				for (const NodeData::Property &prop : n.properties) {
+					if ((prop.name & FLAG_PROP_NAME_MASK) < sname_count && snames[prop.name & FLAG_PROP_NAME_MASK] == meta_property) {
+						packed = true;
+						break;
+					}
+				}
+				if (!packed) {
+					node->remove_meta(meta);
+				}
+			}
+
+			List<Node::GroupInfo> groups;
+			node->get_groups(&groups);
+			for (const Node::GroupInfo &gi : groups) {
+				if (String(gi.name).begins_with("_")) {
+					continue;
+				}
+				bool packed = false;
+				for (int j = 0; j < n.groups.size(); j++) {
+					if (n.groups[j] < sname_count && snames[n.groups[j]] == gi.name) {
+						packed = true;
+						break;
+					}
+				}
+				if (!packed) {
+					node->remove_from_group(gi.name);
+				}
+			}
+		}
+
+		for (int j = 0; j < n.groups.size(); j++) {
+			ERR_FAIL_INDEX_V(n.groups[j], sname_count, false);
+			if (!node->is_in_group(snames[n.groups[j]])) {
+				node->add_to_group(snames[n.groups[j]], true);
+			}
+		}
+
+		for (const NodeData::Property &prop : n.properties) {
+			ERR_FAIL_INDEX_V(prop.value, prop_count, false);
+
+			if (prop.name & FLAG_PATH_PROPERTY_IS_NODE) {
+				uint32_t name_idx = prop.name & FLAG_PROP_NAME_MASK;
+				ERR_FAIL_UNSIGNED_INDEX_V(name_idx, (uint32_t)sname_count, false);
+				DeferredNodePathProperties dnp;
+				dnp.path = props[prop.value];
+				dnp.base = node;
+				dnp.property = snames[name_idx];
+				deferred_node_paths.push_back(dnp);
+				continue;
+			}
+
+			ERR_FAIL_INDEX_V(prop.name, sname_count, false);
+			if (snames[prop.name] == CoreStringNames::get_singleton()->_script) {
+				continue;
+			}
+
+			Variant value = props[prop.value];
+			if (value.get_type() == Variant::OBJECT) {
+				Ref<Resource> res = value;
+				if (res.is_valid() && res->is_local_to_scene()) {
+					// The instance keeps its own copy of the resource.
+					continue;
+				}
+			}
+
+			Variant current_value = node->get(snames[prop.name]);
+			if (value.get_type() == Variant::ARRAY && current_value.get_type() == Variant::ARRAY) {
+				Array set_array = value;
+				Array get_array = current_value;
+				if (!set_array.is_same_typed(get_array)) {
+					value = Array(set_array, get_array.get_typed_builtin(), get_array.get_typed_class_name(), get_array.get_typed_script());
+				}
+			}
+			if (PropertyUtils::is_property_value_different(current_value, value)) {
+				node->set(snames[prop.name], value);
+			}
+		}
+
+		node->request_ready();
+		reset_nodes[i] = node;
+	}
+
+	for (const DeferredNodePathProperties &dnp : deferred_node_paths) {
+		Node *other = dnp.base->get_node_or_null(dnp.path);
+		dnp.base->set(dnp.property, other);
+	}
+
+	return true;
+}
+
+void SceneState::_update_property_setters() const {
+	MutexLock lock(property_setters_mutex);
+
+	if (property_setters_valid) {
+		return;
+	}
+
+	int nc = nodes.size();
+	int sname_count = names.size();
+
+	node_setter_offsets.resize(nc);
+	property_setters.clear();
+
+	for (int i = 0; i < nc; i++) {
+		const NodeData &n = nodes[i];
+		node_setter_offsets[i] = property_setters.size();
+
+		// Only nodes created by this scene from their type have a known class.
+		StringName type;
+		if (n.type != TYPE_INSTANTIATED && n.instance < 0 && !(i == 0 && base_scene_idx >= 0) && n.type >= 0 && n.type < sname_count) {
+			type = names[n.type];
+			ClassDB::APIType api = ClassDB::get_api_type(type);
+			if (!ClassDB::class_exists(type) || api == ClassDB::API_EXTENSION || api == ClassDB::API_EDITOR_EXTENSION) {
+				type = StringName();
+			}
+		}
+
+		for (int j = 0; j < n.properties.size(); j++) {
+			PropertySetter setter;
+
+			int name_idx = n.properties[j].name;
+			if (type != StringName() && !(name_idx & FLAG_PATH_PROPERTY_IS_NODE) && name_idx < sname_count && names[name_idx] != CoreStringNames::get_singleton()->_script) {
+				StringName setter_name = ClassDB::get_property_setter(type, names[name_idx]);
+				if (setter_name != StringName()) {
+					setter.method = ClassDB::get_method(type, setter_name);
+					setter.index = ClassDB::get_property_index(type, names[name_idx]);
+				}
+			}
+
+			property_setters.push_back(setter);
+		}
+	}
+
+	property_setters_valid = true;
+}
+
+void SceneState::_invalidate_property_setters() {
+	MutexLock lock(property_setters_mutex);
+	property_setters_valid = false;
+}
+
 static int _nm_get_string(const String &p_string, HashMap<StringName, int> &name_map) {
 	if (name_map.has(p_string)) {
 		return name_map[p_string];
@@ -1006,6 +1289,7 @@ String SceneState::get_path() const {
 }
 
 void SceneState::clear() {
+	_invalidate_property_setters();
 	names.clear();
 	variants.clear();
 	nodes.clear();
@@ -1221,6 +1505,8 @@ void SceneState::set_bundled_scene(const Dictionary &p_dictionary) {
 
 	ERR_FAIL_COND_MSG(version > PACKED_SCENE_VERSION, "Save format version too new.");
 
+	_invalidate_property_setters();
+
 	const int node_count = p_dictionary["node_count"];
 	const Vector<int> snodes = p_dictionary["nodes"];
 	ERR_FAIL_COND(snodes.size() < node_count);
@@ -1683,6 +1969,7 @@ int SceneState::add_node(int p_parent, int p_owner, int p_type, int p_name, int
 	nd.instance = p_instance;
 	nd.index = p_index;
 
+	_invalidate_property_setters();
 	nodes.push_back(nd);
 
 	return nodes.size() - 1;
@@ -1699,6 +1986,7 @@ void SceneState::add_node_property(int p_node, int p_name, int p_value, bool p_d
 		prop.name |= FLAG_PATH_PROPERTY_IS_NODE;
 	}
 	prop.value = p_value;
+	_invalidate_property_setters();
 	nodes.write[p_node].properties.push_back(prop);
 }
 
@@ -1795,10 +2083,12 @@ Dictionary PackedScene::_get_bundled_scene() const {
 }
 
 Error PackedScene::pack(Node *p_scene) {
+	clear_pool();
 	return state->pack(p_scene);
 }
 
 void PackedScene::clear() {
+	clear_pool();
 	state->clear();
 }
 
@@ -1851,7 +2141,138 @@ Node *PackedScene::instantiate(GenEditState p_edit_state) const {
 	return s;
 }
 
+static int _count_nodes(const Node *p_node) {
+	int count = 1;
+	for (int i = 0; i < p_node->get_child_count(); i++) {
+		count += _count_nodes(p_node->get_child(i));
+	}
+	return count;
+}
+
+static void _free_instance(Node *p_instance, bool p_was_inside_tree) {
+	// Nodes taken out of the tree might still be in use by the code that triggered the recycling.
+	if (p_was_inside_tree) {
+		p_instance->queue_free();
+	} else {
+		memdelete(p_instance);
+	}
+}
+
+Node *PackedScene::instantiate_pooled() const {
+	{
+		MutexLock lock(pool_mutex);
+		if (!pool.is_empty()) {
+			Node *s = pool[pool.size() - 1];
+			pool.resize(pool.size() - 1);
+			pool_hits++;
+			return s;
+		}
+		pool_misses++;
+	}
+
+	Node *s = instantiate();
+	if (s) {
+		MutexLock lock(pool_mutex);
+		if (pool_node_count < 0) {
+			pool_node_count = _count_nodes(s);
+		}
+		// Instances freed by the user are never recycled, forget them once in a while.
+		if (pool_instances.size() >= pool_instances_prune_size) {
+			LocalVector<ObjectID> freed;
+			for (const ObjectID &id : pool_instances) {
+				if (!ObjectDB::get_instance(id)) {
+					freed.push_back(id);
+				}
+			}
+			for (const ObjectID &id : freed) {
+				pool_instances.erase(id);
+			}
+			pool_instances_prune_size = MAX(64u, pool_instances.size() * 2);
+		}
+		pool_instances.insert(s->get_instance_id());
+	}
+	return s;
+}
+
+bool PackedScene::recycle_instance(Node *p_instance) {
+	ERR_FAIL_NULL_V(p_instance, false);
+	ERR_FAIL_COND_V_MSG(p_instance->is_queued_for_deletion(), false, "Can't recycle an instance that is queued for deletion.");
+
+	const bool was_inside_tree = p_instance->is_inside_tree();
+	bool can_pool;
+	{
+		MutexLock lock(pool_mutex);
+		if (!pool_instances.has(p_instance->get_instance_id())) {
+			// Not created by instantiate_pooled(), it can't be trusted to match the scene.
+			_free_instance(p_instance, was_inside_tree);
+			return false;
+		}
+		can_pool = (int)pool.size() < pool_capacity && pool_node_count > 0;
+	}
+
+	if (p_instance->get_parent()) {
+		p_instance->get_parent()->remove_child(p_instance);
+	}
+
+	// Nodes added or removed at runtime can't be undone, only instances with the original structure are kept.
+	if (can_pool && _count_nodes(p_instance) == pool_node_count && state->reset_instance(p_instance)) {
+		MutexLock lock(pool_mutex);
+		if ((int)pool.size() < pool_capacity) {
+			pool.push_back(p_instance);
+			return true;
+		}
+	}
+
+	{
+		MutexLock lock(pool_mutex);
+		pool_instances.erase(p_instance->get_instance_id());
+	}
+	_free_instance(p_instance, was_inside_tree);
+	return false;
+}
+
+void PackedScene::set_pool_capacity(int p_capacity) {
+	ERR_FAIL_COND(p_capacity < 0);
+
+	MutexLock lock(pool_mutex);
+	pool_capacity = p_capacity;
+	while ((int)pool.size() > pool_capacity) {
+		pool_instances.erase(pool[pool.size() - 1]->get_instance_id());
+		memdelete(pool[pool.size() - 1]);
+		pool.resize(pool.size() - 1);
+	}
+}
+
+int PackedScene::get_pool_capacity() const {
+	return pool_capacity;
+}
+
+int PackedScene::get_pooled_instance_count() const {
+	MutexLock lock(pool_mutex);
+	return pool.size();
+}
+
+uint64_t PackedScene::get_pool_hit_count() const {
+	return pool_hits;
+}
+
+uint64_t PackedScene::get_pool_miss_count() const {
+	return pool_misses;
+}
+
+void PackedScene::clear_pool() {
+	MutexLock lock(pool_mutex);
+	for (Node *E : pool) {
+		memdelete(E);
+	}
+	pool.clear();
+	// Instances still in use belong to the old state, they are freed when recycled.
+	pool_instances.clear();
+	pool_node_count = -1;
+}
+
 void PackedScene::replace_state(Ref<SceneState> p_by) {
+	clear_pool();
 	state = p_by;
 	state->set_path(get_path());
 #ifdef TOOLS_ENABLED
@@ -1860,6 +2281,7 @@ void PackedScene::replace_state(Ref<SceneState> p_by) {
 }
 
 void PackedScene::recreate_state() {
+	clear_pool();
 	state = Ref<SceneState>(memnew(SceneState));
 	state->set_path(get_path());
 #ifdef TOOLS_ENABLED
@@ -1883,6 +2305,14 @@ void PackedScene::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("pack", "path"), &PackedScene::pack);
 	ClassDB::bind_method(D_METHOD("instantiate", "edit_state"), &PackedScene::instantiate, DEFVAL(GEN_EDIT_STATE_DISABLED));
 	ClassDB::bind_method(D_METHOD("can_instantiate"), &PackedScene::can_instantiate);
+	ClassDB::bind_method(D_METHOD("instantiate_pooled"), &PackedScene::instantiate_pooled);
+	ClassDB::bind_method(D_METHOD("recycle_instance", "instance"), &PackedScene::recycle_instance);
+	ClassDB::bind_method(D_METHOD("set_pool_capacity", "capacity"), &PackedScene::set_pool_capacity);
+	ClassDB::bind_method(D_METHOD("get_pool_capacity"), &PackedScene::get_pool_capacity);
+	ClassDB::bind_method(D_METHOD("get_pooled_instance_count"), &PackedScene::get_pooled_instance_count);
+	ClassDB::bind_method(D_METHOD("get_pool_hit_count"), &PackedScene::get_pool_hit_count);
+	ClassDB::bind_method(D_METHOD("get_pool_miss_count"), &PackedScene::get_pool_miss_count);
+	ClassDB::bind_method(D_METHOD("clear_pool"), &PackedScene::clear_pool);
 	ClassDB::bind_method(D_METHOD("_set_bundled_scene", "scene"), &PackedScene::_set_bundled_scene);
 	ClassDB::bind_method(D_METHOD("_get_bundled_scene"), &PackedScene::_get_bundled_scene);
 	ClassDB::bind_method(D_METHOD("get_state"), &PackedScene::get_state);
@@ -1898,3 +2328,7 @@ void PackedScene::_bind_methods() {
 PackedScene::PackedScene() {
 	state = Ref<SceneState>(memnew(SceneState));
 }
+
+PackedScene::~PackedScene() {
+	clear_pool();
+}
@@ -32,6 +32,8 @@
 #define PACKED_SCENE_H
 
 #include "core/io/resource.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
 #include "scene/main/node.h"
 
 class SceneState : public RefCounted {
@@ -89,6 +91,24 @@ class SceneState : public RefCounted {
 
 	Vector<ConnectionData> connections;
 
+	// Property setters resolved through ClassDB once per state, so that
+	// instantiating the same scene many times does not look up every
+	// property in the class hierarchy again. Setters for all nodes are
+	// stored in a single flat array, node_setter_offsets[i] being the
+	// position of the first property of node i.
+	struct PropertySetter {
+		MethodBind *method = nullptr;
+		int index = -1;
+	};
+
+	mutable LocalVector<uint32_t> node_setter_offsets;
+	mutable LocalVector<PropertySetter> property_setters;
+	mutable bool property_setters_valid = false;
+	mutable Mutex property_setters_mutex;
+
+	void _update_property_setters() const;
+	void _invalidate_property_setters();
+
 	Error _parse_node(Node *p_owner, Node *p_node, int p_parent_idx, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 	Error _parse_connections(Node *p_owner, Node *p_node, HashMap<StringName, int> &name_map, HashMap<Variant, int, VariantHasher, VariantComparator> &variant_map, HashMap<Node *, int> &node_map, HashMap<Node *, int> &nodepath_map);
 
@@ -147,6 +167,7 @@ public:
 
 	bool can_instantiate() const;
 	Node *instantiate(GenEditState p_edit_state) const;
+	bool reset_instance(Node *p_root) const;
 
 	Ref<SceneState> get_base_scene_state() const;
 
@@ -212,6 +233,16 @@ class PackedScene : public Resource {
 
 	Ref<SceneState> state;
 
+	// Instances given back through recycle_instance(), already reset to their packed state.
+	mutable Mutex pool_mutex;
+	mutable LocalVector<Node *> pool;
+	mutable HashSet<ObjectID> pool_instances; // Roots created by instantiate_pooled(), only those can be recycled.
+	mutable uint32_t pool_instances_prune_size = 64;
+	mutable int pool_node_count = -1;
+	mutable uint64_t pool_hits = 0;
+	mutable uint64_t pool_misses = 0;
+	int pool_capacity = 0;
+
 	void _set_bundled_scene(const Dictionary &p_scene);
 	Dictionary _get_bundled_scene() const;
 
@@ -235,6 +266,16 @@ public:
 	bool can_instantiate() const;
 	Node *instantiate(GenEditState p_edit_state = GEN_EDIT_STATE_DISABLED) const;
 
+	Node *instantiate_pooled() const;
+	bool recycle_instance(Node *p_instance);
+
+	void set_pool_capacity(int p_capacity);
+	int get_pool_capacity() const;
+	int get_pooled_instance_count() const;
+	uint64_t get_pool_hit_count() const;
+	uint64_t get_pool_miss_count() const;
+	void clear_pool();
+
 	void recreate_state();
 	void replace_state(Ref<SceneState> p_by);
 
@@ -250,6 +291,7 @@ public:
 	Ref<SceneState> get_state() const;
 
 	PackedScene();
+	~PackedScene();
 };
 
 VARIANT_ENUM_CAST(PackedScene::GenEditState)
@@ -55,6 +55,11 @@ Size2 Texture2D::get_size() const {
 	return Size2(get_width(), get_height());
 }
 
+uint64_t Texture2D::get_memory_usage_estimate() const {
+	// Assumes uncompressed RGBA8 without mipmaps, as the actual format is not known here.
+	return (uint64_t)get_width() * get_height() * 4;
+}
+
 bool Texture2D::is_pixel_opaque(int p_x, int p_y) const {
 	bool ret = true;
 	GDVIRTUAL_CALL(_is_pixel_opaque, p_x, p_y, ret);
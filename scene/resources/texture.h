@@ -84,6 +84,8 @@ public:
 
 	virtual Ref<Resource> create_placeholder() const;
 
+	virtual uint64_t get_memory_usage_estimate() const override;
+
 	Texture2D();
 };
 
@@ -160,6 +160,13 @@ void PhysicsServer2DExtension::_bind_methods() {
 	GDVIRTUAL_BIND(_space_get_contacts, "space");
 	GDVIRTUAL_BIND(_space_get_contact_count, "space");
 
+	GDVIRTUAL_BIND(_space_save_snapshot, "space");
+	GDVIRTUAL_BIND(_space_restore_snapshot, "space", "snapshot");
+
+	GDVIRTUAL_BIND(_space_set_deterministic, "space", "deterministic");
+	GDVIRTUAL_BIND(_space_is_deterministic, "space");
+	GDVIRTUAL_BIND(_space_get_state_checksum, "space");
+
 	/* AREA API */
 
 	GDVIRTUAL_BIND(_area_create);
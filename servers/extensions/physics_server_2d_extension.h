@@ -237,6 +237,13 @@ public:
 	EXBIND1RC(Vector<Vector2>, space_get_contacts, RID)
 	EXBIND1RC(int, space_get_contact_count, RID)
 
+	EXBIND1R(Vector<uint8_t>, space_save_snapshot, RID)
+	EXBIND2R(bool, space_restore_snapshot, RID, const Vector<uint8_t> &)
+
+	EXBIND2(space_set_deterministic, RID, bool)
+	EXBIND1RC(bool, space_is_deterministic, RID)
+	EXBIND1RC(uint32_t, space_get_state_checksum, RID)
+
 	/* AREA API */
 
 	//EXBIND0RID(area);
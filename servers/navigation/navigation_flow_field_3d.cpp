@@ -0,0 +1,204 @@
+/**************************************************************************/
+/*  navigation_flow_field_3d.cpp                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "navigation_flow_field_3d.h"
+
+#include "core/math/face3.h"
+
+void NavigationFlowField3D::set_destination(const Vector3 &p_destination) {
+	destination = p_destination;
+}
+
+Vector3 NavigationFlowField3D::get_destination() const {
+	return destination;
+}
+
+void NavigationFlowField3D::set_up(const Vector3 &p_up) {
+	up = p_up.normalized();
+}
+
+void NavigationFlowField3D::set_arrival_distance(real_t p_arrival_distance) {
+	arrival_distance = p_arrival_distance;
+}
+
+int NavigationFlowField3D::get_polygon_count() const {
+	return polygon_targets.size();
+}
+
+void NavigationFlowField3D::add_polygon(const Vector3 *p_points, uint32_t p_point_count, const Vector3 &p_target, int32_t p_next_polygon, float p_cost, float p_travel_cost) {
+	if (polygon_point_begin.is_empty()) {
+		polygon_point_begin.push_back(0);
+	}
+	for (uint32_t i = 0; i < p_point_count; i++) {
+		points.push_back(p_points[i]);
+	}
+	polygon_point_begin.push_back(points.size());
+	polygon_targets.push_back(p_target);
+	polygon_next.push_back(p_next_polygon);
+	polygon_costs.push_back(p_cost);
+	polygon_travel_costs.push_back(p_travel_cost);
+}
+
+Vector2i NavigationFlowField3D::_get_grid_cell(const Vector2 &p_point) const {
+	const Vector2 cell = ((p_point - grid_origin) / grid_cell_size).floor();
+	return Vector2i(CLAMP((int)cell.x, 0, grid_size.x - 1), CLAMP((int)cell.y, 0, grid_size.y - 1));
+}
+
+void NavigationFlowField3D::build_lookup(uint32_t p_polygon_count) {
+	ERR_FAIL_COND(p_polygon_count > polygon_targets.size());
+
+	grid_cell_begin.clear();
+	grid_polygons.clear();
+	if (p_polygon_count == 0) {
+		return;
+	}
+
+	grid_axis_u = ABS(up.x) < 0.9 ? up.cross(Vector3(1, 0, 0)).normalized() : up.cross(Vector3(0, 0, 1)).normalized();
+	grid_axis_v = up.cross(grid_axis_u);
+
+	// Bounds of the polygons, projected on the grid plane.
+	LocalVector<Rect2> polygon_bounds;
+	polygon_bounds.resize(p_polygon_count);
+	Rect2 bounds;
+	for (uint32_t polygon = 0; polygon < p_polygon_count; polygon++) {
+		Rect2 polygon_rect(_project(points[polygon_point_begin[polygon]]), Vector2());
+		for (uint32_t point = polygon_point_begin[polygon] + 1; point < polygon_point_begin[polygon + 1]; point++) {
+			polygon_rect.expand_to(_project(points[point]));
+		}
+		polygon_bounds[polygon] = polygon_rect;
+		bounds = polygon == 0 ? polygon_rect : bounds.merge(polygon_rect);
+	}
+
+	// About one polygon per cell, and no more cells than polygons along the longest side.
+	grid_origin = bounds.position;
+	grid_cell_size = MAX(Math::sqrt(bounds.get_area() / p_polygon_count), MAX(bounds.size.x, bounds.size.y) / p_polygon_count);
+	if (grid_cell_size <= CMP_EPSILON) {
+		grid_cell_size = 1.0;
+	}
+	grid_size = Vector2i(bounds.size.x / grid_cell_size + 1, bounds.size.y / grid_cell_size + 1);
+
+	// Count the polygons of each cell, then store them cell by cell.
+	const uint32_t cell_count = grid_size.x * grid_size.y;
+	grid_cell_begin.resize(cell_count + 1);
+	memset(grid_cell_begin.ptr(), 0, grid_cell_begin.size() * sizeof(uint32_t));
+	for (uint32_t polygon = 0; polygon < p_polygon_count; polygon++) {
+		const Vector2i from = _get_grid_cell(polygon_bounds[polygon].position);
+		const Vector2i to = _get_grid_cell(polygon_bounds[polygon].get_end());
+		for (int y = from.y; y <= to.y; y++) {
+			for (int x = from.x; x <= to.x; x++) {
+				grid_cell_begin[y * grid_size.x + x + 1]++;
+			}
+		}
+	}
+	for (uint32_t cell = 0; cell < cell_count; cell++) {
+		grid_cell_begin[cell + 1] += grid_cell_begin[cell];
+	}
+
+	grid_polygons.resize(grid_cell_begin[cell_count]);
+	LocalVector<uint32_t> cell_fill;
+	cell_fill.resize(cell_count);
+	memcpy(cell_fill.ptr(), grid_cell_begin.ptr(), cell_count * sizeof(uint32_t));
+	for (uint32_t polygon = 0; polygon < p_polygon_count; polygon++) {
+		const Vector2i from = _get_grid_cell(polygon_bounds[polygon].position);
+		const Vector2i to = _get_grid_cell(polygon_bounds[polygon].get_end());
+		for (int y = from.y; y <= to.y; y++) {
+			for (int x = from.x; x <= to.x; x++) {
+				grid_polygons[cell_fill[y * grid_size.x + x]++] = polygon;
+			}
+		}
+	}
+}
+
+int32_t NavigationFlowField3D::_find_polygon(const Vector3 &p_position) const {
+	if (grid_cell_begin.is_empty()) {
+		return -1;
+	}
+
+	// Positions off the mesh use the polygons of the nearest cell.
+	const Vector2i cell = _get_grid_cell(_project(p_position));
+	const uint32_t cell_index = cell.y * grid_size.x + cell.x;
+
+	int32_t closest_polygon = -1;
+	real_t closest_distance = 1e20;
+	for (uint32_t i = grid_cell_begin[cell_index]; i < grid_cell_begin[cell_index + 1]; i++) {
+		const uint32_t polygon = grid_polygons[i];
+		const uint32_t point_begin = polygon_point_begin[polygon];
+		for (uint32_t point = point_begin + 2; point < polygon_point_begin[polygon + 1]; point++) {
+			const Face3 face(points[point_begin], points[point - 1], points[point]);
+			const real_t distance = face.get_closest_point_to(p_position).distance_squared_to(p_position);
+			if (distance < closest_distance) {
+				closest_distance = distance;
+				closest_polygon = polygon;
+			}
+		}
+	}
+	return closest_polygon;
+}
+
+bool NavigationFlowField3D::is_reachable(const Vector3 &p_position) const {
+	const int32_t polygon = _find_polygon(p_position);
+	return polygon != -1 && polygon_costs[polygon] >= 0.0;
+}
+
+Vector3 NavigationFlowField3D::get_next_position(const Vector3 &p_position) const {
+	const int32_t polygon = _find_polygon(p_position);
+	if (polygon == -1 || polygon_costs[polygon] < 0.0) {
+		return p_position;
+	}
+
+	// Once on the way out of its polygon, the agent follows the next one, e.g. along a link.
+	int32_t next_polygon = polygon;
+	while (polygon_next[next_polygon] != -1 && p_position.distance_to(polygon_targets[next_polygon]) <= arrival_distance) {
+		next_polygon = polygon_next[next_polygon];
+	}
+	return polygon_targets[next_polygon];
+}
+
+Vector3 NavigationFlowField3D::get_direction(const Vector3 &p_position) const {
+	return (get_next_position(p_position) - p_position).normalized();
+}
+
+real_t NavigationFlowField3D::get_travel_cost(const Vector3 &p_position) const {
+	const int32_t polygon = _find_polygon(p_position);
+	if (polygon == -1 || polygon_costs[polygon] < 0.0) {
+		return -1.0;
+	}
+	return polygon_costs[polygon] + p_position.distance_to(polygon_targets[polygon]) * polygon_travel_costs[polygon];
+}
+
+void NavigationFlowField3D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("get_destination"), &NavigationFlowField3D::get_destination);
+	ClassDB::bind_method(D_METHOD("get_polygon_count"), &NavigationFlowField3D::get_polygon_count);
+
+	ClassDB::bind_method(D_METHOD("is_reachable", "position"), &NavigationFlowField3D::is_reachable);
+	ClassDB::bind_method(D_METHOD("get_next_position", "position"), &NavigationFlowField3D::get_next_position);
+	ClassDB::bind_method(D_METHOD("get_direction", "position"), &NavigationFlowField3D::get_direction);
+	ClassDB::bind_method(D_METHOD("get_travel_cost", "position"), &NavigationFlowField3D::get_travel_cost);
+}
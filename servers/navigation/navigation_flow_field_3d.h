@@ -0,0 +1,95 @@
+/**************************************************************************/
+/*  navigation_flow_field_3d.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef NAVIGATION_FLOW_FIELD_3D_H
+#define NAVIGATION_FLOW_FIELD_3D_H
+
+#include "core/math/vector2.h"
+#include "core/math/vector2i.h"
+#include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
+
+/// Directions toward a single destination for every polygon of a navigation map.
+/// Built once by the navigation server, then sampled by any number of agents.
+class NavigationFlowField3D : public RefCounted {
+	GDCLASS(NavigationFlowField3D, RefCounted);
+
+	Vector3 destination;
+	Vector3 up = Vector3(0, 1, 0);
+	real_t arrival_distance = 0.25;
+
+	/// Polygon `i` owns the points from `polygon_point_begin[i]` to `polygon_point_begin[i + 1]`.
+	LocalVector<Vector3> points;
+	LocalVector<uint32_t> polygon_point_begin;
+
+	/// Where agents on each polygon head to, the polygon they reach there, and the cost
+	/// left from there to the destination, negative when the destination can't be reached.
+	LocalVector<Vector3> polygon_targets;
+	LocalVector<int32_t> polygon_next;
+	LocalVector<float> polygon_costs;
+	LocalVector<float> polygon_travel_costs;
+
+	/// Uniform grid on the plane perpendicular to `up`, listing the polygons overlapping each cell.
+	Vector3 grid_axis_u;
+	Vector3 grid_axis_v;
+	Vector2 grid_origin;
+	real_t grid_cell_size = 1.0;
+	Vector2i grid_size;
+	LocalVector<uint32_t> grid_cell_begin;
+	LocalVector<uint32_t> grid_polygons;
+
+	_FORCE_INLINE_ Vector2 _project(const Vector3 &p_point) const {
+		return Vector2(grid_axis_u.dot(p_point), grid_axis_v.dot(p_point));
+	}
+	Vector2i _get_grid_cell(const Vector2 &p_point) const;
+	int32_t _find_polygon(const Vector3 &p_position) const;
+
+protected:
+	static void _bind_methods();
+
+public:
+	/// Used by the navigation server to fill the field, polygons are added in map order.
+	void set_destination(const Vector3 &p_destination);
+	void set_up(const Vector3 &p_up);
+	void set_arrival_distance(real_t p_arrival_distance);
+	void add_polygon(const Vector3 *p_points, uint32_t p_point_count, const Vector3 &p_target, int32_t p_next_polygon, float p_cost, float p_travel_cost);
+	/// Indexes the first `p_polygon_count` polygons, the ones agents can stand on.
+	void build_lookup(uint32_t p_polygon_count);
+
+	Vector3 get_destination() const;
+	int get_polygon_count() const;
+
+	bool is_reachable(const Vector3 &p_position) const;
+	Vector3 get_next_position(const Vector3 &p_position) const;
+	Vector3 get_direction(const Vector3 &p_position) const;
+	real_t get_travel_cost(const Vector3 &p_position) const;
+};
+
+#endif // NAVIGATION_FLOW_FIELD_3D_H
@@ -37,6 +37,7 @@
 #include "scene/resources/navigation_polygon.h"
 #include "servers/navigation/navigation_path_query_parameters_2d.h"
 #include "servers/navigation/navigation_path_query_result_2d.h"
+#include "servers/navigation_server_3d.h"
 
 // This server exposes the `NavigationServer3D` features in the 2D world.
 class NavigationServer2D : public Object {
@@ -82,6 +83,12 @@ public:
 	/// Returns the link connection radius of this map.
 	virtual real_t map_get_link_connection_radius(RID p_map) const;
 
+	/// Set the structure used to find the neighbors of the avoidance agents.
+	virtual void map_set_avoidance_backend(RID p_map, NavigationServer3D::AvoidanceBackend p_backend);
+
+	/// Returns the avoidance backend of this map.
+	virtual NavigationServer3D::AvoidanceBackend map_get_avoidance_backend(RID p_map) const;
+
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector2> map_get_path(RID p_map, Vector2 p_origin, Vector2 p_destination, bool p_optimize, uint32_t p_navigation_layers = 1) const;
 
@@ -47,11 +47,14 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_get_edge_connection_margin", "map"), &NavigationServer3D::map_get_edge_connection_margin);
 	ClassDB::bind_method(D_METHOD("map_set_link_connection_radius", "map", "radius"), &NavigationServer3D::map_set_link_connection_radius);
 	ClassDB::bind_method(D_METHOD("map_get_link_connection_radius", "map"), &NavigationServer3D::map_get_link_connection_radius);
+	ClassDB::bind_method(D_METHOD("map_set_avoidance_backend", "map", "backend"), &NavigationServer3D::map_set_avoidance_backend);
+	ClassDB::bind_method(D_METHOD("map_get_avoidance_backend", "map"), &NavigationServer3D::map_get_avoidance_backend);
 	ClassDB::bind_method(D_METHOD("map_get_path", "map", "origin", "destination", "optimize", "navigation_layers"), &NavigationServer3D::map_get_path, DEFVAL(1));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_to_segment", "map", "start", "end", "use_collision"), &NavigationServer3D::map_get_closest_point_to_segment, DEFVAL(false));
 	ClassDB::bind_method(D_METHOD("map_get_closest_point", "map", "to_point"), &NavigationServer3D::map_get_closest_point);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_normal", "map", "to_point"), &NavigationServer3D::map_get_closest_point_normal);
 	ClassDB::bind_method(D_METHOD("map_get_closest_point_owner", "map", "to_point"), &NavigationServer3D::map_get_closest_point_owner);
+	ClassDB::bind_method(D_METHOD("map_get_flow_field", "map", "destination", "navigation_layers"), &NavigationServer3D::map_get_flow_field, DEFVAL(1));
 
 	ClassDB::bind_method(D_METHOD("map_get_links", "map"), &NavigationServer3D::map_get_links);
 	ClassDB::bind_method(D_METHOD("map_get_regions", "map"), &NavigationServer3D::map_get_regions);
@@ -60,6 +63,9 @@ void NavigationServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("map_force_update", "map"), &NavigationServer3D::map_force_update);
 
 	ClassDB::bind_method(D_METHOD("query_path", "parameters", "result"), &NavigationServer3D::query_path);
+	ClassDB::bind_method(D_METHOD("query_paths_async", "parameters", "callback"), &NavigationServer3D::query_paths_async);
+	ClassDB::bind_method(D_METHOD("set_path_query_time_budget", "time_budget_msec"), &NavigationServer3D::set_path_query_time_budget);
+	ClassDB::bind_method(D_METHOD("get_path_query_time_budget"), &NavigationServer3D::get_path_query_time_budget);
 
 	ClassDB::bind_method(D_METHOD("region_create"), &NavigationServer3D::region_create);
 	ClassDB::bind_method(D_METHOD("region_set_enter_cost", "region", "enter_cost"), &NavigationServer3D::region_set_enter_cost);
@@ -125,6 +131,10 @@ void NavigationServer3D::_bind_methods() {
 
 	ClassDB::bind_method(D_METHOD("get_process_info", "process_info"), &NavigationServer3D::get_process_info);
 
+	BIND_ENUM_CONSTANT(AVOIDANCE_BACKEND_KD_TREE);
+	BIND_ENUM_CONSTANT(AVOIDANCE_BACKEND_SPATIAL_HASH);
+	BIND_ENUM_CONSTANT(AVOIDANCE_BACKEND_MAX);
+
 	BIND_ENUM_CONSTANT(INFO_ACTIVE_MAPS);
 	BIND_ENUM_CONSTANT(INFO_REGION_COUNT);
 	BIND_ENUM_CONSTANT(INFO_AGENT_COUNT);
@@ -598,6 +608,44 @@ void NavigationServer3D::query_path(const Ref<NavigationPathQueryParameters3D> &
 	p_query_result->set_path_owner_ids(_query_result.path_owner_ids);
 }
 
+void NavigationServer3D::query_paths_async(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const Callable &p_callback) {
+	ERR_FAIL_COND(!p_callback.is_valid());
+
+	Vector<NavigationUtilities::PathQueryParameters> parameters;
+	parameters.resize(p_query_parameters.size());
+	NavigationUtilities::PathQueryParameters *parameters_ptrw = parameters.ptrw();
+	for (int i = 0; i < p_query_parameters.size(); i++) {
+		const Ref<NavigationPathQueryParameters3D> query_parameters = p_query_parameters[i];
+		ERR_FAIL_COND_MSG(!query_parameters.is_valid(), vformat("Invalid path query parameters at index %d.", i));
+		parameters_ptrw[i] = query_parameters->get_parameters();
+	}
+
+	_query_paths_async(parameters, p_callback);
+}
+
+void NavigationServer3D::_dispatch_path_query_results(const Callable &p_callback, const LocalVector<NavigationUtilities::PathQueryResult> &p_results) const {
+	TypedArray<NavigationPathQueryResult3D> results;
+	results.resize(p_results.size());
+	for (uint32_t i = 0; i < p_results.size(); i++) {
+		Ref<NavigationPathQueryResult3D> query_result;
+		query_result.instantiate();
+		query_result->set_path(p_results[i].path);
+		query_result->set_path_types(p_results[i].path_types);
+		query_result->set_path_rids(p_results[i].path_rids);
+		query_result->set_path_owner_ids(p_results[i].path_owner_ids);
+		results[i] = query_result;
+	}
+
+	Variant results_variant = results;
+	const Variant *args[1] = { &results_variant };
+	Variant return_value;
+	Callable::CallError call_error;
+	p_callback.callp(args, 1, return_value, call_error);
+	if (call_error.error != Callable::CallError::CALL_OK) {
+		ERR_PRINT("Error calling path query callback: " + Variant::get_callable_error_text(p_callback, args, 1, call_error));
+	}
+}
+
 ///////////////////////////////////////////////////////
 
 NavigationServer3DCallback NavigationServer3DManager::create_callback = nullptr;
@@ -32,9 +32,11 @@
 #define NAVIGATION_SERVER_3D_H
 
 #include "core/object/class_db.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
 
 #include "scene/3d/navigation_region_3d.h"
+#include "servers/navigation/navigation_flow_field_3d.h"
 #include "servers/navigation/navigation_path_query_parameters_3d.h"
 #include "servers/navigation/navigation_path_query_result_3d.h"
 
@@ -53,10 +55,18 @@ class NavigationServer3D : public Object {
 protected:
 	static void _bind_methods();
 
+	void _dispatch_path_query_results(const Callable &p_callback, const LocalVector<NavigationUtilities::PathQueryResult> &p_results) const;
+
 public:
 	/// Thread safe, can be used across many threads.
 	static NavigationServer3D *get_singleton();
 
+	enum AvoidanceBackend {
+		AVOIDANCE_BACKEND_KD_TREE,
+		AVOIDANCE_BACKEND_SPATIAL_HASH,
+		AVOIDANCE_BACKEND_MAX,
+	};
+
 	virtual TypedArray<RID> get_maps() const = 0;
 
 	/// Create a new map.
@@ -92,6 +102,12 @@ public:
 	/// Returns the link connection radius of this map.
 	virtual real_t map_get_link_connection_radius(RID p_map) const = 0;
 
+	/// Set the structure used to find the neighbors of the avoidance agents.
+	virtual void map_set_avoidance_backend(RID p_map, AvoidanceBackend p_backend) = 0;
+
+	/// Returns the avoidance backend of this map.
+	virtual AvoidanceBackend map_get_avoidance_backend(RID p_map) const = 0;
+
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers = 1) const = 0;
 
@@ -100,6 +116,9 @@ public:
 	virtual Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const = 0;
 	virtual RID map_get_closest_point_owner(RID p_map, const Vector3 &p_point) const = 0;
 
+	/// Returns the directions toward the destination from every polygon of the map.
+	virtual Ref<NavigationFlowField3D> map_get_flow_field(RID p_map, const Vector3 &p_destination, uint32_t p_navigation_layers = 1) const = 0;
+
 	virtual TypedArray<RID> map_get_links(RID p_map) const = 0;
 	virtual TypedArray<RID> map_get_regions(RID p_map) const = 0;
 	virtual TypedArray<RID> map_get_agents(RID p_map) const = 0;
@@ -257,6 +276,16 @@ public:
 
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const = 0;
 
+	/// Queues a batch of path queries that are solved on worker threads during `process`.
+	/// The callback is called on the main thread with the results, in query order, once the whole batch is solved.
+	void query_paths_async(const TypedArray<NavigationPathQueryParameters3D> &p_query_parameters, const Callable &p_callback);
+
+	virtual void _query_paths_async(const Vector<NavigationUtilities::PathQueryParameters> &p_parameters, const Callable &p_callback) = 0;
+
+	/// Maximum time spent each `process` on queued path queries, in milliseconds. Zero or less means unlimited.
+	virtual void set_path_query_time_budget(real_t p_time_budget_msec) = 0;
+	virtual real_t get_path_query_time_budget() const = 0;
+
 	NavigationServer3D();
 	~NavigationServer3D() override;
 
@@ -395,6 +424,7 @@ public:
 	static NavigationServer3D *new_default_server();
 };
 
+VARIANT_ENUM_CAST(NavigationServer3D::AvoidanceBackend);
 VARIANT_ENUM_CAST(NavigationServer3D::ProcessInfo);
 
 #endif // NAVIGATION_SERVER_3D_H
@@ -49,11 +49,14 @@ public:
 	real_t map_get_edge_connection_margin(RID p_map) const override { return 0; }
 	void map_set_link_connection_radius(RID p_map, real_t p_connection_radius) override {}
 	real_t map_get_link_connection_radius(RID p_map) const override { return 0; }
+	void map_set_avoidance_backend(RID p_map, AvoidanceBackend p_backend) override {}
+	AvoidanceBackend map_get_avoidance_backend(RID p_map) const override { return AVOIDANCE_BACKEND_KD_TREE; }
 	Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers) const override { return Vector<Vector3>(); }
 	Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const override { return Vector3(); }
 	Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const override { return Vector3(); }
 	Vector3 map_get_closest_point_normal(RID p_map, const Vector3 &p_point) const override { return Vector3(); }
 	RID map_get_closest_point_owner(RID p_map, const Vector3 &p_point) const override { return RID(); }
+	Ref<NavigationFlowField3D> map_get_flow_field(RID p_map, const Vector3 &p_destination, uint32_t p_navigation_layers) const override { return Ref<NavigationFlowField3D>(); }
 	TypedArray<RID> map_get_links(RID p_map) const override { return TypedArray<RID>(); }
 	TypedArray<RID> map_get_regions(RID p_map) const override { return TypedArray<RID>(); }
 	TypedArray<RID> map_get_agents(RID p_map) const override { return TypedArray<RID>(); }
@@ -111,6 +114,9 @@ public:
 	void set_active(bool p_active) override {}
 	void process(real_t delta_time) override {}
 	NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const override { return NavigationUtilities::PathQueryResult(); }
+	void _query_paths_async(const Vector<NavigationUtilities::PathQueryParameters> &p_parameters, const Callable &p_callback) override {}
+	void set_path_query_time_budget(real_t p_time_budget_msec) override {}
+	real_t get_path_query_time_budget() const override { return 0; }
 	int get_process_info(ProcessInfo p_info) const override { return 0; }
 	void set_debug_enabled(bool p_enabled) {}
 	bool get_debug_enabled() const { return false; }
@@ -640,6 +640,15 @@ void GodotBody2D::integrate_velocities(real_t p_step) {
 		pos += center_of_mass - center_of_mass.rotated(angle_delta);
 	}
 
+	if (get_space()->is_deterministic() && get_space()->get_deterministic_quantum() > 0) {
+		// Round the state to a fixed-point grid, so rounding differences below it don't accumulate between runs.
+		real_t quantum = get_space()->get_deterministic_quantum();
+		angle = Math::snapped(angle, quantum);
+		pos = pos.snapped(Vector2(quantum, quantum));
+		linear_velocity = linear_velocity.snapped(Vector2(quantum, quantum));
+		angular_velocity = Math::snapped(angular_velocity, quantum);
+	}
+
 	_set_transform(Transform2D(angle, pos), continuous_cd_mode == PhysicsServer2D::CCD_MODE_DISABLED);
 	_set_inv_transform(get_transform().inverse());
 
@@ -700,6 +709,31 @@ void GodotBody2D::call_queries() {
 	}
 }
 
+void GodotBody2D::save_snapshot_state(SnapshotState &r_state) const {
+	r_state.transform = get_transform();
+	r_state.new_transform = new_transform;
+	r_state.linear_velocity = linear_velocity;
+	r_state.angular_velocity = angular_velocity;
+	r_state.prev_linear_velocity = prev_linear_velocity;
+	r_state.prev_angular_velocity = prev_angular_velocity;
+	r_state.still_time = still_time;
+	r_state.active = active;
+}
+
+void GodotBody2D::load_snapshot_state(const SnapshotState &p_state) {
+	_set_transform(p_state.transform);
+	_set_inv_transform(p_state.transform.affine_inverse());
+	new_transform = p_state.new_transform;
+	linear_velocity = p_state.linear_velocity;
+	angular_velocity = p_state.angular_velocity;
+	prev_linear_velocity = p_state.prev_linear_velocity;
+	prev_angular_velocity = p_state.prev_angular_velocity;
+	still_time = p_state.still_time;
+	_update_transform_dependent();
+
+	set_active(p_state.active);
+}
+
 bool GodotBody2D::sleep_test(real_t p_step) {
 	if (mode == PhysicsServer2D::BODY_MODE_STATIC || mode == PhysicsServer2D::BODY_MODE_KINEMATIC) {
 		return true;
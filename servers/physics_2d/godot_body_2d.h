@@ -156,6 +156,21 @@ class GodotBody2D : public GodotCollisionObject2D {
 	friend class GodotPhysicsDirectBodyState2D; // i give up, too many functions to expose
 
 public:
+	// Simulation state saved in space snapshots, everything else is set by the user or recomputed each step.
+	struct SnapshotState {
+		Transform2D transform;
+		Transform2D new_transform;
+		Vector2 linear_velocity;
+		real_t angular_velocity = 0.0;
+		Vector2 prev_linear_velocity;
+		real_t prev_angular_velocity = 0.0;
+		real_t still_time = 0.0;
+		bool active = false;
+	};
+
+	void save_snapshot_state(SnapshotState &r_state) const;
+	void load_snapshot_state(const SnapshotState &p_state);
+
 	void set_state_sync_callback(const Callable &p_callable);
 	void set_force_integration_callback(const Callable &p_callable, const Variant &p_udata = Variant());
 
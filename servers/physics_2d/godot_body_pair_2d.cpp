@@ -587,6 +587,97 @@ void GodotBodyPair2D::solve(real_t p_step) {
 	}
 }
 
+// Fields are copied one by one, so no padding bytes end up in the snapshot.
+// Only for types without padding of their own.
+template <typename T>
+static _FORCE_INLINE_ void _save_cached_field(const T &p_value, uint8_t *&r_w) {
+	memcpy(r_w, &p_value, sizeof(T));
+	r_w += sizeof(T);
+}
+
+template <typename T>
+static _FORCE_INLINE_ void _load_cached_field(T &r_value, const uint8_t *&r_r) {
+	memcpy(&r_value, r_r, sizeof(T));
+	r_r += sizeof(T);
+}
+
+void GodotBodyPair2D::save_cached_state(uint8_t *r_buffer) const {
+	uint8_t *w = r_buffer;
+	_save_cached_field(sep_axis, w);
+	_save_cached_field(collided, w);
+	_save_cached_field(oneway_disabled, w);
+	_save_cached_field(contact_count, w);
+	for (int i = 0; i < MAX_CONTACTS; i++) {
+		// Unused slots are saved too, so the state always has the same size.
+		const Contact c = i < contact_count ? contacts[i] : Contact();
+		_save_cached_field(c.position, w);
+		_save_cached_field(c.normal, w);
+		_save_cached_field(c.local_A, w);
+		_save_cached_field(c.local_B, w);
+		_save_cached_field(c.acc_impulse, w);
+		_save_cached_field(c.acc_normal_impulse, w);
+		_save_cached_field(c.acc_tangent_impulse, w);
+		_save_cached_field(c.acc_bias_impulse, w);
+		_save_cached_field(c.acc_bias_impulse_center_of_mass, w);
+		_save_cached_field(c.mass_normal, w);
+		_save_cached_field(c.mass_tangent, w);
+		_save_cached_field(c.bias, w);
+		_save_cached_field(c.depth, w);
+		_save_cached_field(c.active, w);
+		_save_cached_field(c.used, w);
+		_save_cached_field(c.rA, w);
+		_save_cached_field(c.rB, w);
+		_save_cached_field(c.bounce, w);
+	}
+	DEV_ASSERT(w == r_buffer + CACHED_STATE_SIZE);
+}
+
+void GodotBodyPair2D::load_cached_state(const uint8_t *p_buffer) {
+	const uint8_t *r = p_buffer;
+	Vector2 state_sep_axis;
+	bool state_collided = false;
+	bool state_oneway_disabled = false;
+	int state_contact_count = 0;
+	_load_cached_field(state_sep_axis, r);
+	_load_cached_field(state_collided, r);
+	_load_cached_field(state_oneway_disabled, r);
+	_load_cached_field(state_contact_count, r);
+	ERR_FAIL_INDEX(state_contact_count, MAX_CONTACTS + 1);
+
+	sep_axis = state_sep_axis;
+	collided = state_collided;
+	oneway_disabled = state_oneway_disabled;
+	contact_count = state_contact_count;
+	for (int i = 0; i < contact_count; i++) {
+		Contact &c = contacts[i];
+		_load_cached_field(c.position, r);
+		_load_cached_field(c.normal, r);
+		_load_cached_field(c.local_A, r);
+		_load_cached_field(c.local_B, r);
+		_load_cached_field(c.acc_impulse, r);
+		_load_cached_field(c.acc_normal_impulse, r);
+		_load_cached_field(c.acc_tangent_impulse, r);
+		_load_cached_field(c.acc_bias_impulse, r);
+		_load_cached_field(c.acc_bias_impulse_center_of_mass, r);
+		_load_cached_field(c.mass_normal, r);
+		_load_cached_field(c.mass_tangent, r);
+		_load_cached_field(c.bias, r);
+		_load_cached_field(c.depth, r);
+		_load_cached_field(c.active, r);
+		_load_cached_field(c.used, r);
+		_load_cached_field(c.rA, r);
+		_load_cached_field(c.rB, r);
+		_load_cached_field(c.bounce, r);
+	}
+}
+
+void GodotBodyPair2D::clear_cached_state() {
+	sep_axis = Vector2();
+	collided = false;
+	oneway_disabled = false;
+	contact_count = 0;
+}
+
 GodotBodyPair2D::GodotBodyPair2D(GodotBody2D *p_A, int p_shape_A, GodotBody2D *p_B, int p_shape_B) :
 		GodotConstraint2D(_arr, 2) {
 	A = p_A;
@@ -84,12 +84,22 @@ class GodotBodyPair2D : public GodotConstraint2D {
 	bool oneway_disabled = false;
 	bool report_contacts_only = false;
 
+	// Cached state saved field by field: separating axis, collided, one way disabled, contact count, then every contact slot.
+	static constexpr uint32_t CONTACT_STATE_SIZE = sizeof(Vector2) * 7 + sizeof(real_t) * 9 + sizeof(bool) * 2;
+	static constexpr uint32_t CACHED_STATE_SIZE = sizeof(Vector2) + sizeof(bool) * 2 + sizeof(int) + CONTACT_STATE_SIZE * MAX_CONTACTS;
+
 	bool _test_ccd(real_t p_step, GodotBody2D *p_A, int p_shape_A, const Transform2D &p_xform_A, GodotBody2D *p_B, int p_shape_B, const Transform2D &p_xform_B);
 	void _validate_contacts();
 	static void _add_contact(const Vector2 &p_point_A, const Vector2 &p_point_B, void *p_self);
 	_FORCE_INLINE_ void _contact_added_callback(const Vector2 &p_point_A, const Vector2 &p_point_B);
 
 public:
+	virtual uint64_t get_order_key() const override { return ((uint64_t)shape_A << 32) | (uint32_t)shape_B; }
+	virtual uint32_t get_cached_state_size() const override { return CACHED_STATE_SIZE; }
+	virtual void save_cached_state(uint8_t *r_buffer) const override;
+	virtual void load_cached_state(const uint8_t *p_buffer) override;
+	virtual void clear_cached_state() override;
+
 	virtual bool setup(real_t p_step) override;
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
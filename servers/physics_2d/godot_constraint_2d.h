@@ -60,6 +60,15 @@ public:
 	_FORCE_INLINE_ void disable_collisions_between_bodies(const bool p_disabled) { disabled_collisions_between_bodies = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled_collisions_between_bodies() const { return disabled_collisions_between_bodies; }
 
+	// Orders constraints between the same bodies, so deterministic spaces solve them in the same order on every run.
+	virtual uint64_t get_order_key() const { return self.get_id(); }
+
+	// Solver state kept between steps (e.g. contacts for warm starting), saved in space snapshots.
+	virtual uint32_t get_cached_state_size() const { return 0; }
+	virtual void save_cached_state(uint8_t *r_buffer) const {}
+	virtual void load_cached_state(const uint8_t *p_buffer) {}
+	virtual void clear_cached_state() {}
+
 	virtual bool setup(real_t p_step) = 0;
 	virtual bool pre_solve(real_t p_step) = 0;
 	virtual void solve(real_t p_step) = 0;
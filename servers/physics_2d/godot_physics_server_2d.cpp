@@ -276,6 +276,39 @@ int GodotPhysicsServer2D::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+Vector<uint8_t> GodotPhysicsServer2D::space_save_snapshot(RID p_space) {
+	GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, Vector<uint8_t>());
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), Vector<uint8_t>(), "Space state is inaccessible right now, wait for iteration or physics process notification.");
+	return space->save_snapshot();
+}
+
+bool GodotPhysicsServer2D::space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+	GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, false);
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), false, "Space state is inaccessible right now, wait for iteration or physics process notification.");
+	return space->load_snapshot(p_snapshot);
+}
+
+void GodotPhysicsServer2D::space_set_deterministic(RID p_space, bool p_deterministic) {
+	GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND(!space);
+	space->set_deterministic(p_deterministic);
+}
+
+bool GodotPhysicsServer2D::space_is_deterministic(RID p_space) const {
+	const GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, false);
+	return space->is_deterministic();
+}
+
+uint32_t GodotPhysicsServer2D::space_get_state_checksum(RID p_space) const {
+	const GodotSpace2D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, 0);
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), 0, "Space state is inaccessible right now, wait for iteration or physics process notification.");
+	return space->get_state_checksum();
+}
+
 PhysicsDirectSpaceState2D *GodotPhysicsServer2D::space_get_direct_state(RID p_space) {
 	GodotSpace2D *space = space_owner.get_or_null(p_space);
 	ERR_FAIL_COND_V(!space, nullptr);
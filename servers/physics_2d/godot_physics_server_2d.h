@@ -116,6 +116,13 @@ public:
 	virtual Vector<Vector2> space_get_contacts(RID p_space) const override;
 	virtual int space_get_contact_count(RID p_space) const override;
 
+	virtual Vector<uint8_t> space_save_snapshot(RID p_space) override;
+	virtual bool space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) override;
+
+	virtual void space_set_deterministic(RID p_space, bool p_deterministic) override;
+	virtual bool space_is_deterministic(RID p_space) const override;
+	virtual uint32_t space_get_state_checksum(RID p_space) const override;
+
 	// this function only works on physics process, errors and returns null otherwise
 	virtual PhysicsDirectSpaceState2D *space_get_direct_state(RID p_space) override;
 
@@ -33,9 +33,12 @@
 #include "godot_collision_solver_2d.h"
 #include "godot_physics_server_2d.h"
 
+#include "core/io/marshalls.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
 #include "core/templates/pair.h"
 
+#define QUERY_BATCH_MIN_TASK_SIZE 64
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
 
@@ -117,13 +120,20 @@ int GodotPhysicsDirectSpaceState2D::intersect_point(const PointParameters &p_par
 bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
 	ERR_FAIL_COND_V(space->locked, false);
 
+	QueryScratch scratch;
+	scratch.results = space->intersection_query_results;
+	scratch.subindex_results = space->intersection_query_subindex_results;
+	return _intersect_ray(p_parameters, p_parameters.from, p_parameters.to, r_result, scratch);
+}
+
+bool GodotPhysicsDirectSpaceState2D::_intersect_ray(const RayParameters &p_parameters, const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, QueryScratch &r_scratch) {
 	Vector2 begin, end;
 	Vector2 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = _cull_segment(begin, end, r_scratch);
 
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
@@ -134,17 +144,17 @@ bool GodotPhysicsDirectSpaceState2D::intersect_ray(const RayParameters &p_parame
 	real_t min_d = 1e10;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_scratch.results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_scratch.results[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject2D *col_obj = r_scratch.results[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = r_scratch.subindex_results[i];
 		Transform2D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector2 local_from = inv_xform.xform(begin);
@@ -257,39 +267,46 @@ bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parame
 	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
 	ERR_FAIL_COND_V(!shape, false);
 
-	Rect2 aabb = p_parameters.transform.xform(shape->get_aabb());
-	aabb = aabb.merge(Rect2(aabb.position + p_parameters.motion, aabb.size)); //motion
+	QueryScratch scratch;
+	scratch.results = space->intersection_query_results;
+	scratch.subindex_results = space->intersection_query_subindex_results;
+	return _cast_motion(p_parameters, shape, p_parameters.transform, p_parameters.motion, p_closest_safe, p_closest_unsafe, scratch);
+}
+
+bool GodotPhysicsDirectSpaceState2D::_cast_motion(const ShapeParameters &p_parameters, GodotShape2D *p_shape, const Transform2D &p_transform, const Vector2 &p_motion, real_t &p_closest_safe, real_t &p_closest_unsafe, QueryScratch &r_scratch) {
+	Rect2 aabb = p_transform.xform(p_shape->get_aabb());
+	aabb = aabb.merge(Rect2(aabb.position + p_motion, aabb.size)); //motion
 	aabb = aabb.grow(p_parameters.margin);
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace2D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = _cull_aabb(aabb, r_scratch);
 
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_scratch.results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_scratch.results[i]->get_self())) {
 			continue; //ignore excluded
 		}
 
-		const GodotCollisionObject2D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject2D *col_obj = r_scratch.results[i];
+		int shape_idx = r_scratch.subindex_results[i];
 
 		Transform2D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (!GodotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (!GodotCollisionSolver2D::solve(p_shape, p_transform, p_motion, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
 		//test initial overlap, ignore objects it's inside of.
-		if (GodotCollisionSolver2D::solve(shape, p_parameters.transform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
+		if (GodotCollisionSolver2D::solve(p_shape, p_transform, Vector2(), col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, nullptr, p_parameters.margin)) {
 			continue;
 		}
 
-		Vector2 mnormal = p_parameters.motion.normalized();
+		Vector2 mnormal = p_motion.normalized();
 
 		//just do kinematic solving
 		real_t low = 0.0;
@@ -299,7 +316,7 @@ bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parame
 			real_t fraction = low + (hi - low) * fraction_coeff;
 
 			Vector2 sep = mnormal; //important optimization for this to work fast enough
-			bool collided = GodotCollisionSolver2D::solve(shape, p_parameters.transform, p_parameters.motion * fraction, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, &sep, p_parameters.margin);
+			bool collided = GodotCollisionSolver2D::solve(p_shape, p_transform, p_motion * fraction, col_obj->get_shape(shape_idx), col_obj_xform, Vector2(), nullptr, nullptr, &sep, p_parameters.margin);
 
 			if (collided) {
 				hi = fraction;
@@ -336,6 +353,118 @@ bool GodotPhysicsDirectSpaceState2D::cast_motion(const ShapeParameters &p_parame
 	return true;
 }
 
+int GodotPhysicsDirectSpaceState2D::_cull_segment(const Vector2 &p_from, const Vector2 &p_to, QueryScratch &r_scratch) {
+	if (r_scratch.hits) {
+		return space->broadphase->cull_segment_concurrent(p_from, p_to, *r_scratch.hits, r_scratch.results, GodotSpace2D::INTERSECTION_QUERY_MAX, r_scratch.subindex_results);
+	}
+	return space->broadphase->cull_segment(p_from, p_to, r_scratch.results, GodotSpace2D::INTERSECTION_QUERY_MAX, r_scratch.subindex_results);
+}
+
+int GodotPhysicsDirectSpaceState2D::_cull_aabb(const Rect2 &p_aabb, QueryScratch &r_scratch) {
+	if (r_scratch.hits) {
+		return space->broadphase->cull_aabb_concurrent(p_aabb, *r_scratch.hits, r_scratch.results, GodotSpace2D::INTERSECTION_QUERY_MAX, r_scratch.subindex_results);
+	}
+	return space->broadphase->cull_aabb(p_aabb, r_scratch.results, GodotSpace2D::INTERSECTION_QUERY_MAX, r_scratch.subindex_results);
+}
+
+int GodotPhysicsDirectSpaceState2D::_get_batch_task_count(int p_count) {
+	int max_task_count = WorkerThreadPool::get_singleton()->get_thread_count() * 4;
+	return CLAMP((p_count + QUERY_BATCH_MIN_TASK_SIZE - 1) / QUERY_BATCH_MIN_TASK_SIZE, 1, MAX(max_task_count, 1));
+}
+
+void GodotPhysicsDirectSpaceState2D::_intersect_ray_batch(uint32_t p_task_index, RayBatch *p_batch) {
+	LocalVector<GodotCollisionObject2D *> results;
+	results.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+	LocalVector<int> subindex_results;
+	subindex_results.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+	LocalVector<uint32_t, uint32_t, true> hits;
+
+	QueryScratch scratch;
+	scratch.results = results.ptr();
+	scratch.subindex_results = subindex_results.ptr();
+	scratch.hits = &hits;
+
+	int from = p_task_index * p_batch->task_size;
+	int to = MIN(from + p_batch->task_size, p_batch->count);
+	for (int i = from; i < to; i++) {
+		p_batch->hits[i] = _intersect_ray(*p_batch->parameters, p_batch->from[i], p_batch->to[i], p_batch->results[i], scratch);
+	}
+}
+
+void GodotPhysicsDirectSpaceState2D::_cast_motion_batch(uint32_t p_task_index, MotionBatch *p_batch) {
+	LocalVector<GodotCollisionObject2D *> results;
+	results.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+	LocalVector<int> subindex_results;
+	subindex_results.resize(GodotSpace2D::INTERSECTION_QUERY_MAX);
+	LocalVector<uint32_t, uint32_t, true> hits;
+
+	QueryScratch scratch;
+	scratch.results = results.ptr();
+	scratch.subindex_results = subindex_results.ptr();
+	scratch.hits = &hits;
+
+	int from = p_task_index * p_batch->task_size;
+	int to = MIN(from + p_batch->task_size, p_batch->count);
+	for (int i = from; i < to; i++) {
+		_cast_motion(*p_batch->parameters, p_batch->shape, p_batch->transforms[i], p_batch->motions[i], p_batch->closest_safe[i], p_batch->closest_unsafe[i], scratch);
+	}
+}
+
+void GodotPhysicsDirectSpaceState2D::intersect_rays(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits) {
+	ERR_FAIL_COND(space->locked);
+	if (p_count <= 0) {
+		return;
+	}
+
+	RayBatch batch;
+	batch.parameters = &p_parameters;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.results = r_results;
+	batch.hits = r_hits;
+	batch.count = p_count;
+
+	// The space can't change while the calling thread waits, so the queries can share it without locking.
+	int task_count = _get_batch_task_count(p_count);
+	batch.task_size = (p_count + task_count - 1) / task_count;
+	if (task_count == 1) {
+		_intersect_ray_batch(0, &batch);
+		return;
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState2D::_intersect_ray_batch, &batch, task_count, -1, true, SNAME("Physics2DIntersectRays"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
+bool GodotPhysicsDirectSpaceState2D::cast_motions(const ShapeParameters &p_parameters, const Transform2D *p_transforms, const Vector2 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	ERR_FAIL_COND_V(space->locked, false);
+	GodotShape2D *shape = GodotPhysicsServer2D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_COND_V(!shape, false);
+	if (p_count <= 0) {
+		return true;
+	}
+
+	MotionBatch batch;
+	batch.parameters = &p_parameters;
+	batch.shape = shape;
+	batch.transforms = p_transforms;
+	batch.motions = p_motions;
+	batch.closest_safe = r_closest_safe;
+	batch.closest_unsafe = r_closest_unsafe;
+	batch.count = p_count;
+
+	int task_count = _get_batch_task_count(p_count);
+	batch.task_size = (p_count + task_count - 1) / task_count;
+	if (task_count == 1) {
+		_cast_motion_batch(0, &batch);
+		return true;
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState2D::_cast_motion_batch, &batch, task_count, -1, true, SNAME("Physics2DCastMotions"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	return true;
+}
+
 bool GodotPhysicsDirectSpaceState2D::collide_shape(const ShapeParameters &p_parameters, Vector2 *r_results, int p_result_max, int &r_result_count) {
 	if (p_result_max <= 0) {
 		return false;
@@ -1021,6 +1150,12 @@ void *GodotSpace2D::_broadphase_pair(GodotCollisionObject2D *A, int p_subindex_A
 	GodotSpace2D *self = static_cast<GodotSpace2D *>(p_self);
 	self->collision_pairs++;
 
+	if (self->deterministic && type_A == type_B && A->get_self().get_id() > B->get_self().get_id()) {
+		// The broadphase reports pairs in any order, keep the same roles for both objects on every run.
+		SWAP(A, B);
+		SWAP(p_subindex_A, p_subindex_B);
+	}
+
 	if (type_A == GodotCollisionObject2D::TYPE_AREA) {
 		GodotArea2D *area = static_cast<GodotArea2D *>(A);
 		if (type_B == GodotCollisionObject2D::TYPE_AREA) {
@@ -1143,6 +1278,199 @@ void GodotSpace2D::update() {
 	broadphase->update();
 }
 
+// Snapshot layout, in native byte order:
+// - header: version, body count.
+// - for each body, sorted by RID: RID, GodotBody2D::SnapshotState field by field, constraint count.
+// - for each constraint the body comes first in: RID of the other body, order key, cached state size and data.
+static const uint32_t SNAPSHOT_VERSION = 2;
+static const uint32_t SNAPSHOT_HEADER_SIZE = sizeof(uint32_t) * 2;
+static const uint32_t SNAPSHOT_BODY_STATE_SIZE = sizeof(Transform2D) * 2 + sizeof(Vector2) * 2 + sizeof(real_t) * 2 + sizeof(real_t) + sizeof(bool);
+static const uint32_t SNAPSHOT_BODY_SIZE = sizeof(uint64_t) + SNAPSHOT_BODY_STATE_SIZE + sizeof(uint32_t);
+static const uint32_t SNAPSHOT_CONSTRAINT_SIZE = sizeof(uint64_t) * 2 + sizeof(uint32_t);
+
+struct _SnapshotBodyOrder2D {
+	template <class T>
+	_FORCE_INLINE_ bool operator()(const T &p_a, const T &p_b) const {
+		return p_a.body->get_self().get_id() < p_b.body->get_self().get_id();
+	}
+};
+
+static _FORCE_INLINE_ uint64_t _get_snapshot_other_body_id(const GodotConstraint2D *p_constraint) {
+	return p_constraint->get_body_count() > 1 ? p_constraint->get_body_ptr()[1]->get_self().get_id() : 0;
+}
+
+// Fields are copied one by one, so no padding bytes end up in the snapshot.
+// Only for types without padding of their own.
+template <typename T>
+static _FORCE_INLINE_ void _save_snapshot_field(const T &p_value, uint8_t *&r_w) {
+	memcpy(r_w, &p_value, sizeof(T));
+	r_w += sizeof(T);
+}
+
+template <typename T>
+static _FORCE_INLINE_ void _load_snapshot_field(T &r_value, const uint8_t *&r_r) {
+	memcpy(&r_value, r_r, sizeof(T));
+	r_r += sizeof(T);
+}
+
+static void _save_snapshot_body_state(const GodotBody2D::SnapshotState &p_state, uint8_t *&r_w) {
+	_save_snapshot_field(p_state.transform, r_w);
+	_save_snapshot_field(p_state.new_transform, r_w);
+	_save_snapshot_field(p_state.linear_velocity, r_w);
+	_save_snapshot_field(p_state.angular_velocity, r_w);
+	_save_snapshot_field(p_state.prev_linear_velocity, r_w);
+	_save_snapshot_field(p_state.prev_angular_velocity, r_w);
+	_save_snapshot_field(p_state.still_time, r_w);
+	_save_snapshot_field(p_state.active, r_w);
+}
+
+static void _load_snapshot_body_state(GodotBody2D::SnapshotState &r_state, const uint8_t *p_r) {
+	_load_snapshot_field(r_state.transform, p_r);
+	_load_snapshot_field(r_state.new_transform, p_r);
+	_load_snapshot_field(r_state.linear_velocity, p_r);
+	_load_snapshot_field(r_state.angular_velocity, p_r);
+	_load_snapshot_field(r_state.prev_linear_velocity, p_r);
+	_load_snapshot_field(r_state.prev_angular_velocity, p_r);
+	_load_snapshot_field(r_state.still_time, p_r);
+	_load_snapshot_field(r_state.active, p_r);
+}
+
+Vector<uint8_t> GodotSpace2D::save_snapshot() {
+	snapshot_bodies.clear();
+	for (GodotCollisionObject2D *object : objects) {
+		if (object->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+			SnapshotBody snapshot_body;
+			snapshot_body.body = static_cast<GodotBody2D *>(object);
+			snapshot_bodies.push_back(snapshot_body);
+		}
+	}
+	snapshot_bodies.sort_custom<_SnapshotBodyOrder2D>();
+
+	// Compute the exact size first so the buffer is only allocated once.
+	uint32_t size = SNAPSHOT_HEADER_SIZE;
+	for (const SnapshotBody &snapshot_body : snapshot_bodies) {
+		size += SNAPSHOT_BODY_SIZE;
+		for (const Pair<GodotConstraint2D *, int> &E : snapshot_body.body->get_constraint_list()) {
+			uint32_t state_size = E.first->get_cached_state_size();
+			if (E.second == 0 && state_size > 0) {
+				size += SNAPSHOT_CONSTRAINT_SIZE + state_size;
+			}
+		}
+	}
+
+	Vector<uint8_t> snapshot;
+	snapshot.resize(size);
+	uint8_t *w = snapshot.ptrw();
+
+	w += encode_uint32(SNAPSHOT_VERSION, w);
+	w += encode_uint32(snapshot_bodies.size(), w);
+
+	for (const SnapshotBody &snapshot_body : snapshot_bodies) {
+		const GodotBody2D *body = snapshot_body.body;
+		GodotBody2D::SnapshotState state;
+		body->save_snapshot_state(state);
+
+		w += encode_uint64(body->get_self().get_id(), w);
+		_save_snapshot_body_state(state, w);
+
+		uint8_t *constraint_count_w = w;
+		w += sizeof(uint32_t);
+		uint32_t constraint_count = 0;
+		for (const Pair<GodotConstraint2D *, int> &E : body->get_constraint_list()) {
+			uint32_t state_size = E.first->get_cached_state_size();
+			if (E.second != 0 || state_size == 0) {
+				continue; // Saved with the other body, or nothing to save.
+			}
+			w += encode_uint64(_get_snapshot_other_body_id(E.first), w);
+			w += encode_uint64(E.first->get_order_key(), w);
+			w += encode_uint32(state_size, w);
+			E.first->save_cached_state(w);
+			w += state_size;
+			constraint_count++;
+		}
+		encode_uint32(constraint_count, constraint_count_w);
+	}
+
+	return snapshot;
+}
+
+bool GodotSpace2D::load_snapshot(const Vector<uint8_t> &p_snapshot) {
+	const uint8_t *r = p_snapshot.ptr();
+	uint32_t size = p_snapshot.size();
+	ERR_FAIL_COND_V_MSG(size < SNAPSHOT_HEADER_SIZE || decode_uint32(r) != SNAPSHOT_VERSION, false, "Invalid physics space snapshot.");
+	uint32_t body_count = decode_uint32(r + sizeof(uint32_t));
+
+	snapshot_body_map.clear();
+	for (GodotCollisionObject2D *object : objects) {
+		if (object->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+			snapshot_body_map.insert(object->get_self().get_id(), static_cast<GodotBody2D *>(object));
+		}
+	}
+
+	// Check the whole snapshot before touching any body.
+	snapshot_bodies.clear();
+	uint32_t offset = SNAPSHOT_HEADER_SIZE;
+	for (uint32_t i = 0; i < body_count; i++) {
+		ERR_FAIL_COND_V_MSG(offset + SNAPSHOT_BODY_SIZE > size, false, "Invalid physics space snapshot.");
+		GodotBody2D **body = snapshot_body_map.getptr(decode_uint64(r + offset));
+		ERR_FAIL_NULL_V_MSG(body, false, "Physics space snapshot contains a body that isn't in the space anymore.");
+
+		SnapshotBody snapshot_body;
+		snapshot_body.body = *body;
+		snapshot_body.state_offset = offset + sizeof(uint64_t);
+		offset += SNAPSHOT_BODY_SIZE;
+		snapshot_body.constraint_count = decode_uint32(r + offset - sizeof(uint32_t));
+
+		for (uint32_t j = 0; j < snapshot_body.constraint_count; j++) {
+			ERR_FAIL_COND_V_MSG(offset + SNAPSHOT_CONSTRAINT_SIZE > size, false, "Invalid physics space snapshot.");
+			offset += SNAPSHOT_CONSTRAINT_SIZE + decode_uint32(r + offset + sizeof(uint64_t) * 2);
+			ERR_FAIL_COND_V_MSG(offset > size, false, "Invalid physics space snapshot.");
+		}
+		snapshot_bodies.push_back(snapshot_body);
+	}
+
+	for (const SnapshotBody &snapshot_body : snapshot_bodies) {
+		GodotBody2D::SnapshotState state;
+		_load_snapshot_body_state(state, r + snapshot_body.state_offset);
+		snapshot_body.body->load_snapshot_state(state);
+	}
+
+	// Pair the bodies at their restored positions, then give the pairs back their contacts.
+	update();
+
+	for (const SnapshotBody &snapshot_body : snapshot_bodies) {
+		const uint8_t *constraints_r = r + snapshot_body.state_offset + SNAPSHOT_BODY_STATE_SIZE + sizeof(uint32_t);
+		for (const Pair<GodotConstraint2D *, int> &E : snapshot_body.body->get_constraint_list()) {
+			GodotConstraint2D *constraint = E.first;
+			uint32_t state_size = constraint->get_cached_state_size();
+			if (E.second != 0 || state_size == 0) {
+				continue;
+			}
+
+			uint64_t other_body_id = _get_snapshot_other_body_id(constraint);
+			uint64_t key = constraint->get_order_key();
+			bool found = false;
+			const uint8_t *record_r = constraints_r;
+			for (uint32_t j = 0; j < snapshot_body.constraint_count; j++) {
+				uint32_t record_size = decode_uint32(record_r + sizeof(uint64_t) * 2);
+				if (decode_uint64(record_r) == other_body_id && decode_uint64(record_r + sizeof(uint64_t)) == key && record_size == state_size) {
+					constraint->load_cached_state(record_r + SNAPSHOT_CONSTRAINT_SIZE);
+					found = true;
+					break;
+				}
+				record_r += SNAPSHOT_CONSTRAINT_SIZE + record_size;
+			}
+
+			if (!found) {
+				// The pair didn't exist when the snapshot was taken.
+				constraint->clear_cached_state();
+			}
+		}
+	}
+
+	return true;
+}
+
 void GodotSpace2D::set_param(PhysicsServer2D::SpaceParameter p_param, real_t p_value) {
 	switch (p_param) {
 		case PhysicsServer2D::SPACE_PARAM_CONTACT_RECYCLE_RADIUS:
@@ -1172,6 +1500,9 @@ void GodotSpace2D::set_param(PhysicsServer2D::SpaceParameter p_param, real_t p_v
 		case PhysicsServer2D::SPACE_PARAM_SOLVER_ITERATIONS:
 			solver_iterations = p_value;
 			break;
+		case PhysicsServer2D::SPACE_PARAM_DETERMINISTIC_QUANTUM:
+			deterministic_quantum = p_value;
+			break;
 	}
 }
 
@@ -1195,10 +1526,39 @@ real_t GodotSpace2D::get_param(PhysicsServer2D::SpaceParameter p_param) const {
 			return constraint_bias;
 		case PhysicsServer2D::SPACE_PARAM_SOLVER_ITERATIONS:
 			return solver_iterations;
+		case PhysicsServer2D::SPACE_PARAM_DETERMINISTIC_QUANTUM:
+			return deterministic_quantum;
 	}
 	return 0;
 }
 
+uint32_t GodotSpace2D::get_state_checksum() const {
+	LocalVector<GodotBody2D *> bodies;
+	for (GodotCollisionObject2D *object : objects) {
+		if (object->get_type() == GodotCollisionObject2D::TYPE_BODY) {
+			bodies.push_back(static_cast<GodotBody2D *>(object));
+		}
+	}
+	bodies.sort_custom<BodyOrder>();
+
+	uint32_t h = hash_murmur3_one_32(bodies.size());
+	for (const GodotBody2D *body : bodies) {
+		const Transform2D &transform = body->get_transform();
+		h = hash_murmur3_one_64(body->get_self().get_id(), h);
+		h = hash_murmur3_one_real(transform.columns[0].x, h);
+		h = hash_murmur3_one_real(transform.columns[0].y, h);
+		h = hash_murmur3_one_real(transform.columns[1].x, h);
+		h = hash_murmur3_one_real(transform.columns[1].y, h);
+		h = hash_murmur3_one_real(transform.columns[2].x, h);
+		h = hash_murmur3_one_real(transform.columns[2].y, h);
+		h = hash_murmur3_one_real(body->get_linear_velocity().x, h);
+		h = hash_murmur3_one_real(body->get_linear_velocity().y, h);
+		h = hash_murmur3_one_real(body->get_angular_velocity(), h);
+		h = hash_murmur3_one_32(body->is_active(), h);
+	}
+	return hash_fmix32(h);
+}
+
 void GodotSpace2D::lock() {
 	locked = true;
 }
@@ -45,6 +45,44 @@
 class GodotPhysicsDirectSpaceState2D : public PhysicsDirectSpaceState2D {
 	GDCLASS(GodotPhysicsDirectSpaceState2D, PhysicsDirectSpaceState2D);
 
+	// Where the broadphase results of a query are stored.
+	// With hits set, the query doesn't use any shared buffer and can run on any thread.
+	struct QueryScratch {
+		GodotCollisionObject2D **results = nullptr;
+		int *subindex_results = nullptr;
+		LocalVector<uint32_t, uint32_t, true> *hits = nullptr;
+	};
+
+	struct RayBatch {
+		const RayParameters *parameters = nullptr;
+		const Vector2 *from = nullptr;
+		const Vector2 *to = nullptr;
+		RayResult *results = nullptr;
+		bool *hits = nullptr;
+		int count = 0;
+		int task_size = 0;
+	};
+
+	struct MotionBatch {
+		const ShapeParameters *parameters = nullptr;
+		GodotShape2D *shape = nullptr;
+		const Transform2D *transforms = nullptr;
+		const Vector2 *motions = nullptr;
+		real_t *closest_safe = nullptr;
+		real_t *closest_unsafe = nullptr;
+		int count = 0;
+		int task_size = 0;
+	};
+
+	int _cull_segment(const Vector2 &p_from, const Vector2 &p_to, QueryScratch &r_scratch);
+	int _cull_aabb(const Rect2 &p_aabb, QueryScratch &r_scratch);
+	bool _intersect_ray(const RayParameters &p_parameters, const Vector2 &p_from, const Vector2 &p_to, RayResult &r_result, QueryScratch &r_scratch);
+	bool _cast_motion(const ShapeParameters &p_parameters, GodotShape2D *p_shape, const Transform2D &p_transform, const Vector2 &p_motion, real_t &p_closest_safe, real_t &p_closest_unsafe, QueryScratch &r_scratch);
+
+	static int _get_batch_task_count(int p_count);
+	void _intersect_ray_batch(uint32_t p_task_index, RayBatch *p_batch);
+	void _cast_motion_batch(uint32_t p_task_index, MotionBatch *p_batch);
+
 public:
 	GodotSpace2D *space = nullptr;
 
@@ -52,6 +90,8 @@ public:
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) override;
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe) override;
+	virtual void intersect_rays(const RayParameters &p_parameters, const Vector2 *p_from, const Vector2 *p_to, int p_count, RayResult *r_results, bool *r_hits) override;
+	virtual bool cast_motions(const ShapeParameters &p_parameters, const Transform2D *p_transforms, const Vector2 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) override;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector2 *r_results, int p_result_max, int &r_result_count) override;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
 
@@ -60,6 +100,13 @@ public:
 
 class GodotSpace2D {
 public:
+	// Sorts bodies the same way on every run, regardless of the order they were added or woken up in.
+	struct BodyOrder {
+		_FORCE_INLINE_ bool operator()(const GodotBody2D *p_a, const GodotBody2D *p_b) const {
+			return p_a->get_self().get_id() < p_b->get_self().get_id();
+		}
+	};
+
 	enum ElapsedTime {
 		ELAPSED_TIME_INTEGRATE_FORCES,
 		ELAPSED_TIME_GENERATE_ISLANDS,
@@ -94,6 +141,16 @@ private:
 
 	HashSet<GodotCollisionObject2D *> objects;
 
+	struct SnapshotBody {
+		GodotBody2D *body = nullptr;
+		uint32_t state_offset = 0;
+		uint32_t constraint_count = 0;
+	};
+
+	// Kept between snapshots to avoid reallocating them every frame.
+	LocalVector<SnapshotBody> snapshot_bodies;
+	HashMap<uint64_t, GodotBody2D *> snapshot_body_map;
+
 	GodotArea2D *area = nullptr;
 
 	int solver_iterations = 0;
@@ -104,6 +161,9 @@ private:
 	real_t contact_bias = 0.0;
 	real_t constraint_bias = 0.0;
 
+	bool deterministic = false;
+	real_t deterministic_quantum = 0.0;
+
 	enum {
 		INTERSECTION_QUERY_MAX = 2048
 	};
@@ -168,10 +228,18 @@ public:
 	_FORCE_INLINE_ real_t get_body_angular_velocity_sleep_threshold() const { return body_angular_velocity_sleep_threshold; }
 	_FORCE_INLINE_ real_t get_body_time_to_sleep() const { return body_time_to_sleep; }
 
+	void set_deterministic(bool p_deterministic) { deterministic = p_deterministic; }
+	_FORCE_INLINE_ bool is_deterministic() const { return deterministic; }
+	_FORCE_INLINE_ real_t get_deterministic_quantum() const { return deterministic_quantum; }
+	uint32_t get_state_checksum() const;
+
 	void update();
 	void setup();
 	void call_queries();
 
+	Vector<uint8_t> save_snapshot();
+	bool load_snapshot(const Vector<uint8_t> &p_snapshot);
+
 	bool is_locked() const;
 	void lock();
 	void unlock();
@@ -39,6 +39,23 @@
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
 
+// Sorts constraints by the bodies they connect, which doesn't depend on the order the broadphase found them in.
+struct _ConstraintOrder2D {
+	_FORCE_INLINE_ bool operator()(const GodotConstraint2D *p_a, const GodotConstraint2D *p_b) const {
+		if (p_a->get_body_count() != p_b->get_body_count()) {
+			return p_a->get_body_count() < p_b->get_body_count();
+		}
+		for (int i = 0; i < p_a->get_body_count(); i++) {
+			uint64_t id_a = p_a->get_body_ptr()[i]->get_self().get_id();
+			uint64_t id_b = p_b->get_body_ptr()[i]->get_self().get_id();
+			if (id_a != id_b) {
+				return id_a < id_b;
+			}
+		}
+		return p_a->get_order_key() < p_b->get_order_key();
+	}
+};
+
 void GodotStep2D::_populate_island(GodotBody2D *p_body, LocalVector<GodotBody2D *> &p_body_island, LocalVector<GodotConstraint2D *> &p_constraint_island) {
 	p_body->set_island_step(_step);
 
@@ -192,13 +209,19 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE RIGID BODIES */
 
-	b = body_list->first();
+	// In deterministic mode, islands are built from bodies in a fixed order instead of activation order.
+	bool deterministic = p_space->is_deterministic();
+	ordered_bodies.clear();
+	for (b = body_list->first(); b; b = b->next()) {
+		ordered_bodies.push_back(b->self());
+	}
+	if (deterministic) {
+		ordered_bodies.sort_custom<GodotSpace2D::BodyOrder>();
+	}
 
 	uint32_t body_island_count = 0;
 
-	while (b) {
-		GodotBody2D *body = b->self();
-
+	for (GodotBody2D *body : ordered_bodies) {
 		if (body->get_island_step() != _step) {
 			++body_island_count;
 			if (body_islands.size() < body_island_count) {
@@ -218,6 +241,10 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 			_populate_island(body, body_island, constraint_island);
 
+			if (deterministic) {
+				constraint_island.sort_custom<_ConstraintOrder2D>();
+			}
+
 			if (body_island.is_empty()) {
 				--body_island_count;
 			}
@@ -226,7 +253,6 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 				--island_count;
 			}
 		}
-		b = b->next();
 	}
 
 	p_space->set_island_count((int)island_count);
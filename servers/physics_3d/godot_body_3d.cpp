@@ -299,6 +299,9 @@ void GodotBody3D::set_mode(PhysicsServer3D::BodyMode p_mode) {
 	PhysicsServer3D::BodyMode prev = mode;
 	mode = p_mode;
 
+	// Static bodies don't connect islands.
+	invalidate_island();
+
 	switch (p_mode) {
 		case PhysicsServer3D::BODY_MODE_STATIC:
 		case PhysicsServer3D::BODY_MODE_KINEMATIC: {
@@ -438,6 +441,8 @@ Variant GodotBody3D::get_state(PhysicsServer3D::BodyState p_state) const {
 }
 
 void GodotBody3D::set_space(GodotSpace3D *p_space) {
+	invalidate_island();
+
 	if (get_space()) {
 		if (mass_properties_update_list.in_list()) {
 			get_space()->body_remove_from_mass_properties_update_list(&mass_properties_update_list);
@@ -727,12 +732,26 @@ void GodotBody3D::integrate_velocities(real_t p_step) {
 
 	transform_new.origin += total_linear_velocity * p_step;
 
+	// The body only traveled up to its CCD impact, the contact will take the full velocity next step.
+	linear_velocity += ccd_excess_linear_velocity;
+	ccd_excess_linear_velocity = Vector3();
+
 	_set_transform(transform_new);
 	_set_inv_transform(get_transform().inverse());
 
 	_update_transform_dependent();
 }
 
+void GodotBody3D::invalidate_island() {
+	if (island_id == 0) {
+		return;
+	}
+	if (get_space()) {
+		get_space()->invalidate_island(island_id);
+	}
+	island_id = 0;
+}
+
 void GodotBody3D::wakeup_neighbours() {
 	for (const KeyValue<GodotConstraint3D *, int> &E : constraint_map) {
 		const GodotConstraint3D *c = E.key;
@@ -779,6 +798,32 @@ void GodotBody3D::call_queries() {
 	}
 }
 
+void GodotBody3D::save_snapshot_state(SnapshotState &r_state) const {
+	r_state.transform = get_transform();
+	r_state.new_transform = new_transform;
+	r_state.linear_velocity = linear_velocity;
+	r_state.angular_velocity = angular_velocity;
+	r_state.prev_linear_velocity = prev_linear_velocity;
+	r_state.prev_angular_velocity = prev_angular_velocity;
+	r_state.still_time = still_time;
+	r_state.active = active;
+}
+
+void GodotBody3D::load_snapshot_state(const SnapshotState &p_state) {
+	_set_transform(p_state.transform);
+	_set_inv_transform(p_state.transform.affine_inverse());
+	new_transform = p_state.new_transform;
+	linear_velocity = p_state.linear_velocity;
+	angular_velocity = p_state.angular_velocity;
+	prev_linear_velocity = p_state.prev_linear_velocity;
+	prev_angular_velocity = p_state.prev_angular_velocity;
+	still_time = p_state.still_time;
+	_update_transform_dependent();
+
+	set_active(p_state.active);
+	invalidate_island();
+}
+
 bool GodotBody3D::sleep_test(real_t p_step) {
 	if (mode == PhysicsServer3D::BODY_MODE_STATIC || mode == PhysicsServer3D::BODY_MODE_KINEMATIC) {
 		return true;
@@ -105,6 +105,8 @@ class GodotBody3D : public GodotCollisionObject3D {
 	bool active = true;
 
 	bool continuous_cd = false;
+	// Velocity removed by CCD to stop the body at an impact, given back after integration.
+	Vector3 ccd_excess_linear_velocity;
 	bool can_sleep = true;
 	bool first_time_kinematic = false;
 
@@ -144,12 +146,28 @@ class GodotBody3D : public GodotCollisionObject3D {
 	GodotPhysicsDirectBodyState3D *direct_state = nullptr;
 
 	uint64_t island_step = 0;
+	uint64_t island_id = 0;
 
 	void _update_transform_dependent();
 
 	friend class GodotPhysicsDirectBodyState3D; // i give up, too many functions to expose
 
 public:
+	// Simulation state saved in space snapshots, everything else is set by the user or recomputed each step.
+	struct SnapshotState {
+		Transform3D transform;
+		Transform3D new_transform;
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		Vector3 prev_linear_velocity;
+		Vector3 prev_angular_velocity;
+		real_t still_time = 0.0;
+		bool active = false;
+	};
+
+	void save_snapshot_state(SnapshotState &r_state) const;
+	void load_snapshot_state(const SnapshotState &p_state);
+
 	void set_state_sync_callback(const Callable &p_callable);
 	void set_force_integration_callback(const Callable &p_callable, const Variant &p_udata = Variant());
 
@@ -194,8 +212,18 @@ public:
 	_FORCE_INLINE_ uint64_t get_island_step() const { return island_step; }
 	_FORCE_INLINE_ void set_island_step(uint64_t p_step) { island_step = p_step; }
 
-	_FORCE_INLINE_ void add_constraint(GodotConstraint3D *p_constraint, int p_pos) { constraint_map[p_constraint] = p_pos; }
-	_FORCE_INLINE_ void remove_constraint(GodotConstraint3D *p_constraint) { constraint_map.erase(p_constraint); }
+	_FORCE_INLINE_ uint64_t get_island_id() const { return island_id; }
+	_FORCE_INLINE_ void set_island_id(uint64_t p_island_id) { island_id = p_island_id; }
+	void invalidate_island();
+
+	_FORCE_INLINE_ void add_constraint(GodotConstraint3D *p_constraint, int p_pos) {
+		constraint_map[p_constraint] = p_pos;
+		invalidate_island();
+	}
+	_FORCE_INLINE_ void remove_constraint(GodotConstraint3D *p_constraint) {
+		constraint_map.erase(p_constraint);
+		invalidate_island();
+	}
 	const HashMap<GodotConstraint3D *, int> &get_constraint_map() const { return constraint_map; }
 	_FORCE_INLINE_ void clear_constraint_map() { constraint_map.clear(); }
 
@@ -216,7 +244,9 @@ public:
 	_FORCE_INLINE_ Vector3 get_prev_linear_velocity() const { return prev_linear_velocity; }
 	_FORCE_INLINE_ Vector3 get_prev_angular_velocity() const { return prev_angular_velocity; }
 
+	_FORCE_INLINE_ void set_biased_linear_velocity(const Vector3 &p_velocity) { biased_linear_velocity = p_velocity; }
 	_FORCE_INLINE_ const Vector3 &get_biased_linear_velocity() const { return biased_linear_velocity; }
+	_FORCE_INLINE_ void set_biased_angular_velocity(const Vector3 &p_velocity) { biased_angular_velocity = p_velocity; }
 	_FORCE_INLINE_ const Vector3 &get_biased_angular_velocity() const { return biased_angular_velocity; }
 
 	_FORCE_INLINE_ void apply_central_impulse(const Vector3 &p_impulse) {
@@ -300,6 +330,14 @@ public:
 
 	_FORCE_INLINE_ void set_continuous_collision_detection(bool p_enable) { continuous_cd = p_enable; }
 	_FORCE_INLINE_ bool is_continuous_collision_detection_enabled() const { return continuous_cd; }
+	// Not thread safe, several pairs can clamp the same body. Only called from the serial pre-solve pass.
+	_FORCE_INLINE_ void clamp_ccd_linear_velocity(const Vector3 &p_velocity) {
+		if (p_velocity.length_squared() >= linear_velocity.length_squared()) {
+			return; // Already stopped by an earlier impact.
+		}
+		ccd_excess_linear_velocity += linear_velocity - p_velocity;
+		linear_velocity = p_velocity;
+	}
 
 	void set_space(GodotSpace3D *p_space) override;
 
@@ -31,6 +31,7 @@
 #include "godot_body_pair_3d.h"
 
 #include "godot_collision_solver_3d.h"
+#include "godot_narrow_phase_3d.h"
 #include "godot_space_3d.h"
 
 #include "core/os/os.h"
@@ -162,9 +163,9 @@ void GodotBodyPair3D::validate_contacts() {
 }
 
 // _test_ccd prevents tunneling by slowing down a high velocity body that is about to collide so that next frame it will be at an appropriate location to collide (i.e. slight overlap)
-// Warning: the way velocity is adjusted down to cause a collision means the momentum will be weaker than it should for a bounce!
+// The clamped part of the velocity is given back to the body once it has moved, so the contact is solved with its full momentum on the next step.
 // Process: only proceed if body A's motion is high relative to its size.
-// cast forward along motion vector to see if A is going to enter/pass B's collider next frame, only proceed if it does.
+// sweep A along the motion vector to find the time of impact with B's collider, only proceed if it is within this frame.
 // adjust the velocity of A down so that it will just slightly intersect the collider instead of blowing right past it.
 bool GodotBodyPair3D::_test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B) {
 	GodotShape3D *shape_A_ptr = p_A->get_shape(p_shape_A);
@@ -181,68 +182,33 @@ bool GodotBodyPair3D::_test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A,
 	real_t min = 0.0, max = 0.0;
 	shape_A_ptr->project_range(mnormal, p_xform_A, min, max);
 
-	// Did it move enough in this direction to even attempt raycast?
+	// Did it move enough in this direction to even attempt a sweep?
 	// Let's say it should move more than 1/3 the size of the object in that axis.
 	bool fast_object = mlen > (max - min) * 0.3;
 	if (!fast_object) {
 		return false; // moving slow enough that there's no chance of tunneling.
 	}
 
-	// A is moving fast enough that tunneling might occur. See if it's really about to collide.
-
-	// Support points are the farthest forward points on A in the direction of the motion vector.
-	// i.e. the candidate points of which one should hit B first if any collision does occur.
-	static const int max_supports = 16;
-	Vector3 supports_A[max_supports];
-	int support_count_A;
-	GodotShape3D::FeatureType support_type_A;
-	// Convert mnormal into body A's local xform because get_supports requires (and returns) local coordinates.
-	shape_A_ptr->get_supports(p_xform_A.basis.xform_inv(mnormal).normalized(), max_supports, supports_A, support_count_A, support_type_A);
-
-	// Cast a segment from each support point of A in the motion direction.
-	int segment_support_idx = -1;
-	float segment_hit_length = FLT_MAX;
-	Vector3 segment_hit_local;
-	for (int i = 0; i < support_count_A; i++) {
-		supports_A[i] = p_xform_A.xform(supports_A[i]);
-
-		Vector3 from = supports_A[i];
-		Vector3 to = from + motion;
-
-		Transform3D from_inv = p_xform_B.affine_inverse();
-
-		// Back up 10% of the per-frame motion behind the support point and use that as the beginning of our cast.
-		// At high speeds, this may mean we're actually casting from well behind the body instead of inside it, which is odd.
-		// But it still works out.
-		Vector3 local_from = from_inv.xform(from - motion * 0.1);
-		Vector3 local_to = from_inv.xform(to);
-
-		Vector3 rpos, rnorm;
-		if (shape_B_ptr->intersect_segment(local_from, local_to, rpos, rnorm, true)) {
-			float hit_length = local_from.distance_to(rpos);
-			if (hit_length < segment_hit_length) {
-				segment_support_idx = i;
-				segment_hit_length = hit_length;
-				segment_hit_local = rpos;
-			}
-		}
-	}
-
-	if (segment_support_idx == -1) {
-		// There was no hit. Since the segment is the length of per-frame motion, this means the bodies will not
-		// actually collide yet on next frame. We'll probably check again next frame once they're closer.
+	// A is moving fast enough that tunneling might occur. Sweep the whole shape to see if it's really about to collide.
+	// Unlike casting rays from a few points, this also catches thin or small geometry passing between them.
+	real_t toi = 1.0;
+	Vector3 point_A, point_B;
+	if (!GodotCollisionSolver3D::solve_time_of_impact(shape_A_ptr, p_xform_A, motion, shape_B_ptr, p_xform_B, (max - min) * 0.005, toi, point_A, point_B)) {
+		// The bodies will not collide within this frame's motion.
+		// We'll probably check again next frame once they're closer.
 		return false;
 	}
 
-	Vector3 hitpos = p_xform_B.xform(segment_hit_local);
-
-	real_t newlen = hitpos.distance_to(supports_A[segment_support_idx]);
-	// Adding 1% of body length to the distance between collision and support point
-	// should cause body A's support point to arrive just within B's collider next frame.
+	real_t newlen = toi * mlen;
+	// Adding 1% of body length to the distance traveled until the impact
+	// should cause body A to arrive just within B's collider next frame.
 	newlen += (max - min) * 0.01;
-	// FIXME: This doesn't always work well when colliding with a triangle face of a trimesh shape.
+	if (newlen >= mlen) {
+		return false;
+	}
 
-	p_A->set_linear_velocity((mnormal * newlen) / p_step);
+	// Pre-solve runs serially, so pairs sharing this body don't race on its velocity.
+	p_A->clamp_ccd_linear_velocity((mnormal * newlen) / p_step);
 
 	return true;
 }
@@ -256,6 +222,10 @@ real_t combine_friction(GodotBody3D *A, GodotBody3D *B) {
 }
 
 bool GodotBodyPair3D::setup(real_t p_step) {
+	return setup_batched(p_step, nullptr);
+}
+
+bool GodotBodyPair3D::setup_batched(real_t p_step, GodotNarrowPhase3D *p_narrow_phase) {
 	check_ccd = false;
 
 	if (!A->interacts_with(B) || A->has_exception(B->get_self()) || B->has_exception(A->get_self())) {
@@ -291,8 +261,24 @@ bool GodotBodyPair3D::setup(real_t p_step) {
 	GodotShape3D *shape_A_ptr = A->get_shape(shape_A);
 	GodotShape3D *shape_B_ptr = B->get_shape(shape_B);
 
+	if (p_narrow_phase && p_narrow_phase->add_query(shape_A_ptr, xform_A, shape_B_ptr, xform_B, _contact_added_callback, _narrow_phase_finished, this, &sep_axis)) {
+		// Contacts are added when the batch is solved.
+		collided = false;
+		return true;
+	}
+
 	collided = GodotCollisionSolver3D::solve_static(shape_A_ptr, xform_A, shape_B_ptr, xform_B, _contact_added_callback, this, &sep_axis);
 
+	return _collision_solved();
+}
+
+void GodotBodyPair3D::_narrow_phase_finished(bool p_collided, void *p_userdata) {
+	GodotBodyPair3D *pair = static_cast<GodotBodyPair3D *>(p_userdata);
+	pair->collided = p_collided;
+	pair->_collision_solved();
+}
+
+bool GodotBodyPair3D::_collision_solved() {
 	if (!collided) {
 		if (A->is_continuous_collision_detection_enabled() && collide_A) {
 			check_ccd = true;
@@ -354,6 +340,8 @@ bool GodotBodyPair3D::pre_solve(real_t p_step) {
 
 	bool do_process = false;
 
+	combined_friction = combine_friction(A, B);
+
 	const Basis &basis_A = A->get_transform().basis;
 	const Basis &basis_B = B->get_transform().basis;
 
@@ -444,6 +432,13 @@ bool GodotBodyPair3D::pre_solve(real_t p_step) {
 	return do_process;
 }
 
+bool GodotBodyPair3D::bind_solver_bodies(GodotSolverBodies3D *p_solver_bodies) {
+	solver_bodies = p_solver_bodies;
+	solver_index_A = solver_bodies->add_body(A);
+	solver_index_B = solver_bodies->add_body(B);
+	return true;
+}
+
 void GodotBodyPair3D::solve(real_t p_step) {
 	if (!collided) {
 		return;
@@ -454,11 +449,15 @@ void GodotBodyPair3D::solve(real_t p_step) {
 	Basis zero_basis;
 	zero_basis.set_zero();
 
-	const Basis &inv_inertia_tensor_A = collide_A ? A->get_inv_inertia_tensor() : zero_basis;
-	const Basis &inv_inertia_tensor_B = collide_B ? B->get_inv_inertia_tensor() : zero_basis;
+	GodotSolverBodies3D &bodies = *solver_bodies;
+	const uint32_t a = solver_index_A;
+	const uint32_t b = solver_index_B;
 
-	real_t inv_mass_A = collide_A ? A->get_inv_mass() : 0.0;
-	real_t inv_mass_B = collide_B ? B->get_inv_mass() : 0.0;
+	const Basis &inv_inertia_tensor_A = collide_A ? bodies.get_inv_inertia_tensor(a) : zero_basis;
+	const Basis &inv_inertia_tensor_B = collide_B ? bodies.get_inv_inertia_tensor(b) : zero_basis;
+
+	real_t inv_mass_A = collide_A ? bodies.get_inv_mass(a) : 0.0;
+	real_t inv_mass_B = collide_B ? bodies.get_inv_mass(b) : 0.0;
 
 	for (int i = 0; i < contact_count; i++) {
 		Contact &c = contacts[i];
@@ -470,9 +469,9 @@ void GodotBodyPair3D::solve(real_t p_step) {
 
 		//bias impulse
 
-		Vector3 crbA = A->get_biased_angular_velocity().cross(c.rA);
-		Vector3 crbB = B->get_biased_angular_velocity().cross(c.rB);
-		Vector3 dbv = B->get_biased_linear_velocity() + crbB - A->get_biased_linear_velocity() - crbA;
+		Vector3 crbA = bodies.get_biased_angular_velocity(a).cross(c.rA);
+		Vector3 crbB = bodies.get_biased_angular_velocity(b).cross(c.rB);
+		Vector3 dbv = bodies.get_biased_linear_velocity(b) + crbB - bodies.get_biased_linear_velocity(a) - crbA;
 
 		real_t vbn = dbv.dot(c.normal);
 
@@ -484,15 +483,15 @@ void GodotBodyPair3D::solve(real_t p_step) {
 			Vector3 jb = c.normal * (c.acc_bias_impulse - jbnOld);
 
 			if (collide_A) {
-				A->apply_bias_impulse(-jb, c.rA + A->get_center_of_mass(), max_bias_av);
+				bodies.apply_bias_impulse(a, -jb, c.rA + bodies.get_center_of_mass(a), max_bias_av);
 			}
 			if (collide_B) {
-				B->apply_bias_impulse(jb, c.rB + B->get_center_of_mass(), max_bias_av);
+				bodies.apply_bias_impulse(b, jb, c.rB + bodies.get_center_of_mass(b), max_bias_av);
 			}
 
-			crbA = A->get_biased_angular_velocity().cross(c.rA);
-			crbB = B->get_biased_angular_velocity().cross(c.rB);
-			dbv = B->get_biased_linear_velocity() + crbB - A->get_biased_linear_velocity() - crbA;
+			crbA = bodies.get_biased_angular_velocity(a).cross(c.rA);
+			crbB = bodies.get_biased_angular_velocity(b).cross(c.rB);
+			dbv = bodies.get_biased_linear_velocity(b) + crbB - bodies.get_biased_linear_velocity(a) - crbA;
 
 			vbn = dbv.dot(c.normal);
 
@@ -504,19 +503,19 @@ void GodotBodyPair3D::solve(real_t p_step) {
 				Vector3 jb_com = c.normal * (c.acc_bias_impulse_center_of_mass - jbnOld_com);
 
 				if (collide_A) {
-					A->apply_bias_impulse(-jb_com, A->get_center_of_mass(), 0.0f);
+					bodies.apply_bias_impulse(a, -jb_com, bodies.get_center_of_mass(a), 0.0f);
 				}
 				if (collide_B) {
-					B->apply_bias_impulse(jb_com, B->get_center_of_mass(), 0.0f);
+					bodies.apply_bias_impulse(b, jb_com, bodies.get_center_of_mass(b), 0.0f);
 				}
 			}
 
 			c.active = true;
 		}
 
-		Vector3 crA = A->get_angular_velocity().cross(c.rA);
-		Vector3 crB = B->get_angular_velocity().cross(c.rB);
-		Vector3 dv = B->get_linear_velocity() + crB - A->get_linear_velocity() - crA;
+		Vector3 crA = bodies.get_angular_velocity(a).cross(c.rA);
+		Vector3 crB = bodies.get_angular_velocity(b).cross(c.rB);
+		Vector3 dv = bodies.get_linear_velocity(b) + crB - bodies.get_linear_velocity(a) - crA;
 
 		//normal impulse
 		real_t vn = dv.dot(c.normal);
@@ -529,10 +528,10 @@ void GodotBodyPair3D::solve(real_t p_step) {
 			Vector3 j = c.normal * (c.acc_normal_impulse - jnOld);
 
 			if (collide_A) {
-				A->apply_impulse(-j, c.rA + A->get_center_of_mass());
+				bodies.apply_impulse(a, -j, c.rA + bodies.get_center_of_mass(a));
 			}
 			if (collide_B) {
-				B->apply_impulse(j, c.rB + B->get_center_of_mass());
+				bodies.apply_impulse(b, j, c.rB + bodies.get_center_of_mass(b));
 			}
 			c.acc_impulse -= j;
 
@@ -541,10 +540,8 @@ void GodotBodyPair3D::solve(real_t p_step) {
 
 		//friction impulse
 
-		real_t friction = combine_friction(A, B);
-
-		Vector3 lvA = A->get_linear_velocity() + A->get_angular_velocity().cross(c.rA);
-		Vector3 lvB = B->get_linear_velocity() + B->get_angular_velocity().cross(c.rB);
+		Vector3 lvA = bodies.get_linear_velocity(a) + bodies.get_angular_velocity(a).cross(c.rA);
+		Vector3 lvB = bodies.get_linear_velocity(b) + bodies.get_angular_velocity(b).cross(c.rB);
 
 		Vector3 dtv = lvB - lvA;
 		real_t tn = c.normal.dot(dtv);
@@ -567,7 +564,7 @@ void GodotBodyPair3D::solve(real_t p_step) {
 			c.acc_tangent_impulse += jt;
 
 			real_t fi_len = c.acc_tangent_impulse.length();
-			real_t jtMax = c.acc_normal_impulse * friction;
+			real_t jtMax = c.acc_normal_impulse * combined_friction;
 
 			if (fi_len > CMP_EPSILON && fi_len > jtMax) {
 				c.acc_tangent_impulse *= jtMax / fi_len;
@@ -576,10 +573,10 @@ void GodotBodyPair3D::solve(real_t p_step) {
 			jt = c.acc_tangent_impulse - jtOld;
 
 			if (collide_A) {
-				A->apply_impulse(-jt, c.rA + A->get_center_of_mass());
+				bodies.apply_impulse(a, -jt, c.rA + bodies.get_center_of_mass(a));
 			}
 			if (collide_B) {
-				B->apply_impulse(jt, c.rB + B->get_center_of_mass());
+				bodies.apply_impulse(b, jt, c.rB + bodies.get_center_of_mass(b));
 			}
 			c.acc_impulse -= jt;
 
@@ -588,6 +585,94 @@ void GodotBodyPair3D::solve(real_t p_step) {
 	}
 }
 
+// Fields are copied one by one, so no padding bytes end up in the snapshot.
+// Only for types without padding of their own.
+template <typename T>
+static _FORCE_INLINE_ void _save_cached_field(const T &p_value, uint8_t *&r_w) {
+	memcpy(r_w, &p_value, sizeof(T));
+	r_w += sizeof(T);
+}
+
+template <typename T>
+static _FORCE_INLINE_ void _load_cached_field(T &r_value, const uint8_t *&r_r) {
+	memcpy(&r_value, r_r, sizeof(T));
+	r_r += sizeof(T);
+}
+
+void GodotBodyPair3D::save_cached_state(uint8_t *r_buffer) const {
+	uint8_t *w = r_buffer;
+	_save_cached_field(sep_axis, w);
+	_save_cached_field(collided, w);
+	_save_cached_field(contact_count, w);
+	for (int i = 0; i < MAX_CONTACTS; i++) {
+		// Unused slots are saved too, so the state always has the same size.
+		const Contact c = i < contact_count ? contacts[i] : Contact();
+		_save_cached_field(c.position, w);
+		_save_cached_field(c.normal, w);
+		_save_cached_field(c.index_A, w);
+		_save_cached_field(c.index_B, w);
+		_save_cached_field(c.local_A, w);
+		_save_cached_field(c.local_B, w);
+		_save_cached_field(c.acc_impulse, w);
+		_save_cached_field(c.acc_normal_impulse, w);
+		_save_cached_field(c.acc_tangent_impulse, w);
+		_save_cached_field(c.acc_bias_impulse, w);
+		_save_cached_field(c.acc_bias_impulse_center_of_mass, w);
+		_save_cached_field(c.mass_normal, w);
+		_save_cached_field(c.bias, w);
+		_save_cached_field(c.bounce, w);
+		_save_cached_field(c.depth, w);
+		_save_cached_field(c.active, w);
+		_save_cached_field(c.used, w);
+		_save_cached_field(c.rA, w);
+		_save_cached_field(c.rB, w);
+	}
+	DEV_ASSERT(w == r_buffer + CACHED_STATE_SIZE);
+}
+
+void GodotBodyPair3D::load_cached_state(const uint8_t *p_buffer) {
+	const uint8_t *r = p_buffer;
+	Vector3 state_sep_axis;
+	bool state_collided = false;
+	int state_contact_count = 0;
+	_load_cached_field(state_sep_axis, r);
+	_load_cached_field(state_collided, r);
+	_load_cached_field(state_contact_count, r);
+	ERR_FAIL_INDEX(state_contact_count, MAX_CONTACTS + 1);
+
+	sep_axis = state_sep_axis;
+	collided = state_collided;
+	contact_count = state_contact_count;
+	for (int i = 0; i < contact_count; i++) {
+		Contact &c = contacts[i];
+		_load_cached_field(c.position, r);
+		_load_cached_field(c.normal, r);
+		_load_cached_field(c.index_A, r);
+		_load_cached_field(c.index_B, r);
+		_load_cached_field(c.local_A, r);
+		_load_cached_field(c.local_B, r);
+		_load_cached_field(c.acc_impulse, r);
+		_load_cached_field(c.acc_normal_impulse, r);
+		_load_cached_field(c.acc_tangent_impulse, r);
+		_load_cached_field(c.acc_bias_impulse, r);
+		_load_cached_field(c.acc_bias_impulse_center_of_mass, r);
+		_load_cached_field(c.mass_normal, r);
+		_load_cached_field(c.bias, r);
+		_load_cached_field(c.bounce, r);
+		_load_cached_field(c.depth, r);
+		_load_cached_field(c.active, r);
+		_load_cached_field(c.used, r);
+		_load_cached_field(c.rA, r);
+		_load_cached_field(c.rB, r);
+	}
+}
+
+void GodotBodyPair3D::clear_cached_state() {
+	sep_axis = Vector3();
+	collided = false;
+	contact_count = 0;
+}
+
 GodotBodyPair3D::GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B) :
 		GodotBodyContact3D(_arr, 2) {
 	A = p_A;
@@ -34,6 +34,7 @@
 #include "godot_body_3d.h"
 #include "godot_constraint_3d.h"
 #include "godot_soft_body_3d.h"
+#include "godot_solver_bodies_3d.h"
 
 #include "core/templates/local_vector.h"
 
@@ -94,19 +95,39 @@ class GodotBodyPair3D : public GodotBodyContact3D {
 
 	Vector3 offset_B; //use local A coordinates to avoid numerical issues on collision detection
 
+	real_t combined_friction = 0.0;
+
+	GodotSolverBodies3D *solver_bodies = nullptr;
+	uint32_t solver_index_A = 0;
+	uint32_t solver_index_B = 0;
+
 	Contact contacts[MAX_CONTACTS];
 	int contact_count = 0;
 
+	// Cached state saved field by field: separating axis, collided, contact count, then every contact slot.
+	static constexpr uint32_t CONTACT_STATE_SIZE = sizeof(Vector3) * 8 + sizeof(int) * 2 + sizeof(real_t) * 7 + sizeof(bool) * 2;
+	static constexpr uint32_t CACHED_STATE_SIZE = sizeof(Vector3) + sizeof(bool) + sizeof(int) + CONTACT_STATE_SIZE * MAX_CONTACTS;
+
 	static void _contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal, void *p_userdata);
+	static void _narrow_phase_finished(bool p_collided, void *p_userdata);
 
 	void contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal);
 
 	void validate_contacts();
+	bool _collision_solved();
 	bool _test_ccd(real_t p_step, GodotBody3D *p_A, int p_shape_A, const Transform3D &p_xform_A, GodotBody3D *p_B, int p_shape_B, const Transform3D &p_xform_B);
 
 public:
+	virtual uint64_t get_order_key() const override { return ((uint64_t)shape_A << 32) | (uint32_t)shape_B; }
+	virtual uint32_t get_cached_state_size() const override { return CACHED_STATE_SIZE; }
+	virtual void save_cached_state(uint8_t *r_buffer) const override;
+	virtual void load_cached_state(const uint8_t *p_buffer) override;
+	virtual void clear_cached_state() override;
+
 	virtual bool setup(real_t p_step) override;
+	virtual bool setup_batched(real_t p_step, GodotNarrowPhase3D *p_narrow_phase) override;
 	virtual bool pre_solve(real_t p_step) override;
+	virtual bool bind_solver_bodies(GodotSolverBodies3D *p_solver_bodies) override;
 	virtual void solve(real_t p_step) override;
 
 	GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B);
@@ -586,3 +586,122 @@ bool GodotCollisionSolver3D::solve_distance(const GodotShape3D *p_shape_A, const
 		return gjk_epa_calculate_distance(p_shape_A, p_transform_A, p_shape_B, p_transform_B, r_point_A, r_point_B); //should pass sepaxis..
 	}
 }
+
+struct _ConcaveTimeOfImpactInfo {
+	const Transform3D *transform_A = nullptr;
+	const GodotShape3D *shape_A = nullptr;
+	const Transform3D *transform_B = nullptr;
+	Vector3 motion;
+	real_t tolerance = 0.0;
+	bool hit = false;
+	real_t toi = 1.0;
+	Vector3 point_A;
+	Vector3 point_B;
+};
+
+bool GodotCollisionSolver3D::concave_time_of_impact_callback(void *p_userdata, GodotShape3D *p_convex) {
+	_ConcaveTimeOfImpactInfo &tinfo = *(static_cast<_ConcaveTimeOfImpactInfo *>(p_userdata));
+
+	real_t toi = 1.0;
+	Vector3 point_A, point_B;
+	if (solve_convex_time_of_impact(tinfo.shape_A, *tinfo.transform_A, tinfo.motion, p_convex, *tinfo.transform_B, tinfo.tolerance, toi, point_A, point_B)) {
+		if (!tinfo.hit || toi < tinfo.toi) {
+			tinfo.hit = true;
+			tinfo.toi = toi;
+			tinfo.point_A = point_A;
+			tinfo.point_B = point_B;
+		}
+	}
+
+	return false;
+}
+
+bool GodotCollisionSolver3D::solve_convex_time_of_impact(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const Vector3 &p_motion, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, real_t p_tolerance, real_t &r_toi, Vector3 &r_point_A, Vector3 &r_point_B) {
+	static const int max_iterations = 32;
+
+	// Conservative advancement: the closest points define a plane separating both shapes,
+	// so A can always travel up to that plane along the motion without touching B.
+	real_t toi = 0.0;
+	// Last fraction where the shapes were still apart, and their closest points there.
+	real_t separated_toi = 0.0;
+	Vector3 point_A, point_B;
+	Transform3D transform_A = p_transform_A;
+	for (int i = 0; i < max_iterations; i++) {
+		Vector3 closest_A, closest_B;
+		if (!solve_distance(p_shape_A, transform_A, p_shape_B, p_transform_B, closest_A, closest_B, AABB())) {
+			if (i == 0) {
+				return false; // Already overlapping, this is handled by regular contacts.
+			}
+			break; // Numerical overshoot into B, keep the last separated fraction.
+		}
+		separated_toi = toi;
+		point_A = closest_A;
+		point_B = closest_B;
+
+		Vector3 separation = point_B - point_A;
+		real_t distance = separation.length();
+		if (distance <= p_tolerance) {
+			break;
+		}
+
+		real_t approach = p_motion.dot(separation / distance);
+		if (approach <= CMP_EPSILON) {
+			return false; // Moving away from or parallel to B.
+		}
+
+		toi += distance / approach;
+		if (toi > 1.0) {
+			return false;
+		}
+
+		transform_A.origin = p_transform_A.origin + p_motion * toi;
+	}
+
+	r_toi = separated_toi;
+	r_point_A = point_A;
+	r_point_B = point_B;
+	return true;
+}
+
+bool GodotCollisionSolver3D::solve_time_of_impact(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const Vector3 &p_motion, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, real_t p_tolerance, real_t &r_toi, Vector3 &r_point_A, Vector3 &r_point_B) {
+	if (p_shape_A->is_concave() || p_shape_A->get_type() == PhysicsServer3D::SHAPE_WORLD_BOUNDARY) {
+		return false;
+	}
+
+	AABB motion_aabb = p_transform_A.xform(p_shape_A->get_aabb());
+	motion_aabb = motion_aabb.merge(AABB(motion_aabb.position + p_motion, motion_aabb.size));
+
+	// Reject early if A swept along the whole motion doesn't reach B, same as in cast_motion.
+	GodotMotionShape3D mshape;
+	mshape.shape = const_cast<GodotShape3D *>(p_shape_A);
+	mshape.motion = p_transform_A.affine_inverse().basis.xform(p_motion);
+
+	Vector3 point_A, point_B;
+	if (solve_distance(&mshape, p_transform_A, p_shape_B, p_transform_B, point_A, point_B, motion_aabb)) {
+		return false;
+	}
+
+	if (!p_shape_B->is_concave()) {
+		return solve_convex_time_of_impact(p_shape_A, p_transform_A, p_motion, p_shape_B, p_transform_B, p_tolerance, r_toi, r_point_A, r_point_B);
+	}
+
+	// Sweep against every face touched by the motion and keep the earliest impact.
+	const GodotConcaveShape3D *concave_B = static_cast<const GodotConcaveShape3D *>(p_shape_B);
+
+	_ConcaveTimeOfImpactInfo tinfo;
+	tinfo.transform_A = &p_transform_A;
+	tinfo.shape_A = p_shape_A;
+	tinfo.transform_B = &p_transform_B;
+	tinfo.motion = p_motion;
+	tinfo.tolerance = p_tolerance;
+
+	concave_B->cull(p_transform_B.affine_inverse().xform(motion_aabb), concave_time_of_impact_callback, &tinfo, false);
+	if (!tinfo.hit) {
+		return false;
+	}
+
+	r_toi = tinfo.toi;
+	r_point_A = tinfo.point_A;
+	r_point_B = tinfo.point_B;
+	return true;
+}
@@ -32,7 +32,9 @@
 #define GODOT_CONSTRAINT_3D_H
 
 class GodotBody3D;
+class GodotNarrowPhase3D;
 class GodotSoftBody3D;
+class GodotSolverBodies3D;
 
 class GodotConstraint3D {
 	GodotBody3D **_body_ptr;
@@ -71,8 +73,23 @@ public:
 	_FORCE_INLINE_ void disable_collisions_between_bodies(const bool p_disabled) { disabled_collisions_between_bodies = p_disabled; }
 	_FORCE_INLINE_ bool is_disabled_collisions_between_bodies() const { return disabled_collisions_between_bodies; }
 
+	// Tells apart constraints between the same bodies.
+	virtual uint64_t get_order_key() const { return self.get_id(); }
+
+	// Solver state kept between steps (e.g. contacts for warm starting), saved in space snapshots.
+	virtual uint32_t get_cached_state_size() const { return 0; }
+	virtual void save_cached_state(uint8_t *r_buffer) const {}
+	virtual void load_cached_state(const uint8_t *p_buffer) {}
+	virtual void clear_cached_state() {}
+
 	virtual bool setup(real_t p_step) = 0;
+	// Collision queries can be added to p_narrow_phase instead of being solved
+	// immediately, in which case their results are only valid after it is solved.
+	virtual bool setup_batched(real_t p_step, GodotNarrowPhase3D *p_narrow_phase) { return setup(p_step); }
 	virtual bool pre_solve(real_t p_step) = 0;
+	// Called after pre_solve(). Constraints that return true read and write the
+	// state of their bodies in p_solver_bodies when solving, others use the bodies.
+	virtual bool bind_solver_bodies(GodotSolverBodies3D *p_solver_bodies) { return false; }
 	virtual void solve(real_t p_step) = 0;
 
 	virtual ~GodotConstraint3D() {}
@@ -0,0 +1,541 @@
+/**************************************************************************/
+/*  godot_narrow_phase_3d.cpp                                             */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "godot_narrow_phase_3d.h"
+
+// The kernels below process LANE_COUNT pairs per call with the same
+// instructions for every lane, so the loops over the lanes can be vectorized.
+// Unused lanes are filled with copies of the last query by _solve_lanes().
+
+// Same as the edge support threshold of the capsule shape: capsules whose
+// axes are closer to parallel than this touch along a line in the SAT solver.
+static constexpr real_t CAPSULE_PARALLEL_THRESHOLD = 0.0002;
+
+real_t GodotNarrowPhase3D::_get_box_radius(const Lanes &p_box, int p_lane, real_t p_axis_x, real_t p_axis_y, real_t p_axis_z) {
+	real_t radius = 0;
+	for (int k = 0; k < 3; k++) {
+		radius += p_box.size[k][p_lane] * Math::abs(p_axis_x * p_box.axis[k][0][p_lane] + p_axis_y * p_box.axis[k][1][p_lane] + p_axis_z * p_box.axis[k][2][p_lane]);
+	}
+	return radius;
+}
+
+void GodotNarrowPhase3D::_test_box_axes(const real_t (&p_axis)[3][LANE_COUNT], const real_t (&p_offset)[3][LANE_COUNT], const Lanes &p_A, const Lanes &p_B, bool *r_separated) {
+	for (int i = 0; i < LANE_COUNT; i++) {
+		real_t x = p_axis[0][i];
+		real_t y = p_axis[1][i];
+		real_t z = p_axis[2][i];
+		// Axes don't need to be normalized, both sides of the test scale with them.
+		real_t distance = Math::abs(x * p_offset[0][i] + y * p_offset[1][i] + z * p_offset[2][i]);
+		bool separating = x * x + y * y + z * z > CMP_EPSILON && distance > _get_box_radius(p_A, i, x, y, z) + _get_box_radius(p_B, i, x, y, z);
+		r_separated[i] = r_separated[i] || separating;
+	}
+}
+
+void GodotNarrowPhase3D::_load_lane(Lanes &r_lanes, int p_lane, const GodotShape3D *p_shape, const Transform3D &p_transform) {
+	real_t scale[3];
+	for (int i = 0; i < 3; i++) {
+		Vector3 column = p_transform.basis.get_column(i);
+		scale[i] = column.length();
+		if (scale[i] > 0) {
+			column /= scale[i];
+		}
+		for (int j = 0; j < 3; j++) {
+			r_lanes.axis[i][j][p_lane] = column[j];
+		}
+		r_lanes.origin[i][p_lane] = p_transform.origin[i];
+		r_lanes.size[i][p_lane] = 0;
+	}
+
+	switch (p_shape->get_type()) {
+		case PhysicsServer3D::SHAPE_SPHERE: {
+			const GodotSphereShape3D *sphere = static_cast<const GodotSphereShape3D *>(p_shape);
+			r_lanes.size[0][p_lane] = sphere->get_radius() * scale[0];
+		} break;
+		case PhysicsServer3D::SHAPE_BOX: {
+			const GodotBoxShape3D *box = static_cast<const GodotBoxShape3D *>(p_shape);
+			Vector3 half_extents = box->get_half_extents();
+			for (int i = 0; i < 3; i++) {
+				r_lanes.size[i][p_lane] = half_extents[i] * scale[i];
+			}
+		} break;
+		case PhysicsServer3D::SHAPE_CAPSULE: {
+			const GodotCapsuleShape3D *capsule = static_cast<const GodotCapsuleShape3D *>(p_shape);
+			r_lanes.size[0][p_lane] = capsule->get_radius() * scale[0];
+			r_lanes.size[1][p_lane] = MAX(capsule->get_height() * 0.5 - capsule->get_radius(), 0) * scale[1];
+		} break;
+		default: {
+			ERR_FAIL_MSG("Unsupported shape type in narrow phase batch.");
+		}
+	}
+}
+
+void GodotNarrowPhase3D::_solve_sphere_sphere(const Lanes &p_A, const Lanes &p_B, Results &r_results) {
+	for (int i = 0; i < LANE_COUNT; i++) {
+		real_t dx = p_B.origin[0][i] - p_A.origin[0][i];
+		real_t dy = p_B.origin[1][i] - p_A.origin[1][i];
+		real_t dz = p_B.origin[2][i] - p_A.origin[2][i];
+		real_t radius = p_A.size[0][i] + p_B.size[0][i];
+		r_results.overlap[i] = dx * dx + dy * dy + dz * dz <= radius * radius;
+	}
+	for (int j = 0; j < 3; j++) {
+		for (int i = 0; i < LANE_COUNT; i++) {
+			r_results.point_A[j][i] = p_A.origin[j][i];
+			r_results.point_B[j][i] = p_B.origin[j][i];
+		}
+	}
+}
+
+void GodotNarrowPhase3D::_solve_sphere_box(const Lanes &p_A, const Lanes &p_B, Results &r_results) {
+	for (int i = 0; i < LANE_COUNT; i++) {
+		real_t dx = p_A.origin[0][i] - p_B.origin[0][i];
+		real_t dy = p_A.origin[1][i] - p_B.origin[1][i];
+		real_t dz = p_A.origin[2][i] - p_B.origin[2][i];
+
+		// Find the point of the box nearest to the center of the sphere.
+		real_t nx = p_B.origin[0][i];
+		real_t ny = p_B.origin[1][i];
+		real_t nz = p_B.origin[2][i];
+		for (int k = 0; k < 3; k++) {
+			real_t t = dx * p_B.axis[k][0][i] + dy * p_B.axis[k][1][i] + dz * p_B.axis[k][2][i];
+			t = CLAMP(t, -p_B.size[k][i], p_B.size[k][i]);
+			nx += p_B.axis[k][0][i] * t;
+			ny += p_B.axis[k][1][i] * t;
+			nz += p_B.axis[k][2][i] * t;
+		}
+
+		real_t ox = p_A.origin[0][i] - nx;
+		real_t oy = p_A.origin[1][i] - ny;
+		real_t oz = p_A.origin[2][i] - nz;
+		r_results.overlap[i] = ox * ox + oy * oy + oz * oz <= p_A.size[0][i] * p_A.size[0][i];
+	}
+}
+
+void GodotNarrowPhase3D::_solve_sphere_capsule(const Lanes &p_A, const Lanes &p_B, Results &r_results) {
+	for (int i = 0; i < LANE_COUNT; i++) {
+		real_t dx = p_A.origin[0][i] - p_B.origin[0][i];
+		real_t dy = p_A.origin[1][i] - p_B.origin[1][i];
+		real_t dz = p_A.origin[2][i] - p_B.origin[2][i];
+
+		// Find the point of the capsule segment nearest to the center of the sphere.
+		real_t t = dx * p_B.axis[1][0][i] + dy * p_B.axis[1][1][i] + dz * p_B.axis[1][2][i];
+		t = CLAMP(t, -p_B.size[1][i], p_B.size[1][i]);
+		real_t nx = p_B.origin[0][i] + p_B.axis[1][0][i] * t;
+		real_t ny = p_B.origin[1][i] + p_B.axis[1][1][i] * t;
+		real_t nz = p_B.origin[2][i] + p_B.axis[1][2][i] * t;
+
+		real_t ox = p_A.origin[0][i] - nx;
+		real_t oy = p_A.origin[1][i] - ny;
+		real_t oz = p_A.origin[2][i] - nz;
+		real_t radius = p_A.size[0][i] + p_B.size[0][i];
+		r_results.overlap[i] = ox * ox + oy * oy + oz * oz <= radius * radius;
+
+		r_results.point_A[0][i] = p_A.origin[0][i];
+		r_results.point_A[1][i] = p_A.origin[1][i];
+		r_results.point_A[2][i] = p_A.origin[2][i];
+		r_results.point_B[0][i] = nx;
+		r_results.point_B[1][i] = ny;
+		r_results.point_B[2][i] = nz;
+	}
+}
+
+void GodotNarrowPhase3D::_solve_capsule_capsule(const Lanes &p_A, const Lanes &p_B, Results &r_results) {
+	for (int i = 0; i < LANE_COUNT; i++) {
+		// Segments go from p1 to p1 + d1 and from p2 to p2 + d2.
+		real_t half_A = p_A.size[1][i];
+		real_t half_B = p_B.size[1][i];
+		real_t p1x = p_A.origin[0][i] - p_A.axis[1][0][i] * half_A;
+		real_t p1y = p_A.origin[1][i] - p_A.axis[1][1][i] * half_A;
+		real_t p1z = p_A.origin[2][i] - p_A.axis[1][2][i] * half_A;
+		real_t d1x = p_A.axis[1][0][i] * half_A * 2;
+		real_t d1y = p_A.axis[1][1][i] * half_A * 2;
+		real_t d1z = p_A.axis[1][2][i] * half_A * 2;
+		real_t p2x = p_B.origin[0][i] - p_B.axis[1][0][i] * half_B;
+		real_t p2y = p_B.origin[1][i] - p_B.axis[1][1][i] * half_B;
+		real_t p2z = p_B.origin[2][i] - p_B.axis[1][2][i] * half_B;
+		real_t d2x = p_B.axis[1][0][i] * half_B * 2;
+		real_t d2y = p_B.axis[1][1][i] * half_B * 2;
+		real_t d2z = p_B.axis[1][2][i] * half_B * 2;
+		real_t rx = p1x - p2x;
+		real_t ry = p1y - p2y;
+		real_t rz = p1z - p2z;
+
+		real_t a = d1x * d1x + d1y * d1y + d1z * d1z;
+		real_t b = d1x * d2x + d1y * d2y + d1z * d2z;
+		real_t c = d1x * rx + d1y * ry + d1z * rz;
+		real_t e = d2x * d2x + d2y * d2y + d2z * d2z;
+		real_t f = d2x * rx + d2y * ry + d2z * rz;
+		real_t denom = a * e - b * b;
+
+		// Closest points between the segment lines, clamped to the segments.
+		// Parallel and degenerate segments use the start of the first segment.
+		real_t inv_a = a > 0 ? (real_t)1.0 / a : 0;
+		real_t inv_e = e > 0 ? (real_t)1.0 / e : 0;
+		real_t s = denom > CMP_EPSILON * a * e ? CLAMP((b * f - c * e) / denom, 0, 1) : 0;
+		real_t t = (b * s + f) * inv_e;
+		real_t t_clamped = CLAMP(t, 0, 1);
+		s = t != t_clamped ? CLAMP((b * t_clamped - c) * inv_a, 0, 1) : s;
+
+		real_t ax = p1x + d1x * s;
+		real_t ay = p1y + d1y * s;
+		real_t az = p1z + d1z * s;
+		real_t bx = p2x + d2x * t_clamped;
+		real_t by = p2y + d2y * t_clamped;
+		real_t bz = p2z + d2z * t_clamped;
+
+		real_t ox = bx - ax;
+		real_t oy = by - ay;
+		real_t oz = bz - az;
+		real_t radius = p_A.size[0][i] + p_B.size[0][i];
+		r_results.overlap[i] = ox * ox + oy * oy + oz * oz <= radius * radius;
+
+		// Parallel capsules side by side touch along the overlap of their
+		// segments. Report both ends of it, projected from A onto B.
+		real_t uAx = p_A.axis[1][0][i];
+		real_t uAy = p_A.axis[1][1][i];
+		real_t uAz = p_A.axis[1][2][i];
+		real_t uBx = p_B.axis[1][0][i];
+		real_t uBy = p_B.axis[1][1][i];
+		real_t uBz = p_B.axis[1][2][i];
+		real_t cx = uAy * uBz - uAz * uBy;
+		real_t cy = uAz * uBx - uAx * uBz;
+		real_t cz = uAx * uBy - uAy * uBx;
+		real_t ex = p_B.origin[0][i] - p_A.origin[0][i];
+		real_t ey = p_B.origin[1][i] - p_A.origin[1][i];
+		real_t ez = p_B.origin[2][i] - p_A.origin[2][i];
+		real_t center_B = ex * uAx + ey * uAy + ez * uAz;
+		real_t extent_B = half_B * Math::abs(uAx * uBx + uAy * uBy + uAz * uBz);
+		real_t low = MAX(-half_A, center_B - extent_B);
+		real_t high = MIN(half_A, center_B + extent_B);
+		real_t lx = ex - uAx * center_B;
+		real_t ly = ey - uAy * center_B;
+		real_t lz = ez - uAz * center_B;
+		bool parallel = cx * cx + cy * cy + cz * cz < CAPSULE_PARALLEL_THRESHOLD * CAPSULE_PARALLEL_THRESHOLD;
+		// Coaxial capsules have no side to push along, they keep the single contact.
+		bool second = parallel && high - low > CMP_EPSILON && lx * lx + ly * ly + lz * lz > CMP_EPSILON;
+
+		real_t low_x = p_A.origin[0][i] + uAx * low;
+		real_t low_y = p_A.origin[1][i] + uAy * low;
+		real_t low_z = p_A.origin[2][i] + uAz * low;
+		real_t high_x = p_A.origin[0][i] + uAx * high;
+		real_t high_y = p_A.origin[1][i] + uAy * high;
+		real_t high_z = p_A.origin[2][i] + uAz * high;
+		real_t low_t = CLAMP((low_x - p_B.origin[0][i]) * uBx + (low_y - p_B.origin[1][i]) * uBy + (low_z - p_B.origin[2][i]) * uBz, -half_B, half_B);
+		real_t high_t = CLAMP((high_x - p_B.origin[0][i]) * uBx + (high_y - p_B.origin[1][i]) * uBy + (high_z - p_B.origin[2][i]) * uBz, -half_B, half_B);
+
+		r_results.has_second_point[i] = second;
+		r_results.point_A[0][i] = second ? low_x : ax;
+		r_results.point_A[1][i] = second ? low_y : ay;
+		r_results.point_A[2][i] = second ? low_z : az;
+		r_results.point_B[0][i] = second ? p_B.origin[0][i] + uBx * low_t : bx;
+		r_results.point_B[1][i] = second ? p_B.origin[1][i] + uBy * low_t : by;
+		r_results.point_B[2][i] = second ? p_B.origin[2][i] + uBz * low_t : bz;
+		r_results.second_point_A[0][i] = high_x;
+		r_results.second_point_A[1][i] = high_y;
+		r_results.second_point_A[2][i] = high_z;
+		r_results.second_point_B[0][i] = p_B.origin[0][i] + uBx * high_t;
+		r_results.second_point_B[1][i] = p_B.origin[1][i] + uBy * high_t;
+		r_results.second_point_B[2][i] = p_B.origin[2][i] + uBz * high_t;
+	}
+}
+
+void GodotNarrowPhase3D::_solve_box_box(const Lanes &p_A, const Lanes &p_B, Results &r_results) {
+	real_t offset[3][LANE_COUNT];
+	for (int j = 0; j < 3; j++) {
+		for (int i = 0; i < LANE_COUNT; i++) {
+			offset[j][i] = p_B.origin[j][i] - p_A.origin[j][i];
+		}
+	}
+	for (int i = 0; i < LANE_COUNT; i++) {
+		r_results.overlap[i] = false; // Used as the separated flag until the end.
+	}
+
+	// Face normals of both boxes, then the cross products of their edges.
+	for (int k = 0; k < 3; k++) {
+		_test_box_axes(p_A.axis[k], offset, p_A, p_B, r_results.overlap);
+		_test_box_axes(p_B.axis[k], offset, p_A, p_B, r_results.overlap);
+	}
+	real_t axis[3][LANE_COUNT];
+	for (int k = 0; k < 3; k++) {
+		for (int l = 0; l < 3; l++) {
+			for (int i = 0; i < LANE_COUNT; i++) {
+				axis[0][i] = p_A.axis[k][1][i] * p_B.axis[l][2][i] - p_A.axis[k][2][i] * p_B.axis[l][1][i];
+				axis[1][i] = p_A.axis[k][2][i] * p_B.axis[l][0][i] - p_A.axis[k][0][i] * p_B.axis[l][2][i];
+				axis[2][i] = p_A.axis[k][0][i] * p_B.axis[l][1][i] - p_A.axis[k][1][i] * p_B.axis[l][0][i];
+			}
+			_test_box_axes(axis, offset, p_A, p_B, r_results.overlap);
+		}
+	}
+
+	for (int i = 0; i < LANE_COUNT; i++) {
+		r_results.overlap[i] = !r_results.overlap[i];
+	}
+}
+
+void GodotNarrowPhase3D::_solve_box_capsule(const Lanes &p_A, const Lanes &p_B, Results &r_results) {
+	// Face normals of the box, the capsule axis, and the cross products of
+	// the box edges with the capsule axis. Axes against the capsule ends are
+	// not tested, so pairs that pass can still be separated and are left to
+	// the full solver.
+	for (int i = 0; i < LANE_COUNT; i++) {
+		real_t ox = p_B.origin[0][i] - p_A.origin[0][i];
+		real_t oy = p_B.origin[1][i] - p_A.origin[1][i];
+		real_t oz = p_B.origin[2][i] - p_A.origin[2][i];
+		real_t cx = p_B.axis[1][0][i];
+		real_t cy = p_B.axis[1][1][i];
+		real_t cz = p_B.axis[1][2][i];
+		real_t radius = p_B.size[0][i];
+		real_t half_segment = p_B.size[1][i];
+
+		bool separated = cx * cx + cy * cy + cz * cz > CMP_EPSILON && Math::abs(cx * ox + cy * oy + cz * oz) > _get_box_radius(p_A, i, cx, cy, cz) + half_segment + radius;
+		for (int k = 0; k < 3; k++) {
+			real_t fx = p_A.axis[k][0][i];
+			real_t fy = p_A.axis[k][1][i];
+			real_t fz = p_A.axis[k][2][i];
+			real_t face_distance = Math::abs(fx * ox + fy * oy + fz * oz);
+			bool face_separating = fx * fx + fy * fy + fz * fz > CMP_EPSILON && face_distance > p_A.size[k][i] + half_segment * Math::abs(cx * fx + cy * fy + cz * fz) + radius;
+
+			real_t ax = fy * cz - fz * cy;
+			real_t ay = fz * cx - fx * cz;
+			real_t az = fx * cy - fy * cx;
+			real_t length_squared = ax * ax + ay * ay + az * az;
+			real_t edge_distance = Math::abs(ax * ox + ay * oy + az * oz);
+			bool edge_separating = length_squared > CMP_EPSILON && edge_distance > _get_box_radius(p_A, i, ax, ay, az) + radius * Math::sqrt(length_squared);
+
+			separated = separated || face_separating || edge_separating;
+		}
+
+		r_results.overlap[i] = !separated;
+	}
+}
+
+void GodotNarrowPhase3D::_report_sphere_contact(const Query &p_query, const Vector3 &p_center_A, real_t p_radius_A, const Vector3 &p_center_B, real_t p_radius_B) {
+	if (!p_query.result_callback) {
+		return;
+	}
+
+	// Same as the analytic sphere collision of the SAT solver.
+	Vector3 b_to_a = p_center_A - p_center_B;
+	real_t b_to_a_len = b_to_a.length();
+	real_t overlap = p_radius_A + p_radius_B - b_to_a_len;
+
+	if (b_to_a_len < CMP_EPSILON) {
+		b_to_a = Vector3(0, 1, 0); // Spheres coincident, use arbitrary direction.
+	} else {
+		b_to_a /= b_to_a_len;
+	}
+
+	Vector3 point_A;
+	Vector3 point_B;
+	if (p_radius_A < p_radius_B) {
+		point_A = p_center_A - b_to_a * p_radius_A;
+		point_B = point_A + b_to_a * overlap;
+	} else {
+		point_B = p_center_B + b_to_a * p_radius_B;
+		point_A = point_B - b_to_a * overlap;
+	}
+
+	Vector3 normal = b_to_a;
+	if (normal.dot(point_B - point_A) < 0) {
+		normal = -normal;
+	}
+
+	if (p_query.swap) {
+		p_query.result_callback(point_B, 0, point_A, 0, -normal, p_query.userdata);
+	} else {
+		p_query.result_callback(point_A, 0, point_B, 0, normal, p_query.userdata);
+	}
+}
+
+void GodotNarrowPhase3D::_solve_lanes(PairType p_type, const Query *p_queries, int p_count) {
+	Lanes lanes_A;
+	Lanes lanes_B;
+	for (int i = 0; i < LANE_COUNT; i++) {
+		const Query &query = p_queries[MIN(i, p_count - 1)];
+		_load_lane(lanes_A, i, query.shape_A, query.transform_A);
+		_load_lane(lanes_B, i, query.shape_B, query.transform_B);
+	}
+
+	Results results;
+	for (int i = 0; i < LANE_COUNT; i++) {
+		results.has_second_point[i] = false;
+	}
+	bool sphere_like = false;
+	switch (p_type) {
+		case PAIR_SPHERE_SPHERE: {
+			_solve_sphere_sphere(lanes_A, lanes_B, results);
+			sphere_like = true;
+		} break;
+		case PAIR_SPHERE_BOX: {
+			_solve_sphere_box(lanes_A, lanes_B, results);
+		} break;
+		case PAIR_SPHERE_CAPSULE: {
+			_solve_sphere_capsule(lanes_A, lanes_B, results);
+			sphere_like = true;
+		} break;
+		case PAIR_BOX_BOX: {
+			_solve_box_box(lanes_A, lanes_B, results);
+		} break;
+		case PAIR_BOX_CAPSULE: {
+			_solve_box_capsule(lanes_A, lanes_B, results);
+		} break;
+		case PAIR_CAPSULE_CAPSULE: {
+			_solve_capsule_capsule(lanes_A, lanes_B, results);
+			sphere_like = true;
+		} break;
+		default: {
+			ERR_FAIL_MSG("Invalid narrow phase pair type.");
+		}
+	}
+
+	for (int i = 0; i < p_count; i++) {
+		const Query &query = p_queries[i];
+		bool collided = false;
+
+		if (results.overlap[i]) {
+			if (sphere_like) {
+				Vector3 point_A(results.point_A[0][i], results.point_A[1][i], results.point_A[2][i]);
+				Vector3 point_B(results.point_B[0][i], results.point_B[1][i], results.point_B[2][i]);
+				_report_sphere_contact(query, point_A, lanes_A.size[0][i], point_B, lanes_B.size[0][i]);
+				if (results.has_second_point[i]) {
+					Vector3 second_point_A(results.second_point_A[0][i], results.second_point_A[1][i], results.second_point_A[2][i]);
+					Vector3 second_point_B(results.second_point_B[0][i], results.second_point_B[1][i], results.second_point_B[2][i]);
+					_report_sphere_contact(query, second_point_A, lanes_A.size[0][i], second_point_B, lanes_B.size[0][i]);
+				}
+				collided = true;
+			} else if (query.swap) {
+				collided = GodotCollisionSolver3D::solve_static(query.shape_B, query.transform_B, query.shape_A, query.transform_A, query.result_callback, query.userdata, query.sep_axis);
+			} else {
+				collided = GodotCollisionSolver3D::solve_static(query.shape_A, query.transform_A, query.shape_B, query.transform_B, query.result_callback, query.userdata, query.sep_axis);
+			}
+		}
+
+		if (query.finished_callback) {
+			query.finished_callback(collided, query.userdata);
+		}
+	}
+}
+
+bool GodotNarrowPhase3D::get_pair_type(PhysicsServer3D::ShapeType p_type_A, PhysicsServer3D::ShapeType p_type_B, PairType &r_type) {
+	if (p_type_A > p_type_B) {
+		SWAP(p_type_A, p_type_B);
+	}
+
+	switch (p_type_A) {
+		case PhysicsServer3D::SHAPE_SPHERE: {
+			switch (p_type_B) {
+				case PhysicsServer3D::SHAPE_SPHERE: {
+					r_type = PAIR_SPHERE_SPHERE;
+					return true;
+				}
+				case PhysicsServer3D::SHAPE_BOX: {
+					r_type = PAIR_SPHERE_BOX;
+					return true;
+				}
+				case PhysicsServer3D::SHAPE_CAPSULE: {
+					r_type = PAIR_SPHERE_CAPSULE;
+					return true;
+				}
+				default: {
+					return false;
+				}
+			}
+		}
+		case PhysicsServer3D::SHAPE_BOX: {
+			switch (p_type_B) {
+				case PhysicsServer3D::SHAPE_BOX: {
+					r_type = PAIR_BOX_BOX;
+					return true;
+				}
+				case PhysicsServer3D::SHAPE_CAPSULE: {
+					r_type = PAIR_BOX_CAPSULE;
+					return true;
+				}
+				default: {
+					return false;
+				}
+			}
+		}
+		case PhysicsServer3D::SHAPE_CAPSULE: {
+			if (p_type_B == PhysicsServer3D::SHAPE_CAPSULE) {
+				r_type = PAIR_CAPSULE_CAPSULE;
+				return true;
+			}
+			return false;
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+bool GodotNarrowPhase3D::add_query(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, GodotCollisionSolver3D::CallbackResult p_result_callback, CallbackFinished p_finished_callback, void *p_userdata, Vector3 *r_sep_axis) {
+	PairType pair_type;
+	if (!get_pair_type(p_shape_A->get_type(), p_shape_B->get_type(), pair_type)) {
+		return false;
+	}
+
+	// Store the shapes in the order of the pair type.
+	Query query;
+	query.swap = p_shape_A->get_type() > p_shape_B->get_type();
+	query.shape_A = query.swap ? p_shape_B : p_shape_A;
+	query.shape_B = query.swap ? p_shape_A : p_shape_B;
+	query.transform_A = query.swap ? p_transform_B : p_transform_A;
+	query.transform_B = query.swap ? p_transform_A : p_transform_B;
+	query.result_callback = p_result_callback;
+	query.finished_callback = p_finished_callback;
+	query.userdata = p_userdata;
+	query.sep_axis = r_sep_axis;
+	queries[pair_type].push_back(query);
+
+	return true;
+}
+
+uint32_t GodotNarrowPhase3D::get_query_count() const {
+	uint32_t count = 0;
+	for (int i = 0; i < PAIR_TYPE_MAX; i++) {
+		count += queries[i].size();
+	}
+	return count;
+}
+
+void GodotNarrowPhase3D::solve() {
+	for (int type = 0; type < PAIR_TYPE_MAX; type++) {
+		const LocalVector<Query> &type_queries = queries[type];
+		for (uint32_t from = 0; from < type_queries.size(); from += LANE_COUNT) {
+			_solve_lanes(PairType(type), &type_queries[from], MIN((uint32_t)LANE_COUNT, type_queries.size() - from));
+		}
+	}
+}
+
+void GodotNarrowPhase3D::clear() {
+	for (int i = 0; i < PAIR_TYPE_MAX; i++) {
+		queries[i].clear();
+	}
+}
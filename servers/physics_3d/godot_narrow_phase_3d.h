@@ -0,0 +1,128 @@
+/**************************************************************************/
+/*  godot_narrow_phase_3d.h                                               */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_NARROW_PHASE_3D_H
+#define GODOT_NARROW_PHASE_3D_H
+
+#include "godot_collision_solver_3d.h"
+
+#include "core/templates/local_vector.h"
+
+// Collects collision queries between primitive shapes and solves them in
+// batches, several pairs at a time, using a structure of arrays layout.
+// Pairs that cannot collide are rejected by the batched kernels, and contacts
+// between sphere-like shapes (spheres and capsules) are generated directly
+// from the closest points they compute, with a second contact for parallel
+// capsules lying side by side. Other overlapping pairs fall back to
+// GodotCollisionSolver3D.
+class GodotNarrowPhase3D {
+public:
+	typedef void (*CallbackFinished)(bool p_collided, void *p_userdata);
+
+	enum PairType {
+		PAIR_SPHERE_SPHERE,
+		PAIR_SPHERE_BOX,
+		PAIR_SPHERE_CAPSULE,
+		PAIR_BOX_BOX,
+		PAIR_BOX_CAPSULE,
+		PAIR_CAPSULE_CAPSULE,
+		PAIR_TYPE_MAX,
+	};
+
+	enum {
+		LANE_COUNT = 8,
+	};
+
+private:
+	struct Query {
+		const GodotShape3D *shape_A = nullptr;
+		const GodotShape3D *shape_B = nullptr;
+		Transform3D transform_A;
+		Transform3D transform_B;
+		GodotCollisionSolver3D::CallbackResult result_callback = nullptr;
+		CallbackFinished finished_callback = nullptr;
+		void *userdata = nullptr;
+		Vector3 *sep_axis = nullptr;
+		bool swap = false;
+	};
+
+	// One shape per lane. Sizes are the sphere radius, the box half extents,
+	// or the capsule radius and half segment length, with the scale applied.
+	struct Lanes {
+		real_t origin[3][LANE_COUNT];
+		real_t axis[3][3][LANE_COUNT]; // Normalized basis columns.
+		real_t size[3][LANE_COUNT];
+	};
+
+	struct Results {
+		bool overlap[LANE_COUNT];
+		// Closest points between the cores of sphere-like shapes.
+		real_t point_A[3][LANE_COUNT];
+		real_t point_B[3][LANE_COUNT];
+		// Parallel capsules touch along a line, their contact gets a second
+		// pair of points at the other end of the segment overlap.
+		bool has_second_point[LANE_COUNT];
+		real_t second_point_A[3][LANE_COUNT];
+		real_t second_point_B[3][LANE_COUNT];
+	};
+
+	LocalVector<Query> queries[PAIR_TYPE_MAX];
+
+	static _FORCE_INLINE_ real_t _get_box_radius(const Lanes &p_box, int p_lane, real_t p_axis_x, real_t p_axis_y, real_t p_axis_z);
+	// Tests one axis per lane between the boxes in p_A and p_B.
+	static void _test_box_axes(const real_t (&p_axis)[3][LANE_COUNT], const real_t (&p_offset)[3][LANE_COUNT], const Lanes &p_A, const Lanes &p_B, bool *r_separated);
+
+	static void _load_lane(Lanes &r_lanes, int p_lane, const GodotShape3D *p_shape, const Transform3D &p_transform);
+
+	static void _solve_sphere_sphere(const Lanes &p_A, const Lanes &p_B, Results &r_results);
+	static void _solve_sphere_box(const Lanes &p_A, const Lanes &p_B, Results &r_results);
+	static void _solve_sphere_capsule(const Lanes &p_A, const Lanes &p_B, Results &r_results);
+	static void _solve_box_box(const Lanes &p_A, const Lanes &p_B, Results &r_results);
+	static void _solve_box_capsule(const Lanes &p_A, const Lanes &p_B, Results &r_results);
+	static void _solve_capsule_capsule(const Lanes &p_A, const Lanes &p_B, Results &r_results);
+
+	static void _report_sphere_contact(const Query &p_query, const Vector3 &p_center_A, real_t p_radius_A, const Vector3 &p_center_B, real_t p_radius_B);
+	static void _solve_lanes(PairType p_type, const Query *p_queries, int p_count);
+
+public:
+	static bool get_pair_type(PhysicsServer3D::ShapeType p_type_A, PhysicsServer3D::ShapeType p_type_B, PairType &r_type);
+
+	// Returns false if the shape pair is not supported, in which case the
+	// query must be solved with GodotCollisionSolver3D instead.
+	bool add_query(const GodotShape3D *p_shape_A, const Transform3D &p_transform_A, const GodotShape3D *p_shape_B, const Transform3D &p_transform_B, GodotCollisionSolver3D::CallbackResult p_result_callback, CallbackFinished p_finished_callback, void *p_userdata, Vector3 *r_sep_axis = nullptr);
+	uint32_t get_query_count() const;
+
+	// Solves all the queries, calling the result callback for each contact and
+	// then the finished callback once per query.
+	void solve();
+	void clear();
+};
+
+#endif // GODOT_NARROW_PHASE_3D_H
@@ -108,6 +108,13 @@ void GodotPhysicsServer3D::shape_set_data(RID p_shape, const Variant &p_data) {
 	shape->set_data(p_data);
 };
 
+void GodotPhysicsServer3D::heightmap_shape_update_region(RID p_shape, const Rect2i &p_region, const Vector<real_t> &p_heights) {
+	GodotShape3D *shape = shape_owner.get_or_null(p_shape);
+	ERR_FAIL_COND(!shape);
+	ERR_FAIL_COND(shape->get_type() != SHAPE_HEIGHTMAP);
+	static_cast<GodotHeightMapShape3D *>(shape)->update_region(p_region, p_heights);
+}
+
 void GodotPhysicsServer3D::shape_set_custom_solver_bias(RID p_shape, real_t p_bias) {
 	GodotShape3D *shape = shape_owner.get_or_null(p_shape);
 	ERR_FAIL_COND(!shape);
@@ -214,6 +221,20 @@ int GodotPhysicsServer3D::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+Vector<uint8_t> GodotPhysicsServer3D::space_save_snapshot(RID p_space) {
+	GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, Vector<uint8_t>());
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), Vector<uint8_t>(), "Space state is inaccessible right now, wait for iteration or physics process notification.");
+	return space->save_snapshot();
+}
+
+bool GodotPhysicsServer3D::space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) {
+	GodotSpace3D *space = space_owner.get_or_null(p_space);
+	ERR_FAIL_COND_V(!space, false);
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), false, "Space state is inaccessible right now, wait for iteration or physics process notification.");
+	return space->load_snapshot(p_snapshot);
+}
+
 RID GodotPhysicsServer3D::area_create() {
 	GodotArea3D *area = memnew(GodotArea3D);
 	RID rid = area_owner.make_rid(area);
@@ -1675,6 +1696,7 @@ void GodotPhysicsServer3D::flush_queries() {
 		uint64_t total_time[GodotSpace3D::ELAPSED_TIME_MAX];
 		static const char *time_name[GodotSpace3D::ELAPSED_TIME_MAX] = {
 			"integrate_forces",
+			"broadphase",
 			"generate_islands",
 			"setup_constraints",
 			"solve_constraints",
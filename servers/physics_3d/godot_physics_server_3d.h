@@ -91,6 +91,7 @@ public:
 	virtual RID custom_shape_create() override;
 
 	virtual void shape_set_data(RID p_shape, const Variant &p_data) override;
+	virtual void heightmap_shape_update_region(RID p_shape, const Rect2i &p_region, const Vector<real_t> &p_heights) override;
 	virtual void shape_set_custom_solver_bias(RID p_shape, real_t p_bias) override;
 
 	virtual ShapeType shape_get_type(RID p_shape) const override;
@@ -117,6 +118,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override;
 	virtual int space_get_contact_count(RID p_space) const override;
 
+	virtual Vector<uint8_t> space_save_snapshot(RID p_space) override;
+	virtual bool space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) override;
+
 	/* AREA API */
 
 	virtual RID area_create() override;
@@ -1281,11 +1281,12 @@ Vector<Vector3> GodotConcavePolygonShape3D::get_faces() const {
 	Vector<Vector3> rfaces;
 	rfaces.resize(faces.size() * 3);
 
-	for (int i = 0; i < faces.size(); i++) {
-		Face f = faces.get(i);
+	Vector3 *rfacesw = rfaces.ptrw();
+	for (uint32_t i = 0; i < faces.size(); i++) {
+		const Face &f = faces[i];
 
 		for (int j = 0; j < 3; j++) {
-			rfaces.set(i * 3 + j, vertices.get(f.indices[j]));
+			rfacesw[i * 3 + j] = vertices[f.indices[j]];
 		}
 	}
 
@@ -1338,39 +1339,50 @@ Vector3 GodotConcavePolygonShape3D::get_support(const Vector3 &p_normal) const {
 	return vptr[vert_support_idx];
 }
 
-void GodotConcavePolygonShape3D::_cull_segment(int p_idx, _SegmentCullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
+void GodotConcavePolygonShape3D::_cull_segment(_SegmentCullParams *p_params) const {
+	uint32_t stack[BVH_MAX_DEPTH];
+	int stack_size = 0;
+	uint32_t node_index = 0;
 
-	if (!params_bvh->aabb.intersects_segment(p_params->from, p_params->to)) {
-		return;
-	}
+	while (true) {
+		const BVH &node = p_params->bvh[node_index];
+		if (_get_bvh_aabb(node).intersects_segment(p_params->from, p_params->to)) {
+			if (!(node.data & BVH_LEAF_FLAG)) {
+				stack[stack_size++] = node.data;
+				node_index++;
+				continue;
+			}
 
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-
-		Vector3 res;
-		Vector3 normal;
-		if (face->intersect_segment(p_params->from, p_params->to, res, normal, true)) {
-			real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
-			if ((d > 0) && (d < p_params->min_d)) {
-				p_params->min_d = d;
-				p_params->result = res;
-				p_params->normal = normal;
-				p_params->collisions++;
+			const uint32_t first_face = node.data & BVH_LEAF_FACE_INDEX_MASK;
+			const uint32_t face_count = ((node.data & ~BVH_LEAF_FLAG) >> BVH_LEAF_FACE_COUNT_SHIFT) + 1;
+			for (uint32_t face_index = first_face; face_index < first_face + face_count; face_index++) {
+				const Face *f = &p_params->faces[face_index];
+				GodotFaceShape3D *face = p_params->face;
+				face->normal = f->normal;
+				face->vertex[0] = p_params->vertices[f->indices[0]];
+				face->vertex[1] = p_params->vertices[f->indices[1]];
+				face->vertex[2] = p_params->vertices[f->indices[2]];
+
+				Vector3 res;
+				Vector3 normal;
+				if (face->intersect_segment(p_params->from, p_params->to, res, normal, true)) {
+					real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
+					if ((d > 0) && (d < p_params->min_d)) {
+						p_params->min_d = d;
+						p_params->result = res;
+						p_params->normal = normal;
+						p_params->collisions++;
+						// Only closer hits matter now, shorten the segment to skip farther nodes.
+						p_params->to = res;
+					}
+				}
 			}
 		}
-	} else {
-		if (params_bvh->left >= 0) {
-			_cull_segment(params_bvh->left, p_params);
-		}
-		if (params_bvh->right >= 0) {
-			_cull_segment(params_bvh->right, p_params);
+
+		if (stack_size == 0) {
+			break;
 		}
+		node_index = stack[--stack_size];
 	}
 }
 
@@ -1399,7 +1411,7 @@ bool GodotConcavePolygonShape3D::intersect_segment(const Vector3 &p_begin, const
 	params.face = &face;
 
 	// cull
-	_cull_segment(0, &params);
+	_cull_segment(&params);
 
 	if (params.collisions > 0) {
 		r_result = params.result;
@@ -1418,38 +1430,52 @@ Vector3 GodotConcavePolygonShape3D::get_closest_point_to(const Vector3 &p_point)
 	return Vector3();
 }
 
-bool GodotConcavePolygonShape3D::_cull(int p_idx, _CullParams *p_params) const {
-	const BVH *params_bvh = &p_params->bvh[p_idx];
+void GodotConcavePolygonShape3D::_cull(_CullParams *p_params) const {
+	uint32_t stack[BVH_MAX_DEPTH];
+	int stack_size = 0;
+	uint32_t node_index = 0;
 
-	if (!p_params->aabb.intersects(params_bvh->aabb)) {
-		return false;
-	}
+	while (true) {
+		const BVH &node = p_params->bvh[node_index];
+		// Quantized bounds are compared directly.
+		if (node.min[0] <= p_params->max[0] && node.max[0] >= p_params->min[0] &&
+				node.min[1] <= p_params->max[1] && node.max[1] >= p_params->min[1] &&
+				node.min[2] <= p_params->max[2] && node.max[2] >= p_params->min[2]) {
+			if (!(node.data & BVH_LEAF_FLAG)) {
+				stack[stack_size++] = node.data;
+				node_index++;
+				continue;
+			}
 
-	if (params_bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[params_bvh->face_index];
-		GodotFaceShape3D *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-		if (p_params->callback(p_params->userdata, face)) {
-			return true;
-		}
-	} else {
-		if (params_bvh->left >= 0) {
-			if (_cull(params_bvh->left, p_params)) {
-				return true;
+			const uint32_t first_face = node.data & BVH_LEAF_FACE_INDEX_MASK;
+			const uint32_t face_count = ((node.data & ~BVH_LEAF_FLAG) >> BVH_LEAF_FACE_COUNT_SHIFT) + 1;
+			for (uint32_t face_index = first_face; face_index < first_face + face_count; face_index++) {
+				const Face *f = &p_params->faces[face_index];
+				GodotFaceShape3D *face = p_params->face;
+				face->vertex[0] = p_params->vertices[f->indices[0]];
+				face->vertex[1] = p_params->vertices[f->indices[1]];
+				face->vertex[2] = p_params->vertices[f->indices[2]];
+
+				// Leaves hold several faces, skip the ones that are out of the query.
+				AABB face_aabb(face->vertex[0], Vector3());
+				face_aabb.expand_to(face->vertex[1]);
+				face_aabb.expand_to(face->vertex[2]);
+				if (!p_params->aabb.intersects(face_aabb)) {
+					continue;
+				}
+
+				face->normal = f->normal;
+				if (p_params->callback(p_params->userdata, face)) {
+					return;
+				}
 			}
 		}
 
-		if (params_bvh->right >= 0) {
-			if (_cull(params_bvh->right, p_params)) {
-				return true;
-			}
+		if (stack_size == 0) {
+			break;
 		}
+		node_index = stack[--stack_size];
 	}
-
-	return false;
 }
 
 void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
@@ -1470,6 +1496,7 @@ void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_
 	face.invert_backface_collision = p_invert_backface_collision;
 
 	_CullParams params;
+	_quantize_bvh_aabb(local_aabb, params.min, params.max, 0);
 	params.aabb = local_aabb;
 	params.face = &face;
 	params.faces = fr;
@@ -1479,7 +1506,7 @@ void GodotConcavePolygonShape3D::cull(const AABB &p_local_aabb, QueryCallback p_
 	params.userdata = p_userdata;
 
 	// cull
-	_cull(0, &params);
+	_cull(&params);
 }
 
 Vector3 GodotConcavePolygonShape3D::get_moment_of_inertia(real_t p_mass) const {
@@ -1516,90 +1543,53 @@ struct _Volume_BVH_CompareZ {
 	}
 };
 
-struct _Volume_BVH {
-	AABB aabb;
-	_Volume_BVH *left = nullptr;
-	_Volume_BVH *right = nullptr;
+void GodotConcavePolygonShape3D::_build_bvh(_Volume_BVH_Element *p_elements, int p_begin, int p_end) {
+	// Nodes are added depth first, don't keep references while children are built.
+	const uint32_t node_index = bvh.size();
+	bvh.push_back(BVH());
 
-	int face_index = 0;
-};
-
-_Volume_BVH *_volume_build_bvh(_Volume_BVH_Element *p_elements, int p_size, int &count) {
-	_Volume_BVH *bvh = memnew(_Volume_BVH);
-
-	if (p_size == 1) {
-		//leaf
-		bvh->aabb = p_elements[0].aabb;
-		bvh->left = nullptr;
-		bvh->right = nullptr;
-		bvh->face_index = p_elements->face_index;
-		count++;
-		return bvh;
-	} else {
-		bvh->face_index = -1;
+	AABB aabb = p_elements[p_begin].aabb;
+	AABB center_aabb(p_elements[p_begin].center, Vector3());
+	for (int i = p_begin + 1; i < p_end; i++) {
+		aabb.merge_with(p_elements[i].aabb);
+		center_aabb.expand_to(p_elements[i].center);
 	}
+	// Pad by one step so that rounding errors never shrink the bounds.
+	_quantize_bvh_aabb(aabb, bvh[node_index].min, bvh[node_index].max, 1);
 
-	AABB aabb;
-	for (int i = 0; i < p_size; i++) {
-		if (i == 0) {
-			aabb = p_elements[i].aabb;
-		} else {
-			aabb.merge_with(p_elements[i].aabb);
-		}
+	const int count = p_end - p_begin;
+	if (count <= BVH_MAX_LEAF_FACES) {
+		bvh[node_index].data = BVH_LEAF_FLAG | ((count - 1) << BVH_LEAF_FACE_COUNT_SHIFT) | p_begin;
+		return;
 	}
-	bvh->aabb = aabb;
-	switch (aabb.get_longest_axis_index()) {
+
+	// Split at the median along the longest axis, only partitioning is needed, not a full sort.
+	const int split = p_begin + count / 2;
+	switch (center_aabb.get_longest_axis_index()) {
 		case 0: {
 			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareX> sort_x;
-			sort_x.sort(p_elements, p_size);
-
+			sort_x.nth_element(p_begin, p_end, split, p_elements);
 		} break;
 		case 1: {
 			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareY> sort_y;
-			sort_y.sort(p_elements, p_size);
+			sort_y.nth_element(p_begin, p_end, split, p_elements);
 		} break;
 		case 2: {
 			SortArray<_Volume_BVH_Element, _Volume_BVH_CompareZ> sort_z;
-			sort_z.sort(p_elements, p_size);
+			sort_z.nth_element(p_begin, p_end, split, p_elements);
 		} break;
 	}
 
-	int split = p_size / 2;
-	bvh->left = _volume_build_bvh(p_elements, split, count);
-	bvh->right = _volume_build_bvh(&p_elements[split], p_size - split, count);
-
-	//printf("branch at %p - %i: %i\n",bvh,count,bvh->face_index);
-	count++;
-	return bvh;
-}
-
-void GodotConcavePolygonShape3D::_fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx) {
-	int idx = p_idx;
-
-	p_bvh_array[idx].aabb = p_bvh_tree->aabb;
-	p_bvh_array[idx].face_index = p_bvh_tree->face_index;
-	//printf("%p - %i: %i(%p)  -- %p:%p\n",%p_bvh_array[idx],p_idx,p_bvh_array[i]->face_index,&p_bvh_tree->face_index,p_bvh_tree->left,p_bvh_tree->right);
-
-	if (p_bvh_tree->left) {
-		p_bvh_array[idx].left = ++p_idx;
-		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
-
-	} else {
-		p_bvh_array[p_idx].left = -1;
-	}
-
-	if (p_bvh_tree->right) {
-		p_bvh_array[idx].right = ++p_idx;
-		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
-
-	} else {
-		p_bvh_array[p_idx].right = -1;
-	}
-
-	memdelete(p_bvh_tree);
+	_build_bvh(p_elements, p_begin, split);
+	bvh[node_index].data = bvh.size();
+	_build_bvh(p_elements, split, p_end);
 }
 
 void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_backface_collision) {
+	faces.clear();
+	vertices.clear();
+	bvh.clear();
+
 	int src_face_count = p_faces.size();
 	if (src_face_count == 0) {
 		configure(AABB());
@@ -1607,52 +1597,55 @@ void GodotConcavePolygonShape3D::_setup(const Vector<Vector3> &p_faces, bool p_b
 	}
 	ERR_FAIL_COND(src_face_count % 3);
 	src_face_count /= 3;
+	ERR_FAIL_COND_MSG((uint32_t)src_face_count > BVH_LEAF_FACE_INDEX_MASK, "Too many faces in concave polygon shape.");
 
 	const Vector3 *facesr = p_faces.ptr();
 
-	Vector<_Volume_BVH_Element> bvh_array;
-	bvh_array.resize(src_face_count);
-
-	_Volume_BVH_Element *bvh_arrayw = bvh_array.ptrw();
-
-	faces.resize(src_face_count);
-	Face *facesw = faces.ptrw();
-
-	vertices.resize(src_face_count * 3);
-
-	Vector3 *verticesw = vertices.ptrw();
+	LocalVector<_Volume_BVH_Element> bvh_elements;
+	bvh_elements.resize(src_face_count);
 
 	AABB _aabb;
 
 	for (int i = 0; i < src_face_count; i++) {
 		Face3 face(facesr[i * 3 + 0], facesr[i * 3 + 1], facesr[i * 3 + 2]);
 
-		bvh_arrayw[i].aabb = face.get_aabb();
-		bvh_arrayw[i].center = bvh_arrayw[i].aabb.get_center();
-		bvh_arrayw[i].face_index = i;
-		facesw[i].indices[0] = i * 3 + 0;
-		facesw[i].indices[1] = i * 3 + 1;
-		facesw[i].indices[2] = i * 3 + 2;
-		facesw[i].normal = face.get_plane().normal;
-		verticesw[i * 3 + 0] = face.vertex[0];
-		verticesw[i * 3 + 1] = face.vertex[1];
-		verticesw[i * 3 + 2] = face.vertex[2];
+		bvh_elements[i].aabb = face.get_aabb();
+		bvh_elements[i].center = bvh_elements[i].aabb.get_center();
+		bvh_elements[i].face_index = i;
 		if (i == 0) {
-			_aabb = bvh_arrayw[i].aabb;
+			_aabb = bvh_elements[i].aabb;
 		} else {
-			_aabb.merge_with(bvh_arrayw[i].aabb);
+			_aabb.merge_with(bvh_elements[i].aabb);
 		}
 	}
 
-	int count = 0;
-	_Volume_BVH *bvh_tree = _volume_build_bvh(bvh_arrayw, src_face_count, count);
+	bvh_origin = _aabb.position;
+	for (int i = 0; i < 3; i++) {
+		bvh_scale[i] = _aabb.size[i] / UINT16_MAX;
+		bvh_inv_scale[i] = (_aabb.size[i] > 0) ? UINT16_MAX / _aabb.size[i] : 0;
+	}
 
-	bvh.resize(count + 1);
+	// Median splits keep the tree balanced, so the traversal stacks can't overflow.
+	bvh.reserve(2 * (src_face_count / BVH_MAX_LEAF_FACES + 1));
+	_build_bvh(bvh_elements.ptr(), 0, src_face_count);
 
-	BVH *bvh_arrayw2 = bvh.ptrw();
+	// Store faces in leaf order, so that faces of the same leaf are next to each other in memory.
+	faces.resize(src_face_count);
+	HashMap<Vector3, int> vertex_indices;
+	for (int i = 0; i < src_face_count; i++) {
+		const Vector3 *face_vertices = &facesr[bvh_elements[i].face_index * 3];
 
-	int idx = 0;
-	_fill_bvh(bvh_tree, bvh_arrayw2, idx);
+		Face &face = faces[i];
+		face.normal = Plane(face_vertices[0], face_vertices[1], face_vertices[2]).normal;
+		for (int j = 0; j < 3; j++) {
+			HashMap<Vector3, int>::Iterator E = vertex_indices.find(face_vertices[j]);
+			if (!E) {
+				E = vertex_indices.insert(face_vertices[j], vertices.size());
+				vertices.push_back(face_vertices[j]);
+			}
+			face.indices[j] = E->value;
+		}
+	}
 
 	backface_collision = p_backface_collision;
 
@@ -1969,7 +1962,7 @@ bool GodotHeightMapShape3D::intersect_segment(const Vector3 &p_begin, const Vect
 			r_normal = params.normal;
 			return true;
 		}
-	} else if (bounds_grid.is_empty()) {
+	} else if (bounds_levels.is_empty()) {
 		// Process all cells intersecting the flat projection of the ray.
 		return _intersect_grid_segment(_heightmap_cell_cull_segment, p_begin, p_end, width, depth, local_origin, r_point, r_normal);
 	} else {
@@ -1983,7 +1976,7 @@ bool GodotHeightMapShape3D::intersect_segment(const Vector3 &p_begin, const Vect
 			Vector3 bounds_from = p_begin / BOUNDS_CHUNK_SIZE;
 			Vector3 bounds_to = p_end / BOUNDS_CHUNK_SIZE;
 			Vector3 bounds_offset = local_origin / BOUNDS_CHUNK_SIZE;
-			return _intersect_grid_segment(_heightmap_chunk_cull_segment, bounds_from, bounds_to, bounds_grid_width, bounds_grid_depth, bounds_offset, r_point, r_normal);
+			return _intersect_grid_segment(_heightmap_chunk_cull_segment, bounds_from, bounds_to, bounds_levels[0].width, bounds_levels[0].depth, bounds_offset, r_point, r_normal);
 		}
 	}
 
@@ -2013,6 +2006,69 @@ void GodotHeightMapShape3D::_get_cell(const Vector3 &p_point, int &r_x, int &r_y
 	r_z = (clamped_point.z < 0.0) ? (clamped_point.z - 0.5) : (clamped_point.z + 0.5);
 }
 
+bool GodotHeightMapShape3D::_cull_cells(const _CullParams &p_params, int p_begin_x, int p_end_x, int p_begin_z, int p_end_z) const {
+	GodotFaceShape3D &face = *p_params.face;
+
+	for (int z = p_begin_z; z < p_end_z; z++) {
+		for (int x = p_begin_x; x < p_end_x; x++) {
+			// First triangle.
+			_get_point(x, z, face.vertex[0]);
+			_get_point(x + 1, z, face.vertex[1]);
+			_get_point(x, z + 1, face.vertex[2]);
+			face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
+			if (p_params.callback(p_params.userdata, &face)) {
+				return true;
+			}
+
+			// Second triangle.
+			face.vertex[0] = face.vertex[1];
+			_get_point(x + 1, z + 1, face.vertex[1]);
+			face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
+			if (p_params.callback(p_params.userdata, &face)) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool GodotHeightMapShape3D::_cull_bounds(const _CullParams &p_params, int p_level, int p_x, int p_z) const {
+	const BoundsLevel &level = bounds_levels[p_level];
+	if (p_x >= level.width || p_z >= level.depth) {
+		return false;
+	}
+
+	// Cells covered by this node.
+	const int node_size = BOUNDS_CHUNK_SIZE << p_level;
+	const int begin_x = MAX(p_x * node_size, p_params.begin_x);
+	const int end_x = MIN((p_x + 1) * node_size, p_params.end_x);
+	const int begin_z = MAX(p_z * node_size, p_params.begin_z);
+	const int end_z = MIN((p_z + 1) * node_size, p_params.end_z);
+	if (begin_x >= end_x || begin_z >= end_z) {
+		return false;
+	}
+
+	const Range &range = level.ranges[(p_z * level.width) + p_x];
+	if (range.min > p_params.max_height || range.max < p_params.min_height) {
+		return false;
+	}
+
+	if (p_level == 0) {
+		return _cull_cells(p_params, begin_x, end_x, begin_z, end_z);
+	}
+
+	for (int z = 0; z < 2; z++) {
+		for (int x = 0; x < 2; x++) {
+			if (_cull_bounds(p_params, p_level - 1, p_x * 2 + x, p_z * 2 + z)) {
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
 void GodotHeightMapShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callback, void *p_userdata, bool p_invert_backface_collision) const {
 	if (heights.is_empty()) {
 		return;
@@ -2034,35 +2090,29 @@ void GodotHeightMapShape3D::cull(const AABB &p_local_aabb, QueryCallback p_callb
 		aabb_max[i]++;
 	}
 
-	int start_x = MAX(0, aabb_min[0]);
-	int end_x = MIN(width - 1, aabb_max[0]);
-	int start_z = MAX(0, aabb_min[2]);
-	int end_z = MIN(depth - 1, aabb_max[2]);
-
 	GodotFaceShape3D face;
 	face.backface_collision = !p_invert_backface_collision;
 	face.invert_backface_collision = p_invert_backface_collision;
 
-	for (int z = start_z; z < end_z; z++) {
-		for (int x = start_x; x < end_x; x++) {
-			// First triangle.
-			_get_point(x, z, face.vertex[0]);
-			_get_point(x + 1, z, face.vertex[1]);
-			_get_point(x, z + 1, face.vertex[2]);
-			face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
-			if (p_callback(p_userdata, &face)) {
-				return;
-			}
+	_CullParams params;
+	params.begin_x = MAX(0, aabb_min[0]);
+	params.end_x = MIN(width - 1, aabb_max[0]);
+	params.begin_z = MAX(0, aabb_min[2]);
+	params.end_z = MIN(depth - 1, aabb_max[2]);
+	params.min_height = local_aabb.position.y;
+	params.max_height = local_aabb.position.y + local_aabb.size.y;
+	params.callback = p_callback;
+	params.userdata = p_userdata;
+	params.face = &face;
 
-			// Second triangle.
-			face.vertex[0] = face.vertex[1];
-			_get_point(x + 1, z + 1, face.vertex[1]);
-			face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
-			if (p_callback(p_userdata, &face)) {
-				return;
-			}
-		}
+	if (bounds_levels.is_empty()) {
+		_cull_cells(params, params.begin_x, params.end_x, params.begin_z, params.end_z);
+		return;
 	}
+
+	// Skip whole areas of the terrain that are above or below the query.
+	const int top_level = bounds_levels.size() - 1;
+	_cull_bounds(params, top_level, 0, 0);
 }
 
 Vector3 GodotHeightMapShape3D::get_moment_of_inertia(real_t p_mass) const {
@@ -2075,11 +2125,52 @@ Vector3 GodotHeightMapShape3D::get_moment_of_inertia(real_t p_mass) const {
 			(p_mass / 3.0) * (extents.x * extents.x + extents.y * extents.y));
 }
 
+GodotHeightMapShape3D::Range GodotHeightMapShape3D::_compute_chunk_range(int p_x, int p_z) const {
+	int z0 = p_z * BOUNDS_CHUNK_SIZE;
+	int x0 = p_x * BOUNDS_CHUNK_SIZE;
+
+	Range r;
+
+	r.min = _get_height(x0, z0);
+	r.max = r.min;
+
+	// Compute min and max height for this chunk.
+	// We have to include one extra cell to account for neighbors.
+	// Here is why:
+	// Say we have a flat terrain, and a plateau that fits a chunk perfectly.
+	//
+	//   Left        Right
+	// 0---0---0---1---1---1
+	// |   |   |   |   |   |
+	// 0---0---0---1---1---1
+	// |   |   |   |   |   |
+	// 0---0---0---1---1---1
+	//           x
+	//
+	// If the AABB for the Left chunk did not share vertices with the Right,
+	// then we would fail collision tests at x due to a gap.
+	//
+	int z_max = MIN(z0 + BOUNDS_CHUNK_SIZE + 1, depth);
+	int x_max = MIN(x0 + BOUNDS_CHUNK_SIZE + 1, width);
+	for (int z = z0; z < z_max; ++z) {
+		for (int x = x0; x < x_max; ++x) {
+			real_t height = _get_height(x, z);
+			if (height < r.min) {
+				r.min = height;
+			} else if (height > r.max) {
+				r.max = height;
+			}
+		}
+	}
+
+	return r;
+}
+
 void GodotHeightMapShape3D::_build_accelerator() {
-	bounds_grid.clear();
+	bounds_levels.clear();
 
-	bounds_grid_width = width / BOUNDS_CHUNK_SIZE;
-	bounds_grid_depth = depth / BOUNDS_CHUNK_SIZE;
+	int bounds_grid_width = width / BOUNDS_CHUNK_SIZE;
+	int bounds_grid_depth = depth / BOUNDS_CHUNK_SIZE;
 
 	if (width % BOUNDS_CHUNK_SIZE > 0) {
 		++bounds_grid_width; // In case terrain size isn't dividable by chunk size.
@@ -2089,59 +2180,107 @@ void GodotHeightMapShape3D::_build_accelerator() {
 		++bounds_grid_depth;
 	}
 
-	uint32_t bound_grid_size = (uint32_t)(bounds_grid_width * bounds_grid_depth);
-
-	if (bound_grid_size < 2) {
+	if (bounds_grid_width * bounds_grid_depth < 2) {
 		// Grid is empty or just one chunk.
 		return;
 	}
 
-	bounds_grid.resize(bound_grid_size);
-
-	// Compute min and max height for all chunks.
-	for (int cz = 0; cz < bounds_grid_depth; ++cz) {
-		int z0 = cz * BOUNDS_CHUNK_SIZE;
-
-		for (int cx = 0; cx < bounds_grid_width; ++cx) {
-			int x0 = cx * BOUNDS_CHUNK_SIZE;
-
-			Range r;
-
-			r.min = _get_height(x0, z0);
-			r.max = r.min;
-
-			// Compute min and max height for this chunk.
-			// We have to include one extra cell to account for neighbors.
-			// Here is why:
-			// Say we have a flat terrain, and a plateau that fits a chunk perfectly.
-			//
-			//   Left        Right
-			// 0---0---0---1---1---1
-			// |   |   |   |   |   |
-			// 0---0---0---1---1---1
-			// |   |   |   |   |   |
-			// 0---0---0---1---1---1
-			//           x
-			//
-			// If the AABB for the Left chunk did not share vertices with the Right,
-			// then we would fail collision tests at x due to a gap.
-			//
-			int z_max = MIN(z0 + BOUNDS_CHUNK_SIZE + 1, depth);
-			int x_max = MIN(x0 + BOUNDS_CHUNK_SIZE + 1, width);
-			for (int z = z0; z < z_max; ++z) {
-				for (int x = x0; x < x_max; ++x) {
-					real_t height = _get_height(x, z);
-					if (height < r.min) {
-						r.min = height;
-					} else if (height > r.max) {
-						r.max = height;
+	// Allocate all levels, each one half the size of the previous one.
+	int level_width = bounds_grid_width;
+	int level_depth = bounds_grid_depth;
+	while (true) {
+		BoundsLevel level;
+		level.width = level_width;
+		level.depth = level_depth;
+		level.ranges.resize(level_width * level_depth);
+		bounds_levels.push_back(level);
+
+		if (level_width == 1 && level_depth == 1) {
+			break;
+		}
+		level_width = (level_width + 1) / 2;
+		level_depth = (level_depth + 1) / 2;
+	}
+
+	_update_accelerator(0, 0, bounds_grid_width - 1, bounds_grid_depth - 1);
+}
+
+void GodotHeightMapShape3D::_update_accelerator(int p_begin_x, int p_begin_z, int p_end_x, int p_end_z) {
+	if (bounds_levels.is_empty()) {
+		return;
+	}
+
+	// Compute min and max height for the chunks.
+	BoundsLevel &chunks = bounds_levels[0];
+	for (int cz = p_begin_z; cz <= p_end_z; ++cz) {
+		for (int cx = p_begin_x; cx <= p_end_x; ++cx) {
+			chunks.ranges[cx + cz * chunks.width] = _compute_chunk_range(cx, cz);
+		}
+	}
+
+	// Merge the ranges up to the root, only where they changed.
+	for (uint32_t level_index = 1; level_index < bounds_levels.size(); ++level_index) {
+		const BoundsLevel &children = bounds_levels[level_index - 1];
+		BoundsLevel &level = bounds_levels[level_index];
+
+		p_begin_x /= 2;
+		p_begin_z /= 2;
+		p_end_x /= 2;
+		p_end_z /= 2;
+
+		for (int z = p_begin_z; z <= p_end_z; ++z) {
+			for (int x = p_begin_x; x <= p_end_x; ++x) {
+				Range r = children.ranges[(x * 2) + (z * 2) * children.width];
+				for (int child = 1; child < 4; ++child) {
+					int child_x = x * 2 + (child & 1);
+					int child_z = z * 2 + (child >> 1);
+					if (child_x >= children.width || child_z >= children.depth) {
+						continue;
 					}
+					const Range &child_range = children.ranges[child_x + child_z * children.width];
+					r.min = MIN(r.min, child_range.min);
+					r.max = MAX(r.max, child_range.max);
 				}
+				level.ranges[x + z * level.width] = r;
 			}
+		}
+	}
+}
+
+void GodotHeightMapShape3D::update_region(const Rect2i &p_region, const Vector<real_t> &p_heights) {
+	ERR_FAIL_COND(heights.is_empty());
+	ERR_FAIL_COND_MSG(!p_region.has_area() || !Rect2i(0, 0, width, depth).encloses(p_region), "Heightmap region must be inside the heightmap.");
+	ERR_FAIL_COND(p_heights.size() != p_region.size.x * p_region.size.y);
 
-			bounds_grid[cx + cz * bounds_grid_width] = r;
+	const real_t *r = p_heights.ptr();
+	real_t *w = heights.ptrw();
+	AABB aabb_new = get_aabb();
+	real_t min_height = aabb_new.position.y;
+	real_t max_height = aabb_new.position.y + aabb_new.size.y;
+	for (int z = 0; z < p_region.size.y; ++z) {
+		for (int x = 0; x < p_region.size.x; ++x) {
+			real_t h = r[z * p_region.size.x + x];
+			w[(p_region.position.y + z) * width + p_region.position.x + x] = h;
+			min_height = MIN(min_height, h);
+			max_height = MAX(max_height, h);
 		}
 	}
+
+	// Chunks also include the first row and column of their next neighbors.
+	int last_chunk_x = (bounds_levels.is_empty() ? 0 : bounds_levels[0].width - 1);
+	int last_chunk_z = (bounds_levels.is_empty() ? 0 : bounds_levels[0].depth - 1);
+	int begin_x = MAX(p_region.position.x - 1, 0) / BOUNDS_CHUNK_SIZE;
+	int begin_z = MAX(p_region.position.y - 1, 0) / BOUNDS_CHUNK_SIZE;
+	int end_x = MIN((p_region.position.x + p_region.size.x - 1) / BOUNDS_CHUNK_SIZE, last_chunk_x);
+	int end_z = MIN((p_region.position.y + p_region.size.y - 1) / BOUNDS_CHUNK_SIZE, last_chunk_z);
+	_update_accelerator(begin_x, begin_z, end_x, end_z);
+
+	// The shape only needs to be reconfigured when the height range grows.
+	if (min_height < aabb_new.position.y || max_height > aabb_new.position.y + aabb_new.size.y) {
+		aabb_new.position.y = min_height;
+		aabb_new.size.y = max_height - min_height;
+		configure(aabb_new);
+	}
 }
 
 void GodotHeightMapShape3D::_setup(const Vector<real_t> &p_heights, int p_width, int p_depth, real_t p_min_height, real_t p_max_height) {
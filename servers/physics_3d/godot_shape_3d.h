@@ -302,7 +302,7 @@ public:
 	GodotConvexPolygonShape3D();
 };
 
-struct _Volume_BVH;
+struct _Volume_BVH_Element;
 struct GodotFaceShape3D;
 
 struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
@@ -313,20 +313,49 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 		int indices[3] = {};
 	};
 
-	Vector<Face> faces;
-	Vector<Vector3> vertices;
+	// Faces are sorted in BVH leaf order, vertices are shared between faces.
+	LocalVector<Face> faces;
+	LocalVector<Vector3> vertices;
 
+	// Nodes are stored depth first, so the left child of an internal node is always the next node.
+	// Bounds are quantized to 16 bits relative to the shape's AABB.
 	struct BVH {
-		AABB aabb;
-		int left = 0;
-		int right = 0;
-
-		int face_index = 0;
+		uint16_t min[3] = {};
+		uint16_t max[3] = {};
+		// Internal nodes store the index of their right child,
+		// leaves store BVH_LEAF_FLAG, their face count minus one and their first face.
+		uint32_t data = 0;
 	};
 
-	Vector<BVH> bvh;
+	static const uint32_t BVH_LEAF_FLAG = 1u << 31;
+	static const uint32_t BVH_LEAF_FACE_COUNT_SHIFT = 29;
+	static const uint32_t BVH_LEAF_FACE_INDEX_MASK = (1u << BVH_LEAF_FACE_COUNT_SHIFT) - 1;
+	static const int BVH_MAX_LEAF_FACES = 4;
+	static const int BVH_MAX_DEPTH = 64;
+
+	LocalVector<BVH> bvh;
+	Vector3 bvh_origin;
+	Vector3 bvh_scale;
+	Vector3 bvh_inv_scale;
+
+	_FORCE_INLINE_ AABB _get_bvh_aabb(const BVH &p_node) const {
+		Vector3 min(p_node.min[0], p_node.min[1], p_node.min[2]);
+		Vector3 max(p_node.max[0], p_node.max[1], p_node.max[2]);
+		return AABB(bvh_origin + min * bvh_scale, (max - min) * bvh_scale);
+	}
+
+	_FORCE_INLINE_ void _quantize_bvh_aabb(const AABB &p_aabb, uint16_t *r_min, uint16_t *r_max, real_t p_padding) const {
+		for (int i = 0; i < 3; i++) {
+			real_t min = Math::floor((p_aabb.position[i] - bvh_origin[i]) * bvh_inv_scale[i]) - p_padding;
+			real_t max = Math::ceil((p_aabb.position[i] + p_aabb.size[i] - bvh_origin[i]) * bvh_inv_scale[i]) + p_padding;
+			r_min[i] = CLAMP(min, 0, UINT16_MAX);
+			r_max[i] = CLAMP(max, 0, UINT16_MAX);
+		}
+	}
 
 	struct _CullParams {
+		uint16_t min[3] = {};
+		uint16_t max[3] = {};
 		AABB aabb;
 		QueryCallback callback = nullptr;
 		void *userdata = nullptr;
@@ -353,10 +382,10 @@ struct GodotConcavePolygonShape3D : public GodotConcaveShape3D {
 
 	bool backface_collision = false;
 
-	void _cull_segment(int p_idx, _SegmentCullParams *p_params) const;
-	bool _cull(int p_idx, _CullParams *p_params) const;
+	void _cull_segment(_SegmentCullParams *p_params) const;
+	void _cull(_CullParams *p_params) const;
 
-	void _fill_bvh(_Volume_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx);
+	void _build_bvh(_Volume_BVH_Element *p_elements, int p_begin, int p_end);
 
 	void _setup(const Vector<Vector3> &p_faces, bool p_backface_collision);
 
@@ -393,14 +422,20 @@ struct GodotHeightMapShape3D : public GodotConcaveShape3D {
 		real_t min = 0.0;
 		real_t max = 0.0;
 	};
-	LocalVector<Range> bounds_grid;
-	int bounds_grid_width = 0;
-	int bounds_grid_depth = 0;
+	// Min/max quadtree, the first level has a range per chunk of cells,
+	// each next level merges 2x2 ranges of the previous one, up to a single range.
+	struct BoundsLevel {
+		LocalVector<Range> ranges;
+		int width = 0;
+		int depth = 0;
+	};
+	LocalVector<BoundsLevel> bounds_levels;
 
 	static const int BOUNDS_CHUNK_SIZE = 16;
 
 	_FORCE_INLINE_ const Range &_get_bounds_chunk(int p_x, int p_z) const {
-		return bounds_grid[(p_z * bounds_grid_width) + p_x];
+		const BoundsLevel &level = bounds_levels[0];
+		return level.ranges[(p_z * level.width) + p_x];
 	}
 
 	_FORCE_INLINE_ real_t _get_height(int p_x, int p_z) const {
@@ -415,7 +450,24 @@ struct GodotHeightMapShape3D : public GodotConcaveShape3D {
 
 	void _get_cell(const Vector3 &p_point, int &r_x, int &r_y, int &r_z) const;
 
+	struct _CullParams {
+		int begin_x = 0;
+		int end_x = 0;
+		int begin_z = 0;
+		int end_z = 0;
+		real_t min_height = 0.0;
+		real_t max_height = 0.0;
+		QueryCallback callback = nullptr;
+		void *userdata = nullptr;
+		GodotFaceShape3D *face = nullptr;
+	};
+
+	bool _cull_cells(const _CullParams &p_params, int p_begin_x, int p_end_x, int p_begin_z, int p_end_z) const;
+	bool _cull_bounds(const _CullParams &p_params, int p_level, int p_x, int p_z) const;
+
+	Range _compute_chunk_range(int p_x, int p_z) const;
 	void _build_accelerator();
+	void _update_accelerator(int p_begin_x, int p_begin_z, int p_end_x, int p_end_z);
 
 	template <typename ProcessFunction>
 	bool _intersect_grid_segment(ProcessFunction &p_process, const Vector3 &p_begin, const Vector3 &p_end, int p_width, int p_depth, const Vector3 &offset, Vector3 &r_point, Vector3 &r_normal) const;
@@ -427,6 +479,9 @@ public:
 	int get_width() const;
 	int get_depth() const;
 
+	// Only the bounds of the chunks touching the region are recomputed.
+	void update_region(const Rect2i &p_region, const Vector<real_t> &p_heights);
+
 	virtual PhysicsServer3D::ShapeType get_type() const override { return PhysicsServer3D::SHAPE_HEIGHTMAP; }
 
 	virtual void project_range(const Vector3 &p_normal, const Transform3D &p_transform, real_t &r_min, real_t &r_max) const override;
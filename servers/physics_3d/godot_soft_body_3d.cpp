@@ -33,9 +33,15 @@
 #include "godot_space_3d.h"
 
 #include "core/math/geometry_3d.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/rb_map.h"
 #include "servers/rendering_server.h"
 
+// Links that don't fit in these colors are solved serially.
+constexpr uint32_t MAX_LINK_COLORS = 64;
+// Elements per task when the work of a soft body is split across threads.
+constexpr uint32_t SOFT_BODY_CHUNK_SIZE = 256;
+
 // Based on Bullet soft body.
 
 /*
@@ -580,6 +586,7 @@ bool GodotSoftBody3D::create_from_trimesh(const Vector<int> &p_indices, const Ve
 
 	generate_bending_constraints(2);
 	reoptimize_link_order();
+	color_links();
 
 	update_constants();
 	update_normals_and_centroids();
@@ -824,6 +831,65 @@ void GodotSoftBody3D::reoptimize_link_order() {
 	memdelete_arr(link_buffer);
 }
 
+void GodotSoftBody3D::color_links() {
+	link_color_offsets.clear();
+
+	uint32_t link_count = links.size();
+	if (link_count == 0) {
+		return;
+	}
+
+	// Greedy coloring, each link takes the first color not used yet by either of its nodes.
+	LocalVector<uint64_t> node_colors;
+	node_colors.resize(nodes.size());
+	memset(node_colors.ptr(), 0, sizeof(uint64_t) * nodes.size());
+
+	LocalVector<uint32_t> link_colors;
+	link_colors.resize(link_count);
+	uint32_t color_counts[MAX_LINK_COLORS + 1] = {};
+	uint32_t color_count = 0;
+
+	for (uint32_t i = 0; i < link_count; i++) {
+		const uint32_t node_a = (uint32_t)(links[i].n[0] - &nodes[0]);
+		const uint32_t node_b = (uint32_t)(links[i].n[1] - &nodes[0]);
+		const uint64_t used_colors = node_colors[node_a] | node_colors[node_b];
+
+		uint32_t color = 0;
+		while (color < MAX_LINK_COLORS && (used_colors & (uint64_t(1) << color))) {
+			color++;
+		}
+		if (color < MAX_LINK_COLORS) {
+			node_colors[node_a] |= uint64_t(1) << color;
+			node_colors[node_b] |= uint64_t(1) << color;
+			color_count = MAX(color_count, color + 1);
+		}
+
+		link_colors[i] = color;
+		color_counts[color]++;
+	}
+
+	// Sort links by color, keeping the order from reoptimize_link_order() within each color.
+	uint32_t color_offsets[MAX_LINK_COLORS + 1];
+	uint32_t offset = 0;
+	for (uint32_t color = 0; color <= MAX_LINK_COLORS; color++) {
+		color_offsets[color] = offset;
+		offset += color_counts[color];
+	}
+
+	link_color_offsets.resize(color_count + 1);
+	for (uint32_t color = 0; color < color_count; color++) {
+		link_color_offsets[color] = color_offsets[color];
+	}
+	link_color_offsets[color_count] = color_offsets[MAX_LINK_COLORS];
+
+	LocalVector<Link> sorted_links;
+	sorted_links.resize(link_count);
+	for (uint32_t i = 0; i < link_count; i++) {
+		sorted_links[color_offsets[link_colors[i]]++] = links[i];
+	}
+	links = sorted_links;
+}
+
 void GodotSoftBody3D::append_link(uint32_t p_node1, uint32_t p_node2) {
 	if (p_node1 == p_node2) {
 		return;
@@ -967,7 +1033,7 @@ Vector3 GodotSoftBody3D::_compute_area_windforce(const GodotArea3D *p_area, cons
 	return nodal_force_magnitude * p_face->normal;
 }
 
-void GodotSoftBody3D::predict_motion(real_t p_delta) {
+void GodotSoftBody3D::predict_motion(real_t p_delta, bool p_multithreaded) {
 	const real_t inv_delta = 1.0 / p_delta;
 
 	ERR_FAIL_COND(!get_space());
@@ -1029,35 +1095,26 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 	// Avoid soft body from 'exploding' so use some upper threshold of maximum motion
 	// that a node can travel per frame.
 	const real_t max_displacement = 1000.0;
-	real_t clamp_delta_v = max_displacement * inv_delta;
 
 	// Integrate.
-	for (Node &node : nodes) {
-		node.q = node.x;
-		Vector3 delta_v = node.f * node.im * p_delta;
-		for (int c = 0; c < 3; c++) {
-			delta_v[c] = CLAMP(delta_v[c], -clamp_delta_v, clamp_delta_v);
-		}
-		node.v += delta_v;
-		node.x += node.v * p_delta;
-		node.f = Vector3();
-	}
+	ChunkTask task;
+	task.type = CHUNK_TASK_INTEGRATE_NODES;
+	task.end = nodes.size();
+	task.delta = p_delta;
+	task.value = max_displacement * inv_delta;
+	_run_chunk_task(task, p_multithreaded);
 
 	// Bounds and tree update.
 	update_bounds();
 
-	// Node tree update.
-	for (const Node &node : nodes) {
-		AABB node_aabb(node.x, Vector3());
-		node_aabb.expand_to(node.x + node.v * p_delta);
-		node_aabb.grow_by(collision_margin);
-
-		node_tree.update(node.leaf, node_aabb);
-	}
+	// Node tree update, all nodes move so refit the tree instead of reinserting each of them.
+	task.type = CHUNK_TASK_UPDATE_NODE_VOLUMES;
+	_run_chunk_task(task, p_multithreaded);
+	node_tree.refit();
 
 	// Face tree update.
 	if (!face_tree.is_empty()) {
-		update_face_tree(p_delta);
+		update_face_tree(p_delta, p_multithreaded);
 	}
 
 	// Optimize node tree.
@@ -1065,50 +1122,157 @@ void GodotSoftBody3D::predict_motion(real_t p_delta) {
 	face_tree.optimize_incremental(1);
 }
 
-void GodotSoftBody3D::solve_constraints(real_t p_delta) {
+void GodotSoftBody3D::solve_constraints(real_t p_delta, bool p_multithreaded) {
 	const real_t inv_delta = 1.0 / p_delta;
 
-	for (Link &link : links) {
-		link.c3 = link.n[1]->q - link.n[0]->q;
-		link.c2 = 1 / (link.c3.length_squared() * link.c0);
-	}
+	ChunkTask task;
+	task.type = CHUNK_TASK_PREPARE_LINKS;
+	task.end = links.size();
+	_run_chunk_task(task, p_multithreaded);
 
 	// Solve velocities.
-	for (Node &node : nodes) {
-		node.x = node.q + node.v * p_delta;
-	}
+	task.type = CHUNK_TASK_PREDICT_NODES;
+	task.end = nodes.size();
+	task.delta = p_delta;
+	_run_chunk_task(task, p_multithreaded);
 
 	// Solve positions.
 	for (int isolve = 0; isolve < iteration_count; ++isolve) {
 		const real_t ti = isolve / (real_t)iteration_count;
-		solve_links(1.0, ti);
+		solve_links(1.0, ti, p_multithreaded);
 	}
-	const real_t vc = (1.0 - damping_coefficient) * inv_delta;
-	for (Node &node : nodes) {
-		node.x += node.bv * p_delta;
-		node.bv = Vector3();
 
-		node.v = (node.x - node.q) * vc;
+	task.type = CHUNK_TASK_FINISH_NODES;
+	task.value = (1.0 - damping_coefficient) * inv_delta;
+	_run_chunk_task(task, p_multithreaded);
 
-		node.q = node.x;
+	update_normals_and_centroids();
+}
+
+void GodotSoftBody3D::solve_links(real_t kst, real_t ti, bool p_multithreaded) {
+	ChunkTask task;
+	task.type = CHUNK_TASK_SOLVE_LINKS;
+	task.value = kst;
+
+	// Links of the same color are independent, colors must be solved one after the other.
+	uint32_t color_count = link_color_offsets.is_empty() ? 0 : link_color_offsets.size() - 1;
+	for (uint32_t color = 0; color < color_count; color++) {
+		task.begin = link_color_offsets[color];
+		task.end = link_color_offsets[color + 1];
+		_run_chunk_task(task, p_multithreaded);
 	}
 
-	update_normals_and_centroids();
+	// Remaining links are solved serially.
+	task.begin = link_color_offsets.is_empty() ? 0 : link_color_offsets[color_count];
+	task.end = links.size();
+	_run_chunk_task(task, false);
 }
 
-void GodotSoftBody3D::solve_links(real_t kst, real_t ti) {
-	for (Link &link : links) {
-		if (link.c0 > 0) {
-			Node &node_a = *link.n[0];
-			Node &node_b = *link.n[1];
-			const Vector3 del = node_b.x - node_a.x;
-			const real_t len = del.length_squared();
-			if (link.c1 + len > CMP_EPSILON) {
-				const real_t k = ((link.c1 - len) / (link.c0 * (link.c1 + len))) * kst;
-				node_a.x -= del * (k * node_a.im);
-				node_b.x += del * (k * node_b.im);
+void GodotSoftBody3D::_run_chunk_task(ChunkTask &p_task, bool p_multithreaded) {
+	const uint32_t count = p_task.end - p_task.begin;
+	if (!p_multithreaded || count < SOFT_BODY_CHUNK_SIZE * 2) {
+		// Not worth the synchronization cost.
+		_process_range(p_task, p_task.begin, p_task.end);
+		return;
+	}
+
+	const uint32_t chunk_count = (count + SOFT_BODY_CHUNK_SIZE - 1) / SOFT_BODY_CHUNK_SIZE;
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotSoftBody3D::_process_chunk, &p_task, chunk_count, -1, true, SNAME("SoftBody3DProcessChunks"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
+void GodotSoftBody3D::_process_chunk(uint32_t p_chunk, ChunkTask *p_task) {
+	const uint32_t begin = p_task->begin + p_chunk * SOFT_BODY_CHUNK_SIZE;
+	_process_range(*p_task, begin, MIN(begin + SOFT_BODY_CHUNK_SIZE, p_task->end));
+}
+
+void GodotSoftBody3D::_process_range(const ChunkTask &p_task, uint32_t p_begin, uint32_t p_end) {
+	switch (p_task.type) {
+		case CHUNK_TASK_INTEGRATE_NODES: {
+			for (uint32_t i = p_begin; i < p_end; i++) {
+				Node &node = nodes[i];
+				node.q = node.x;
+				Vector3 delta_v = node.f * node.im * p_task.delta;
+				for (int c = 0; c < 3; c++) {
+					delta_v[c] = CLAMP(delta_v[c], -p_task.value, p_task.value);
+				}
+				node.v += delta_v;
+				node.x += node.v * p_task.delta;
+				node.f = Vector3();
 			}
-		}
+		} break;
+		case CHUNK_TASK_UPDATE_NODE_VOLUMES: {
+			for (uint32_t i = p_begin; i < p_end; i++) {
+				const Node &node = nodes[i];
+				AABB node_aabb(node.x, Vector3());
+				node_aabb.expand_to(node.x + node.v * p_task.delta);
+				node_aabb.grow_by(collision_margin);
+
+				node_tree.set_volume(node.leaf, node_aabb);
+			}
+		} break;
+		case CHUNK_TASK_UPDATE_FACE_VOLUMES: {
+			for (uint32_t i = p_begin; i < p_end; i++) {
+				const Face &face = faces[i];
+				AABB face_aabb;
+
+				const Node *node0 = face.n[0];
+				face_aabb.position = node0->x;
+				face_aabb.expand_to(node0->x + node0->v * p_task.delta);
+
+				const Node *node1 = face.n[1];
+				face_aabb.expand_to(node1->x);
+				face_aabb.expand_to(node1->x + node1->v * p_task.delta);
+
+				const Node *node2 = face.n[2];
+				face_aabb.expand_to(node2->x);
+				face_aabb.expand_to(node2->x + node2->v * p_task.delta);
+
+				face_aabb.grow_by(collision_margin);
+
+				face_tree.set_volume(face.leaf, face_aabb);
+			}
+		} break;
+		case CHUNK_TASK_PREPARE_LINKS: {
+			for (uint32_t i = p_begin; i < p_end; i++) {
+				Link &link = links[i];
+				link.c3 = link.n[1]->q - link.n[0]->q;
+				link.c2 = 1 / (link.c3.length_squared() * link.c0);
+			}
+		} break;
+		case CHUNK_TASK_PREDICT_NODES: {
+			for (uint32_t i = p_begin; i < p_end; i++) {
+				Node &node = nodes[i];
+				node.x = node.q + node.v * p_task.delta;
+			}
+		} break;
+		case CHUNK_TASK_SOLVE_LINKS: {
+			for (uint32_t i = p_begin; i < p_end; i++) {
+				const Link &link = links[i];
+				if (link.c0 > 0) {
+					Node &node_a = *link.n[0];
+					Node &node_b = *link.n[1];
+					const Vector3 del = node_b.x - node_a.x;
+					const real_t len = del.length_squared();
+					if (link.c1 + len > CMP_EPSILON) {
+						const real_t k = ((link.c1 - len) / (link.c0 * (link.c1 + len))) * p_task.value;
+						node_a.x -= del * (k * node_a.im);
+						node_b.x += del * (k * node_b.im);
+					}
+				}
+			}
+		} break;
+		case CHUNK_TASK_FINISH_NODES: {
+			for (uint32_t i = p_begin; i < p_end; i++) {
+				Node &node = nodes[i];
+				node.x += node.bv * p_task.delta;
+				node.bv = Vector3();
+
+				node.v = (node.x - node.q) * p_task.value;
+
+				node.q = node.x;
+			}
+		} break;
 	}
 }
 
@@ -1169,26 +1333,13 @@ void GodotSoftBody3D::initialize_face_tree() {
 	}
 }
 
-void GodotSoftBody3D::update_face_tree(real_t p_delta) {
-	for (const Face &face : faces) {
-		AABB face_aabb;
-
-		const Node *node0 = face.n[0];
-		face_aabb.position = node0->x;
-		face_aabb.expand_to(node0->x + node0->v * p_delta);
-
-		const Node *node1 = face.n[1];
-		face_aabb.expand_to(node1->x);
-		face_aabb.expand_to(node1->x + node1->v * p_delta);
-
-		const Node *node2 = face.n[2];
-		face_aabb.expand_to(node2->x);
-		face_aabb.expand_to(node2->x + node2->v * p_delta);
-
-		face_aabb.grow_by(collision_margin);
-
-		face_tree.update(face.leaf, face_aabb);
-	}
+void GodotSoftBody3D::update_face_tree(real_t p_delta, bool p_multithreaded) {
+	ChunkTask task;
+	task.type = CHUNK_TASK_UPDATE_FACE_VOLUMES;
+	task.end = faces.size();
+	task.delta = p_delta;
+	_run_chunk_task(task, p_multithreaded);
+	face_tree.refit();
 }
 
 void GodotSoftBody3D::initialize_shape(bool p_force_move) {
@@ -1219,6 +1370,7 @@ void GodotSoftBody3D::destroy() {
 
 	nodes.clear();
 	links.clear();
+	link_color_offsets.clear();
 	faces.clear();
 
 	bounds = AABB();
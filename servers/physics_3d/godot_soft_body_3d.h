@@ -82,6 +82,29 @@ class GodotSoftBody3D : public GodotCollisionObject3D {
 	LocalVector<Link> links;
 	LocalVector<Face> faces;
 
+	// Links are sorted by color, links of the same color don't share any node and can be solved in parallel.
+	// Links after the last offset couldn't be colored and are solved serially.
+	LocalVector<uint32_t> link_color_offsets;
+
+	enum ChunkTaskType {
+		CHUNK_TASK_INTEGRATE_NODES,
+		CHUNK_TASK_UPDATE_NODE_VOLUMES,
+		CHUNK_TASK_UPDATE_FACE_VOLUMES,
+		CHUNK_TASK_PREPARE_LINKS,
+		CHUNK_TASK_PREDICT_NODES,
+		CHUNK_TASK_SOLVE_LINKS,
+		CHUNK_TASK_FINISH_NODES,
+	};
+
+	// Work over a range of nodes, links or faces, split in chunks across worker threads when large enough.
+	struct ChunkTask {
+		ChunkTaskType type = CHUNK_TASK_INTEGRATE_NODES;
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		real_t delta = 0.0;
+		real_t value = 0.0; // Velocity clamp, link stiffness or velocity factor, depending on the type.
+	};
+
 	DynamicBVH node_tree;
 	DynamicBVH face_tree;
 
@@ -201,8 +224,9 @@ public:
 	void set_drag_coefficient(real_t p_val);
 	_FORCE_INLINE_ real_t get_drag_coefficient() const { return drag_coefficient; }
 
-	void predict_motion(real_t p_delta);
-	void solve_constraints(real_t p_delta);
+	// Only use p_multithreaded when not already running on a worker thread.
+	void predict_motion(real_t p_delta, bool p_multithreaded = false);
+	void solve_constraints(real_t p_delta, bool p_multithreaded = false);
 
 	_FORCE_INLINE_ uint32_t get_node_index(void *p_node) const { return static_cast<Node *>(p_node)->index; }
 	_FORCE_INLINE_ uint32_t get_face_index(void *p_face) const { return static_cast<Face *>(p_face)->index; }
@@ -234,13 +258,18 @@ private:
 	bool create_from_trimesh(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices);
 	void generate_bending_constraints(int p_distance);
 	void reoptimize_link_order();
+	void color_links();
 	void append_link(uint32_t p_node1, uint32_t p_node2);
 	void append_face(uint32_t p_node1, uint32_t p_node2, uint32_t p_node3);
 
-	void solve_links(real_t kst, real_t ti);
+	void solve_links(real_t kst, real_t ti, bool p_multithreaded);
+
+	void _run_chunk_task(ChunkTask &p_task, bool p_multithreaded);
+	void _process_chunk(uint32_t p_chunk, ChunkTask *p_task);
+	void _process_range(const ChunkTask &p_task, uint32_t p_begin, uint32_t p_end);
 
 	void initialize_face_tree();
-	void update_face_tree(real_t p_delta);
+	void update_face_tree(real_t p_delta, bool p_multithreaded);
 
 	void initialize_shape(bool p_force_move = true);
 	void deinitialize_shape();
@@ -0,0 +1,116 @@
+/**************************************************************************/
+/*  godot_solver_bodies_3d.cpp                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "godot_solver_bodies_3d.h"
+
+#include "godot_constraint_3d.h"
+
+uint32_t GodotSolverBodies3D::add_body(GodotBody3D *p_body) {
+	HashMap<GodotBody3D *, uint32_t>::Iterator E = body_indices.find(p_body);
+	if (E) {
+		return E->value;
+	}
+
+	uint32_t index = bodies.size();
+	body_indices.insert(p_body, index);
+	bodies.push_back(p_body);
+
+	linear_velocities.push_back(Vector3());
+	angular_velocities.push_back(Vector3());
+	biased_linear_velocities.push_back(Vector3());
+	biased_angular_velocities.push_back(Vector3());
+	inv_inertia_tensors.push_back(Basis());
+	centers_of_mass.push_back(Vector3());
+	inv_masses.push_back(0.0);
+
+	load_body(index);
+	return index;
+}
+
+void GodotSolverBodies3D::load_body(uint32_t p_index) {
+	const GodotBody3D *body = bodies[p_index];
+	linear_velocities[p_index] = body->get_linear_velocity();
+	angular_velocities[p_index] = body->get_angular_velocity();
+	biased_linear_velocities[p_index] = body->get_biased_linear_velocity();
+	biased_angular_velocities[p_index] = body->get_biased_angular_velocity();
+	inv_inertia_tensors[p_index] = body->get_inv_inertia_tensor();
+	centers_of_mass[p_index] = body->get_center_of_mass();
+	inv_masses[p_index] = body->get_inv_mass();
+}
+
+void GodotSolverBodies3D::store_body(uint32_t p_index) const {
+	GodotBody3D *body = bodies[p_index];
+	if (body->get_mode() <= PhysicsServer3D::BODY_MODE_KINEMATIC) {
+		// Not modified by the solver, and can be shared with other islands.
+		return;
+	}
+	body->set_linear_velocity(linear_velocities[p_index]);
+	body->set_angular_velocity(angular_velocities[p_index]);
+	body->set_biased_linear_velocity(biased_linear_velocities[p_index]);
+	body->set_biased_angular_velocity(biased_angular_velocities[p_index]);
+}
+
+void GodotSolverBodies3D::store_bodies() const {
+	for (uint32_t i = 0; i < bodies.size(); i++) {
+		store_body(i);
+	}
+}
+
+void GodotSolverBodies3D::set_constraint_count(uint32_t p_count) {
+	constraint_uses_bodies.resize(p_count);
+}
+
+void GodotSolverBodies3D::solve_constraint_with_bodies(GodotConstraint3D *p_constraint, real_t p_step) {
+	GodotBody3D **constraint_bodies = p_constraint->get_body_ptr();
+	int constraint_body_count = p_constraint->get_body_count();
+
+	for (int i = 0; i < constraint_body_count; i++) {
+		store_body(body_indices[constraint_bodies[i]]);
+	}
+
+	p_constraint->solve(p_step);
+
+	for (int i = 0; i < constraint_body_count; i++) {
+		load_body(body_indices[constraint_bodies[i]]);
+	}
+}
+
+void GodotSolverBodies3D::clear() {
+	body_indices.clear();
+	bodies.clear();
+	linear_velocities.clear();
+	angular_velocities.clear();
+	biased_linear_velocities.clear();
+	biased_angular_velocities.clear();
+	inv_inertia_tensors.clear();
+	centers_of_mass.clear();
+	inv_masses.clear();
+	constraint_uses_bodies.clear();
+}
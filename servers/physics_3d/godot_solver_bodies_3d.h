@@ -0,0 +1,103 @@
+/**************************************************************************/
+/*  godot_solver_bodies_3d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef GODOT_SOLVER_BODIES_3D_H
+#define GODOT_SOLVER_BODIES_3D_H
+
+#include "godot_body_3d.h"
+
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+class GodotConstraint3D;
+
+// State of the bodies of a constraint island used while solving its
+// constraints, stored in contiguous arrays and addressed by index so that
+// solver iterations don't go through the body objects.
+class GodotSolverBodies3D {
+	HashMap<GodotBody3D *, uint32_t> body_indices;
+	LocalVector<GodotBody3D *> bodies;
+
+	LocalVector<Vector3> linear_velocities;
+	LocalVector<Vector3> angular_velocities;
+	LocalVector<Vector3> biased_linear_velocities;
+	LocalVector<Vector3> biased_angular_velocities;
+	LocalVector<Basis> inv_inertia_tensors;
+	LocalVector<Vector3> centers_of_mass;
+	LocalVector<real_t> inv_masses;
+
+	// Constraints which use the bodies directly, in island order.
+	LocalVector<uint8_t> constraint_uses_bodies;
+
+public:
+	uint32_t add_body(GodotBody3D *p_body);
+	uint32_t get_body_count() const { return bodies.size(); }
+
+	void load_body(uint32_t p_index);
+	void store_body(uint32_t p_index) const;
+	void store_bodies() const;
+
+	// Constraints that don't use the solver state get their bodies synced
+	// around each of their solver iterations.
+	void set_constraint_count(uint32_t p_count);
+	void set_constraint_uses_bodies(uint32_t p_constraint_index, bool p_uses_bodies) { constraint_uses_bodies[p_constraint_index] = p_uses_bodies; }
+	bool is_constraint_using_bodies(uint32_t p_constraint_index) const { return constraint_uses_bodies[p_constraint_index]; }
+	void move_constraint(uint32_t p_from, uint32_t p_to) { constraint_uses_bodies[p_to] = constraint_uses_bodies[p_from]; }
+	void solve_constraint_with_bodies(GodotConstraint3D *p_constraint, real_t p_step);
+
+	void clear();
+
+	_FORCE_INLINE_ const Vector3 &get_linear_velocity(uint32_t p_index) const { return linear_velocities[p_index]; }
+	_FORCE_INLINE_ const Vector3 &get_angular_velocity(uint32_t p_index) const { return angular_velocities[p_index]; }
+	_FORCE_INLINE_ const Vector3 &get_biased_linear_velocity(uint32_t p_index) const { return biased_linear_velocities[p_index]; }
+	_FORCE_INLINE_ const Vector3 &get_biased_angular_velocity(uint32_t p_index) const { return biased_angular_velocities[p_index]; }
+	_FORCE_INLINE_ const Basis &get_inv_inertia_tensor(uint32_t p_index) const { return inv_inertia_tensors[p_index]; }
+	_FORCE_INLINE_ const Vector3 &get_center_of_mass(uint32_t p_index) const { return centers_of_mass[p_index]; }
+	_FORCE_INLINE_ real_t get_inv_mass(uint32_t p_index) const { return inv_masses[p_index]; }
+
+	// Same as the GodotBody3D methods.
+	_FORCE_INLINE_ void apply_impulse(uint32_t p_index, const Vector3 &p_impulse, const Vector3 &p_position = Vector3()) {
+		linear_velocities[p_index] += p_impulse * inv_masses[p_index];
+		angular_velocities[p_index] += inv_inertia_tensors[p_index].xform((p_position - centers_of_mass[p_index]).cross(p_impulse));
+	}
+
+	_FORCE_INLINE_ void apply_bias_impulse(uint32_t p_index, const Vector3 &p_impulse, const Vector3 &p_position = Vector3(), real_t p_max_delta_av = -1.0) {
+		biased_linear_velocities[p_index] += p_impulse * inv_masses[p_index];
+		if (p_max_delta_av != 0.0) {
+			Vector3 delta_av = inv_inertia_tensors[p_index].xform((p_position - centers_of_mass[p_index]).cross(p_impulse));
+			if (p_max_delta_av > 0 && delta_av.length() > p_max_delta_av) {
+				delta_av = delta_av.normalized() * p_max_delta_av;
+			}
+			biased_angular_velocities[p_index] += delta_av;
+		}
+	}
+};
+
+#endif // GODOT_SOLVER_BODIES_3D_H
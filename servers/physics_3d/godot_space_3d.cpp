@@ -34,7 +34,10 @@
 #include "godot_physics_server_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/io/marshalls.h"
+#include "core/object/worker_thread_pool.h"
 
+#define QUERY_BATCH_MIN_TASK_SIZE 64
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
 
@@ -108,13 +111,20 @@ int GodotPhysicsDirectSpaceState3D::intersect_point(const PointParameters &p_par
 bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
 	ERR_FAIL_COND_V(space->locked, false);
 
+	QueryScratch scratch;
+	scratch.results = space->intersection_query_results;
+	scratch.subindex_results = space->intersection_query_subindex_results;
+	return _intersect_ray(p_parameters, p_parameters.from, p_parameters.to, r_result, scratch);
+}
+
+bool GodotPhysicsDirectSpaceState3D::_intersect_ray(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, QueryScratch &r_scratch) {
 	Vector3 begin, end;
 	Vector3 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = _cull_segment(begin, end, r_scratch);
 
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
@@ -125,21 +135,21 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	real_t min_d = 1e10;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_scratch.results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.pick_ray && !(space->intersection_query_results[i]->is_ray_pickable())) {
+		if (p_parameters.pick_ray && !(r_scratch.results[i]->is_ray_pickable())) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_scratch.results[i]->get_self())) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
+		const GodotCollisionObject3D *col_obj = r_scratch.results[i];
 
-		int shape_idx = space->intersection_query_subindex_results[i];
+		int shape_idx = r_scratch.subindex_results[i];
 		Transform3D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -260,51 +270,58 @@ bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parame
 	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
 	ERR_FAIL_COND_V(!shape, false);
 
-	AABB aabb = p_parameters.transform.xform(shape->get_aabb());
-	aabb = aabb.merge(AABB(aabb.position + p_parameters.motion, aabb.size)); //motion
+	QueryScratch scratch;
+	scratch.results = space->intersection_query_results;
+	scratch.subindex_results = space->intersection_query_subindex_results;
+	return _cast_motion(p_parameters, shape, p_parameters.transform, p_parameters.motion, p_closest_safe, p_closest_unsafe, r_info, scratch);
+}
+
+bool GodotPhysicsDirectSpaceState3D::_cast_motion(const ShapeParameters &p_parameters, GodotShape3D *p_shape, const Transform3D &p_transform, const Vector3 &p_motion, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info, QueryScratch &r_scratch) {
+	AABB aabb = p_transform.xform(p_shape->get_aabb());
+	aabb = aabb.merge(AABB(aabb.position + p_motion, aabb.size)); //motion
 	aabb = aabb.grow(p_parameters.margin);
 
-	int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+	int amount = _cull_aabb(aabb, r_scratch);
 
 	real_t best_safe = 1;
 	real_t best_unsafe = 1;
 
-	Transform3D xform_inv = p_parameters.transform.affine_inverse();
+	Transform3D xform_inv = p_transform.affine_inverse();
 	GodotMotionShape3D mshape;
-	mshape.shape = shape;
-	mshape.motion = xform_inv.basis.xform(p_parameters.motion);
+	mshape.shape = p_shape;
+	mshape.motion = xform_inv.basis.xform(p_motion);
 
 	bool best_first = true;
 
-	Vector3 motion_normal = p_parameters.motion.normalized();
+	Vector3 motion_normal = p_motion.normalized();
 
 	Vector3 closest_A, closest_B;
 
 	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+		if (!_can_collide_with(r_scratch.results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
 			continue;
 		}
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_parameters.exclude.has(r_scratch.results[i]->get_self())) {
 			continue; //ignore excluded
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
-		int shape_idx = space->intersection_query_subindex_results[i];
+		const GodotCollisionObject3D *col_obj = r_scratch.results[i];
+		int shape_idx = r_scratch.subindex_results[i];
 
 		Vector3 point_A, point_B;
 		Vector3 sep_axis = motion_normal;
 
 		Transform3D col_obj_xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
 		//test initial overlap, does it collide if going all the way?
-		if (GodotCollisionSolver3D::solve_distance(&mshape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (GodotCollisionSolver3D::solve_distance(&mshape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
 			continue;
 		}
 
 		//test initial overlap, ignore objects it's inside of.
 		sep_axis = motion_normal;
 
-		if (!GodotCollisionSolver3D::solve_distance(shape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
+		if (!GodotCollisionSolver3D::solve_distance(p_shape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, point_A, point_B, aabb, &sep_axis)) {
 			continue;
 		}
 
@@ -315,11 +332,11 @@ bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parame
 		for (int j = 0; j < 8; j++) { //steps should be customizable..
 			real_t fraction = low + (hi - low) * fraction_coeff;
 
-			mshape.motion = xform_inv.basis.xform(p_parameters.motion * fraction);
+			mshape.motion = xform_inv.basis.xform(p_motion * fraction);
 
 			Vector3 lA, lB;
 			Vector3 sep = motion_normal; //important optimization for this to work fast enough
-			bool collided = !GodotCollisionSolver3D::solve_distance(&mshape, p_parameters.transform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, aabb, &sep);
+			bool collided = !GodotCollisionSolver3D::solve_distance(&mshape, p_transform, col_obj->get_shape(shape_idx), col_obj_xform, lA, lB, aabb, &sep);
 
 			if (collided) {
 				hi = fraction;
@@ -375,6 +392,118 @@ bool GodotPhysicsDirectSpaceState3D::cast_motion(const ShapeParameters &p_parame
 	return true;
 }
 
+int GodotPhysicsDirectSpaceState3D::_cull_segment(const Vector3 &p_from, const Vector3 &p_to, QueryScratch &r_scratch) {
+	if (r_scratch.hits) {
+		return space->broadphase->cull_segment_concurrent(p_from, p_to, *r_scratch.hits, r_scratch.results, GodotSpace3D::INTERSECTION_QUERY_MAX, r_scratch.subindex_results);
+	}
+	return space->broadphase->cull_segment(p_from, p_to, r_scratch.results, GodotSpace3D::INTERSECTION_QUERY_MAX, r_scratch.subindex_results);
+}
+
+int GodotPhysicsDirectSpaceState3D::_cull_aabb(const AABB &p_aabb, QueryScratch &r_scratch) {
+	if (r_scratch.hits) {
+		return space->broadphase->cull_aabb_concurrent(p_aabb, *r_scratch.hits, r_scratch.results, GodotSpace3D::INTERSECTION_QUERY_MAX, r_scratch.subindex_results);
+	}
+	return space->broadphase->cull_aabb(p_aabb, r_scratch.results, GodotSpace3D::INTERSECTION_QUERY_MAX, r_scratch.subindex_results);
+}
+
+int GodotPhysicsDirectSpaceState3D::_get_batch_task_count(int p_count) {
+	int max_task_count = WorkerThreadPool::get_singleton()->get_thread_count() * 4;
+	return CLAMP((p_count + QUERY_BATCH_MIN_TASK_SIZE - 1) / QUERY_BATCH_MIN_TASK_SIZE, 1, MAX(max_task_count, 1));
+}
+
+void GodotPhysicsDirectSpaceState3D::_intersect_ray_batch(uint32_t p_task_index, RayBatch *p_batch) {
+	LocalVector<GodotCollisionObject3D *> results;
+	results.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+	LocalVector<int> subindex_results;
+	subindex_results.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+	LocalVector<uint32_t, uint32_t, true> hits;
+
+	QueryScratch scratch;
+	scratch.results = results.ptr();
+	scratch.subindex_results = subindex_results.ptr();
+	scratch.hits = &hits;
+
+	int from = p_task_index * p_batch->task_size;
+	int to = MIN(from + p_batch->task_size, p_batch->count);
+	for (int i = from; i < to; i++) {
+		p_batch->hits[i] = _intersect_ray(*p_batch->parameters, p_batch->from[i], p_batch->to[i], p_batch->results[i], scratch);
+	}
+}
+
+void GodotPhysicsDirectSpaceState3D::_cast_motion_batch(uint32_t p_task_index, MotionBatch *p_batch) {
+	LocalVector<GodotCollisionObject3D *> results;
+	results.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+	LocalVector<int> subindex_results;
+	subindex_results.resize(GodotSpace3D::INTERSECTION_QUERY_MAX);
+	LocalVector<uint32_t, uint32_t, true> hits;
+
+	QueryScratch scratch;
+	scratch.results = results.ptr();
+	scratch.subindex_results = subindex_results.ptr();
+	scratch.hits = &hits;
+
+	int from = p_task_index * p_batch->task_size;
+	int to = MIN(from + p_batch->task_size, p_batch->count);
+	for (int i = from; i < to; i++) {
+		_cast_motion(*p_batch->parameters, p_batch->shape, p_batch->transforms[i], p_batch->motions[i], p_batch->closest_safe[i], p_batch->closest_unsafe[i], nullptr, scratch);
+	}
+}
+
+void GodotPhysicsDirectSpaceState3D::intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits) {
+	ERR_FAIL_COND(space->locked);
+	if (p_count <= 0) {
+		return;
+	}
+
+	RayBatch batch;
+	batch.parameters = &p_parameters;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.results = r_results;
+	batch.hits = r_hits;
+	batch.count = p_count;
+
+	// The space can't change while the calling thread waits, so the queries can share it without locking.
+	int task_count = _get_batch_task_count(p_count);
+	batch.task_size = (p_count + task_count - 1) / task_count;
+	if (task_count == 1) {
+		_intersect_ray_batch(0, &batch);
+		return;
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState3D::_intersect_ray_batch, &batch, task_count, -1, true, SNAME("Physics3DIntersectRays"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+}
+
+bool GodotPhysicsDirectSpaceState3D::cast_motions(const ShapeParameters &p_parameters, const Transform3D *p_transforms, const Vector3 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) {
+	ERR_FAIL_COND_V(space->locked, false);
+	GodotShape3D *shape = GodotPhysicsServer3D::godot_singleton->shape_owner.get_or_null(p_parameters.shape_rid);
+	ERR_FAIL_COND_V(!shape, false);
+	if (p_count <= 0) {
+		return true;
+	}
+
+	MotionBatch batch;
+	batch.parameters = &p_parameters;
+	batch.shape = shape;
+	batch.transforms = p_transforms;
+	batch.motions = p_motions;
+	batch.closest_safe = r_closest_safe;
+	batch.closest_unsafe = r_closest_unsafe;
+	batch.count = p_count;
+
+	int task_count = _get_batch_task_count(p_count);
+	batch.task_size = (p_count + task_count - 1) / task_count;
+	if (task_count == 1) {
+		_cast_motion_batch(0, &batch);
+		return true;
+	}
+
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState3D::_cast_motion_batch, &batch, task_count, -1, true, SNAME("Physics3DCastMotions"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	return true;
+}
+
 bool GodotPhysicsDirectSpaceState3D::collide_shape(const ShapeParameters &p_parameters, Vector3 *r_results, int p_result_max, int &r_result_count) {
 	if (p_result_max <= 0) {
 		return false;
@@ -1178,10 +1307,208 @@ void GodotSpace3D::setup() {
 	}
 }
 
+GodotSpace3D::Island *GodotSpace3D::create_island(uint64_t &r_island_id) {
+	r_island_id = ++last_island_id;
+	return &islands.insert(r_island_id, Island())->value;
+}
+
 void GodotSpace3D::update() {
 	broadphase->update();
 }
 
+// Snapshot layout, in native byte order:
+// - header: version, body count.
+// - for each body, sorted by RID: RID, GodotBody3D::SnapshotState field by field, constraint count.
+// - for each constraint the body comes first in: RID of the other body, order key, cached state size and data.
+static const uint32_t SNAPSHOT_VERSION = 2;
+static const uint32_t SNAPSHOT_HEADER_SIZE = sizeof(uint32_t) * 2;
+static const uint32_t SNAPSHOT_BODY_STATE_SIZE = sizeof(Transform3D) * 2 + sizeof(Vector3) * 2 + sizeof(Vector3) * 2 + sizeof(real_t) + sizeof(bool);
+static const uint32_t SNAPSHOT_BODY_SIZE = sizeof(uint64_t) + SNAPSHOT_BODY_STATE_SIZE + sizeof(uint32_t);
+static const uint32_t SNAPSHOT_CONSTRAINT_SIZE = sizeof(uint64_t) * 2 + sizeof(uint32_t);
+
+struct _SnapshotBodyOrder3D {
+	template <class T>
+	_FORCE_INLINE_ bool operator()(const T &p_a, const T &p_b) const {
+		return p_a.body->get_self().get_id() < p_b.body->get_self().get_id();
+	}
+};
+
+static _FORCE_INLINE_ uint64_t _get_snapshot_other_body_id(const GodotConstraint3D *p_constraint) {
+	return p_constraint->get_body_count() > 1 ? p_constraint->get_body_ptr()[1]->get_self().get_id() : 0;
+}
+
+// Fields are copied one by one, so no padding bytes end up in the snapshot.
+// Only for types without padding of their own.
+template <typename T>
+static _FORCE_INLINE_ void _save_snapshot_field(const T &p_value, uint8_t *&r_w) {
+	memcpy(r_w, &p_value, sizeof(T));
+	r_w += sizeof(T);
+}
+
+template <typename T>
+static _FORCE_INLINE_ void _load_snapshot_field(T &r_value, const uint8_t *&r_r) {
+	memcpy(&r_value, r_r, sizeof(T));
+	r_r += sizeof(T);
+}
+
+static void _save_snapshot_body_state(const GodotBody3D::SnapshotState &p_state, uint8_t *&r_w) {
+	_save_snapshot_field(p_state.transform, r_w);
+	_save_snapshot_field(p_state.new_transform, r_w);
+	_save_snapshot_field(p_state.linear_velocity, r_w);
+	_save_snapshot_field(p_state.angular_velocity, r_w);
+	_save_snapshot_field(p_state.prev_linear_velocity, r_w);
+	_save_snapshot_field(p_state.prev_angular_velocity, r_w);
+	_save_snapshot_field(p_state.still_time, r_w);
+	_save_snapshot_field(p_state.active, r_w);
+}
+
+static void _load_snapshot_body_state(GodotBody3D::SnapshotState &r_state, const uint8_t *p_r) {
+	_load_snapshot_field(r_state.transform, p_r);
+	_load_snapshot_field(r_state.new_transform, p_r);
+	_load_snapshot_field(r_state.linear_velocity, p_r);
+	_load_snapshot_field(r_state.angular_velocity, p_r);
+	_load_snapshot_field(r_state.prev_linear_velocity, p_r);
+	_load_snapshot_field(r_state.prev_angular_velocity, p_r);
+	_load_snapshot_field(r_state.still_time, p_r);
+	_load_snapshot_field(r_state.active, p_r);
+}
+
+Vector<uint8_t> GodotSpace3D::save_snapshot() {
+	snapshot_bodies.clear();
+	for (GodotCollisionObject3D *object : objects) {
+		if (object->get_type() == GodotCollisionObject3D::TYPE_BODY) {
+			SnapshotBody snapshot_body;
+			snapshot_body.body = static_cast<GodotBody3D *>(object);
+			snapshot_bodies.push_back(snapshot_body);
+		}
+	}
+	snapshot_bodies.sort_custom<_SnapshotBodyOrder3D>();
+
+	// Compute the exact size first so the buffer is only allocated once.
+	uint32_t size = SNAPSHOT_HEADER_SIZE;
+	for (const SnapshotBody &snapshot_body : snapshot_bodies) {
+		size += SNAPSHOT_BODY_SIZE;
+		for (const KeyValue<GodotConstraint3D *, int> &E : snapshot_body.body->get_constraint_map()) {
+			uint32_t state_size = E.key->get_cached_state_size();
+			if (E.value == 0 && state_size > 0) {
+				size += SNAPSHOT_CONSTRAINT_SIZE + state_size;
+			}
+		}
+	}
+
+	Vector<uint8_t> snapshot;
+	snapshot.resize(size);
+	uint8_t *w = snapshot.ptrw();
+
+	w += encode_uint32(SNAPSHOT_VERSION, w);
+	w += encode_uint32(snapshot_bodies.size(), w);
+
+	for (const SnapshotBody &snapshot_body : snapshot_bodies) {
+		const GodotBody3D *body = snapshot_body.body;
+		GodotBody3D::SnapshotState state;
+		body->save_snapshot_state(state);
+
+		w += encode_uint64(body->get_self().get_id(), w);
+		_save_snapshot_body_state(state, w);
+
+		uint8_t *constraint_count_w = w;
+		w += sizeof(uint32_t);
+		uint32_t constraint_count = 0;
+		for (const KeyValue<GodotConstraint3D *, int> &E : body->get_constraint_map()) {
+			uint32_t state_size = E.key->get_cached_state_size();
+			if (E.value != 0 || state_size == 0) {
+				continue; // Saved with the other body, or nothing to save.
+			}
+			w += encode_uint64(_get_snapshot_other_body_id(E.key), w);
+			w += encode_uint64(E.key->get_order_key(), w);
+			w += encode_uint32(state_size, w);
+			E.key->save_cached_state(w);
+			w += state_size;
+			constraint_count++;
+		}
+		encode_uint32(constraint_count, constraint_count_w);
+	}
+
+	return snapshot;
+}
+
+bool GodotSpace3D::load_snapshot(const Vector<uint8_t> &p_snapshot) {
+	const uint8_t *r = p_snapshot.ptr();
+	uint32_t size = p_snapshot.size();
+	ERR_FAIL_COND_V_MSG(size < SNAPSHOT_HEADER_SIZE || decode_uint32(r) != SNAPSHOT_VERSION, false, "Invalid physics space snapshot.");
+	uint32_t body_count = decode_uint32(r + sizeof(uint32_t));
+
+	snapshot_body_map.clear();
+	for (GodotCollisionObject3D *object : objects) {
+		if (object->get_type() == GodotCollisionObject3D::TYPE_BODY) {
+			snapshot_body_map.insert(object->get_self().get_id(), static_cast<GodotBody3D *>(object));
+		}
+	}
+
+	// Check the whole snapshot before touching any body.
+	snapshot_bodies.clear();
+	uint32_t offset = SNAPSHOT_HEADER_SIZE;
+	for (uint32_t i = 0; i < body_count; i++) {
+		ERR_FAIL_COND_V_MSG(offset + SNAPSHOT_BODY_SIZE > size, false, "Invalid physics space snapshot.");
+		GodotBody3D **body = snapshot_body_map.getptr(decode_uint64(r + offset));
+		ERR_FAIL_NULL_V_MSG(body, false, "Physics space snapshot contains a body that isn't in the space anymore.");
+
+		SnapshotBody snapshot_body;
+		snapshot_body.body = *body;
+		snapshot_body.state_offset = offset + sizeof(uint64_t);
+		offset += SNAPSHOT_BODY_SIZE;
+		snapshot_body.constraint_count = decode_uint32(r + offset - sizeof(uint32_t));
+
+		for (uint32_t j = 0; j < snapshot_body.constraint_count; j++) {
+			ERR_FAIL_COND_V_MSG(offset + SNAPSHOT_CONSTRAINT_SIZE > size, false, "Invalid physics space snapshot.");
+			offset += SNAPSHOT_CONSTRAINT_SIZE + decode_uint32(r + offset + sizeof(uint64_t) * 2);
+			ERR_FAIL_COND_V_MSG(offset > size, false, "Invalid physics space snapshot.");
+		}
+		snapshot_bodies.push_back(snapshot_body);
+	}
+
+	for (const SnapshotBody &snapshot_body : snapshot_bodies) {
+		GodotBody3D::SnapshotState state;
+		_load_snapshot_body_state(state, r + snapshot_body.state_offset);
+		snapshot_body.body->load_snapshot_state(state);
+	}
+
+	// Pair the bodies at their restored positions, then give the pairs back their contacts.
+	update();
+
+	for (const SnapshotBody &snapshot_body : snapshot_bodies) {
+		const uint8_t *constraints_r = r + snapshot_body.state_offset + SNAPSHOT_BODY_STATE_SIZE + sizeof(uint32_t);
+		for (const KeyValue<GodotConstraint3D *, int> &E : snapshot_body.body->get_constraint_map()) {
+			GodotConstraint3D *constraint = E.key;
+			uint32_t state_size = constraint->get_cached_state_size();
+			if (E.value != 0 || state_size == 0) {
+				continue;
+			}
+
+			uint64_t other_body_id = _get_snapshot_other_body_id(constraint);
+			uint64_t key = constraint->get_order_key();
+			bool found = false;
+			const uint8_t *record_r = constraints_r;
+			for (uint32_t j = 0; j < snapshot_body.constraint_count; j++) {
+				uint32_t record_size = decode_uint32(record_r + sizeof(uint64_t) * 2);
+				if (decode_uint64(record_r) == other_body_id && decode_uint64(record_r + sizeof(uint64_t)) == key && record_size == state_size) {
+					constraint->load_cached_state(record_r + SNAPSHOT_CONSTRAINT_SIZE);
+					found = true;
+					break;
+				}
+				record_r += SNAPSHOT_CONSTRAINT_SIZE + record_size;
+			}
+
+			if (!found) {
+				// The pair didn't exist when the snapshot was taken.
+				constraint->clear_cached_state();
+			}
+		}
+	}
+
+	return true;
+}
+
 void GodotSpace3D::set_param(PhysicsServer3D::SpaceParameter p_param, real_t p_value) {
 	switch (p_param) {
 		case PhysicsServer3D::SPACE_PARAM_CONTACT_RECYCLE_RADIUS:
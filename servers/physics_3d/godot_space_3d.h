@@ -41,11 +41,50 @@
 
 #include "core/config/project_settings.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/typedefs.h"
 
 class GodotPhysicsDirectSpaceState3D : public PhysicsDirectSpaceState3D {
 	GDCLASS(GodotPhysicsDirectSpaceState3D, PhysicsDirectSpaceState3D);
 
+	// Where the broadphase results of a query are stored.
+	// With hits set, the query doesn't use any shared buffer and can run on any thread.
+	struct QueryScratch {
+		GodotCollisionObject3D **results = nullptr;
+		int *subindex_results = nullptr;
+		LocalVector<uint32_t, uint32_t, true> *hits = nullptr;
+	};
+
+	struct RayBatch {
+		const RayParameters *parameters = nullptr;
+		const Vector3 *from = nullptr;
+		const Vector3 *to = nullptr;
+		RayResult *results = nullptr;
+		bool *hits = nullptr;
+		int count = 0;
+		int task_size = 0;
+	};
+
+	struct MotionBatch {
+		const ShapeParameters *parameters = nullptr;
+		GodotShape3D *shape = nullptr;
+		const Transform3D *transforms = nullptr;
+		const Vector3 *motions = nullptr;
+		real_t *closest_safe = nullptr;
+		real_t *closest_unsafe = nullptr;
+		int count = 0;
+		int task_size = 0;
+	};
+
+	int _cull_segment(const Vector3 &p_from, const Vector3 &p_to, QueryScratch &r_scratch);
+	int _cull_aabb(const AABB &p_aabb, QueryScratch &r_scratch);
+	bool _intersect_ray(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, RayResult &r_result, QueryScratch &r_scratch);
+	bool _cast_motion(const ShapeParameters &p_parameters, GodotShape3D *p_shape, const Transform3D &p_transform, const Vector3 &p_motion, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info, QueryScratch &r_scratch);
+
+	static int _get_batch_task_count(int p_count);
+	void _intersect_ray_batch(uint32_t p_task_index, RayBatch *p_batch);
+	void _cast_motion_batch(uint32_t p_task_index, MotionBatch *p_batch);
+
 public:
 	GodotSpace3D *space = nullptr;
 
@@ -53,6 +92,8 @@ public:
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) override;
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info = nullptr) override;
+	virtual void intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_count, RayResult *r_results, bool *r_hits) override;
+	virtual bool cast_motions(const ShapeParameters &p_parameters, const Transform3D *p_transforms, const Vector3 *p_motions, int p_count, real_t *r_closest_safe, real_t *r_closest_unsafe) override;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector3 *r_results, int p_result_max, int &r_result_count) override;
 	virtual bool rest_info(const ShapeParameters &p_parameters, ShapeRestInfo *r_info) override;
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const override;
@@ -64,6 +105,7 @@ class GodotSpace3D {
 public:
 	enum ElapsedTime {
 		ELAPSED_TIME_INTEGRATE_FORCES,
+		ELAPSED_TIME_BROADPHASE,
 		ELAPSED_TIME_GENERATE_ISLANDS,
 		ELAPSED_TIME_SETUP_CONSTRAINTS,
 		ELAPSED_TIME_SOLVE_CONSTRAINTS,
@@ -72,6 +114,13 @@ public:
 
 	};
 
+	// Constraint islands are kept between steps until the constraints of one of
+	// their bodies change, so they don't have to be found again.
+	struct Island {
+		LocalVector<GodotBody3D *> bodies;
+		LocalVector<GodotConstraint3D *> constraints;
+	};
+
 private:
 	uint64_t elapsed_time[ELAPSED_TIME_MAX] = {};
 
@@ -91,6 +140,16 @@ private:
 
 	HashSet<GodotCollisionObject3D *> objects;
 
+	struct SnapshotBody {
+		GodotBody3D *body = nullptr;
+		uint32_t state_offset = 0;
+		uint32_t constraint_count = 0;
+	};
+
+	// Kept between snapshots to avoid reallocating them every frame.
+	LocalVector<SnapshotBody> snapshot_bodies;
+	HashMap<uint64_t, GodotBody3D *> snapshot_body_map;
+
 	GodotArea3D *area = nullptr;
 
 	int solver_iterations = 0;
@@ -124,6 +183,9 @@ private:
 	Vector<Vector3> contact_debug;
 	int contact_debug_count = 0;
 
+	HashMap<uint64_t, Island> islands;
+	uint64_t last_island_id = 0;
+
 	friend class GodotPhysicsDirectSpaceState3D;
 
 	int _cull_aabb_for_body(GodotBody3D *p_body, const AABB &p_aabb);
@@ -173,6 +235,9 @@ public:
 	void setup();
 	void call_queries();
 
+	Vector<uint8_t> save_snapshot();
+	bool load_snapshot(const Vector<uint8_t> &p_snapshot);
+
 	bool is_locked() const;
 	void lock();
 	void unlock();
@@ -183,6 +248,10 @@ public:
 	void set_param(PhysicsServer3D::SpaceParameter p_param, real_t p_value);
 	real_t get_param(PhysicsServer3D::SpaceParameter p_param) const;
 
+	Island *create_island(uint64_t &r_island_id);
+	const Island *get_island(uint64_t p_island_id) const { return islands.getptr(p_island_id); }
+	void invalidate_island(uint64_t p_island_id) { islands.erase(p_island_id); }
+
 	void set_island_count(int p_island_count) { island_count = p_island_count; }
 	int get_island_count() const { return island_count; }
 
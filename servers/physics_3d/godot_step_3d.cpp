@@ -34,16 +34,22 @@
 
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
+#include "core/templates/hash_set.h"
 
 #define BODY_ISLAND_COUNT_RESERVE 128
 #define BODY_ISLAND_SIZE_RESERVE 512
 #define ISLAND_COUNT_RESERVE 128
 #define ISLAND_SIZE_RESERVE 512
 #define CONSTRAINT_COUNT_RESERVE 1024
+#define CONSTRAINT_SETUP_BATCH_SIZE 64
 
-void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island) {
+void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island, GodotSpace3D::Island *r_island) {
 	p_body->set_island_step(_step);
 
+	if (r_island) {
+		r_island->bodies.push_back(p_body);
+	}
+
 	if (p_body->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
 		// Only rigid bodies are tested for activation.
 		p_body_island.push_back(p_body);
@@ -71,11 +77,14 @@ void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D
 			if (other_body->get_mode() == PhysicsServer3D::BODY_MODE_STATIC) {
 				continue; // Static bodies don't connect islands.
 			}
-			_populate_island(other_body, p_body_island, p_constraint_island);
+			_populate_island(other_body, p_body_island, p_constraint_island, r_island);
 		}
 
 		// Find connected soft bodies.
 		for (int i = 0; i < constraint->get_soft_body_count(); i++) {
+			// Changes to the constraints of soft bodies don't invalidate islands.
+			island_cacheable = false;
+
 			GodotSoftBody3D *soft_body = constraint->get_soft_body_ptr(i);
 			if (soft_body->get_island_step() == _step) {
 				continue; // Already processed.
@@ -85,6 +94,41 @@ void GodotStep3D::_populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D
 	}
 }
 
+void GodotStep3D::_store_island_constraints(GodotSpace3D::Island *r_island) const {
+	// Taken from the bodies instead of the walk, which skips the constraints
+	// already claimed by the islands of moving areas.
+	HashSet<GodotConstraint3D *> constraints;
+	for (const GodotBody3D *body : r_island->bodies) {
+		for (const KeyValue<GodotConstraint3D *, int> &E : body->get_constraint_map()) {
+			if (!constraints.has(E.key)) {
+				constraints.insert(E.key);
+				r_island->constraints.push_back(E.key);
+			}
+		}
+	}
+}
+
+void GodotStep3D::_populate_island_from_cache(const GodotSpace3D::Island &p_island, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island) {
+	for (GodotBody3D *body : p_island.bodies) {
+		body->set_island_step(_step);
+
+		if (body->get_mode() > PhysicsServer3D::BODY_MODE_KINEMATIC) {
+			// Only rigid bodies are tested for activation.
+			p_body_island.push_back(body);
+		}
+	}
+
+	for (GodotConstraint3D *constraint : p_island.constraints) {
+		if (constraint->get_island_step() == _step) {
+			continue; // Already processed.
+		}
+		constraint->set_island_step(_step);
+		p_constraint_island.push_back(constraint);
+
+		all_constraints.push_back(constraint);
+	}
+}
+
 void GodotStep3D::_populate_island_soft_body(GodotSoftBody3D *p_soft_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island) {
 	p_soft_body->set_island_step(_step);
 
@@ -107,14 +151,23 @@ void GodotStep3D::_populate_island_soft_body(GodotSoftBody3D *p_soft_body, Local
 			if (body->get_mode() == PhysicsServer3D::BODY_MODE_STATIC) {
 				continue; // Static bodies don't connect islands.
 			}
-			_populate_island(body, p_body_island, p_constraint_island);
+			_populate_island(body, p_body_island, p_constraint_island, nullptr);
 		}
 	}
 }
 
-void GodotStep3D::_setup_constraint(uint32_t p_constraint_index, void *p_userdata) {
-	GodotConstraint3D *constraint = all_constraints[p_constraint_index];
-	constraint->setup(delta);
+void GodotStep3D::_setup_constraint_batch(uint32_t p_batch_index, void *p_userdata) {
+	GodotNarrowPhase3D &narrow_phase = narrow_phases[p_batch_index];
+	narrow_phase.clear();
+
+	uint32_t from = p_batch_index * CONSTRAINT_SETUP_BATCH_SIZE;
+	uint32_t to = MIN(from + CONSTRAINT_SETUP_BATCH_SIZE, all_constraints.size());
+	for (uint32_t constraint_index = from; constraint_index < to; ++constraint_index) {
+		all_constraints[constraint_index]->setup_batched(delta, &narrow_phase);
+	}
+
+	// Collisions between primitive shapes are solved together.
+	narrow_phase.solve();
 }
 
 void GodotStep3D::_pre_solve_island(LocalVector<GodotConstraint3D *> &p_constraint_island) const {
@@ -133,6 +186,21 @@ void GodotStep3D::_pre_solve_island(LocalVector<GodotConstraint3D *> &p_constrai
 void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
 	LocalVector<GodotConstraint3D *> &constraint_island = constraint_islands[p_island_index];
 
+	// Gather the state of the island's bodies in contiguous arrays.
+	GodotSolverBodies3D &solver_bodies = island_solver_bodies[p_island_index];
+	solver_bodies.clear();
+	solver_bodies.set_constraint_count(constraint_island.size());
+	for (uint32_t constraint_index = 0; constraint_index < constraint_island.size(); ++constraint_index) {
+		GodotConstraint3D *constraint = constraint_island[constraint_index];
+		bool uses_bodies = !constraint->bind_solver_bodies(&solver_bodies);
+		if (uses_bodies) {
+			for (int i = 0; i < constraint->get_body_count(); i++) {
+				solver_bodies.add_body(constraint->get_body_ptr()[i]);
+			}
+		}
+		solver_bodies.set_constraint_uses_bodies(constraint_index, uses_bodies);
+	}
+
 	int current_priority = 1;
 
 	uint32_t constraint_count = constraint_island.size();
@@ -140,7 +208,11 @@ void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
 		for (int i = 0; i < iterations; i++) {
 			// Go through all iterations.
 			for (uint32_t constraint_index = 0; constraint_index < constraint_count; ++constraint_index) {
-				constraint_island[constraint_index]->solve(delta);
+				if (solver_bodies.is_constraint_using_bodies(constraint_index)) {
+					solver_bodies.solve_constraint_with_bodies(constraint_island[constraint_index], delta);
+				} else {
+					constraint_island[constraint_index]->solve(delta);
+				}
 			}
 		}
 
@@ -151,37 +223,52 @@ void GodotStep3D::_solve_island(uint32_t p_island_index, void *p_userdata) {
 			GodotConstraint3D *constraint = constraint_island[constraint_index];
 			if (constraint->get_priority() >= current_priority) {
 				// Keep this constraint for the next iteration.
+				solver_bodies.move_constraint(constraint_index, priority_constraint_count);
 				constraint_island[priority_constraint_count++] = constraint;
 			}
 		}
 		constraint_count = priority_constraint_count;
 	}
+
+	solver_bodies.store_bodies();
 }
 
-void GodotStep3D::_check_suspend(const LocalVector<GodotBody3D *> &p_body_island) const {
+void GodotStep3D::_test_island_sleep(uint32_t p_island_index, void *p_userdata) {
+	const LocalVector<GodotBody3D *> &body_island = body_islands[p_island_index];
+
 	bool can_sleep = true;
 
-	uint32_t body_count = p_body_island.size();
+	// Every body is tested, as the test also updates the time it has been still for.
+	uint32_t body_count = body_island.size();
 	for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
-		GodotBody3D *body = p_body_island[body_index];
+		GodotBody3D *body = body_island[body_index];
 
 		if (!body->sleep_test(delta)) {
 			can_sleep = false;
 		}
 	}
 
+	body_island_can_sleep[p_island_index] = can_sleep;
+}
+
+void GodotStep3D::_check_suspend(const LocalVector<GodotBody3D *> &p_body_island, bool p_can_sleep) const {
 	// Put all to sleep or wake up everyone.
+	uint32_t body_count = p_body_island.size();
 	for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
 		GodotBody3D *body = p_body_island[body_index];
 
 		bool active = body->is_active();
 
-		if (active == can_sleep) {
-			body->set_active(!can_sleep);
+		if (active == p_can_sleep) {
+			body->set_active(!p_can_sleep);
 		}
 	}
 }
 
+void GodotStep3D::_solve_soft_body_constraints(uint32_t p_soft_body_index, void *p_userdata) {
+	active_soft_bodies[p_soft_body_index]->solve_constraints(delta);
+}
+
 void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	p_space->lock(); // can't access space during this
 
@@ -212,21 +299,34 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* UPDATE SOFT BODY MOTION */
 
+	// Predicting motion updates the soft body's shape in the broadphase, so soft bodies are
+	// processed one at a time, each of them splitting its nodes across threads.
+	active_soft_bodies.clear();
 	const SelfList<GodotSoftBody3D> *sb = soft_body_list->first();
 	while (sb) {
-		sb->self()->predict_motion(p_delta);
+		sb->self()->predict_motion(p_delta, true);
+		active_soft_bodies.push_back(sb->self());
 		sb = sb->next();
 		active_count++;
 	}
 
 	p_space->set_active_objects(active_count);
 
+	{ //profile
+		profile_endtime = OS::get_singleton()->get_ticks_usec();
+		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_INTEGRATE_FORCES, profile_endtime - profile_begtime);
+		profile_begtime = profile_endtime;
+	}
+
+	/* BROADPHASE */
+
 	// Update the broadphase to register collision pairs.
+	// The pairs of many moved objects are searched on the worker threads, but created in a deterministic order.
 	p_space->update();
 
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
-		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_INTEGRATE_FORCES, profile_endtime - profile_begtime);
+		p_space->set_elapsed_time(GodotSpace3D::ELAPSED_TIME_BROADPHASE, profile_endtime - profile_begtime);
 		profile_begtime = profile_endtime;
 	}
 
@@ -260,6 +360,8 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* GENERATE CONSTRAINT ISLANDS FOR ACTIVE RIGID BODIES */
 
+	// Islands are reused from the previous steps while the constraints of their bodies don't change.
+	// Sleeping islands aren't visited, as none of their bodies are in the active list.
 	b = body_list->first();
 
 	uint32_t body_island_count = 0;
@@ -284,7 +386,27 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 			constraint_island.clear();
 			constraint_island.reserve(ISLAND_SIZE_RESERVE);
 
-			_populate_island(body, body_island, constraint_island);
+			const GodotSpace3D::Island *cached_island = p_space->get_island(body->get_island_id());
+			if (cached_island) {
+				_populate_island_from_cache(*cached_island, body_island, constraint_island);
+			} else {
+				uint64_t island_id = 0;
+				GodotSpace3D::Island *island = p_space->create_island(island_id);
+				island_cacheable = true;
+				_populate_island(body, body_island, constraint_island, island);
+
+				if (island_cacheable) {
+					_store_island_constraints(island);
+					for (GodotBody3D *island_body : island->bodies) {
+						if (island_body->get_island_id() != island_id) {
+							island_body->invalidate_island();
+							island_body->set_island_id(island_id);
+						}
+					}
+				} else {
+					p_space->invalidate_island(island_id);
+				}
+			}
 
 			if (body_island.is_empty()) {
 				--body_island_count;
@@ -344,7 +466,11 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 	/* SETUP CONSTRAINTS / PROCESS COLLISIONS */
 
 	uint32_t total_constraint_count = all_constraints.size();
-	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_setup_constraint, nullptr, total_constraint_count, -1, true, SNAME("Physics3DConstraintSetup"));
+	uint32_t setup_batch_count = (total_constraint_count + CONSTRAINT_SETUP_BATCH_SIZE - 1) / CONSTRAINT_SETUP_BATCH_SIZE;
+	if (narrow_phases.size() < setup_batch_count) {
+		narrow_phases.resize(setup_batch_count);
+	}
+	WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_setup_constraint_batch, nullptr, setup_batch_count, -1, true, SNAME("Physics3DConstraintSetup"));
 	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 
 	{ //profile
@@ -364,6 +490,9 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	// Warning: _solve_island modifies the constraint islands for optimization purpose,
 	// their content is not reliable after these calls and shouldn't be used anymore.
+	if (island_solver_bodies.size() < island_count) {
+		island_solver_bodies.resize(island_count);
+	}
 	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_island, nullptr, island_count, -1, true, SNAME("Physics3DConstraintSolveIslands"));
 	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 
@@ -384,16 +513,23 @@ void GodotStep3D::step(GodotSpace3D *p_space, real_t p_delta) {
 
 	/* SLEEP / WAKE UP ISLANDS */
 
+	// Sleep tests only involve each island's own bodies, but changing the activation state
+	// updates the space's lists, so that part doesn't run on threads.
+	body_island_can_sleep.resize(body_island_count);
+	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_test_island_sleep, nullptr, body_island_count, -1, true, SNAME("Physics3DTestIslandSleep"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
 	for (uint32_t island_index = 0; island_index < body_island_count; ++island_index) {
-		_check_suspend(body_islands[island_index]);
+		_check_suspend(body_islands[island_index], body_island_can_sleep[island_index]);
 	}
 
 	/* UPDATE SOFT BODY CONSTRAINTS */
 
-	sb = soft_body_list->first();
-	while (sb) {
-		sb->self()->solve_constraints(p_delta);
-		sb = sb->next();
+	if (active_soft_bodies.size() == 1) {
+		active_soft_bodies[0]->solve_constraints(p_delta, true);
+	} else if (active_soft_bodies.size() > 1) {
+		group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep3D::_solve_soft_body_constraints, nullptr, active_soft_bodies.size(), -1, true, SNAME("Physics3DSolveSoftBodyConstraints"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 	}
 
 	{ //profile
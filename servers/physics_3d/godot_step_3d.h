@@ -31,6 +31,8 @@
 #ifndef GODOT_STEP_3D_H
 #define GODOT_STEP_3D_H
 
+#include "godot_narrow_phase_3d.h"
+#include "godot_solver_bodies_3d.h"
 #include "godot_space_3d.h"
 
 #include "core/templates/local_vector.h"
@@ -44,13 +46,23 @@ class GodotStep3D {
 	LocalVector<LocalVector<GodotBody3D *>> body_islands;
 	LocalVector<LocalVector<GodotConstraint3D *>> constraint_islands;
 	LocalVector<GodotConstraint3D *> all_constraints;
+	LocalVector<uint8_t> body_island_can_sleep;
+	LocalVector<GodotNarrowPhase3D> narrow_phases;
+	LocalVector<GodotSolverBodies3D> island_solver_bodies;
+	LocalVector<GodotSoftBody3D *> active_soft_bodies;
 
-	void _populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island);
+	bool island_cacheable = false;
+
+	void _populate_island(GodotBody3D *p_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island, GodotSpace3D::Island *r_island);
+	void _store_island_constraints(GodotSpace3D::Island *r_island) const;
+	void _populate_island_from_cache(const GodotSpace3D::Island &p_island, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island);
 	void _populate_island_soft_body(GodotSoftBody3D *p_soft_body, LocalVector<GodotBody3D *> &p_body_island, LocalVector<GodotConstraint3D *> &p_constraint_island);
-	void _setup_constraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
+	void _setup_constraint_batch(uint32_t p_batch_index, void *p_userdata = nullptr);
 	void _pre_solve_island(LocalVector<GodotConstraint3D *> &p_constraint_island) const;
 	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr);
-	void _check_suspend(const LocalVector<GodotBody3D *> &p_body_island) const;
+	void _test_island_sleep(uint32_t p_island_index, void *p_userdata = nullptr);
+	void _check_suspend(const LocalVector<GodotBody3D *> &p_body_island, bool p_can_sleep) const;
+	void _solve_soft_body_constraints(uint32_t p_soft_body_index, void *p_userdata = nullptr);
 
 public:
 	void step(GodotSpace3D *p_space, real_t p_delta);
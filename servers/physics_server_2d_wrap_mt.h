@@ -125,6 +125,23 @@ public:
 		return physics_server_2d->space_get_contact_count(p_space);
 	}
 
+	virtual Vector<uint8_t> space_save_snapshot(RID p_space) override {
+		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), Vector<uint8_t>());
+		return physics_server_2d->space_save_snapshot(p_space);
+	}
+
+	virtual bool space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) override {
+		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), false);
+		return physics_server_2d->space_restore_snapshot(p_space, p_snapshot);
+	}
+
+	FUNC2(space_set_deterministic, RID, bool);
+	FUNC1RC(bool, space_is_deterministic, RID);
+	virtual uint32_t space_get_state_checksum(RID p_space) const override {
+		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), 0);
+		return physics_server_2d->space_get_state_checksum(p_space);
+	}
+
 	/* AREA API */
 
 	//FUNC0RID(area);
@@ -88,6 +88,7 @@ public:
 	FUNCRID(custom_shape)
 
 	FUNC2(shape_set_data, RID, const Variant &);
+	FUNC3(heightmap_shape_update_region, RID, const Rect2i &, const Vector<real_t> &);
 	FUNC2(shape_set_custom_solver_bias, RID, real_t);
 
 	FUNC2(shape_set_margin, RID, real_t)
@@ -129,6 +130,16 @@ public:
 		return physics_server_3d->space_get_contact_count(p_space);
 	}
 
+	virtual Vector<uint8_t> space_save_snapshot(RID p_space) override {
+		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), Vector<uint8_t>());
+		return physics_server_3d->space_save_snapshot(p_space);
+	}
+
+	virtual bool space_restore_snapshot(RID p_space, const Vector<uint8_t> &p_snapshot) override {
+		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), false);
+		return physics_server_3d->space_restore_snapshot(p_space, p_snapshot);
+	}
+
 	/* AREA API */
 
 	//FUNC0RID(area);
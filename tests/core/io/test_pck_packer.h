@@ -117,6 +117,67 @@ TEST_CASE("[PCKPacker] Pack a PCK file with some files and directories") {
 			f->get_length() <= 35000,
 			"The generated non-empty PCK file shouldn't be too large.");
 }
+
+TEST_CASE("[PCKPacker] Files with identical contents are stored once") {
+	const String base_dir = OS::get_singleton()->get_executable_path().get_base_dir();
+
+	PCKPacker pck_packer_single;
+	const String single_pck_path = OS::get_singleton()->get_cache_path().path_join("output_single.pck");
+	REQUIRE(pck_packer_single.pck_start(single_pck_path) == OK);
+	CHECK(pck_packer_single.add_file("icon.png", base_dir.path_join("../icon.png")) == OK);
+	CHECK(pck_packer_single.flush() == OK);
+
+	PCKPacker pck_packer_dup;
+	const String dup_pck_path = OS::get_singleton()->get_cache_path().path_join("output_duplicates.pck");
+	REQUIRE(pck_packer_dup.pck_start(dup_pck_path) == OK);
+	CHECK(pck_packer_dup.add_file("icon.png", base_dir.path_join("../icon.png")) == OK);
+	CHECK(pck_packer_dup.add_file("copies/icon.png", base_dir.path_join("../icon.png")) == OK);
+	CHECK(pck_packer_dup.add_file("copies/other/icon.png", base_dir.path_join("../icon.png")) == OK);
+	CHECK(pck_packer_dup.flush() == OK);
+
+	const uint64_t single_size = FileAccess::open(single_pck_path, FileAccess::READ)->get_length();
+	const uint64_t dup_size = FileAccess::open(dup_pck_path, FileAccess::READ)->get_length();
+	CHECK_MESSAGE(
+			dup_size < single_size + 500,
+			"Duplicated files should only add directory entries to the PCK, not their contents.");
+}
+
+TEST_CASE("[PCKPacker] Patch packs only store files that changed") {
+	const String base_dir = OS::get_singleton()->get_executable_path().get_base_dir();
+
+	PCKPacker pck_packer_base;
+	const String base_pck_path = OS::get_singleton()->get_cache_path().path_join("output_patch_base.pck");
+	REQUIRE(pck_packer_base.pck_start(base_pck_path) == OK);
+	CHECK(pck_packer_base.add_file("icon.png", base_dir.path_join("../icon.png")) == OK);
+	CHECK(pck_packer_base.add_file("logo.png", base_dir.path_join("../logo.png")) == OK);
+	CHECK(pck_packer_base.flush() == OK);
+
+	PCKPacker pck_packer_patch;
+	const String patch_pck_path = OS::get_singleton()->get_cache_path().path_join("output_patch.pck");
+	REQUIRE(pck_packer_patch.pck_start(patch_pck_path) == OK);
+	CHECK(pck_packer_patch.set_patch_base(base_pck_path) == OK);
+	CHECK(pck_packer_patch.add_file("icon.png", base_dir.path_join("../icon.png")) == OK);
+	CHECK(pck_packer_patch.add_file("logo.png", base_dir.path_join("../icon.svg")) == OK);
+	CHECK(pck_packer_patch.flush() == OK);
+
+	const uint64_t base_size = FileAccess::open(base_pck_path, FileAccess::READ)->get_length();
+	const uint64_t patch_size = FileAccess::open(patch_pck_path, FileAccess::READ)->get_length();
+	const uint64_t changed_size = FileAccess::open(base_dir.path_join("../icon.svg"), FileAccess::READ)->get_length();
+	CHECK_MESSAGE(
+			patch_size < base_size,
+			"The patch PCK should be smaller than the base PCK.");
+	CHECK_MESSAGE(
+			patch_size < changed_size + 500,
+			"The patch PCK should only hold the contents of the changed file.");
+
+	PCKPacker pck_packer_invalid;
+	REQUIRE(pck_packer_invalid.pck_start(OS::get_singleton()->get_cache_path().path_join("output_patch_invalid.pck")) == OK);
+	ERR_PRINT_OFF;
+	CHECK_MESSAGE(
+			pck_packer_invalid.set_patch_base(base_dir.path_join("../icon.svg")) != OK,
+			"Using a file that isn't a PCK as patch base should fail.");
+	ERR_PRINT_ON;
+}
 } // namespace TestPCKPacker
 
 #endif // TEST_PCK_PACKER_H
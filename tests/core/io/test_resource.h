@@ -109,6 +109,47 @@ TEST_CASE("[Resource] Saving and loading") {
 			loaded_child_resource_text->get_name() == "I'm a child resource",
 			"The loaded child resource name should be equal to the expected value.");
 }
+
+TEST_CASE("[Resource] Soft cache") {
+	// Resources use the default memory usage estimate of 1 KiB.
+	ResourceCache::set_soft_cache_budget(2048);
+
+	Ref<Resource> resource_a = memnew(Resource);
+	Ref<Resource> resource_b = memnew(Resource);
+	Ref<Resource> resource_c = memnew(Resource);
+	resource_a->set_path("res://soft_cache_a.tres");
+	resource_b->set_path("res://soft_cache_b.tres");
+	resource_c->set_path("res://soft_cache_c.tres");
+
+	const uint64_t evictions = ResourceCache::get_soft_cache_eviction_count();
+
+	ResourceCache::touch(resource_a);
+	ResourceCache::touch(resource_b);
+	CHECK(ResourceCache::get_soft_cache_resource_count() == 2);
+	CHECK(ResourceCache::get_soft_cache_usage() == 2048);
+
+	// Touching again makes resource A the most recently used, so B is evicted first.
+	ResourceCache::touch(resource_a);
+	ResourceCache::touch(resource_c);
+	CHECK(ResourceCache::get_soft_cache_resource_count() == 2);
+	CHECK(ResourceCache::get_soft_cache_eviction_count() == evictions + 1);
+
+	const ObjectID id_a = resource_a->get_instance_id();
+	const ObjectID id_b = resource_b->get_instance_id();
+	resource_a.unref();
+	resource_b.unref();
+	CHECK_MESSAGE(ObjectDB::get_instance(id_a) != nullptr, "The soft cache should keep resource A alive.");
+	CHECK_MESSAGE(ResourceCache::has("res://soft_cache_a.tres"), "Resource A should still be found by path.");
+	CHECK_MESSAGE(ObjectDB::get_instance(id_b) == nullptr, "Evicted resource B should be freed.");
+
+	ResourceCache::clear_soft_cache();
+	CHECK(ResourceCache::get_soft_cache_resource_count() == 0);
+	CHECK(ResourceCache::get_soft_cache_usage() == 0);
+	CHECK_MESSAGE(ObjectDB::get_instance(id_a) == nullptr, "Clearing the soft cache should free resource A.");
+
+	ResourceCache::set_soft_cache_budget(0);
+}
+
 } // namespace TestResource
 
 #endif // TEST_RESOURCE_H
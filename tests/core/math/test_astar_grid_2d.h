@@ -0,0 +1,229 @@
+/**************************************************************************/
+/*  test_astar_grid_2d.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_ASTAR_GRID_2D_H
+#define TEST_ASTAR_GRID_2D_H
+
+#include "core/math/a_star_grid_2d.h"
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestAStarGrid2D {
+
+static real_t path_length(const Vector<Vector2> &p_path) {
+	real_t length = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += p_path[i - 1].distance_to(p_path[i]);
+	}
+	return length;
+}
+
+// Makes about a fifth of the grid solid, keeping the queried points walkable.
+static void add_obstacles(Ref<AStarGrid2D> &p_astar, const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids, uint64_t p_seed) {
+	RandomPCG rng(p_seed);
+	const Size2i size = p_astar->get_size();
+	for (int y = 0; y < size.y; y++) {
+		for (int x = 0; x < size.x; x++) {
+			p_astar->set_point_solid(Vector2i(x, y), rng.rand(5) == 0);
+		}
+	}
+	for (int i = 0; i < p_from_ids.size(); i++) {
+		p_astar->set_point_solid(p_from_ids[i], false);
+		p_astar->set_point_solid(p_to_ids[i], false);
+	}
+}
+
+static void make_queries(const Size2i &p_size, int p_count, uint64_t p_seed, TypedArray<Vector2i> &r_from_ids, TypedArray<Vector2i> &r_to_ids) {
+	RandomPCG rng(p_seed);
+	for (int i = 0; i < p_count; i++) {
+		r_from_ids.push_back(Vector2i(rng.rand(p_size.x), rng.rand(p_size.y)));
+		r_to_ids.push_back(Vector2i(rng.rand(p_size.x), rng.rand(p_size.y)));
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Paths") {
+	Ref<AStarGrid2D> astar;
+	astar.instantiate();
+	astar->set_size(Size2i(5, 5));
+	astar->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_NEVER);
+	astar->update();
+
+	TypedArray<Vector2i> path = astar->get_id_path(Vector2i(0, 0), Vector2i(4, 4));
+	CHECK(path.size() == 9);
+	CHECK(Vector2i(path[0]) == Vector2i(0, 0));
+	CHECK(Vector2i(path[8]) == Vector2i(4, 4));
+
+	path = astar->get_id_path(Vector2i(2, 2), Vector2i(2, 2));
+	CHECK(path.size() == 1);
+
+	SUBCASE("Walls") {
+		for (int y = 0; y < 4; y++) {
+			astar->set_point_solid(Vector2i(2, y));
+		}
+		path = astar->get_id_path(Vector2i(0, 0), Vector2i(4, 0));
+		CHECK_MESSAGE(path.size() == 13, "The path should go around the wall.");
+
+		astar->set_point_solid(Vector2i(2, 4));
+		CHECK_MESSAGE(astar->get_id_path(Vector2i(0, 0), Vector2i(4, 0)).is_empty(), "There should be no path through a closed wall.");
+		CHECK_MESSAGE(astar->get_id_path(Vector2i(0, 0), Vector2i(2, 4)).is_empty(), "There should be no path to a solid point.");
+	}
+
+	SUBCASE("Resized grid") {
+		// Queries reuse their search state, which must follow the size of the grid.
+		astar->set_size(Size2i(3, 2));
+		astar->update();
+		path = astar->get_id_path(Vector2i(0, 0), Vector2i(2, 1));
+		CHECK(path.size() == 4);
+		CHECK(Vector2i(path[3]) == Vector2i(2, 1));
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Jumping") {
+	Ref<AStarGrid2D> astar;
+	astar.instantiate();
+	astar->set_size(Size2i(32, 32));
+	astar->set_default_compute_heuristic(AStarGrid2D::HEURISTIC_OCTILE);
+	astar->set_default_estimate_heuristic(AStarGrid2D::HEURISTIC_OCTILE);
+	astar->update();
+
+	TypedArray<Vector2i> from_ids;
+	TypedArray<Vector2i> to_ids;
+	make_queries(astar->get_size(), 16, 1, from_ids, to_ids);
+	add_obstacles(astar, from_ids, to_ids, 2);
+
+	for (int i = 0; i < from_ids.size(); i++) {
+		astar->set_jumping_enabled(false);
+		const Vector<Vector2> path = astar->get_point_path(from_ids[i], to_ids[i]);
+		astar->set_jumping_enabled(true);
+		const Vector<Vector2> jump_path = astar->get_point_path(from_ids[i], to_ids[i]);
+
+		REQUIRE(path.is_empty() == jump_path.is_empty());
+		if (path.is_empty()) {
+			continue;
+		}
+		CHECK(jump_path.size() <= path.size());
+		CHECK(jump_path[0] == path[0]);
+		CHECK(jump_path[jump_path.size() - 1] == path[path.size() - 1]);
+		CHECK_MESSAGE(path_length(jump_path) == doctest::Approx(path_length(path)), "Jumping should find paths as short as the plain search.");
+	}
+}
+
+TEST_CASE("[AStarGrid2D] Batch queries") {
+	Ref<AStarGrid2D> astar;
+	astar.instantiate();
+	astar->set_size(Size2i(64, 64));
+	astar->update();
+
+	TypedArray<Vector2i> from_ids;
+	TypedArray<Vector2i> to_ids;
+	make_queries(astar->get_size(), 64, 3, from_ids, to_ids);
+	from_ids.push_back(Vector2i(5, 5));
+	to_ids.push_back(Vector2i(5, 5));
+	add_obstacles(astar, from_ids, to_ids, 4);
+
+	// Walls a point in, so that at least one query has no route.
+	astar->set_point_solid(Vector2i(0, 1));
+	astar->set_point_solid(Vector2i(1, 0));
+	astar->set_point_solid(Vector2i(1, 1));
+	astar->set_point_solid(Vector2i(0, 0), false);
+	from_ids.push_back(Vector2i(0, 0));
+	to_ids.push_back(Vector2i(63, 63));
+	astar->set_point_solid(Vector2i(63, 63), false);
+
+	SUBCASE("Without jumping") {
+		astar->set_jumping_enabled(false);
+	}
+	SUBCASE("With jumping") {
+		astar->set_jumping_enabled(true);
+	}
+
+	const Array id_paths = astar->get_id_paths(from_ids, to_ids);
+	const Array point_paths = astar->get_point_paths(from_ids, to_ids);
+	REQUIRE(id_paths.size() == from_ids.size());
+	REQUIRE(point_paths.size() == from_ids.size());
+
+	for (int i = 0; i < from_ids.size(); i++) {
+		CHECK(TypedArray<Vector2i>(id_paths[i]) == astar->get_id_path(from_ids[i], to_ids[i]));
+		CHECK(Vector<Vector2>(point_paths[i]) == astar->get_point_path(from_ids[i], to_ids[i]));
+	}
+	CHECK(TypedArray<Vector2i>(id_paths[id_paths.size() - 1]).is_empty());
+
+	ERR_PRINT_OFF;
+	to_ids.pop_back();
+	CHECK_MESSAGE(astar->get_id_paths(from_ids, to_ids).is_empty(), "Arrays of different sizes should be rejected.");
+	to_ids.push_back(Vector2i(64, 0));
+	CHECK_MESSAGE(astar->get_id_paths(from_ids, to_ids).is_empty(), "Points out of bounds should be rejected.");
+	ERR_PRINT_ON;
+}
+
+TEST_CASE_BENCHMARK("[AStarGrid2D][Benchmark] Queries on a 1024x1024 grid") {
+	Ref<AStarGrid2D> astar;
+	astar.instantiate();
+	astar->set_size(Size2i(1024, 1024));
+	astar->set_default_compute_heuristic(AStarGrid2D::HEURISTIC_OCTILE);
+	astar->set_default_estimate_heuristic(AStarGrid2D::HEURISTIC_OCTILE);
+	astar->update();
+
+	TypedArray<Vector2i> from_ids;
+	TypedArray<Vector2i> to_ids;
+	make_queries(astar->get_size(), 16, 5, from_ids, to_ids);
+	add_obstacles(astar, from_ids, to_ids, 6);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	Vector<real_t> lengths;
+	for (int i = 0; i < from_ids.size(); i++) {
+		lengths.push_back(path_length(astar->get_point_path(from_ids[i], to_ids[i])));
+	}
+	const uint64_t astar_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	astar->set_jumping_enabled(true);
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < from_ids.size(); i++) {
+		CHECK(path_length(astar->get_point_path(from_ids[i], to_ids[i])) == doctest::Approx(lengths[i]));
+	}
+	const uint64_t jump_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	const Array paths = astar->get_point_paths(from_ids, to_ids);
+	const uint64_t batch_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	REQUIRE(paths.size() == from_ids.size());
+	for (int i = 0; i < paths.size(); i++) {
+		CHECK(path_length(paths[i]) == doctest::Approx(lengths[i]));
+	}
+
+	MESSAGE(vformat("%d queries took %d usec with A*, %d usec with jumping and %d usec with jumping in a batch.", from_ids.size(), astar_usec, jump_usec, batch_usec));
+}
+
+} // namespace TestAStarGrid2D
+
+#endif // TEST_ASTAR_GRID_2D_H
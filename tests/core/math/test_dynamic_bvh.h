@@ -0,0 +1,89 @@
+/**************************************************************************/
+/*  test_dynamic_bvh.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_DYNAMIC_BVH_H
+#define TEST_DYNAMIC_BVH_H
+
+#include "core/math/dynamic_bvh.h"
+
+#include "tests/test_macros.h"
+
+namespace TestDynamicBVH {
+
+struct CollectResults {
+	LocalVector<intptr_t> results;
+
+	bool operator()(void *p_data) {
+		results.push_back((intptr_t)p_data);
+		return false;
+	}
+};
+
+static LocalVector<intptr_t> query(DynamicBVH &p_tree, const AABB &p_aabb) {
+	CollectResults collect;
+	p_tree.aabb_query(p_aabb, collect);
+	return collect.results;
+}
+
+TEST_CASE("[DynamicBVH] Refitting moved leaves") {
+	DynamicBVH tree;
+	LocalVector<DynamicBVH::ID> ids;
+	for (int i = 0; i < 16; i++) {
+		ids.push_back(tree.insert(AABB(Vector3(i * 2, 0, 0), Vector3(1, 1, 1)), (void *)(intptr_t)i));
+	}
+
+	CHECK_MESSAGE(query(tree, AABB(Vector3(0, 10, 0), Vector3(40, 1, 1))).size() == 0, "No leaf should be found before moving.");
+
+	// Move every other leaf up.
+	for (int i = 0; i < 16; i += 2) {
+		tree.set_volume(ids[i], AABB(Vector3(i * 2, 10, 0), Vector3(1, 1, 1)));
+	}
+	tree.refit();
+
+	LocalVector<intptr_t> moved = query(tree, AABB(Vector3(0, 10, 0), Vector3(40, 1, 1)));
+	CHECK_MESSAGE(moved.size() == 8, "Moved leaves should be found at their new position.");
+	for (const intptr_t &data : moved) {
+		CHECK_MESSAGE(data % 2 == 0, "Only the moved leaves should be found.");
+	}
+	CHECK_MESSAGE(query(tree, AABB(Vector3(0, 0, 0), Vector3(40, 1, 1))).size() == 8, "Other leaves should stay in place.");
+
+	// The tree must stay consistent with regular updates after a refit.
+	tree.update(ids[1], AABB(Vector3(2, 10, 0), Vector3(1, 1, 1)));
+	CHECK(query(tree, AABB(Vector3(0, 10, 0), Vector3(40, 1, 1))).size() == 9);
+
+	for (const DynamicBVH::ID &id : ids) {
+		tree.remove(id);
+	}
+	CHECK(tree.is_empty());
+}
+
+} // namespace TestDynamicBVH
+
+#endif // TEST_DYNAMIC_BVH_H
@@ -31,6 +31,7 @@
 #ifndef TEST_VARIANT_H
 #define TEST_VARIANT_H
 
+#include "core/os/os.h"
 #include "core/variant/variant.h"
 #include "core/variant/variant_parser.h"
 
@@ -126,6 +127,70 @@ TEST_CASE("[Variant] Writer and parser Variant::FLOAT") {
 	CHECK_MESSAGE(float_parsed == 1.0e+100, "Should match the double literal.");
 }
 
+TEST_CASE("[Variant] Parser packed arrays") {
+	String errs;
+	int line = 1;
+	Variant variant_parsed;
+
+	VariantParser::StreamString ss;
+	ss.s = "PackedVector3Array(1, -2.5, 3e2,\n\t4,5 , -6e-1 ; comment\n, 7, inf, -8)";
+	CHECK(VariantParser::parse(&ss, variant_parsed, errs, line) == OK);
+	CHECK(line == 3);
+	PackedVector3Array vec3_array = variant_parsed;
+	REQUIRE(vec3_array.size() == 3);
+	CHECK(vec3_array[0].is_equal_approx(Vector3(1, -2.5, 300)));
+	CHECK(vec3_array[1].is_equal_approx(Vector3(4, 5, -0.6)));
+	CHECK(vec3_array[2].x == 7);
+	CHECK(Math::is_inf(vec3_array[2].y));
+	CHECK(vec3_array[2].z == -8);
+
+	VariantParser::StreamString ss_int;
+	ss_int.s = "PackedInt32Array(-2147483648, 0, 2147483647)";
+	CHECK(VariantParser::parse(&ss_int, variant_parsed, errs, line) == OK);
+	PackedInt32Array int_array = variant_parsed;
+	REQUIRE(int_array.size() == 3);
+	CHECK(int_array[0] == INT32_MIN);
+	CHECK(int_array[1] == 0);
+	CHECK(int_array[2] == INT32_MAX);
+
+	VariantParser::StreamString ss_empty;
+	ss_empty.s = "PackedFloat32Array( )";
+	CHECK(VariantParser::parse(&ss_empty, variant_parsed, errs, line) == OK);
+	CHECK(PackedFloat32Array(variant_parsed).is_empty());
+
+	ERR_PRINT_OFF;
+	VariantParser::StreamString ss_invalid;
+	ss_invalid.s = "PackedFloat32Array(1, 2";
+	CHECK(VariantParser::parse(&ss_invalid, variant_parsed, errs, line) == ERR_PARSE_ERROR);
+
+	VariantParser::StreamString ss_invalid_value;
+	ss_invalid_value.s = "PackedFloat32Array(1, \"2\")";
+	CHECK(VariantParser::parse(&ss_invalid_value, variant_parsed, errs, line) == ERR_PARSE_ERROR);
+	ERR_PRINT_ON;
+}
+
+TEST_CASE_BENCHMARK("[Variant][Benchmark] Parser packed array throughput") {
+	const int value_count = 3 * 200000;
+	String text = "PackedVector3Array(";
+	for (int i = 0; i < value_count; i++) {
+		text += (i ? ", " : "") + rtos(i * 0.37 - 1000.0);
+	}
+	text += ")";
+
+	String errs;
+	int line = 1;
+	Variant variant_parsed;
+	VariantParser::StreamString ss;
+	ss.s = text;
+
+	const uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	CHECK(VariantParser::parse(&ss, variant_parsed, errs, line) == OK);
+	const uint64_t elapsed = MAX(OS::get_singleton()->get_ticks_usec() - begin, (uint64_t)1);
+
+	CHECK(PackedVector3Array(variant_parsed).size() == value_count / 3);
+	MESSAGE(vformat("Parsed %.1f MB of packed array text at %.1f MB/s.", text.length() / 1e6, text.length() / double(elapsed)));
+}
+
 TEST_CASE("[Variant] Assignment To Bool from Int,Float,String,Vec2,Vec2i,Vec3,Vec3i and Color") {
 	Variant int_v = 0;
 	Variant bool_v = true;
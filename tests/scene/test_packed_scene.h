@@ -0,0 +1,157 @@
+/**************************************************************************/
+/*  test_packed_scene.h                                                   */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PACKED_SCENE_H
+#define TEST_PACKED_SCENE_H
+
+#include "scene/2d/node_2d.h"
+#include "scene/gui/control.h"
+#include "scene/resources/packed_scene.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPackedScene {
+
+TEST_CASE("[PackedScene] Instantiate restores packed properties") {
+	Node2D *root = memnew(Node2D);
+	root->set_name("Root");
+	root->set_position(Vector2(10, 20));
+
+	Control *child = memnew(Control);
+	child->set_name("Child");
+	child->set_offset(SIDE_LEFT, 5);
+	child->set_modulate(Color(1, 0, 0));
+	root->add_child(child);
+	child->set_owner(root);
+
+	Ref<PackedScene> packed_scene;
+	packed_scene.instantiate();
+	CHECK(packed_scene->pack(root) == OK);
+	memdelete(root);
+
+	// Instantiate several times, so resolved setters are reused.
+	for (int i = 0; i < 3; i++) {
+		Node *instance = packed_scene->instantiate();
+		REQUIRE(instance != nullptr);
+
+		Node2D *instance_root = Object::cast_to<Node2D>(instance);
+		REQUIRE(instance_root != nullptr);
+		CHECK(instance_root->get_name() == "Root");
+		CHECK(instance_root->get_position().is_equal_approx(Vector2(10, 20)));
+
+		Control *instance_child = Object::cast_to<Control>(instance->get_node(NodePath("Child")));
+		REQUIRE(instance_child != nullptr);
+		CHECK(instance_child->get_owner() == instance);
+		CHECK(instance_child->get_offset(SIDE_LEFT) == doctest::Approx(5));
+		CHECK(instance_child->get_modulate().is_equal_approx(Color(1, 0, 0)));
+
+		memdelete(instance);
+	}
+}
+
+TEST_CASE("[PackedScene] Instance pooling") {
+	Node2D *root = memnew(Node2D);
+	root->set_name("Root");
+	root->set_position(Vector2(10, 20));
+
+	Node2D *child = memnew(Node2D);
+	child->set_name("Child");
+	root->add_child(child);
+	child->set_owner(root);
+
+	Ref<PackedScene> packed_scene;
+	packed_scene.instantiate();
+	CHECK(packed_scene->pack(root) == OK);
+	memdelete(root);
+
+	packed_scene->set_pool_capacity(1);
+
+	Node2D *instance = Object::cast_to<Node2D>(packed_scene->instantiate_pooled());
+	REQUIRE(instance != nullptr);
+	CHECK(packed_scene->get_pool_miss_count() == 1);
+	CHECK(packed_scene->get_pool_hit_count() == 0);
+
+	SUBCASE("Recycled instances are reset to their packed state") {
+		instance->set_position(Vector2(5, 5));
+		Node2D *instance_child = Object::cast_to<Node2D>(instance->get_node(NodePath("Child")));
+		instance_child->set_rotation(1.0);
+
+		CHECK(packed_scene->recycle_instance(instance));
+		CHECK(packed_scene->get_pooled_instance_count() == 1);
+
+		Node2D *recycled = Object::cast_to<Node2D>(packed_scene->instantiate_pooled());
+		CHECK(recycled == instance);
+		CHECK(packed_scene->get_pool_hit_count() == 1);
+		CHECK(packed_scene->get_pooled_instance_count() == 0);
+		CHECK(recycled->get_position().is_equal_approx(Vector2(10, 20)));
+		CHECK(instance_child->get_rotation() == doctest::Approx(0.0));
+
+		memdelete(recycled);
+	}
+
+	SUBCASE("Metadata and groups added at runtime are removed") {
+		instance->set_meta("runtime", 1);
+		instance->add_to_group("runtime_group");
+		CHECK(packed_scene->recycle_instance(instance));
+
+		Node *recycled = packed_scene->instantiate_pooled();
+		CHECK(recycled == instance);
+		CHECK_FALSE(recycled->has_meta("runtime"));
+		CHECK_FALSE(recycled->is_in_group("runtime_group"));
+		memdelete(recycled);
+	}
+
+	SUBCASE("Instances not created by the pool are freed") {
+		Node *foreign = packed_scene->instantiate();
+		CHECK_FALSE(packed_scene->recycle_instance(foreign));
+		CHECK(packed_scene->get_pooled_instance_count() == 0);
+		memdelete(instance);
+	}
+
+	SUBCASE("Instances with a modified structure are freed") {
+		instance->add_child(memnew(Node));
+		CHECK_FALSE(packed_scene->recycle_instance(instance));
+		CHECK(packed_scene->get_pooled_instance_count() == 0);
+	}
+
+	SUBCASE("Instances over capacity are freed") {
+		Node *other = packed_scene->instantiate_pooled();
+		CHECK(packed_scene->recycle_instance(instance));
+		CHECK_FALSE(packed_scene->recycle_instance(other));
+		CHECK(packed_scene->get_pooled_instance_count() == 1);
+	}
+
+	packed_scene->clear_pool();
+	CHECK(packed_scene->get_pooled_instance_count() == 0);
+}
+
+} // namespace TestPackedScene
+
+#endif // TEST_PACKED_SCENE_H
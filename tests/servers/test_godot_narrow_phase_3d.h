@@ -0,0 +1,260 @@
+/**************************************************************************/
+/*  test_godot_narrow_phase_3d.h                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_NARROW_PHASE_3D_H
+#define TEST_GODOT_NARROW_PHASE_3D_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "servers/physics_3d/godot_narrow_phase_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotNarrowPhase3D {
+
+struct PairResult {
+	int contact_count = 0;
+	bool collided = false;
+	bool finished = false;
+	real_t depth = 0;
+	Vector3 normal;
+	LocalVector<Vector3> points_A;
+};
+
+static void contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &p_normal, void *p_userdata) {
+	PairResult *result = static_cast<PairResult *>(p_userdata);
+	result->contact_count++;
+	result->depth = MAX(result->depth, p_point_A.distance_to(p_point_B));
+	result->normal = p_normal;
+	result->points_A.push_back(p_point_A);
+}
+
+static void narrow_phase_finished(bool p_collided, void *p_userdata) {
+	PairResult *result = static_cast<PairResult *>(p_userdata);
+	result->collided = p_collided;
+	result->finished = true;
+}
+
+struct RandomPairStats {
+	int collided_count = 0;
+	int mismatch_count = 0;
+	int unfinished_count = 0;
+	uint64_t batched_usec = 0;
+	uint64_t solver_usec = 0;
+};
+
+// Solves random pairs of the given shapes with the batched narrow phase and
+// with the collision solver, p_round_count times each.
+static RandomPairStats compare_random_pairs(const GodotShape3D *p_shape_A, const GodotShape3D *p_shape_B, int p_pair_count, int p_round_count) {
+	RandomPCG rng(42);
+	LocalVector<Transform3D> transforms_A;
+	LocalVector<Transform3D> transforms_B;
+	for (int i = 0; i < p_pair_count; i++) {
+		transforms_A.push_back(Transform3D(Basis::from_euler(Vector3(rng.random(-3.0f, 3.0f), rng.random(-3.0f, 3.0f), rng.random(-3.0f, 3.0f))), Vector3()));
+		transforms_B.push_back(Transform3D(Basis::from_euler(Vector3(rng.random(-3.0f, 3.0f), rng.random(-3.0f, 3.0f), rng.random(-3.0f, 3.0f))), Vector3(rng.random(-2.0f, 2.0f), rng.random(-2.0f, 2.0f), rng.random(-2.0f, 2.0f))));
+	}
+
+	RandomPairStats stats;
+	LocalVector<PairResult> batched_results;
+	batched_results.resize(p_pair_count);
+	GodotNarrowPhase3D narrow_phase;
+	for (int round = 0; round < p_round_count; round++) {
+		narrow_phase.clear();
+		for (int i = 0; i < p_pair_count; i++) {
+			batched_results[i] = PairResult();
+			narrow_phase.add_query(p_shape_A, transforms_A[i], p_shape_B, transforms_B[i], contact_added_callback, narrow_phase_finished, &batched_results[i]);
+		}
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		narrow_phase.solve();
+		stats.batched_usec += OS::get_singleton()->get_ticks_usec() - begin;
+	}
+
+	LocalVector<PairResult> results;
+	results.resize(p_pair_count);
+	for (int round = 0; round < p_round_count; round++) {
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < p_pair_count; i++) {
+			results[i] = PairResult();
+			results[i].collided = GodotCollisionSolver3D::solve_static(p_shape_A, transforms_A[i], p_shape_B, transforms_B[i], contact_added_callback, &results[i]);
+		}
+		stats.solver_usec += OS::get_singleton()->get_ticks_usec() - begin;
+	}
+
+	for (int i = 0; i < p_pair_count; i++) {
+		if (!batched_results[i].finished) {
+			stats.unfinished_count++;
+		}
+		if (batched_results[i].collided != results[i].collided || batched_results[i].contact_count != results[i].contact_count) {
+			stats.mismatch_count++;
+		}
+		if (results[i].collided) {
+			stats.collided_count++;
+		}
+	}
+	return stats;
+}
+
+struct PrimitiveShapes {
+	GodotSphereShape3D sphere;
+	GodotBoxShape3D box;
+	GodotCapsuleShape3D capsule;
+
+	const GodotShape3D *get(int p_index) const {
+		const GodotShape3D *shapes[] = { &sphere, &box, &capsule };
+		return shapes[p_index];
+	}
+
+	PrimitiveShapes() {
+		sphere.set_data(0.5);
+		box.set_data(Vector3(0.5, 0.7, 0.4));
+		Dictionary capsule_data;
+		capsule_data["radius"] = 0.4;
+		capsule_data["height"] = 1.8;
+		capsule.set_data(capsule_data);
+	}
+};
+
+TEST_CASE("[GodotNarrowPhase3D] Batched primitive pairs match the collision solver") {
+	PrimitiveShapes shapes;
+	for (int shape_A = 0; shape_A < 3; shape_A++) {
+		for (int shape_B = 0; shape_B < 3; shape_B++) {
+			RandomPairStats stats = compare_random_pairs(shapes.get(shape_A), shapes.get(shape_B), 256, 1);
+			CHECK(stats.unfinished_count == 0);
+			CHECK(stats.collided_count > 0);
+			CHECK(stats.collided_count < 256);
+			CHECK_MESSAGE(stats.mismatch_count == 0, "Batched results should match the collision solver.");
+		}
+	}
+}
+
+TEST_CASE("[GodotNarrowPhase3D] Capsules with parallel axes") {
+	PrimitiveShapes shapes;
+	const GodotShape3D *capsule = &shapes.capsule;
+
+	// Returns the batched result, after checking it against the collision solver.
+	auto solve_pair = [capsule](const Transform3D &p_transform_B, int p_contact_count) {
+		GodotNarrowPhase3D narrow_phase;
+		PairResult batched_result;
+		CHECK(narrow_phase.add_query(capsule, Transform3D(), capsule, p_transform_B, contact_added_callback, narrow_phase_finished, &batched_result));
+		narrow_phase.solve();
+
+		PairResult result;
+		result.collided = GodotCollisionSolver3D::solve_static(capsule, Transform3D(), capsule, p_transform_B, contact_added_callback, &result);
+
+		CHECK(batched_result.finished);
+		CHECK(batched_result.collided == result.collided);
+		CHECK(batched_result.contact_count == p_contact_count);
+		if (result.collided) {
+			CHECK(batched_result.depth == doctest::Approx(result.depth));
+			CHECK(batched_result.normal.dot(result.normal) == doctest::Approx(1.0));
+		}
+		return batched_result;
+	};
+
+	SUBCASE("Side by side") {
+		PairResult result = solve_pair(Transform3D(Basis(), Vector3(0.7, 0, 0)), 2);
+		REQUIRE(result.points_A.size() == 2);
+		CHECK(result.points_A[0].y == doctest::Approx(-0.5));
+		CHECK(result.points_A[1].y == doctest::Approx(0.5));
+	}
+
+	SUBCASE("Side by side with partial overlap") {
+		PairResult result = solve_pair(Transform3D(Basis(), Vector3(0.7, 0.8, 0)), 2);
+		REQUIRE(result.points_A.size() == 2);
+		CHECK(result.points_A[0].y == doctest::Approx(0.3));
+		CHECK(result.points_A[1].y == doctest::Approx(0.5));
+	}
+
+	SUBCASE("Anti-parallel") {
+		PairResult result = solve_pair(Transform3D(Basis(Vector3(0, 0, 1), Math_PI), Vector3(0, 0.3, 0.7)), 2);
+		REQUIRE(result.points_A.size() == 2);
+		CHECK(result.points_A[0].y == doctest::Approx(-0.2));
+		CHECK(result.points_A[1].y == doctest::Approx(0.5));
+	}
+
+	SUBCASE("Parallel and apart") {
+		solve_pair(Transform3D(Basis(), Vector3(0.9, 0, 0)), 0);
+	}
+
+	SUBCASE("Coaxial end to end") {
+		solve_pair(Transform3D(Basis(), Vector3(0, 1.7, 0)), 1);
+	}
+
+	SUBCASE("Coaxial and overlapping") {
+		GodotNarrowPhase3D narrow_phase;
+		PairResult batched_result;
+		narrow_phase.add_query(capsule, Transform3D(), capsule, Transform3D(Basis(), Vector3(0, 0.5, 0)), contact_added_callback, narrow_phase_finished, &batched_result);
+		narrow_phase.solve();
+
+		PairResult result;
+		result.collided = GodotCollisionSolver3D::solve_static(capsule, Transform3D(), capsule, Transform3D(Basis(), Vector3(0, 0.5, 0)), contact_added_callback, &result);
+		CHECK(batched_result.collided == result.collided);
+		CHECK(batched_result.contact_count == result.contact_count);
+	}
+}
+
+TEST_CASE_BENCHMARK("[GodotNarrowPhase3D][Benchmark] Batched primitive pairs") {
+	PrimitiveShapes shapes;
+	const int pair_count = 4096;
+	const int round_count = 8;
+	for (int shape_A = 0; shape_A < 3; shape_A++) {
+		for (int shape_B = 0; shape_B < 3; shape_B++) {
+			RandomPairStats stats = compare_random_pairs(shapes.get(shape_A), shapes.get(shape_B), pair_count, round_count);
+			MESSAGE(vformat("Shape types %d and %d: %d of %d pairs collided, batched narrow phase took %d usec, collision solver took %d usec.", shapes.get(shape_A)->get_type(), shapes.get(shape_B)->get_type(), stats.collided_count, pair_count, stats.batched_usec / round_count, stats.solver_usec / round_count));
+			CHECK(stats.mismatch_count == 0);
+		}
+	}
+}
+
+TEST_CASE("[GodotNarrowPhase3D] Unsupported pairs are rejected") {
+	GodotSphereShape3D sphere;
+	sphere.set_data(0.5);
+	GodotCylinderShape3D cylinder;
+	Dictionary cylinder_data;
+	cylinder_data["radius"] = 0.5;
+	cylinder_data["height"] = 1.0;
+	cylinder.set_data(cylinder_data);
+
+	GodotNarrowPhase3D narrow_phase;
+	PairResult result;
+	CHECK_FALSE(narrow_phase.add_query(&sphere, Transform3D(), &cylinder, Transform3D(), contact_added_callback, narrow_phase_finished, &result));
+	CHECK(narrow_phase.get_query_count() == 0);
+
+	CHECK(narrow_phase.add_query(&sphere, Transform3D(), &sphere, Transform3D(Basis(), Vector3(0.5, 0, 0)), contact_added_callback, narrow_phase_finished, &result));
+	CHECK(narrow_phase.get_query_count() == 1);
+	narrow_phase.solve();
+	CHECK(result.finished);
+	CHECK(result.collided);
+	CHECK(result.contact_count == 1);
+}
+
+} // namespace TestGodotNarrowPhase3D
+
+#endif // TEST_GODOT_NARROW_PHASE_3D_H
@@ -0,0 +1,413 @@
+/**************************************************************************/
+/*  test_godot_shape_3d.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_GODOT_SHAPE_3D_H
+#define TEST_GODOT_SHAPE_3D_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "servers/physics_3d/godot_shape_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestGodotShape3D {
+
+struct CullResult {
+	AABB aabb;
+	int face_count = 0;
+	int intersecting_face_count = 0;
+};
+
+static bool cull_callback(void *p_userdata, GodotShape3D *p_face) {
+	CullResult *result = static_cast<CullResult *>(p_userdata);
+	const GodotFaceShape3D *face = static_cast<const GodotFaceShape3D *>(p_face);
+	AABB face_aabb(face->vertex[0], Vector3());
+	face_aabb.expand_to(face->vertex[1]);
+	face_aabb.expand_to(face->vertex[2]);
+	result->face_count++;
+	if (result->aabb.intersects(face_aabb)) {
+		result->intersecting_face_count++;
+	}
+	return false;
+}
+
+static real_t terrain_height(RandomPCG &p_rng, int p_x, int p_z) {
+	return Math::sin(p_x * 0.05) * 8.0 + Math::cos(p_z * 0.07) * 6.0 + p_rng.random(0.0f, 0.5f);
+}
+
+static Vector<real_t> make_heights(int p_width, int p_depth, uint64_t p_seed) {
+	RandomPCG rng(p_seed);
+	Vector<real_t> heights;
+	heights.resize(p_width * p_depth);
+	real_t *w = heights.ptrw();
+	for (int z = 0; z < p_depth; z++) {
+		for (int x = 0; x < p_width; x++) {
+			w[z * p_width + x] = terrain_height(rng, x, z);
+		}
+	}
+	return heights;
+}
+
+static Dictionary make_heightmap_data(int p_width, int p_depth, const Vector<real_t> &p_heights) {
+	Dictionary d;
+	d["width"] = p_width;
+	d["depth"] = p_depth;
+	d["heights"] = p_heights;
+	return d;
+}
+
+static Vector<Vector3> make_terrain_faces(int p_size, uint64_t p_seed) {
+	Vector<real_t> heights = make_heights(p_size + 1, p_size + 1, p_seed);
+	Vector<Vector3> faces;
+	faces.resize(p_size * p_size * 6);
+	Vector3 *w = faces.ptrw();
+	int index = 0;
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			Vector3 p00(x, heights[z * (p_size + 1) + x], z);
+			Vector3 p10(x + 1, heights[z * (p_size + 1) + x + 1], z);
+			Vector3 p01(x, heights[(z + 1) * (p_size + 1) + x], z + 1);
+			Vector3 p11(x + 1, heights[(z + 1) * (p_size + 1) + x + 1], z + 1);
+			w[index++] = p00;
+			w[index++] = p10;
+			w[index++] = p01;
+			w[index++] = p10;
+			w[index++] = p11;
+			w[index++] = p01;
+		}
+	}
+	return faces;
+}
+
+static bool brute_force_intersect_segment(const Vector<Vector3> &p_faces, const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point) {
+	GodotFaceShape3D face;
+	bool found = false;
+	real_t min_distance = 1e20;
+	for (int i = 0; i < p_faces.size(); i += 3) {
+		face.vertex[0] = p_faces[i + 0];
+		face.vertex[1] = p_faces[i + 1];
+		face.vertex[2] = p_faces[i + 2];
+		face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
+		Vector3 point;
+		Vector3 normal;
+		if (face.intersect_segment(p_begin, p_end, point, normal, false)) {
+			real_t distance = p_begin.distance_to(point);
+			if (distance < min_distance) {
+				min_distance = distance;
+				r_point = point;
+				found = true;
+			}
+		}
+	}
+	return found;
+}
+
+struct ConcaveQueryStats {
+	int cull_mismatch_count = 0;
+	int ray_mismatch_count = 0;
+	int hit_count = 0;
+	uint64_t build_usec = 0;
+	uint64_t cull_usec = 0;
+	uint64_t ray_usec = 0;
+};
+
+static ConcaveQueryStats compare_concave_queries(int p_terrain_size, int p_query_count, int p_ray_count) {
+	ConcaveQueryStats stats;
+	Vector<Vector3> faces = make_terrain_faces(p_terrain_size, 7);
+
+	GodotConcavePolygonShape3D shape;
+	Dictionary d;
+	d["faces"] = faces;
+	d["backface_collision"] = false;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	shape.set_data(d);
+	stats.build_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	CHECK(shape.get_faces().size() == faces.size());
+
+	RandomPCG rng(11);
+	for (int i = 0; i < p_query_count; i++) {
+		AABB aabb(Vector3(rng.random(0.0f, (float)p_terrain_size), rng.random(-16.0f, 16.0f), rng.random(0.0f, (float)p_terrain_size)), Vector3(rng.random(0.1f, 8.0f), rng.random(0.1f, 8.0f), rng.random(0.1f, 8.0f)));
+		CullResult result;
+		result.aabb = aabb;
+		begin = OS::get_singleton()->get_ticks_usec();
+		shape.cull(aabb, cull_callback, &result, false);
+		stats.cull_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		int expected_count = 0;
+		for (int j = 0; j < faces.size(); j += 3) {
+			AABB face_aabb(faces[j], Vector3());
+			face_aabb.expand_to(faces[j + 1]);
+			face_aabb.expand_to(faces[j + 2]);
+			if (aabb.intersects(face_aabb)) {
+				expected_count++;
+			}
+		}
+		if (result.face_count != expected_count || result.intersecting_face_count != expected_count) {
+			stats.cull_mismatch_count++;
+		}
+	}
+
+	for (int i = 0; i < p_ray_count; i++) {
+		Vector3 from(rng.random(0.0f, (float)p_terrain_size), 40.0, rng.random(0.0f, (float)p_terrain_size));
+		Vector3 to(rng.random(0.0f, (float)p_terrain_size), -40.0, rng.random(0.0f, (float)p_terrain_size));
+		Vector3 point;
+		Vector3 normal;
+		begin = OS::get_singleton()->get_ticks_usec();
+		bool hit = shape.intersect_segment(from, to, point, normal, false);
+		stats.ray_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		Vector3 expected_point;
+		bool expected_hit = brute_force_intersect_segment(faces, from, to, expected_point);
+		if (hit != expected_hit || (hit && !point.is_equal_approx(expected_point))) {
+			stats.ray_mismatch_count++;
+		}
+		if (hit) {
+			stats.hit_count++;
+		}
+	}
+
+	return stats;
+}
+
+struct HeightMapQueryStats {
+	int cull_mismatch_count = 0;
+	int culled_face_count = 0;
+	int total_face_count = 0;
+	int hit_count = 0;
+	uint64_t build_usec = 0;
+	uint64_t cull_usec = 0;
+	uint64_t ray_usec = 0;
+};
+
+static HeightMapQueryStats compare_height_map_queries(int p_size, int p_query_count, int p_ray_count) {
+	HeightMapQueryStats stats;
+	Vector<real_t> heights = make_heights(p_size, p_size, 3);
+
+	GodotHeightMapShape3D shape;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	shape.set_data(make_heightmap_data(p_size, p_size, heights));
+	stats.build_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	RandomPCG rng(5);
+	const real_t max_query_size = MIN(64.0, p_size * 0.25);
+	for (int i = 0; i < p_query_count; i++) {
+		// Large queries, partly above the terrain.
+		Vector3 position(rng.random(-0.5f * p_size, 0.5f * p_size), rng.random(-20.0f, 20.0f), rng.random(-0.5f * p_size, 0.5f * p_size));
+		AABB aabb(position, Vector3(rng.random(1.0f, max_query_size), rng.random(0.5f, 4.0f), rng.random(1.0f, max_query_size)));
+		CullResult result;
+		result.aabb = aabb;
+		begin = OS::get_singleton()->get_ticks_usec();
+		shape.cull(aabb, cull_callback, &result, false);
+		stats.cull_usec += OS::get_singleton()->get_ticks_usec() - begin;
+
+		// Compare with every face of the cells below the query.
+		int expected_count = 0;
+		int cell_face_count = 0;
+		const Vector3 offset(-0.5 * (p_size - 1), 0, -0.5 * (p_size - 1));
+		const int begin_x = CLAMP(int(aabb.position.x - offset.x) - 2, 0, p_size - 1);
+		const int end_x = CLAMP(int(aabb.get_end().x - offset.x) + 2, 0, p_size - 1);
+		const int begin_z = CLAMP(int(aabb.position.z - offset.z) - 2, 0, p_size - 1);
+		const int end_z = CLAMP(int(aabb.get_end().z - offset.z) + 2, 0, p_size - 1);
+		for (int z = begin_z; z < end_z; z++) {
+			for (int x = begin_x; x < end_x; x++) {
+				Vector3 p00 = offset + Vector3(x, heights[z * p_size + x], z);
+				Vector3 p10 = offset + Vector3(x + 1, heights[z * p_size + x + 1], z);
+				Vector3 p01 = offset + Vector3(x, heights[(z + 1) * p_size + x], z + 1);
+				Vector3 p11 = offset + Vector3(x + 1, heights[(z + 1) * p_size + x + 1], z + 1);
+				if (p00.x > aabb.position.x + aabb.size.x + 1 || p11.x < aabb.position.x - 1 || p00.z > aabb.position.z + aabb.size.z + 1 || p11.z < aabb.position.z - 1) {
+					continue;
+				}
+				cell_face_count += 2;
+				AABB face_aabb(p00, Vector3());
+				face_aabb.expand_to(p10);
+				face_aabb.expand_to(p01);
+				expected_count += aabb.intersects(face_aabb) ? 1 : 0;
+				face_aabb = AABB(p10, Vector3());
+				face_aabb.expand_to(p11);
+				face_aabb.expand_to(p01);
+				expected_count += aabb.intersects(face_aabb) ? 1 : 0;
+			}
+		}
+
+		if (result.intersecting_face_count != expected_count) {
+			stats.cull_mismatch_count++;
+		}
+		stats.culled_face_count += result.face_count;
+		stats.total_face_count += cell_face_count;
+	}
+
+	for (int i = 0; i < p_ray_count; i++) {
+		Vector3 from(rng.random(-0.5f * p_size, 0.5f * p_size), 40.0, rng.random(-0.5f * p_size, 0.5f * p_size));
+		Vector3 to(rng.random(-0.5f * p_size, 0.5f * p_size), -40.0, rng.random(-0.5f * p_size, 0.5f * p_size));
+		Vector3 point;
+		Vector3 normal;
+		begin = OS::get_singleton()->get_ticks_usec();
+		stats.hit_count += shape.intersect_segment(from, to, point, normal, false) ? 1 : 0;
+		stats.ray_usec += OS::get_singleton()->get_ticks_usec() - begin;
+	}
+
+	return stats;
+}
+
+// Raises a region of the map above the previous height range.
+static Vector<real_t> make_raised_region(const Rect2i &p_region, int p_size, Vector<real_t> &r_heights) {
+	Vector<real_t> region_heights;
+	region_heights.resize(p_region.size.x * p_region.size.y);
+	for (int z = 0; z < p_region.size.y; z++) {
+		for (int x = 0; x < p_region.size.x; x++) {
+			real_t height = 30.0 + x * 0.1 + z * 0.2;
+			region_heights.write[z * p_region.size.x + x] = height;
+			r_heights.write[(p_region.position.y + z) * p_size + p_region.position.x + x] = height;
+		}
+	}
+	return region_heights;
+}
+
+TEST_CASE("[GodotShape3D] Concave polygon queries match brute force") {
+	ConcaveQueryStats stats = compare_concave_queries(32, 64, 32);
+	CHECK_MESSAGE(stats.cull_mismatch_count == 0, "Culling should report exactly the faces intersecting the query.");
+	CHECK(stats.hit_count > 0);
+	CHECK_MESSAGE(stats.ray_mismatch_count == 0, "Rays should hit the closest face.");
+}
+
+TEST_CASE("[GodotShape3D] Height map culling skips no intersecting face") {
+	HeightMapQueryStats stats = compare_height_map_queries(129, 64, 64);
+	CHECK_MESSAGE(stats.cull_mismatch_count == 0, "Culling should report every face intersecting the query.");
+	CHECK_MESSAGE(stats.culled_face_count < stats.total_face_count, "Faces far above or below the query should be skipped.");
+	CHECK(stats.hit_count == 64);
+}
+
+TEST_CASE("[GodotShape3D] Updating a height map region matches a full rebuild") {
+	const int size = 257;
+	Vector<real_t> heights = make_heights(size, size, 9);
+
+	GodotHeightMapShape3D updated_shape;
+	updated_shape.set_data(make_heightmap_data(size, size, heights));
+
+	const Rect2i region(40, 70, 33, 20);
+	updated_shape.update_region(region, make_raised_region(region, size, heights));
+
+	GodotHeightMapShape3D rebuilt_shape;
+	rebuilt_shape.set_data(make_heightmap_data(size, size, heights));
+
+	CHECK(updated_shape.get_heights() == heights);
+	CHECK(updated_shape.get_aabb().position.y <= rebuilt_shape.get_aabb().position.y);
+	CHECK(updated_shape.get_aabb().get_end().y >= rebuilt_shape.get_aabb().get_end().y);
+
+	RandomPCG rng(13);
+	int mismatch_count = 0;
+	for (int i = 0; i < 128; i++) {
+		Vector3 position(rng.random(-128.0f, 128.0f), rng.random(-20.0f, 40.0f), rng.random(-128.0f, 128.0f));
+		AABB aabb(position, Vector3(rng.random(1.0f, 32.0f), rng.random(0.5f, 4.0f), rng.random(1.0f, 32.0f)));
+		CullResult updated_result;
+		updated_result.aabb = aabb;
+		updated_shape.cull(aabb, cull_callback, &updated_result, false);
+		CullResult rebuilt_result;
+		rebuilt_result.aabb = aabb;
+		rebuilt_shape.cull(aabb, cull_callback, &rebuilt_result, false);
+		if (updated_result.intersecting_face_count != rebuilt_result.intersecting_face_count) {
+			mismatch_count++;
+		}
+
+		Vector3 from(rng.random(-128.0f, 128.0f), 60.0, rng.random(-128.0f, 128.0f));
+		Vector3 to(rng.random(-128.0f, 128.0f), -40.0, rng.random(-128.0f, 128.0f));
+		Vector3 updated_point;
+		Vector3 rebuilt_point;
+		Vector3 normal;
+		bool updated_hit = updated_shape.intersect_segment(from, to, updated_point, normal, false);
+		bool rebuilt_hit = rebuilt_shape.intersect_segment(from, to, rebuilt_point, normal, false);
+		if (updated_hit != rebuilt_hit || (updated_hit && !updated_point.is_equal_approx(rebuilt_point))) {
+			mismatch_count++;
+		}
+	}
+	CHECK_MESSAGE(mismatch_count == 0, "Queries should give the same results after a region update.");
+}
+
+TEST_CASE("[GodotShape3D] Updating a height map region through the physics server") {
+	PhysicsServer3D *physics_server = PhysicsServer3DManager::get_singleton()->new_default_server();
+	REQUIRE(physics_server);
+	physics_server->init();
+
+	const int size = 65;
+	Vector<real_t> heights = make_heights(size, size, 17);
+	RID partial_shape = physics_server->heightmap_shape_create();
+	physics_server->shape_set_data(partial_shape, make_heightmap_data(size, size, heights));
+	RID fallback_shape = physics_server->heightmap_shape_create();
+	physics_server->shape_set_data(fallback_shape, make_heightmap_data(size, size, heights));
+
+	const Rect2i region(10, 20, 12, 8);
+	Vector<real_t> region_heights = make_raised_region(region, size, heights);
+
+	SUBCASE("Partial update") {
+		physics_server->heightmap_shape_update_region(partial_shape, region, region_heights);
+		Dictionary d = physics_server->shape_get_data(partial_shape);
+		CHECK(Vector<real_t>(d["heights"]) == heights);
+		CHECK(real_t(d["max_height"]) >= 30.0);
+	}
+
+	SUBCASE("Full data fallback") {
+		// The base implementation is used by servers that don't override it.
+		physics_server->PhysicsServer3D::heightmap_shape_update_region(fallback_shape, region, region_heights);
+		Dictionary d = physics_server->shape_get_data(fallback_shape);
+		CHECK(Vector<real_t>(d["heights"]) == heights);
+		CHECK(int(d["width"]) == size);
+		CHECK(int(d["depth"]) == size);
+		CHECK(real_t(d["max_height"]) >= 30.0);
+	}
+
+	physics_server->free(partial_shape);
+	physics_server->free(fallback_shape);
+	physics_server->finish();
+	memdelete(physics_server);
+}
+
+TEST_CASE_BENCHMARK("[GodotShape3D][Benchmark] Concave polygon queries") {
+	const int terrain_size = 256;
+	ConcaveQueryStats stats = compare_concave_queries(terrain_size, 256, 64);
+	MESSAGE(vformat("Building a concave shape with %d faces took %d usec.", terrain_size * terrain_size * 2, stats.build_usec));
+	MESSAGE(vformat("Concave shape: 256 AABB queries took %d usec, 64 rays took %d usec.", stats.cull_usec, stats.ray_usec));
+	CHECK(stats.cull_mismatch_count == 0);
+	CHECK(stats.ray_mismatch_count == 0);
+}
+
+TEST_CASE_BENCHMARK("[GodotShape3D][Benchmark] Height map queries") {
+	const int size = 1025;
+	HeightMapQueryStats stats = compare_height_map_queries(size, 256, 256);
+	MESSAGE(vformat("Building a %dx%d height map took %d usec.", size, size, stats.build_usec));
+	MESSAGE(vformat("Height map: 256 AABB queries took %d usec and reported %d faces out of %d below the queries.", stats.cull_usec, stats.culled_face_count, stats.total_face_count));
+	MESSAGE(vformat("Height map: 256 rays took %d usec.", stats.ray_usec));
+	CHECK(stats.cull_mismatch_count == 0);
+	CHECK(stats.hit_count == 256);
+}
+
+} // namespace TestGodotShape3D
+
+#endif // TEST_GODOT_SHAPE_3D_H
@@ -0,0 +1,161 @@
+/**************************************************************************/
+/*  test_navigation_server_3d.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_NAVIGATION_SERVER_3D_H
+#define TEST_NAVIGATION_SERVER_3D_H
+
+#include "servers/navigation_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNavigationServer3D {
+
+static int path_query_callback_count = 0;
+static TypedArray<NavigationPathQueryResult3D> path_query_results;
+
+static void path_queries_solved(const TypedArray<NavigationPathQueryResult3D> &p_results) {
+	path_query_callback_count++;
+	path_query_results = p_results;
+}
+
+struct PathQueryScene {
+	NavigationServer3D *navigation_server = nullptr;
+	RID map;
+	RID region;
+
+	PathQueryScene() {
+		navigation_server = NavigationServer3D::get_singleton();
+		map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+
+		Ref<NavigationMesh> navigation_mesh;
+		navigation_mesh.instantiate();
+		Vector<Vector3> vertices;
+		vertices.push_back(Vector3(0, 0, 0));
+		vertices.push_back(Vector3(10, 0, 0));
+		vertices.push_back(Vector3(10, 0, 10));
+		vertices.push_back(Vector3(0, 0, 10));
+		navigation_mesh->set_vertices(vertices);
+		Vector<int> polygon;
+		polygon.push_back(0);
+		polygon.push_back(1);
+		polygon.push_back(2);
+		polygon.push_back(3);
+		navigation_mesh->add_polygon(polygon);
+
+		region = navigation_server->region_create();
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0);
+
+		path_query_callback_count = 0;
+		path_query_results.clear();
+	}
+
+	TypedArray<NavigationPathQueryParameters3D> make_queries(int p_count) const {
+		TypedArray<NavigationPathQueryParameters3D> queries;
+		for (int i = 0; i < p_count; i++) {
+			Ref<NavigationPathQueryParameters3D> query;
+			query.instantiate();
+			query->set_map(map);
+			query->set_start_position(Vector3(1, 0, 1));
+			query->set_target_position(Vector3(9, 0, 1 + (i % 8)));
+			queries.push_back(query);
+		}
+		return queries;
+	}
+
+	~PathQueryScene() {
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0);
+		path_query_results.clear();
+	}
+};
+
+static bool are_path_query_results_in_order(int p_count) {
+	if (path_query_results.size() != p_count) {
+		return false;
+	}
+	for (int i = 0; i < p_count; i++) {
+		const Ref<NavigationPathQueryResult3D> result = path_query_results[i];
+		if (result.is_null() || result->get_path().size() < 2) {
+			return false;
+		}
+		const Vector<Vector3> &path = result->get_path();
+		if (!path[path.size() - 1].is_equal_approx(Vector3(9, 0, 1 + (i % 8)))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[SceneTree][NavigationServer3D] Async path queries") {
+	PathQueryScene scene;
+	NavigationServer3D *navigation_server = scene.navigation_server;
+
+	SUBCASE("Results come in query order on the next update") {
+		navigation_server->query_paths_async(scene.make_queries(16), callable_mp_static(&path_queries_solved));
+		CHECK(path_query_callback_count == 0);
+		navigation_server->process(0.0);
+		CHECK(path_query_callback_count == 1);
+		CHECK(are_path_query_results_in_order(16));
+	}
+
+	SUBCASE("Queries are still solved while the server is inactive") {
+		navigation_server->set_active(false);
+		navigation_server->query_paths_async(scene.make_queries(4), callable_mp_static(&path_queries_solved));
+		navigation_server->process(0.0);
+		navigation_server->set_active(true);
+		CHECK(path_query_callback_count == 1);
+		CHECK(are_path_query_results_in_order(4));
+	}
+
+	SUBCASE("Queries over the time budget carry over to the next updates") {
+		navigation_server->set_path_query_time_budget(0.0001);
+		CHECK(navigation_server->get_path_query_time_budget() == doctest::Approx(0.0001));
+		const int query_count = 64;
+		navigation_server->query_paths_async(scene.make_queries(query_count), callable_mp_static(&path_queries_solved));
+
+		// At least one query is solved on each update.
+		int update_count = 0;
+		while (path_query_callback_count == 0 && update_count < query_count) {
+			navigation_server->process(0.0);
+			update_count++;
+		}
+		navigation_server->set_path_query_time_budget(0.0);
+		CHECK(path_query_callback_count == 1);
+		CHECK(are_path_query_results_in_order(query_count));
+	}
+}
+
+} // namespace TestNavigationServer3D
+
+#endif // TEST_NAVIGATION_SERVER_3D_H
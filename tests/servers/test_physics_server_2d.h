@@ -0,0 +1,198 @@
+/**************************************************************************/
+/*  test_physics_server_2d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_2D_H
+#define TEST_PHYSICS_SERVER_2D_H
+
+#include "servers/physics_server_2d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer2D {
+
+// A deterministic space with a floor and 16 boxes, which aren't added to the space yet.
+struct BoxStack {
+	PhysicsServer2D *physics_server = nullptr;
+	RID space;
+	RID floor_shape;
+	RID floor;
+	RID box_shape;
+	LocalVector<RID> boxes;
+};
+
+static void _create_box_stack(BoxStack &r_stack) {
+	PhysicsServer2D *physics_server = PhysicsServer2DManager::get_singleton()->new_default_server();
+	REQUIRE(physics_server);
+	physics_server->init();
+	physics_server->set_active(true);
+	r_stack.physics_server = physics_server;
+
+	r_stack.space = physics_server->space_create();
+	physics_server->space_set_active(r_stack.space, true);
+	physics_server->space_set_deterministic(r_stack.space, true);
+
+	r_stack.floor_shape = physics_server->rectangle_shape_create();
+	physics_server->shape_set_data(r_stack.floor_shape, Vector2(1000, 10));
+	r_stack.floor = physics_server->body_create();
+	physics_server->body_set_mode(r_stack.floor, PhysicsServer2D::BODY_MODE_STATIC);
+	physics_server->body_add_shape(r_stack.floor, r_stack.floor_shape);
+	physics_server->body_set_state(r_stack.floor, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(0, 20)));
+	physics_server->body_set_space(r_stack.floor, r_stack.space);
+
+	r_stack.box_shape = physics_server->rectangle_shape_create();
+	physics_server->shape_set_data(r_stack.box_shape, Vector2(10, 10));
+	for (int i = 0; i < 16; i++) {
+		RID box = physics_server->body_create();
+		physics_server->body_set_mode(box, PhysicsServer2D::BODY_MODE_RIGID);
+		physics_server->body_add_shape(box, r_stack.box_shape);
+		r_stack.boxes.push_back(box);
+	}
+}
+
+static void _free_box_stack(BoxStack &r_stack) {
+	PhysicsServer2D *physics_server = r_stack.physics_server;
+	for (const RID &box : r_stack.boxes) {
+		physics_server->free(box);
+	}
+	physics_server->free(r_stack.floor);
+	physics_server->free(r_stack.box_shape);
+	physics_server->free(r_stack.floor_shape);
+	physics_server->free(r_stack.space);
+
+	physics_server->finish();
+	memdelete(physics_server);
+	r_stack = BoxStack();
+}
+
+static void reset_boxes(PhysicsServer2D *p_physics_server, RID p_space, const LocalVector<RID> &p_boxes, bool p_reverse) {
+	// Taking the bodies out of the space clears their collision pairs, and adding them back
+	// in a different order makes the broadphase find the pairs in a different order too.
+	for (uint32_t i = 0; i < p_boxes.size(); i++) {
+		p_physics_server->body_set_space(p_boxes[i], RID());
+	}
+	for (uint32_t i = 0; i < p_boxes.size(); i++) {
+		uint32_t index = p_reverse ? p_boxes.size() - 1 - i : i;
+		p_physics_server->body_set_state(p_boxes[index], PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0.1 * index, Vector2((index % 4) * 20.5, -20.0 * (index / 4))));
+		p_physics_server->body_set_state(p_boxes[index], PhysicsServer2D::BODY_STATE_LINEAR_VELOCITY, Vector2(10.0 - index, 0));
+		p_physics_server->body_set_state(p_boxes[index], PhysicsServer2D::BODY_STATE_ANGULAR_VELOCITY, 0.0);
+		p_physics_server->body_set_space(p_boxes[index], p_space);
+	}
+}
+
+TEST_CASE("[PhysicsServer2D] Deterministic spaces give the same state when stepped again") {
+	BoxStack stack;
+	_create_box_stack(stack);
+	PhysicsServer2D *physics_server = stack.physics_server;
+	RID space = stack.space;
+	const LocalVector<RID> &boxes = stack.boxes;
+
+	physics_server->space_set_param(space, PhysicsServer2D::SPACE_PARAM_DETERMINISTIC_QUANTUM, 1.0 / 65536.0);
+	CHECK(physics_server->space_is_deterministic(space));
+	for (const RID &box : boxes) {
+		// Sleep timers aren't reset with the state, keep them out of the comparison.
+		physics_server->body_set_state(box, PhysicsServer2D::BODY_STATE_CAN_SLEEP, false);
+	}
+
+	const int frame_count = 120;
+	LocalVector<uint32_t> checksums;
+
+	reset_boxes(physics_server, space, boxes, false);
+	for (int i = 0; i < frame_count; i++) {
+		physics_server->step(1.0 / 60.0);
+		checksums.push_back(physics_server->space_get_state_checksum(space));
+	}
+
+	reset_boxes(physics_server, space, boxes, true);
+	int first_mismatch = -1;
+	for (int i = 0; i < frame_count; i++) {
+		physics_server->step(1.0 / 60.0);
+		if (first_mismatch < 0 && physics_server->space_get_state_checksum(space) != checksums[i]) {
+			first_mismatch = i;
+		}
+	}
+	CHECK_MESSAGE(first_mismatch == -1, vformat("Stepping the same state again should give the same checksums, first mismatch at frame %d.", first_mismatch));
+
+	// Moving a single body changes the checksum.
+	uint32_t checksum = physics_server->space_get_state_checksum(space);
+	physics_server->body_set_state(boxes[0], PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(-500, -500)));
+	CHECK(physics_server->space_get_state_checksum(space) != checksum);
+
+	_free_box_stack(stack);
+}
+
+TEST_CASE("[PhysicsServer2D] Restoring a snapshot rewinds the space") {
+	BoxStack stack;
+	_create_box_stack(stack);
+	PhysicsServer2D *physics_server = stack.physics_server;
+	RID space = stack.space;
+	const LocalVector<RID> &boxes = stack.boxes;
+
+	reset_boxes(physics_server, space, boxes, false);
+
+	// Take the snapshot once the boxes are landing, so it holds contacts.
+	for (int i = 0; i < 60; i++) {
+		physics_server->step(1.0 / 60.0);
+	}
+	Vector<uint8_t> snapshot = physics_server->space_save_snapshot(space);
+	CHECK(snapshot.size() > 0);
+	uint32_t snapshot_checksum = physics_server->space_get_state_checksum(space);
+
+	const int frame_count = 10;
+	LocalVector<uint32_t> checksums;
+	for (int i = 0; i < frame_count; i++) {
+		physics_server->step(1.0 / 60.0);
+		checksums.push_back(physics_server->space_get_state_checksum(space));
+	}
+
+	// Re-simulating the same frames from the snapshot, like rollback does, gives the same states.
+	for (int rollback = 0; rollback < 3; rollback++) {
+		CHECK(physics_server->space_restore_snapshot(space, snapshot));
+		CHECK(physics_server->space_get_state_checksum(space) == snapshot_checksum);
+
+		int first_mismatch = -1;
+		for (int i = 0; i < frame_count; i++) {
+			physics_server->step(1.0 / 60.0);
+			if (first_mismatch < 0 && physics_server->space_get_state_checksum(space) != checksums[i]) {
+				first_mismatch = i;
+			}
+		}
+		CHECK_MESSAGE(first_mismatch == -1, vformat("Stepping again from the snapshot should give the same checksums, first mismatch at frame %d.", first_mismatch));
+	}
+
+	ERR_PRINT_OFF;
+	CHECK_FALSE_MESSAGE(physics_server->space_restore_snapshot(space, Vector<uint8_t>()), "An empty snapshot should be rejected.");
+	ERR_PRINT_ON;
+
+	_free_box_stack(stack);
+}
+
+} // namespace TestPhysicsServer2D
+
+#endif // TEST_PHYSICS_SERVER_2D_H
@@ -0,0 +1,592 @@
+/**************************************************************************/
+/*  test_physics_server_3d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_3D_H
+#define TEST_PHYSICS_SERVER_3D_H
+
+#include "core/os/os.h"
+#include "servers/physics_server_3d.h"
+#include "servers/rendering_server.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer3D {
+
+struct BoxScene {
+	PhysicsServer3D *physics_server = nullptr;
+	RID space;
+	RID floor_shape;
+	RID floor;
+	RID box_shape;
+	Vector<RID> boxes;
+};
+
+static void _create_box_scene(BoxScene &r_scene) {
+	PhysicsServer3D *physics_server = PhysicsServer3DManager::get_singleton()->new_default_server();
+	REQUIRE(physics_server);
+	physics_server->init();
+	physics_server->set_active(true);
+	r_scene.physics_server = physics_server;
+
+	r_scene.space = physics_server->space_create();
+	physics_server->space_set_active(r_scene.space, true);
+
+	r_scene.floor_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(r_scene.floor_shape, Vector3(100, 1, 100));
+	r_scene.floor = physics_server->body_create();
+	physics_server->body_set_mode(r_scene.floor, PhysicsServer3D::BODY_MODE_STATIC);
+	physics_server->body_add_shape(r_scene.floor, r_scene.floor_shape);
+	physics_server->body_set_state(r_scene.floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, -1, 0)));
+	physics_server->body_set_space(r_scene.floor, r_scene.space);
+
+	r_scene.box_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(r_scene.box_shape, Vector3(0.5, 0.5, 0.5));
+}
+
+static void _add_box(BoxScene &r_scene, const Vector3 &p_origin) {
+	PhysicsServer3D *physics_server = r_scene.physics_server;
+	RID box = physics_server->body_create();
+	physics_server->body_set_mode(box, PhysicsServer3D::BODY_MODE_RIGID);
+	physics_server->body_add_shape(box, r_scene.box_shape);
+	physics_server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), p_origin));
+	physics_server->body_set_space(box, r_scene.space);
+	r_scene.boxes.push_back(box);
+}
+
+static void _add_box_grid(BoxScene &r_scene, int p_grid_size, int p_layer_count) {
+	for (int y = 0; y < p_layer_count; y++) {
+		for (int x = 0; x < p_grid_size; x++) {
+			for (int z = 0; z < p_grid_size; z++) {
+				_add_box(r_scene, Vector3(x * 1.1, 0.55 + y * 1.05, z * 1.1));
+			}
+		}
+	}
+}
+
+static void _add_box_pyramid(BoxScene &r_scene, int p_base_size) {
+	for (int y = 0; y < p_base_size; y++) {
+		for (int x = 0; x < p_base_size - y; x++) {
+			_add_box(r_scene, Vector3((x + y * 0.5) * 1.05, 0.5 + y, 0));
+		}
+	}
+}
+
+// Returns the total time spent stepping, in microseconds.
+static uint64_t _step_box_scene(BoxScene &r_scene, int p_step_count) {
+	uint64_t step_usec = 0;
+	for (int i = 0; i < p_step_count; i++) {
+		uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+		r_scene.physics_server->step(1.0 / 60.0);
+		step_usec += OS::get_singleton()->get_ticks_usec() - begin_usec;
+	}
+	return step_usec;
+}
+
+static bool _are_boxes_above_floor(const BoxScene &p_scene) {
+	for (const RID &box : p_scene.boxes) {
+		Transform3D transform = p_scene.physics_server->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM);
+		if (transform.origin.y < 0.25) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static Vector3 _get_top_box_origin(const BoxScene &p_scene) {
+	Transform3D transform = p_scene.physics_server->body_get_state(p_scene.boxes[p_scene.boxes.size() - 1], PhysicsServer3D::BODY_STATE_TRANSFORM);
+	return transform.origin;
+}
+
+static void _free_box_scene(BoxScene &r_scene) {
+	PhysicsServer3D *physics_server = r_scene.physics_server;
+	for (const RID &box : r_scene.boxes) {
+		physics_server->free(box);
+	}
+	physics_server->free(r_scene.floor);
+	physics_server->free(r_scene.box_shape);
+	physics_server->free(r_scene.floor_shape);
+	physics_server->free(r_scene.space);
+
+	physics_server->finish();
+	memdelete(physics_server);
+	r_scene = BoxScene();
+}
+
+TEST_CASE("[PhysicsServer3D] Many bodies resting on each other") {
+	BoxScene scene;
+	_create_box_scene(scene);
+
+	// Just enough moving bodies for the broadphase pairing to run on the worker threads.
+	const int grid_size = 8;
+	const int layer_count = 4;
+	_add_box_grid(scene, grid_size, layer_count);
+	_step_box_scene(scene, 20);
+
+	CHECK_MESSAGE(
+			scene.physics_server->get_process_info(PhysicsServer3D::INFO_COLLISION_PAIRS) >= grid_size * grid_size * layer_count,
+			"Every box should at least be paired with the body it rests on.");
+	CHECK_MESSAGE(_are_boxes_above_floor(scene), "No box should have fallen through the floor or the boxes below it.");
+
+	_free_box_scene(scene);
+}
+
+TEST_CASE("[PhysicsServer3D] Box pyramid stays stacked") {
+	BoxScene scene;
+	_create_box_scene(scene);
+
+	// A single island where every iteration goes through all the contacts.
+	_add_box_pyramid(scene, 6);
+	const Vector3 top_origin = _get_top_box_origin(scene);
+	_step_box_scene(scene, 60);
+
+	CHECK_MESSAGE(_get_top_box_origin(scene).distance_to(top_origin) < 0.5, "The top of the pyramid should stay in place.");
+
+	_free_box_scene(scene);
+}
+
+TEST_CASE_BENCHMARK("[PhysicsServer3D][Benchmark] Many bodies resting on each other") {
+	BoxScene scene;
+	_create_box_scene(scene);
+	_add_box_grid(scene, 12, 4);
+
+	const int step_count = 60;
+	uint64_t step_usec = _step_box_scene(scene, step_count);
+	MESSAGE(vformat("%d bodies: %.3f ms per step on average, %d collision pairs, %d islands.",
+			scene.boxes.size(), step_usec / 1000.0 / step_count,
+			scene.physics_server->get_process_info(PhysicsServer3D::INFO_COLLISION_PAIRS),
+			scene.physics_server->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT)));
+	CHECK(_are_boxes_above_floor(scene));
+
+	_free_box_scene(scene);
+}
+
+TEST_CASE_BENCHMARK("[PhysicsServer3D][Benchmark] Box pyramid") {
+	BoxScene scene;
+	_create_box_scene(scene);
+	_add_box_pyramid(scene, 16);
+	const Vector3 top_origin = _get_top_box_origin(scene);
+
+	const int step_count = 120;
+	uint64_t step_usec = _step_box_scene(scene, step_count);
+	MESSAGE(vformat("Pyramid of %d bodies: %.3f ms per step on average, %d collision pairs.",
+			scene.boxes.size(), step_usec / 1000.0 / step_count,
+			scene.physics_server->get_process_info(PhysicsServer3D::INFO_COLLISION_PAIRS)));
+	CHECK(_get_top_box_origin(scene).distance_to(top_origin) < 0.5);
+
+	_free_box_scene(scene);
+}
+
+TEST_CASE("[PhysicsServer3D] Islands follow the contacts between bodies") {
+	PhysicsServer3D *physics_server = PhysicsServer3DManager::get_singleton()->new_default_server();
+	REQUIRE(physics_server);
+	physics_server->init();
+	physics_server->set_active(true);
+
+	RID space = physics_server->space_create();
+	physics_server->space_set_active(space, true);
+
+	RID floor_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(floor_shape, Vector3(100, 1, 100));
+	RID floor = physics_server->body_create();
+	physics_server->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+	physics_server->body_add_shape(floor, floor_shape);
+	physics_server->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, -1, 0)));
+	physics_server->body_set_space(floor, space);
+
+	RID box_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(box_shape, Vector3(0.5, 0.5, 0.5));
+	RID boxes[2];
+	for (int i = 0; i < 2; i++) {
+		boxes[i] = physics_server->body_create();
+		physics_server->body_set_mode(boxes[i], PhysicsServer3D::BODY_MODE_RIGID);
+		physics_server->body_add_shape(boxes[i], box_shape);
+		physics_server->body_set_state(boxes[i], PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(i * 10, 0.5, 0)));
+		physics_server->body_set_space(boxes[i], space);
+	}
+
+	for (int i = 0; i < 5; i++) {
+		physics_server->step(1.0 / 60.0);
+	}
+	CHECK_MESSAGE(physics_server->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT) == 2, "Boxes apart from each other should be in separate islands.");
+
+	// Stacking the boxes joins their islands.
+	physics_server->body_set_state(boxes[1], PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, 1.5, 0)));
+	for (int i = 0; i < 5; i++) {
+		physics_server->step(1.0 / 60.0);
+	}
+	CHECK_MESSAGE(physics_server->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT) == 1, "Stacked boxes should be in the same island.");
+
+	// Separating them splits the island again.
+	physics_server->body_set_state(boxes[1], PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(10, 0.5, 0)));
+	for (int i = 0; i < 5; i++) {
+		physics_server->step(1.0 / 60.0);
+	}
+	CHECK_MESSAGE(physics_server->get_process_info(PhysicsServer3D::INFO_ISLAND_COUNT) == 2, "Boxes apart from each other should be in separate islands.");
+
+	for (int i = 0; i < 2; i++) {
+		physics_server->free(boxes[i]);
+	}
+	physics_server->free(floor);
+	physics_server->free(box_shape);
+	physics_server->free(floor_shape);
+	physics_server->free(space);
+
+	physics_server->finish();
+	memdelete(physics_server);
+}
+
+TEST_CASE("[PhysicsServer3D] Restoring a snapshot rewinds the space") {
+	BoxScene scene;
+	_create_box_scene(scene);
+	_add_box(scene, Vector3(0, 1, 0));
+	PhysicsServer3D *physics_server = scene.physics_server;
+	RID space = scene.space;
+	RID box = scene.boxes[0];
+	physics_server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(Vector3(0, 0, 1), 0.3), Vector3(0, 1, 0)));
+
+	// Take the snapshot while the box tips over on the floor, so it holds contacts.
+	for (int i = 0; i < 30; i++) {
+		physics_server->step(1.0 / 60.0);
+	}
+	Vector<uint8_t> snapshot = physics_server->space_save_snapshot(space);
+	CHECK(snapshot.size() > 0);
+	Transform3D snapshot_transform = physics_server->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM);
+
+	for (int i = 0; i < 30; i++) {
+		physics_server->step(1.0 / 60.0);
+	}
+	Transform3D expected_transform = physics_server->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM);
+	Vector3 expected_velocity = physics_server->body_get_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY);
+
+	CHECK(physics_server->space_restore_snapshot(space, snapshot));
+	CHECK(Transform3D(physics_server->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM)).is_equal_approx(snapshot_transform));
+
+	for (int i = 0; i < 30; i++) {
+		physics_server->step(1.0 / 60.0);
+	}
+	CHECK_MESSAGE(Transform3D(physics_server->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM)).is_equal_approx(expected_transform), "Stepping again from the snapshot should give the same transform.");
+	CHECK_MESSAGE(Vector3(physics_server->body_get_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY)).is_equal_approx(expected_velocity), "Stepping again from the snapshot should give the same velocity.");
+
+	_free_box_scene(scene);
+}
+
+// Shoots a box at a static obstacle at x=10 for half a second and returns how far it got.
+static real_t shoot_box_at_obstacle(PhysicsServer3D *p_physics_server, const Vector3 &p_obstacle_half_extents, const Transform3D &p_box_transform, real_t p_box_half_size, int p_ticks_per_second, bool p_continuous_cd, uint64_t &r_step_usec) {
+	RID space = p_physics_server->space_create();
+	p_physics_server->space_set_active(space, true);
+
+	RID obstacle_shape = p_physics_server->box_shape_create();
+	p_physics_server->shape_set_data(obstacle_shape, p_obstacle_half_extents);
+	RID obstacle = p_physics_server->body_create();
+	p_physics_server->body_set_mode(obstacle, PhysicsServer3D::BODY_MODE_STATIC);
+	p_physics_server->body_add_shape(obstacle, obstacle_shape);
+	p_physics_server->body_set_state(obstacle, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(10, 0, 0)));
+	p_physics_server->body_set_space(obstacle, space);
+
+	RID box_shape = p_physics_server->box_shape_create();
+	p_physics_server->shape_set_data(box_shape, Vector3(p_box_half_size, p_box_half_size, p_box_half_size));
+	RID box = p_physics_server->body_create();
+	p_physics_server->body_set_mode(box, PhysicsServer3D::BODY_MODE_RIGID);
+	p_physics_server->body_add_shape(box, box_shape);
+	p_physics_server->body_set_param(box, PhysicsServer3D::BODY_PARAM_GRAVITY_SCALE, 0.0);
+	p_physics_server->body_set_enable_continuous_collision_detection(box, p_continuous_cd);
+	p_physics_server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, p_box_transform);
+	p_physics_server->body_set_state(box, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY, Vector3(200, 0, 0));
+	p_physics_server->body_set_space(box, space);
+
+	r_step_usec = 0;
+	for (int i = 0; i < p_ticks_per_second / 2; i++) {
+		uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+		p_physics_server->step(1.0 / p_ticks_per_second);
+		r_step_usec += OS::get_singleton()->get_ticks_usec() - begin_usec;
+	}
+
+	Transform3D box_transform = p_physics_server->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM);
+
+	p_physics_server->free(box);
+	p_physics_server->free(obstacle);
+	p_physics_server->free(box_shape);
+	p_physics_server->free(obstacle_shape);
+	p_physics_server->free(space);
+
+	return box_transform.origin.x;
+}
+
+TEST_CASE("[PhysicsServer3D] Continuous collision detection stops fast bodies") {
+	PhysicsServer3D *physics_server = PhysicsServer3DManager::get_singleton()->new_default_server();
+	REQUIRE(physics_server);
+	physics_server->init();
+	physics_server->set_active(true);
+
+	// At 200 m/s the box moves over 3 m per step at 60 Hz, several times its size.
+	uint64_t step_usec = 0;
+
+	SUBCASE("Thin wall") {
+		Transform3D box_transform(Basis(Vector3(1, 1, 0).normalized(), Math_PI * 0.25), Vector3());
+		real_t x = shoot_box_at_obstacle(physics_server, Vector3(0.05, 5, 5), box_transform, 0.25, 60, true, step_usec);
+		CHECK_MESSAGE(x < 10.0, "The box shouldn't tunnel through the wall with CCD enabled.");
+	}
+
+	SUBCASE("Small obstacle between the corners of the box") {
+		// The obstacle passes between the rays cast from the corners of the leading face,
+		// and the box steps from x=8.2 to x=11.5, so it is only stopped by sweeping the whole shape.
+		Transform3D box_transform(Basis(), Vector3(1.5, 0, 0));
+		real_t x = shoot_box_at_obstacle(physics_server, Vector3(0.05, 0.1, 0.1), box_transform, 0.5, 60, false, step_usec);
+		CHECK_MESSAGE(x > 10.0, "The box should tunnel through the obstacle without CCD.");
+
+		x = shoot_box_at_obstacle(physics_server, Vector3(0.05, 0.1, 0.1), box_transform, 0.5, 60, true, step_usec);
+		CHECK_MESSAGE(x < 10.0, "The box shouldn't tunnel through the obstacle with CCD enabled.");
+	}
+
+	physics_server->finish();
+	memdelete(physics_server);
+}
+
+TEST_CASE_BENCHMARK("[PhysicsServer3D][Benchmark] Continuous collision detection against higher tick rates") {
+	PhysicsServer3D *physics_server = PhysicsServer3DManager::get_singleton()->new_default_server();
+	REQUIRE(physics_server);
+	physics_server->init();
+	physics_server->set_active(true);
+
+	Transform3D box_transform(Basis(Vector3(1, 1, 0).normalized(), Math_PI * 0.25), Vector3());
+	uint64_t ccd_usec = 0;
+	real_t ccd_x = shoot_box_at_obstacle(physics_server, Vector3(0.05, 5, 5), box_transform, 0.25, 60, true, ccd_usec);
+	MESSAGE(vformat("60 Hz with CCD: box at x=%.2f in %d usec.", ccd_x, ccd_usec));
+
+	// Compare with the usual workaround of raising the tick rate instead.
+	for (int ticks_per_second : { 60, 240, 960 }) {
+		uint64_t usec = 0;
+		real_t x = shoot_box_at_obstacle(physics_server, Vector3(0.05, 5, 5), box_transform, 0.25, ticks_per_second, false, usec);
+		MESSAGE(vformat("%d Hz without CCD: box at x=%.2f (%s) in %d usec.", ticks_per_second, x, x < 10.0 ? "stopped" : "tunneled", usec));
+	}
+
+	physics_server->finish();
+	memdelete(physics_server);
+}
+
+TEST_CASE("[PhysicsServer3D] Batched queries give the same results as single queries") {
+	PhysicsServer3D *physics_server = PhysicsServer3DManager::get_singleton()->new_default_server();
+	REQUIRE(physics_server);
+	physics_server->init();
+	physics_server->set_active(true);
+
+	RID space = physics_server->space_create();
+	physics_server->space_set_active(space, true);
+
+	RID box_shape = physics_server->box_shape_create();
+	physics_server->shape_set_data(box_shape, Vector3(1, 1, 1));
+	Vector<RID> boxes;
+	for (int i = 0; i < 10; i++) {
+		RID box = physics_server->body_create();
+		physics_server->body_set_mode(box, PhysicsServer3D::BODY_MODE_STATIC);
+		physics_server->body_add_shape(box, box_shape);
+		physics_server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(i * 4, 0, 0)));
+		physics_server->body_set_space(box, space);
+		boxes.push_back(box);
+	}
+
+	// Update the broadphase.
+	physics_server->step(1.0 / 60.0);
+
+	PhysicsDirectSpaceState3D *space_state = physics_server->space_get_direct_state(space);
+	REQUIRE(space_state);
+
+	SUBCASE("Rays") {
+		const int ray_count = 1000;
+		LocalVector<Vector3> from;
+		LocalVector<Vector3> to;
+		for (int i = 0; i < ray_count; i++) {
+			Vector3 position(-2 + (i % 100) * 0.42, 0, -1.5 + (i / 100) * 0.33);
+			from.push_back(position + Vector3(0, 5, 0));
+			to.push_back(position - Vector3(0, 5, 0));
+		}
+
+		PhysicsDirectSpaceState3D::RayParameters parameters;
+		LocalVector<PhysicsDirectSpaceState3D::RayResult> results;
+		results.resize(ray_count);
+		LocalVector<bool> hits;
+		hits.resize(ray_count);
+		space_state->intersect_rays(parameters, from.ptr(), to.ptr(), ray_count, results.ptr(), hits.ptr());
+
+		int hit_count = 0;
+		bool all_match = true;
+		for (int i = 0; i < ray_count; i++) {
+			parameters.from = from[i];
+			parameters.to = to[i];
+			PhysicsDirectSpaceState3D::RayResult result;
+			bool hit = space_state->intersect_ray(parameters, result);
+			if (hit != hits[i] || (hit && (result.rid != results[i].rid || !result.position.is_equal_approx(results[i].position)))) {
+				all_match = false;
+			}
+			if (hit) {
+				hit_count++;
+			}
+		}
+
+		CHECK_MESSAGE(hit_count > 0, "Some rays should hit the boxes.");
+		CHECK_MESSAGE(hit_count < ray_count, "Some rays should go between the boxes.");
+		CHECK_MESSAGE(all_match, "Batched rays should give the same results as single rays.");
+	}
+
+	SUBCASE("Motions") {
+		RID sphere_shape = physics_server->sphere_shape_create();
+		physics_server->shape_set_data(sphere_shape, 0.5);
+
+		const int motion_count = 200;
+		LocalVector<Transform3D> transforms;
+		LocalVector<Vector3> motions;
+		for (int i = 0; i < motion_count; i++) {
+			transforms.push_back(Transform3D(Basis(), Vector3(-2 + i * 0.21, 5, 0)));
+			motions.push_back(Vector3(0, -10, 0));
+		}
+
+		PhysicsDirectSpaceState3D::ShapeParameters parameters;
+		parameters.shape_rid = sphere_shape;
+		LocalVector<real_t> closest_safe;
+		closest_safe.resize(motion_count);
+		LocalVector<real_t> closest_unsafe;
+		closest_unsafe.resize(motion_count);
+		CHECK(space_state->cast_motions(parameters, transforms.ptr(), motions.ptr(), motion_count, closest_safe.ptr(), closest_unsafe.ptr()));
+
+		int blocked_count = 0;
+		bool all_match = true;
+		for (int i = 0; i < motion_count; i++) {
+			parameters.transform = transforms[i];
+			parameters.motion = motions[i];
+			real_t safe = 1.0;
+			real_t unsafe = 1.0;
+			CHECK(space_state->cast_motion(parameters, safe, unsafe));
+			if (!Math::is_equal_approx(safe, closest_safe[i]) || !Math::is_equal_approx(unsafe, closest_unsafe[i])) {
+				all_match = false;
+			}
+			if (safe < 1.0) {
+				blocked_count++;
+			}
+		}
+
+		CHECK_MESSAGE(blocked_count > 0, "Some motions should be blocked by the boxes.");
+		CHECK_MESSAGE(all_match, "Batched motions should give the same results as single motions.");
+
+		physics_server->free(sphere_shape);
+	}
+
+	for (const RID &box : boxes) {
+		physics_server->free(box);
+	}
+	physics_server->free(box_shape);
+	physics_server->free(space);
+
+	physics_server->finish();
+	memdelete(physics_server);
+}
+
+static RID _create_soft_body_grid_mesh(int p_side) {
+	PackedVector3Array vertices;
+	for (int z = 0; z < p_side; z++) {
+		for (int x = 0; x < p_side; x++) {
+			vertices.push_back(Vector3(x * 0.1, 0, z * 0.1));
+		}
+	}
+	PackedInt32Array indices;
+	for (int z = 0; z < p_side - 1; z++) {
+		for (int x = 0; x < p_side - 1; x++) {
+			const int i = z * p_side + x;
+			indices.push_back(i);
+			indices.push_back(i + 1);
+			indices.push_back(i + p_side);
+			indices.push_back(i + 1);
+			indices.push_back(i + p_side + 1);
+			indices.push_back(i + p_side);
+		}
+	}
+
+	Array arrays;
+	arrays.resize(RS::ARRAY_MAX);
+	arrays[RS::ARRAY_VERTEX] = vertices;
+	arrays[RS::ARRAY_INDEX] = indices;
+	RID mesh = RenderingServer::get_singleton()->mesh_create();
+	RenderingServer::get_singleton()->mesh_add_surface_from_arrays(mesh, RS::PRIMITIVE_TRIANGLES, arrays);
+	return mesh;
+}
+
+static RID _create_soft_body(PhysicsServer3D *p_physics_server, RID p_mesh, RID p_space) {
+	RID soft_body = p_physics_server->soft_body_create();
+	p_physics_server->soft_body_set_mesh(soft_body, p_mesh);
+	p_physics_server->soft_body_pin_point(soft_body, 0, true);
+	p_physics_server->soft_body_set_space(soft_body, p_space);
+	return soft_body;
+}
+
+TEST_CASE("[SceneTree][PhysicsServer3D] Soft body constraints solved on threads") {
+	// Soft bodies need the rendering server for their mesh, so this uses the servers
+	// the scene tree is running with instead of creating a separate physics server.
+	PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+	REQUIRE(physics_server);
+
+	// A single soft body in a space splits its work across threads, while several
+	// soft bodies are solved serially, one per task. Both must give the same result.
+	const int side = 48;
+	const int point_count = side * side;
+	RID mesh = _create_soft_body_grid_mesh(side);
+
+	RID threaded_space = physics_server->space_create();
+	physics_server->space_set_active(threaded_space, true);
+	RID threaded_body = _create_soft_body(physics_server, mesh, threaded_space);
+
+	RID serial_space = physics_server->space_create();
+	physics_server->space_set_active(serial_space, true);
+	RID serial_body = _create_soft_body(physics_server, mesh, serial_space);
+	RID other_serial_body = _create_soft_body(physics_server, mesh, serial_space);
+
+	for (int i = 0; i < 30; i++) {
+		physics_server->step(1.0 / 60.0);
+	}
+
+	bool all_match = true;
+	for (int i = 0; i < point_count; i++) {
+		if (!physics_server->soft_body_get_point_global_position(threaded_body, i).is_equal_approx(physics_server->soft_body_get_point_global_position(serial_body, i))) {
+			all_match = false;
+		}
+	}
+	CHECK_MESSAGE(all_match, "Solving a soft body on threads should give the same points as solving it serially.");
+	CHECK_MESSAGE(physics_server->soft_body_get_point_global_position(threaded_body, point_count - 1).y < 0, "The soft body should fall under gravity.");
+	CHECK_MESSAGE(physics_server->soft_body_get_point_global_position(threaded_body, 0).is_equal_approx(Vector3()), "The pinned point should stay in place.");
+
+	physics_server->free(threaded_body);
+	physics_server->free(serial_body);
+	physics_server->free(other_serial_body);
+	physics_server->free(threaded_space);
+	physics_server->free(serial_space);
+	RenderingServer::get_singleton()->free(mesh);
+}
+
+} // namespace TestPhysicsServer3D
+
+#endif // TEST_PHYSICS_SERVER_3D_H
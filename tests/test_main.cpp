@@ -44,8 +44,10 @@
 #include "tests/core/io/test_xml_parser.h"
 #include "tests/core/math/test_aabb.h"
 #include "tests/core/math/test_astar.h"
+#include "tests/core/math/test_astar_grid_2d.h"
 #include "tests/core/math/test_basis.h"
 #include "tests/core/math/test_color.h"
+#include "tests/core/math/test_dynamic_bvh.h"
 #include "tests/core/math/test_expression.h"
 #include "tests/core/math/test_geometry_2d.h"
 #include "tests/core/math/test_geometry_3d.h"
@@ -95,6 +97,7 @@
 #include "tests/scene/test_curve_2d.h"
 #include "tests/scene/test_gradient.h"
 #include "tests/scene/test_node.h"
+#include "tests/scene/test_packed_scene.h"
 #include "tests/scene/test_path_2d.h"
 #include "tests/scene/test_path_3d.h"
 #include "tests/scene/test_primitives.h"
@@ -103,6 +106,11 @@
 #include "tests/scene/test_theme.h"
 #include "tests/scene/test_viewport.h"
 #include "tests/scene/test_visual_shader.h"
+#include "tests/servers/test_godot_narrow_phase_3d.h"
+#include "tests/servers/test_godot_shape_3d.h"
+#include "tests/servers/test_navigation_server_3d.h"
+#include "tests/servers/test_physics_server_2d.h"
+#include "tests/servers/test_physics_server_3d.h"
 #include "tests/servers/test_text_server.h"
 #include "tests/test_validate_testing.h"
 